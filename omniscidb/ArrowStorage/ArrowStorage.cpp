@@ -536,6 +536,13 @@ TableInfoPtr ArrowStorage::createTable(const std::string& table_name,
                                                /*temp=*/true);
           dict_desc->stringDict =
               std::make_shared<StringDictionary>(DictRef{db_id_, dict_id});
+          if (config_->storage.enable_dict_compression) {
+            dict_desc->stringDict->enablePayloadCompression();
+          }
+          dict_desc->stringDict->setTranslationCacheBudget(
+              config_->cache.dict_translation_cache_bytes);
+          dict_desc->stringDict->setPatternCacheBudget(
+              config_->cache.dict_pattern_cache_bytes);
           if (sharing_id < 0) {
             dict_ids.emplace(sharing_id, dict_id);
           }
@@ -854,9 +861,22 @@ void ArrowStorage::appendArrowTable(std::shared_ptr<arrow::Table> at, int table_
     table.row_count = at->num_rows();
   }
 
-  auto table_info = getTableInfo(db_id_, table_id);
-  table_info->fragments = table.fragments.size();
-  table_info->row_count = table.row_count;
+  const size_t fragment_count = table.fragments.size();
+  const size_t row_count = table.row_count;
+  table_lock.unlock();
+
+  // Replace the table info instead of updating it in place. Holders of the previous
+  // info, e.g. cached DAGs, can detect the change by comparing pointers. The table
+  // lock is released first to keep the schema-then-table lock order of dropTable.
+  // Tables only grow, so an info already updated by a later append is kept.
+  mapd_unique_lock<mapd_shared_mutex> schema_lock(schema_mutex_);
+  auto cur_table_info = getTableInfoNoLock(db_id_, table_id);
+  if (cur_table_info && cur_table_info->row_count < row_count) {
+    auto table_info = std::make_shared<TableInfo>(*cur_table_info);
+    table_info->fragments = fragment_count;
+    table_info->row_count = row_count;
+    addTableInfo(table_info);
+  }
 }
 
 TableInfoPtr ArrowStorage::importCsvFile(const std::string& file_name,
@@ -22,6 +22,7 @@
 #include "OSDependent/omnisci_path.h"
 
 #include <jni.h>
+#include <cctype>
 #include <filesystem>
 
 using namespace std::string_literals;
@@ -171,9 +172,8 @@ std::shared_ptr<JVM> JVM::instance_;
 
 class CalciteJNI {
  public:
-  CalciteJNI(const std::string& udf_filename, size_t calcite_max_mem_mb) {
-    // Initialize JVM.
-    jvm_ = JVM::getInstance(calcite_max_mem_mb);
+  CalciteJNI(const std::string& udf_filename, size_t calcite_max_mem_mb)
+      : jvm_(JVM::getInstance(calcite_max_mem_mb)), thread_env_(jvm_->getEnv()) {
     auto env = jvm_->getEnv();
 
     // Create CalciteServerHandler object.
@@ -201,7 +201,7 @@ class CalciteJNI {
 
   std::string process(const std::string& db_name,
                       const std::string& sql_string,
-                      SchemaProvider* schema_provider,
+                      const std::string& schema_json,
                       Config* config,
                       const std::vector<FilterPushDownInfo>& filter_push_down_info,
                       const bool legacy_syntax,
@@ -231,7 +231,6 @@ class CalciteJNI {
                        (jboolean)config->exec.watchdog.enable,
                        arg_filter_push_down_info);
     jobject arg_restriction = nullptr;
-    auto schema_json = schema_to_json(schema_provider);
     jstring arg_schema = env->NewStringUTF(schema_json.c_str());
 
     jobject java_res = env->CallObjectMethod(handler_obj_,
@@ -561,21 +560,81 @@ class CalciteJNI {
 
   std::vector<jobject> global_refs_;
   std::shared_ptr<JVM> jvm_;
+  // Keeps the worker thread attached to JVM while the object exists, so that calls
+  // don't attach and detach it each time.
+  JVM::JNIEnvWrapper thread_env_;
 };
 
+namespace {
+
+// Collapses whitespaces and drops line comments outside of literals, quoted
+// identifiers and block comments (which may hold hints), so that queries differing
+// in formatting only share a cache entry.
+std::string normalize_sql(const std::string& sql) {
+  std::string res;
+  res.reserve(sql.size());
+  bool pending_space = false;
+  for (size_t pos = 0; pos < sql.size(); ++pos) {
+    auto c = sql[pos];
+    auto next = pos + 1 < sql.size() ? sql[pos + 1] : '\0';
+    if (std::isspace(static_cast<unsigned char>(c))) {
+      pending_space = true;
+      continue;
+    }
+    if (c == '-' && next == '-') {
+      pos = sql.find('\n', pos);
+      if (pos == std::string::npos) {
+        break;
+      }
+      pending_space = true;
+      continue;
+    }
+
+    if (pending_space && !res.empty()) {
+      res += ' ';
+    }
+    pending_space = false;
+
+    // Escaped quotes are handled as two consecutive literals.
+    size_t end = pos;
+    if (c == '\'' || c == '"') {
+      end = sql.find(c, pos + 1);
+    } else if (c == '/' && next == '*') {
+      end = sql.find("*/", pos + 2);
+      if (end != std::string::npos) {
+        ++end;
+      }
+    }
+    if (end == std::string::npos) {
+      res.append(sql, pos, std::string::npos);
+      break;
+    }
+    res.append(sql, pos, end - pos + 1);
+    pos = end;
+  }
+  return res;
+}
+
+}  // namespace
+
 CalciteMgr::~CalciteMgr() {
   {
     std::lock_guard<decltype(queue_mutex_)> lock(queue_mutex_);
     should_exit_ = true;
   }
   worker_cv_.notify_all();
-  worker_.join();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
 }
 
-CalciteMgr* CalciteMgr::get(const std::string& udf_filename, size_t calcite_max_mem_mb) {
+CalciteMgr* CalciteMgr::get(const std::string& udf_filename,
+                            size_t calcite_max_mem_mb,
+                            size_t num_workers,
+                            size_t cache_size) {
   std::call_once(instance_init_flag_, [=] {
-    instance_ =
-        std::unique_ptr<CalciteMgr>(new CalciteMgr(udf_filename, calcite_max_mem_mb));
+    instance_ = std::unique_ptr<CalciteMgr>(
+        new CalciteMgr(udf_filename, calcite_max_mem_mb, num_workers, cache_size));
   });
   return instance_.get();
 }
@@ -589,10 +648,35 @@ std::string CalciteMgr::process(
     const bool legacy_syntax,
     const bool is_explain,
     const bool is_view_optimize) {
+  auto schema_json = std::make_shared<const std::string>(schema_to_json(schema_provider));
+
+  // Filter push down info is not a part of the cache key.
+  bool use_cache = cache_size_ && filter_push_down_info.empty();
+  std::string cache_key;
+  uint64_t cache_generation = 0;
+  if (use_cache) {
+    cache_key = db_name;
+    cache_key += '\0';
+    cache_key += legacy_syntax ? '1' : '0';
+    cache_key += is_explain ? '1' : '0';
+    cache_key += is_view_optimize ? '1' : '0';
+    cache_key += config->exec.watchdog.enable ? '1' : '0';
+    cache_key += normalize_sql(sql_string);
+
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    auto entry = cache_.get(cache_key);
+    if (entry && *entry->schema_json == *schema_json) {
+      ++cache_hits_;
+      return entry->query_ra;
+    }
+    ++cache_misses_;
+    cache_generation = cache_generation_;
+  }
+
   auto task = Task([&db_name,
                     &sql_string,
                     &filter_push_down_info,
-                    schema_provider,
+                    &schema_json,
                     config,
                     legacy_syntax,
                     is_explain,
@@ -600,7 +684,7 @@ std::string CalciteMgr::process(
     CHECK(calcite_jni);
     return calcite_jni->process(db_name,
                                 sql_string,
-                                schema_provider,
+                                *schema_json,
                                 config,
                                 filter_push_down_info,
                                 legacy_syntax,
@@ -611,7 +695,22 @@ std::string CalciteMgr::process(
   submitTaskToQueue(std::move(task));
 
   result.wait();
-  return result.get();
+  auto query_ra = result.get();
+
+  if (use_cache) {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    // Entries built with previously registered extension functions are not stored.
+    if (cache_generation == cache_generation_) {
+      if (last_schema_json_ && *last_schema_json_ == *schema_json) {
+        schema_json = last_schema_json_;
+      } else {
+        last_schema_json_ = schema_json;
+      }
+      cache_.put(cache_key, CacheEntry{schema_json, query_ra});
+    }
+  }
+
+  return query_ra;
 }
 
 std::string CalciteMgr::getExtensionFunctionWhitelist() {
@@ -655,42 +754,68 @@ std::string CalciteMgr::getRuntimeExtensionFunctionWhitelist() {
 
 void CalciteMgr::setRuntimeExtensionFunctions(const std::vector<ExtensionFunction>& udfs,
                                               bool is_runtime) {
-  auto task = Task([&udfs, is_runtime](CalciteJNI* calcite_jni) {
+  // Each worker has its own handler, so functions are registered in all of them.
+  submitTaskToAllWorkers([&udfs, is_runtime](CalciteJNI* calcite_jni) {
     CHECK(calcite_jni);
     calcite_jni->setRuntimeExtensionFunctions(udfs, is_runtime);
     return "";  // all tasks return strings
   });
 
-  auto result = task.get_future();
-  submitTaskToQueue(std::move(task));
+  // Cached results might refer to replaced functions.
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  cache_.clear();
+  last_schema_json_.reset();
+  ++cache_generation_;
+}
 
-  result.wait();
+size_t CalciteMgr::getCacheHitCount() {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  return cache_hits_;
 }
 
-CalciteMgr::CalciteMgr(const std::string& udf_filename, size_t calcite_max_mem_mb) {
+size_t CalciteMgr::getCacheMissCount() {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  return cache_misses_;
+}
+
+CalciteMgr::CalciteMgr(const std::string& udf_filename,
+                       size_t calcite_max_mem_mb,
+                       size_t num_workers,
+                       size_t cache_size)
+    : worker_queues_(std::max(num_workers, size_t(1)))
+    , cache_(cache_size)
+    , cache_size_(cache_size) {
   // todo: should register an exit handler for ctrl + c
-  worker_ = std::thread(&CalciteMgr::worker, this, udf_filename, calcite_max_mem_mb);
+  for (size_t worker_idx = 0; worker_idx < worker_queues_.size(); ++worker_idx) {
+    workers_.emplace_back(
+        &CalciteMgr::worker, this, worker_idx, udf_filename, calcite_max_mem_mb);
+  }
 }
 
-void CalciteMgr::worker(const std::string& udf_filename, size_t calcite_max_mem_mb) {
+void CalciteMgr::worker(size_t worker_idx,
+                        const std::string& udf_filename,
+                        size_t calcite_max_mem_mb) {
   auto calcite_jni = std::make_unique<CalciteJNI>(udf_filename, calcite_max_mem_mb);
 
+  auto& worker_queue = worker_queues_[worker_idx];
   std::unique_lock<std::mutex> lock(queue_mutex_);
   while (true) {
-    worker_cv_.wait(lock, [this] { return !queue_.empty() || should_exit_; });
+    worker_cv_.wait(lock, [this, &worker_queue] {
+      return !worker_queue.empty() || !queue_.empty() || should_exit_;
+    });
     if (should_exit_) {
       return;
     }
 
-    if (!queue_.empty()) {
-      auto task = std::move(queue_.front());
-      queue_.pop();
+    // Tasks addressed to the worker change its state and go first.
+    auto& tasks = worker_queue.empty() ? queue_ : worker_queue;
+    auto task = std::move(tasks.front());
+    tasks.pop();
 
-      lock.unlock();
-      task(calcite_jni.get());
+    lock.unlock();
+    task(calcite_jni.get());
 
-      lock.lock();
-    }
+    lock.lock();
   }
 }
 
@@ -700,7 +825,30 @@ void CalciteMgr::submitTaskToQueue(Task&& task) {
   queue_.push(std::move(task));
 
   lock.unlock();
+  worker_cv_.notify_one();
+}
+
+void CalciteMgr::submitTaskToAllWorkers(
+    const std::function<std::string(CalciteJNI*)>& fn) {
+  std::vector<std::future<std::string>> results;
+  {
+    std::lock_guard<decltype(queue_mutex_)> lock(queue_mutex_);
+    for (auto& worker_queue : worker_queues_) {
+      Task task(fn);
+      results.push_back(task.get_future());
+      worker_queue.push(std::move(task));
+    }
+  }
   worker_cv_.notify_all();
+
+  // Tasks reference the caller's data, so all of them should finish before an error
+  // is reported.
+  for (auto& result : results) {
+    result.wait();
+  }
+  for (auto& result : results) {
+    result.get();
+  }
 }
 
 std::once_flag CalciteMgr::instance_init_flag_;
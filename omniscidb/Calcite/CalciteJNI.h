@@ -16,12 +16,14 @@
 
 #pragma once
 
+#include <functional>
 #include <future>
 #include <queue>
 
 #include "QueryEngine/ExtensionFunctionsWhitelist.h"
 #include "SchemaMgr/SchemaProvider.h"
 #include "Shared/Config.h"
+#include "StringDictionary/LruCache.hpp"
 
 struct FilterPushDownInfo {
   int input_prev;
@@ -32,7 +34,9 @@ struct FilterPushDownInfo {
 class CalciteJNI;
 
 /**
- * Run CalciteJNI on a single thread.
+ * Run CalciteJNI on a pool of worker threads attached to the same JVM. Each worker
+ * owns its own CalciteServerHandler, so queries are parsed concurrently. Results of
+ * process() are cached by normalized SQL, options and the schema they were built for.
  */
 class CalciteMgr {
  public:
@@ -42,8 +46,11 @@ class CalciteMgr {
 
   ~CalciteMgr();
 
+  // Worker count and cache size are only used when the instance is created.
   static CalciteMgr* get(const std::string& udf_filename = "",
-                         size_t calcite_max_mem_mb = 1024);
+                         size_t calcite_max_mem_mb = 1024,
+                         size_t num_workers = 1,
+                         size_t cache_size = 0);
 
   std::string process(const std::string& db_name,
                       const std::string& sql_string,
@@ -60,18 +67,47 @@ class CalciteMgr {
   void setRuntimeExtensionFunctions(const std::vector<ExtensionFunction>& udfs,
                                     bool is_runtime = true);
 
+  // Numbers of process() calls answered from the cache and parsed by Calcite while
+  // the cache is enabled.
+  size_t getCacheHitCount();
+  size_t getCacheMissCount();
+
  private:
-  explicit CalciteMgr(const std::string& udf_filename, size_t calcite_max_mem_mb);
+  struct CacheEntry {
+    std::shared_ptr<const std::string> schema_json;
+    std::string query_ra;
+  };
+
+  explicit CalciteMgr(const std::string& udf_filename,
+                      size_t calcite_max_mem_mb,
+                      size_t num_workers,
+                      size_t cache_size);
 
-  void worker(const std::string& udf_filename, size_t calcite_max_mem_mb);
+  void worker(size_t worker_idx,
+              const std::string& udf_filename,
+              size_t calcite_max_mem_mb);
 
   void submitTaskToQueue(Task&& task);
+  // Run the task on each worker and wait for completion.
+  void submitTaskToAllWorkers(const std::function<std::string(CalciteJNI*)>& fn);
 
   std::mutex queue_mutex_;
   std::condition_variable worker_cv_;
-  std::thread worker_;
+  std::vector<std::thread> workers_;
 
+  // Tasks for any worker and tasks for specific workers.
   std::queue<Task> queue_;
+  std::vector<std::queue<Task>> worker_queues_;
+
+  std::mutex cache_mutex_;
+  LruCache<std::string, CacheEntry> cache_;
+  size_t cache_size_;
+  // Schema JSON of the last cached query, shared by entries built for the same schema.
+  std::shared_ptr<const std::string> last_schema_json_;
+  // Incremented when the cache is invalidated.
+  uint64_t cache_generation_{0};
+  size_t cache_hits_{0};
+  size_t cache_misses_{0};
 
   bool should_exit_{false};
   static std::once_flag instance_init_flag_;
@@ -88,6 +88,13 @@ bool ConfigBuilder::parseCommandLineArgs(int argc,
                          po::value<size_t>(&config_->exec.sub_tasks.sub_task_size)
                              ->default_value(config_->exec.sub_tasks.sub_task_size),
                          "Set CPU sub-task size in rows.");
+  opt_desc.add_options()(
+      "cpu-sub-task-target-time",
+      po::value<size_t>(&config_->exec.sub_tasks.sub_task_target_time_us)
+          ->default_value(config_->exec.sub_tasks.sub_task_target_time_us),
+      "Target CPU sub-task run time in microseconds. When set, the sub-task size adapts "
+      "to the measured per-row processing cost, starting from cpu-sub-task-size. Zero "
+      "means a fixed sub-task size.");
 
   // exec.join
   opt_desc.add_options()("enable-loop-join",
@@ -307,6 +314,65 @@ bool ConfigBuilder::parseCommandLineArgs(int argc,
           ->implicit_value(true),
       "Enable the filter function protection feature for the SQL JIT compiler. "
       "Normally should be on but techs might want to disable for troubleshooting.");
+  opt_desc.add_options()(
+      "enable-tiered-compilation",
+      po::value<bool>(&config_->exec.codegen.enable_tiered_compilation)
+          ->default_value(config_->exec.codegen.enable_tiered_compilation)
+          ->implicit_value(true),
+      "Compile CPU kernels with minimal optimization first and recompile hot kernels "
+      "with full optimization in background.");
+  opt_desc.add_options()("tier-up-run-count",
+                         po::value<size_t>(&config_->exec.codegen.tier_up_run_count)
+                             ->default_value(config_->exec.codegen.tier_up_run_count),
+                         "Number of kernel runs triggering recompilation with full "
+                         "optimization when tiered compilation is enabled.");
+  opt_desc.add_options()(
+      "tier-up-run-time-ms",
+      po::value<size_t>(&config_->exec.codegen.tier_up_run_time_ms)
+          ->default_value(config_->exec.codegen.tier_up_run_time_ms),
+      "Kernel run time (in ms) triggering recompilation with full optimization when "
+      "tiered compilation is enabled.");
+  opt_desc.add_options()(
+      "enable-vectorized-interpreter",
+      po::value<bool>(&config_->exec.codegen.enable_vectorized_interpreter)
+          ->default_value(config_->exec.codegen.enable_vectorized_interpreter)
+          ->implicit_value(true),
+      "Execute simple scans and aggregates over small inputs with a precompiled "
+      "vectorized kernel instead of generating code.");
+  opt_desc.add_options()(
+      "vectorized-interpreter-max-rows",
+      po::value<size_t>(&config_->exec.codegen.vectorized_interpreter_max_rows)
+          ->default_value(config_->exec.codegen.vectorized_interpreter_max_rows),
+      "Max number of input rows for queries executed with the vectorized kernel.");
+  opt_desc.add_options()(
+      "parallel-compilation-threads",
+      po::value<size_t>(&config_->exec.codegen.parallel_compilation_threads)
+          ->default_value(config_->exec.codegen.parallel_compilation_threads),
+      "Number of threads used to compile independent query steps in background while "
+      "preceding steps execute. Zero disables parallel compilation.");
+  opt_desc.add_options()(
+      "enable-batch-codegen",
+      po::value<bool>(&config_->exec.codegen.enable_batch_codegen)
+          ->default_value(config_->exec.codegen.enable_batch_codegen)
+          ->implicit_value(true),
+      "Generate CPU kernels evaluating filters for blocks of rows into selection "
+      "vectors before processing the selected rows.");
+  opt_desc.add_options()("batch-codegen-size",
+                         po::value<size_t>(&config_->exec.codegen.batch_codegen_size)
+                             ->default_value(config_->exec.codegen.batch_codegen_size),
+                         "Number of rows in a block processed by batch kernels.");
+  opt_desc.add_options()(
+      "enable-fragment-specialization",
+      po::value<bool>(&config_->exec.codegen.enable_fragment_specialization)
+          ->default_value(config_->exec.codegen.enable_fragment_specialization)
+          ->implicit_value(true),
+      "Compile CPU kernels with filters specialized for fragments using their "
+      "metadata, e.g. with removed null checks and filters true for all rows.");
+  opt_desc.add_options()(
+      "fragment-specialization-max-variants",
+      po::value<size_t>(&config_->exec.codegen.fragment_specialization_max_variants)
+          ->default_value(config_->exec.codegen.fragment_specialization_max_variants),
+      "Maximum number of specialized kernels compiled for a query step.");
 
   // exec
   opt_desc.add_options()("streaming-top-n-max",
@@ -343,6 +409,13 @@ bool ConfigBuilder::parseCommandLineArgs(int argc,
           ->implicit_value(true),
       "Enable multi-fragment intermediate results to improve execution parallelism for "
       "queries with multiple execution steps");
+  opt_desc.add_options()(
+      "fuse-shared-projections",
+      po::value<bool>(&config_->exec.fuse_shared_projections)
+          ->default_value(config_->exec.fuse_shared_projections)
+          ->implicit_value(true),
+      "Compute filters and projections of a single table used by several query steps "
+      "within each of these steps instead of materializing them as a separate step.");
   opt_desc.add_options()("gpu-block-size",
                          po::value<size_t>(&config_->exec.override_gpu_block_size)
                              ->default_value(config_->exec.override_gpu_block_size),
@@ -366,6 +439,39 @@ bool ConfigBuilder::parseCommandLineArgs(int argc,
       "use-cost-model",
       po::value<bool>(&config_->exec.enable_cost_model)->default_value(false),
       "Use Cost Model for query execution when it is possible.");
+  opt_desc.add_options()(
+      "calcite-workers",
+      po::value<size_t>(&config_->exec.calcite_workers)
+          ->default_value(config_->exec.calcite_workers),
+      "Number of threads parsing SQL queries concurrently with Calcite. Workers share "
+      "the JVM. Used when Calcite is initialized for the first time in the process.");
+  opt_desc.add_options()(
+      "enable-concurrent-queries",
+      po::value<bool>(&config_->exec.enable_concurrent_queries)
+          ->default_value(config_->exec.enable_concurrent_queries)
+          ->implicit_value(true),
+      "Run queries submitted to the same executor concurrently on executors sharing "
+      "its caches, with CPU threads shared fairly among running queries. Otherwise, "
+      "queries on the same executor run one at a time.");
+  opt_desc.add_options()(
+      "parallel-steps",
+      po::value<size_t>(&config_->exec.parallel_steps)
+          ->default_value(config_->exec.parallel_steps),
+      "Maximum number of independent query steps, e.g. UNION ALL inputs or "
+      "materialized join inputs, executed concurrently on CPU. Concurrent steps "
+      "share CPU threads. Steps are executed one at a time if 0 or 1.");
+  opt_desc.add_options()(
+      "max-threads-per-query",
+      po::value<size_t>(&config_->exec.max_threads_per_query)
+          ->default_value(config_->exec.max_threads_per_query),
+      "Default maximum number of CPU threads running kernels of a single query. "
+      "0 means no limit.");
+  opt_desc.add_options()(
+      "max-query-memory",
+      po::value<size_t>(&config_->exec.max_query_memory)
+          ->default_value(config_->exec.max_query_memory),
+      "Maximum number of bytes of result buffers, input chunks, linearized columns and "
+      "hash tables acquired by a single query. 0 means no limit.");
 
   // opts.filter_pushdown
   opt_desc.add_options()("enable-filter-push-down",
@@ -410,6 +516,13 @@ bool ConfigBuilder::parseCommandLineArgs(int argc,
           ->default_value(config_->opts.enable_left_join_filter_hoisting)
           ->implicit_value(true),
       "Enable hoisting left hand side filters through left joins.");
+  opt_desc.add_options()(
+      "enable-metadata-aggregates",
+      po::value<bool>(&config_->opts.enable_metadata_aggregates)
+          ->default_value(config_->opts.enable_metadata_aggregates)
+          ->implicit_value(true),
+      "Compute non-grouped COUNT, MIN and MAX aggregates using fragment metadata and "
+      "scan only fragments partially covered by the filter.");
 
   // rs
   opt_desc.add_options()("enable-columnar-output",
@@ -551,6 +664,44 @@ bool ConfigBuilder::parseCommandLineArgs(int argc,
                          po::value<size_t>(&config_->cache.code_cache_size)
                              ->default_value(config_->cache.code_cache_size),
                          "Maximum number of entries in a code cache");
+  opt_desc.add_options()(
+      "code-cache-dir",
+      po::value<std::string>(&config_->cache.code_cache_dir)
+          ->default_value(config_->cache.code_cache_dir),
+      "Directory to store compiled CPU kernels in. Stored kernels are reused across "
+      "process restarts. Empty value disables the persistent code cache.");
+  opt_desc.add_options()(
+      "enable-plan-code-cache",
+      po::value<bool>(&config_->cache.enable_plan_code_cache)
+          ->default_value(config_->cache.enable_plan_code_cache)
+          ->implicit_value(true),
+      "Cache compiled CPU kernels by execution unit and memory layout to skip IR "
+      "generation for repeated queries.");
+  opt_desc.add_options()(
+      "dict-translation-cache-bytes",
+      po::value<size_t>(&config_->cache.dict_translation_cache_bytes)
+          ->default_value(config_->cache.dict_translation_cache_bytes),
+      "Memory budget of cached translation maps of each string dictionary, in bytes. "
+      "Cached maps are reused across queries and extended as dictionaries grow. 0 "
+      "disables the cache.");
+  opt_desc.add_options()(
+      "dict-pattern-cache-bytes",
+      po::value<size_t>(&config_->cache.dict_pattern_cache_bytes)
+          ->default_value(config_->cache.dict_pattern_cache_bytes),
+      "Memory budget of LIKE and REGEXP result caches of each string dictionary, in "
+      "bytes.");
+  opt_desc.add_options()(
+      "calcite-cache-size",
+      po::value<size_t>(&config_->cache.calcite_cache_size)
+          ->default_value(config_->cache.calcite_cache_size),
+      "Maximum number of relational algebra entries cached for parsed SQL queries. 0 "
+      "disables the cache.");
+  opt_desc.add_options()(
+      "rel-alg-dag-cache-size",
+      po::value<size_t>(&config_->cache.rel_alg_dag_cache_size)
+          ->default_value(config_->cache.rel_alg_dag_cache_size),
+      "Maximum number of optimized relational algebra DAGs cached for reuse by "
+      "repeated queries. 0 disables the cache.");
 
   // debug
   opt_desc.add_options()("build-rel-alg-cache",
@@ -569,6 +720,14 @@ bool ConfigBuilder::parseCommandLineArgs(int argc,
                              ->implicit_value(true),
                          "Enable automatic IR metadata (debug builds only).");
 
+  // storage
+  opt_desc.add_options()("enable-dict-compression",
+                         po::value<bool>(&config_->storage.enable_dict_compression)
+                             ->default_value(config_->storage.enable_dict_compression)
+                             ->implicit_value(true),
+                         "Store string dictionary payload compressed with a symbol "
+                         "table trained on dictionary contents.");
+
   if (allow_gtest_flags) {
     opt_desc.add_options()("gtest_list_tests", "list all test");
     opt_desc.add_options()("gtest_filter", "filters tests, use --help for details");
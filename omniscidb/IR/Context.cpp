@@ -11,6 +11,7 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/functional/hash.hpp>
 
+#include <mutex>
 #include <regex>
 #include <unordered_map>
 
@@ -23,6 +24,7 @@ class ContextImpl {
   const NullType* null() { return null_type_.get(); }
 
   const BooleanType* boolean(bool nullable) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     auto& res = boolean_types_[nullable];
     if (!res) {
       res.reset(new BooleanType(ctx_, nullable));
@@ -31,6 +33,7 @@ class ContextImpl {
   }
 
   const IntegerType* integer(int size, bool nullable) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     auto& res = integer_types_[std::make_pair(size, nullable)];
     if (!res) {
       if (size != 1 && size != 2 && size != 4 && size != 8) {
@@ -43,6 +46,7 @@ class ContextImpl {
   }
 
   const FloatingPointType* fp(FloatingPointType::Precision precision, bool nullable) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     auto& res = floating_point_types_[std::make_pair(precision, nullable)];
     if (!res) {
       res.reset(new FloatingPointType(ctx_, precision, nullable));
@@ -51,6 +55,7 @@ class ContextImpl {
   }
 
   const DecimalType* decimal(int size, int precision, int scale, bool nullable) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     auto& res = decimal_types_[std::make_tuple(size, precision, scale, nullable)];
     if (!res) {
       if (size != 8) {
@@ -68,6 +73,7 @@ class ContextImpl {
   }
 
   const VarCharType* varChar(int max_length, bool nullable) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     auto& res = varchar_types_[std::make_pair(max_length, nullable)];
     if (!res) {
       if (max_length < 0) {
@@ -80,6 +86,7 @@ class ContextImpl {
   }
 
   const TextType* text(bool nullable) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     auto& res = text_types_[nullable];
     if (!res) {
       res.reset(new TextType(ctx_, nullable));
@@ -88,6 +95,7 @@ class ContextImpl {
   }
 
   const DateType* date(int size, TimeUnit unit, bool nullable) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     auto& res = date_types_[std::make_tuple(size, unit, nullable)];
     if (!res) {
       if (size != 2 && size != 4 && size != 8) {
@@ -110,6 +118,7 @@ class ContextImpl {
   }
 
   const TimeType* time(int size, TimeUnit unit, bool nullable) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     auto& res = time_types_[std::make_tuple(size, unit, nullable)];
     if (!res) {
       if (size != 2 && size != 4 && size != 8) {
@@ -132,6 +141,7 @@ class ContextImpl {
   }
 
   const TimestampType* timestamp(TimeUnit unit, bool nullable) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     auto& res = timestamp_types_[std::make_pair(unit, nullable)];
     if (!res) {
       if (unit == TimeUnit::kMonth || unit == TimeUnit::kDay) {
@@ -143,6 +153,7 @@ class ContextImpl {
   }
 
   const IntervalType* interval(int size, TimeUnit unit, bool nullable) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     auto& res = interval_types_[std::make_tuple(size, unit, nullable)];
     if (!res) {
       res.reset(new IntervalType(ctx_, size, unit, nullable));
@@ -153,6 +164,7 @@ class ContextImpl {
   const FixedLenArrayType* arrayFixed(int num_elems,
                                       const Type* elem_type,
                                       bool nullable) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     auto& res = fixed_array_types_[std::make_tuple(num_elems, elem_type, nullable)];
     if (!res) {
       if (&ctx_ != &elem_type->ctx()) {
@@ -177,6 +189,7 @@ class ContextImpl {
   const VarLenArrayType* arrayVarLen(const Type* elem_type,
                                      int offs_size,
                                      bool nullable) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     auto& res = varlen_array_types_[std::make_tuple(offs_size, elem_type, nullable)];
     if (!res) {
       if (&ctx_ != &elem_type->ctx()) {
@@ -199,6 +212,7 @@ class ContextImpl {
   }
 
   const ExtDictionaryType* extDict(const Type* elem_type, int dict_id, int index_size) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     auto& res = ext_dict_types_[std::make_tuple(elem_type, dict_id, index_size)];
     if (!res) {
       if (&ctx_ != &elem_type->ctx()) {
@@ -219,6 +233,7 @@ class ContextImpl {
   }
 
   const ColumnType* column(const Type* column_type, bool nullable) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     auto& res = column_types_[std::make_pair(column_type, nullable)];
     if (!res) {
       if (&ctx_ != &column_type->ctx()) {
@@ -231,6 +246,7 @@ class ContextImpl {
   }
 
   const ColumnListType* columnList(const Type* column_type, int length, bool nullable) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     auto& res = column_list_types_[std::make_tuple(column_type, length, nullable)];
     if (!res) {
       if (&ctx_ != &column_type->ctx()) {
@@ -447,6 +463,9 @@ class ContextImpl {
 
  private:
   Context& ctx_;
+  // Types are created lazily and the default context is shared by concurrently
+  // executed queries.
+  std::recursive_mutex mutex_;
   std::unique_ptr<const NullType> null_type_;
   std::unordered_map<bool, std::unique_ptr<const BooleanType>> boolean_types_;
   std::unordered_map<std::pair<int, bool>,
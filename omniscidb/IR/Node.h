@@ -878,9 +878,14 @@ class QueryDag {
 
   ConfigPtr config() const { return config_; }
 
+  // Set by canonizeQuery. Cached DAGs are executed many times but canonized once.
+  bool isCanonized() const { return canonized_; }
+  void setCanonized() { canonized_ = true; }
+
  protected:
   ConfigPtr config_;
   time_t now_;
+  bool canonized_ = false;
   // Root node of the query.
   NodePtr root_;
   // All nodes including the root one.
@@ -36,6 +36,7 @@ CgenState::CgenState(const size_t num_query_infos,
     , filter_func_bb_(nullptr)
     , row_func_call_(nullptr)
     , filter_func_call_(nullptr)
+    , filter_br_(nullptr)
     , context_(context)
     , ir_builder_(context_)
     , ext_module_context_(ext_module_context)
@@ -49,6 +50,7 @@ CgenState::CgenState(const size_t num_query_infos,
 CgenState::CgenState(const Config& config, llvm::LLVMContext& context)
     : module_(nullptr)
     , row_func_(nullptr)
+    , filter_br_(nullptr)
     , context_(context)
     , ir_builder_(context_)
     , ext_module_context_(nullptr)
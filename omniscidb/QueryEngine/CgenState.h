@@ -50,36 +50,54 @@ struct CgenState {
                          const bool use_dict_encoding,
                          const int dict_id,
                          const int device_id) {
+    const auto lit_off =
+        getOrAddLiteral(getLiteralValue(constant, use_dict_encoding, dict_id), device_id);
+    hoisted_constants_[device_id].emplace_back(constant, lit_off);
+    return lit_off;
+  }
+
+  using LiteralValue = boost::variant<int8_t,
+                                      int16_t,
+                                      int32_t,
+                                      int64_t,
+                                      float,
+                                      double,
+                                      std::pair<std::string, int>,
+                                      std::string,
+                                      std::vector<double>,
+                                      std::vector<int32_t>,
+                                      std::vector<int8_t>,
+                                      std::pair<std::vector<int8_t>, int>>;
+  using LiteralValues = std::vector<LiteralValue>;
+
+  static LiteralValue getLiteralValue(const hdk::ir::Constant* constant,
+                                      const bool use_dict_encoding,
+                                      const int dict_id) {
     auto type = constant->type();
     switch (type->id()) {
       case hdk::ir::Type::kBoolean:
-        return getOrAddLiteral(constant->isNull()
-                                   ? int8_t(inline_int_null_value(type))
-                                   : int8_t(constant->value().boolval ? 1 : 0),
-                               device_id);
+        return LiteralValue(constant->isNull()
+                                ? int8_t(inline_int_null_value(type))
+                                : int8_t(constant->value().boolval ? 1 : 0));
       case hdk::ir::Type::kInteger:
       case hdk::ir::Type::kDecimal:
         switch (type->size()) {
           case 1:
-            return getOrAddLiteral(constant->isNull()
-                                       ? int8_t(inline_int_null_value(type))
-                                       : constant->value().tinyintval,
-                                   device_id);
+            return LiteralValue(constant->isNull()
+                                    ? int8_t(inline_int_null_value(type))
+                                    : constant->value().tinyintval);
           case 2:
-            return getOrAddLiteral(constant->isNull()
-                                       ? int16_t(inline_int_null_value(type))
-                                       : constant->value().smallintval,
-                                   device_id);
+            return LiteralValue(constant->isNull()
+                                    ? int16_t(inline_int_null_value(type))
+                                    : constant->value().smallintval);
           case 4:
-            return getOrAddLiteral(constant->isNull()
-                                       ? int32_t(inline_int_null_value(type))
-                                       : constant->value().intval,
-                                   device_id);
+            return LiteralValue(constant->isNull()
+                                    ? int32_t(inline_int_null_value(type))
+                                    : constant->value().intval);
           case 8:
-            return getOrAddLiteral(constant->isNull()
-                                       ? int64_t(inline_int_null_value(type))
-                                       : constant->value().bigintval,
-                                   device_id);
+            return LiteralValue(constant->isNull()
+                                    ? int64_t(inline_int_null_value(type))
+                                    : constant->value().bigintval);
           default:
             abort();
         }
@@ -87,13 +105,11 @@ struct CgenState {
       case hdk::ir::Type::kFloatingPoint:
         switch (type->as<hdk::ir::FloatingPointType>()->precision()) {
           case hdk::ir::FloatingPointType::kFloat:
-            return getOrAddLiteral(constant->isNull() ? float(inline_fp_null_value(type))
-                                                      : constant->value().floatval,
-                                   device_id);
+            return LiteralValue(constant->isNull() ? float(inline_fp_null_value(type))
+                                                   : constant->value().floatval);
           case hdk::ir::FloatingPointType::kDouble:
-            return getOrAddLiteral(constant->isNull() ? inline_fp_null_value(type)
-                                                      : constant->value().doubleval,
-                                   device_id);
+            return LiteralValue(constant->isNull() ? inline_fp_null_value(type)
+                                                   : constant->value().doubleval);
           default:
             abort();
         }
@@ -103,10 +119,9 @@ struct CgenState {
       case hdk::ir::Type::kVarChar:
         if (use_dict_encoding) {
           if (constant->isNull()) {
-            return getOrAddLiteral((int32_t)inline_int_null_value<int32_t>(), device_id);
+            return LiteralValue((int32_t)inline_int_null_value<int32_t>());
           }
-          return getOrAddLiteral(std::make_pair(*constant->value().stringval, dict_id),
-                                 device_id);
+          return LiteralValue(std::make_pair(*constant->value().stringval, dict_id));
         }
         if (constant->isNull()) {
           throw std::runtime_error(
@@ -114,13 +129,13 @@ struct CgenState {
                                                                              // support
                                                                              // null
         }
-        return getOrAddLiteral(*constant->value().stringval, device_id);
+        return LiteralValue(*constant->value().stringval);
       case hdk::ir::Type::kTime:
       case hdk::ir::Type::kTimestamp:
       case hdk::ir::Type::kDate:
       case hdk::ir::Type::kInterval:
         // TODO(alex): support null
-        return getOrAddLiteral(constant->value().bigintval, device_id);
+        return LiteralValue(constant->value().bigintval);
       case hdk::ir::Type::kFixedLenArray:
       case hdk::ir::Type::kVarLenArray: {
         if (!use_dict_encoding) {
@@ -133,7 +148,7 @@ struct CgenState {
               double d = c->value().doubleval;
               double_array_literal.push_back(d);
             }
-            return getOrAddLiteral(double_array_literal, device_id);
+            return LiteralValue(double_array_literal);
           }
           if (elem_type->isInt32()) {
             std::vector<int32_t> int32_array_literal;
@@ -143,7 +158,7 @@ struct CgenState {
               int32_t i = c->value().intval;
               int32_array_literal.push_back(i);
             }
-            return getOrAddLiteral(int32_array_literal, device_id);
+            return LiteralValue(int32_array_literal);
           }
           if (elem_type->isInt8()) {
             std::vector<int8_t> int8_array_literal;
@@ -153,7 +168,7 @@ struct CgenState {
               int8_t i = c->value().tinyintval;
               int8_array_literal.push_back(i);
             }
-            return getOrAddLiteral(int8_array_literal, device_id);
+            return LiteralValue(int8_array_literal);
           }
           throw std::runtime_error("Unsupported literal array");
         }
@@ -164,22 +179,26 @@ struct CgenState {
     }
   }
 
-  using LiteralValue = boost::variant<int8_t,
-                                      int16_t,
-                                      int32_t,
-                                      int64_t,
-                                      float,
-                                      double,
-                                      std::pair<std::string, int>,
-                                      std::string,
-                                      std::vector<double>,
-                                      std::vector<int32_t>,
-                                      std::vector<int8_t>,
-                                      std::pair<std::vector<int8_t>, int>>;
-  using LiteralValues = std::vector<LiteralValue>;
-
   const std::unordered_map<int, LiteralValues>& getLiterals() const { return literals_; }
 
+  // Constants which were codegened as loads from the literal buffer, along with offsets
+  // of their values in the buffer.
+  const std::vector<std::pair<const hdk::ir::Constant*, size_t>>& getHoistedConstants(
+      const int device_id) {
+    return hoisted_constants_[device_id];
+  }
+
+  static std::vector<size_t> getLiteralOffsets(const LiteralValues& literals) {
+    std::vector<size_t> res;
+    size_t lit_off{0};
+    for (const auto& literal : literals) {
+      const auto lit_bytes = literalBytes(literal);
+      lit_off = addAligned(lit_off, lit_bytes);
+      res.push_back(lit_off - lit_bytes);
+    }
+    return res;
+  }
+
   llvm::Value* addStringConstant(const std::string& str, const CompilationOptions& co) {
     llvm::Value* str_lv = ir_builder_.CreateGlobalString(
         str, "str_const_" + std::to_string(std::hash<std::string>()(str)));
@@ -361,6 +380,9 @@ struct CgenState {
   llvm::BasicBlock* filter_func_bb_;
   llvm::CallInst* row_func_call_;
   llvm::CallInst* filter_func_call_;
+  // Branch on the final filter value of the row, used to derive the row filter
+  // function of batched kernels.
+  llvm::BranchInst* filter_br_;
   std::vector<llvm::Function*> helper_functions_;
   llvm::LLVMContext& context_;    // LLVMContext instance is held by an Executor instance.
   llvm::ValueToValueMapTy vmap_;  // used for cloning the runtime module
@@ -461,6 +483,8 @@ struct CgenState {
 
   std::unordered_map<int, LiteralValues> literals_;
   std::unordered_map<int, size_t> literal_bytes_;
+  std::unordered_map<int, std::vector<std::pair<const hdk::ir::Constant*, size_t>>>
+      hoisted_constants_;
 };
 
 #include "AutomaticIRMetadataGuard.h"
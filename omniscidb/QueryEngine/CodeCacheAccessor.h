@@ -66,6 +66,16 @@ class CodeCacheAccessor {
     }
   }
 
+  // Replaces the cached value of the key, if any.
+  void replace(const CodeCacheKey& key, CodeCacheVal<CompilationContext>& value) {
+    std::lock_guard<std::mutex> lock(code_cache_mutex_);
+    put_count_++;
+    if (code_cache_.find(key) != code_cache_.cend()) {
+      overwrite_count_++;
+    }
+    code_cache_.put(key, value);
+  }
+
   // get_or_wait and put should be used in pair.
   CodeCacheVal<CompilationContext>* get_or_wait(const CodeCacheKey& key) {
     std::unique_lock<std::mutex> lk(code_cache_mutex_);
@@ -115,6 +125,17 @@ class CodeCacheAccessor {
     code_cache_.evictFractionEntries(fraction);
   }
 
+  // Cumulative numbers of lookups finding the code and of code insertions.
+  int64_t getFoundCount() {
+    std::lock_guard<std::mutex> lock(code_cache_mutex_);
+    return found_count_;
+  }
+
+  int64_t getPutCount() {
+    std::lock_guard<std::mutex> lock(code_cache_mutex_);
+    return put_count_;
+  }
+
   friend std::ostream& operator<<(std::ostream& os, CodeCacheAccessor& c) {
     std::lock_guard<std::mutex> lock(c.code_cache_mutex_);
     os << "CodeCacheAccessor<" << c.name_ << ">[current size=" << c.code_cache_.size()
@@ -46,8 +46,43 @@ ColumnFetcher::ColumnFetcher(Executor* executor,
                              const ColumnCacheMap& column_cache)
     : executor_(executor)
     , data_provider_(data_provider)
+    , memory_tracker_(executor ? executor->getQueryMemoryTracker() : nullptr)
     , columnarized_table_cache_(column_cache) {}
 
+ColumnFetcher::~ColumnFetcher() {
+  if (memory_tracker_) {
+    memory_tracker_->release(hdk::QueryMemoryCategory::kInputChunks,
+                             tracked_chunk_bytes_);
+    memory_tracker_->release(hdk::QueryMemoryCategory::kLinearizedColumns,
+                             tracked_linearized_bytes_);
+  }
+}
+
+void ColumnFetcher::trackChunk(const Chunk_NS::Chunk& chunk) const {
+  if (!memory_tracker_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(memory_tracker_mutex_);
+  if (!tracked_chunks_.insert(chunk.getBuffer()).second) {
+    return;
+  }
+  size_t bytes = chunk.getBuffer()->size();
+  if (chunk.getIndexBuf()) {
+    bytes += chunk.getIndexBuf()->size();
+  }
+  memory_tracker_->allocate(hdk::QueryMemoryCategory::kInputChunks, bytes);
+  tracked_chunk_bytes_ += bytes;
+}
+
+void ColumnFetcher::trackLinearizedBuffer(size_t bytes) const {
+  if (!memory_tracker_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(memory_tracker_mutex_);
+  memory_tracker_->allocate(hdk::QueryMemoryCategory::kLinearizedColumns, bytes);
+  tracked_linearized_bytes_ += bytes;
+}
+
 //! Gets a column fragment chunk on CPU or on GPU depending on the effective
 //! memory level parameter. For temporary tables, the chunk will be copied to
 //! the GPU if needed. Returns a buffer pointer and an element count.
@@ -205,6 +240,7 @@ const int8_t* ColumnFetcher::getOneTableColumnFragment(
         chunk_meta_it->second->numElements());
     std::lock_guard<std::mutex> chunk_list_lock(chunk_list_mutex_);
     chunk_holder.push_back(chunk);
+    trackChunk(*chunk);
   }
   if (is_varlen) {
     CHECK_GT(table_id, 0);
@@ -372,6 +408,7 @@ const int8_t* ColumnFetcher::linearizeColumnFragments(
                                         chunk_meta_it->second->numBytes(),
                                         chunk_meta_it->second->numElements());
       local_chunk_holder.push_back(chunk);
+      trackChunk(*chunk);
       auto chunk_iter = chunk->begin_iterator(chunk_meta_it->second);
       local_chunk_iter_holder.push_back(chunk_iter);
       local_chunk_num_tuples.push_back(fragment.getNumTuples());
@@ -544,6 +581,7 @@ MergedChunk ColumnFetcher::linearizeVarLenArrayColFrags(
                 << getMemoryLevelString(memory_level) << ", device_id: " << device_id
                 << ")";
       } else {
+        trackLinearizedBuffer(total_data_buf_size);
         merged_data_buffer =
             executor_->getDataMgr()->alloc(memory_level, device_id, total_data_buf_size);
         VLOG(2) << "Allocate " << total_data_buf_size
@@ -554,6 +592,7 @@ MergedChunk ColumnFetcher::linearizeVarLenArrayColFrags(
       }
     } else {
       DeviceMergedChunkMap m;
+      trackLinearizedBuffer(total_data_buf_size);
       merged_data_buffer =
           executor_->getDataMgr()->alloc(memory_level, device_id, total_data_buf_size);
       VLOG(2) << "Allocate " << total_data_buf_size
@@ -575,6 +614,7 @@ MergedChunk ColumnFetcher::linearizeVarLenArrayColFrags(
           << getMemoryLevelString(memory_level) << ", device_id: " << device_id << ")";
     } else {
       auto idx_buf_size = total_idx_buf_size + sizeof(ArrayOffsetT);
+      trackLinearizedBuffer(idx_buf_size);
       merged_index_buffer_in_cpu =
           executor_->getDataMgr()->alloc(Data_Namespace::CPU_LEVEL, 0, idx_buf_size);
       VLOG(2) << "Allocate " << idx_buf_size
@@ -795,6 +835,7 @@ MergedChunk ColumnFetcher::linearizeVarLenArrayColFrags(
         if (merged_idx_buf_it != merged_idx_buf_cache.end()) {
           merged_index_buffer = merged_idx_buf_it->second;
         } else {
+          trackLinearizedBuffer(buf_size);
           merged_index_buffer =
               executor_->getDataMgr()->alloc(memory_level, device_id, buf_size);
           copyBuf(merged_index_buffer_in_cpu->getMemoryPtr(),
@@ -804,6 +845,7 @@ MergedChunk ColumnFetcher::linearizeVarLenArrayColFrags(
           merged_idx_buf_cache.insert(std::make_pair(device_id, merged_index_buffer));
         }
       } else {
+        trackLinearizedBuffer(buf_size);
         merged_index_buffer =
             executor_->getDataMgr()->alloc(memory_level, device_id, buf_size);
         copyBuf(merged_index_buffer_in_cpu->getMemoryPtr(),
@@ -861,6 +903,7 @@ MergedChunk ColumnFetcher::linearizeFixedLenArrayColFrags(
                 << getMemoryLevelString(memory_level) << ", device_id: " << device_id
                 << ")";
       } else {
+        trackLinearizedBuffer(total_data_buf_size);
         merged_data_buffer =
             executor_->getDataMgr()->alloc(memory_level, device_id, total_data_buf_size);
         VLOG(2) << "Allocate " << total_data_buf_size
@@ -871,6 +914,7 @@ MergedChunk ColumnFetcher::linearizeFixedLenArrayColFrags(
       }
     } else {
       DeviceMergedChunkMap m;
+      trackLinearizedBuffer(total_data_buf_size);
       merged_data_buffer =
           executor_->getDataMgr()->alloc(memory_level, device_id, total_data_buf_size);
       VLOG(2) << "Allocate " << total_data_buf_size
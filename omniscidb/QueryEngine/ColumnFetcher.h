@@ -22,8 +22,11 @@
 #include "QueryEngine/Descriptors/QueryFragmentDescriptor.h"
 #include "QueryEngine/JoinHashTable/Runtime/HashJoinRuntime.h"
 #include "ResultSetRegistry/ColumnarResults.h"
+#include "Shared/QueryMemoryTracker.h"
 #include "Shared/hash.h"
 
+#include <unordered_set>
+
 struct FetchResult {
   std::vector<std::vector<const int8_t*>> col_buffers;
   std::vector<std::vector<int64_t>> num_rows;
@@ -37,6 +40,7 @@ class ColumnFetcher {
   ColumnFetcher(Executor* executor,
                 DataProvider* data_provider,
                 const ColumnCacheMap& column_cache);
+  ~ColumnFetcher();
 
   //! Gets one chunk's pointer and element count on either CPU or GPU.
   static std::pair<const int8_t*, size_t> getOneColumnFragment(
@@ -151,8 +155,19 @@ class ColumnFetcher {
                              bool is_true_varlen_type,
                              const size_t total_num_tuples) const;
 
+  // Accounts memory of fetched input chunks and linearized buffers for the query
+  // memory tracker. Accounted memory is released when the fetcher is destroyed.
+  // Chunks are accounted once, no matter how many kernels fetch them.
+  void trackChunk(const Chunk_NS::Chunk& chunk) const;
+  void trackLinearizedBuffer(size_t bytes) const;
+
   Executor* executor_;
   DataProvider* data_provider_;
+  std::shared_ptr<hdk::QueryMemoryTracker> memory_tracker_;
+  mutable std::mutex memory_tracker_mutex_;
+  mutable std::unordered_set<const AbstractBuffer*> tracked_chunks_;
+  mutable size_t tracked_chunk_bytes_ = 0;
+  mutable size_t tracked_linearized_bytes_ = 0;
   mutable std::mutex columnar_fetch_mutex_;
   mutable std::mutex varlen_chunk_fetch_mutex_;
   mutable std::mutex linearization_mutex_;
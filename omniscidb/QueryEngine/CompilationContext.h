@@ -16,8 +16,10 @@
 
 #pragma once
 
+#include "QueryEngine/CompilationOptions.h"
 #include "QueryEngine/ExecutionEngineWrapper.h"
 
+#include <atomic>
 #include <memory>
 
 class CompilationContext {
@@ -25,23 +27,85 @@ class CompilationContext {
   virtual ~CompilationContext() {}
 };
 
-class CpuCompilationContext : public CompilationContext {
+// State required to recompile minimally optimized code with full optimization.
+struct TierUpInfo {
+  // Bitcode of the module after the fast optimization pipeline.
+  std::string bitcode;
+  std::string query_func_name;
+  std::string entry_func_name;
+  std::vector<std::string> live_func_names;
+  CompilationOptions co;
+  size_t run_count_threshold;
+  size_t run_time_threshold_ms;
+  // Notified with the optimized object, e.g. to store it in the persistent code cache.
+  std::unique_ptr<llvm::ObjectCache> object_cache;
+};
+
+/**
+ * With tiered compilation, the context initially holds code built with
+ * ExecutorOptLevel::FastJIT. Once query steps run the code run_count_threshold times,
+ * or the kernels of a single step take at least run_time_threshold_ms, the module is
+ * recompiled with full optimization in background and the entry point is switched to
+ * the optimized code. Runs which already started keep using the old code, so it is
+ * never released.
+ */
+class CpuCompilationContext : public CompilationContext,
+                              public std::enable_shared_from_this<CpuCompilationContext> {
  public:
   CpuCompilationContext(std::unique_ptr<ExecutionEngineWrapper>&& execution_engine)
       : execution_engine_(std::move(execution_engine)) {}
 
   void setFunctionPointer(llvm::Function* function) {
-    func_ = execution_engine_->getPointerToFunction(function);
-    CHECK(func_);
+    auto func = execution_engine_->getPointerToFunction(function);
+    CHECK(func);
+    func_.store(func, std::memory_order_release);
+    if (tier_up_info_) {
+      tier_up_info_->entry_func_name = function->getName().str();
+    }
   }
 
   void* getPointerToFunction(llvm::Function* function) {
     return execution_engine_->getPointerToFunction(function);
   }
 
-  void* func() const { return func_; }
+  void* func() const { return func_.load(std::memory_order_acquire); }
+
+  void enableTierUp(std::unique_ptr<TierUpInfo> tier_up_info) {
+    CHECK(tier_up_info);
+    tier_up_enabled_ = true;
+    run_count_threshold_ = tier_up_info->run_count_threshold;
+    run_time_threshold_ms_ = tier_up_info->run_time_threshold_ms;
+    tier_up_info_ = std::move(tier_up_info);
+  }
+
+  // Called once per execution of a query step using the code, with the time its
+  // kernels took, rather than per kernel launch. Schedules the recompilation once the
+  // code becomes hot.
+  void registerRun(int64_t time_ms) const;
+
+  // Number of recompilations scheduled in the process.
+  static size_t getTierUpCount() { return tier_up_count_.load(); }
+
+  // Transfers the tier-up state to the background compilation.
+  std::unique_ptr<TierUpInfo> takeTierUpInfo() { return std::move(tier_up_info_); }
+
+  void setOptimizedCode(std::unique_ptr<ExecutionEngineWrapper> execution_engine,
+                        void* func) {
+    CHECK(func);
+    optimized_execution_engine_ = std::move(execution_engine);
+    func_.store(func, std::memory_order_release);
+  }
 
  private:
-  void* func_{nullptr};
+  std::atomic<void*> func_{nullptr};
   std::unique_ptr<ExecutionEngineWrapper> execution_engine_;
+  std::unique_ptr<ExecutionEngineWrapper> optimized_execution_engine_;
+
+  std::unique_ptr<TierUpInfo> tier_up_info_;
+  bool tier_up_enabled_{false};
+  size_t run_count_threshold_{0};
+  size_t run_time_threshold_ms_{0};
+  mutable std::atomic<size_t> run_count_{0};
+  mutable std::atomic<bool> tier_up_scheduled_{false};
+  inline static std::atomic<size_t> tier_up_count_{0};
 };
@@ -34,7 +34,10 @@ std::ostream& operator<<(std::ostream& os, const ExecutionOptions& eo) {
      << "running_query_interrupt_freq=" << eo.running_query_interrupt_freq << "\n"
      << "pending_query_interrupt_freq=" << eo.pending_query_interrupt_freq << "\n"
      << "multifrag_result=" << eo.multifrag_result << "\n"
-     << "preserve_order=" << eo.preserve_order << "\n";
+     << "preserve_order=" << eo.preserve_order << "\n"
+     << "priority=" << (eo.priority == QueryPriority::Batch ? "batch" : "interactive")
+     << "\n"
+     << "max_threads=" << eo.max_threads << "\n";
   return os;
 }
 #endif
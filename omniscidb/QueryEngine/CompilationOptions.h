@@ -29,7 +29,8 @@
 #include "Shared/Config.h"
 #include "Shared/DeviceType.h"
 
-enum class ExecutorOptLevel { Default, ReductionJIT };
+// FastJIT is the first tier of tiered compilation, see CpuCompilationContext.
+enum class ExecutorOptLevel { Default, ReductionJIT, FastJIT };
 
 enum class ExecutorExplainType { Default, Optimized };
 
@@ -92,6 +93,10 @@ struct CompilationOptions {
 
 enum class ExecutorType { Native, Extern };
 
+// Interactive queries take CPU threads from running batch queries. Batch queries
+// are left with a single worker thread while interactive queries run kernels.
+enum class QueryPriority { Interactive, Batch };
+
 struct ExecutionOptions {
   bool output_columnar_hint;
   bool allow_multifrag;
@@ -112,6 +117,8 @@ struct ExecutionOptions {
   std::vector<size_t> outer_fragment_indices{};
   bool multifrag_result = false;
   bool preserve_order = false;
+  QueryPriority priority = QueryPriority::Interactive;
+  size_t max_threads = 0;  // Max CPU threads running query kernels, 0 - no limit.
 
   static ExecutionOptions fromConfig(const Config& config) {
     auto eo = ExecutionOptions();
@@ -134,6 +141,8 @@ struct ExecutionOptions {
 
     eo.multifrag_result = config.exec.enable_multifrag_rs;
     eo.preserve_order = false;
+    eo.priority = QueryPriority::Interactive;
+    eo.max_threads = config.exec.max_threads_per_query;
 
     return eo;
   }
@@ -150,6 +159,12 @@ struct ExecutionOptions {
     return eo;
   }
 
+  ExecutionOptions with_priority(QueryPriority priority) const {
+    ExecutionOptions eo = *this;
+    eo.priority = priority;
+    return eo;
+  }
+
   ExecutionOptions with_just_validate(bool enable = true) const {
     ExecutionOptions eo = *this;
     eo.just_validate = enable;
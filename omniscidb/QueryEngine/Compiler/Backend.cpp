@@ -21,6 +21,8 @@
 #include "QueryEngine/ExtensionFunctionsWhitelist.h"
 #include "QueryEngine/NvidiaKernel.h"
 
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
 #include <llvm/IR/DebugInfo.h>
 #include <llvm/IR/InstIterator.h>
 #include <llvm/IR/IntrinsicInst.h>
@@ -32,6 +34,11 @@
 #include <llvm/Transforms/Utils/BasicBlockUtils.h>
 #include <llvm/Transforms/Utils/Cloning.h>
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 #ifdef HAVE_L0
 #include "LLVMSPIRVLib/LLVMSPIRVLib.h"
 #endif
@@ -90,26 +97,17 @@ std::shared_ptr<CompilationContext> CPUBackend::generateNativeCode(
       CPUBackend::generateNativeCPUCode(func, live_funcs, co));
 }
 
-std::shared_ptr<CpuCompilationContext> CPUBackend::generateNativeCPUCode(
-    llvm::Function* func,
-    const std::unordered_set<llvm::Function*>& live_funcs,
-    const CompilationOptions& co) {
-  auto timer = DEBUG_TIMER(__func__);
-  llvm::Module* llvm_module = func->getParent();
-  // run optimizations
-#ifndef WITH_JIT_DEBUG
-  compiler::optimize_ir(func, llvm_module, live_funcs, /*is_gpu_smem_used=*/false, co);
-#endif  // WITH_JIT_DEBUG
+namespace {
 
+std::unique_ptr<ExecutionEngineWrapper> create_cpu_execution_engine(
+    const CompilationOptions& co,
+    std::unique_ptr<llvm::ObjectCache> object_cache) {
   auto init_err = llvm::InitializeNativeTarget();
   CHECK(!init_err);
 
   llvm::InitializeNativeTargetAsmPrinter();
   llvm::InitializeNativeTargetAsmParser();
 
-  std::string err_str;
-  std::unique_ptr<llvm::Module> owner(llvm_module);
-
   llvm::TargetOptions to;
   to.EnableFastISel = true;
 
@@ -137,7 +135,8 @@ std::shared_ptr<CpuCompilationContext> CPUBackend::generateNativeCPUCode(
       std::move(*target_machine_builder_or_error);
   target_machine_builder.getOptions().EnableFastISel = true;
 
-  if (co.opt_level == ExecutorOptLevel::ReductionJIT) {
+  if (co.opt_level == ExecutorOptLevel::ReductionJIT ||
+      co.opt_level == ExecutorOptLevel::FastJIT) {
     target_machine_builder.setCodeGenOptLevel(llvm::CodeGenOpt::None);
   }
 
@@ -149,14 +148,201 @@ std::shared_ptr<CpuCompilationContext> CPUBackend::generateNativeCPUCode(
   std::unique_ptr<llvm::DataLayout> data_layout =
       std::make_unique<llvm::DataLayout>(std::move(*data_layout_or_err));
 
-  auto execution_engine =
-      std::make_unique<ExecutionEngineWrapper>(std::move(execution_session),
-                                               std::move(target_machine_builder),
-                                               std::move(data_layout));
+  return std::make_unique<ExecutionEngineWrapper>(std::move(execution_session),
+                                                  std::move(target_machine_builder),
+                                                  std::move(data_layout),
+                                                  std::move(object_cache));
+}
+
+void tier_up(CpuCompilationContext& ctx) {
+  auto timer = DEBUG_TIMER(__func__);
+  auto info = ctx.takeTierUpInfo();
+  if (!info) {
+    LOG(WARNING) << "Skipped recompilation of a context without tier-up state";
+    return;
+  }
+
+  // Global LLVM context is guarded by the compilation mutex of the executor, so the
+  // module is loaded into a private context.
+  llvm::orc::ThreadSafeContext context(std::make_unique<llvm::LLVMContext>());
+  auto module_or_err = llvm::parseBitcodeFile(
+      llvm::MemoryBufferRef(info->bitcode, info->entry_func_name), *context.getContext());
+  if (!module_or_err) {
+    LOG(WARNING) << "Cannot load module for recompilation: "
+                 << llvmErrorToString(module_or_err.takeError());
+    return;
+  }
+  auto module = std::move(*module_or_err);
+  auto query_func = module->getFunction(info->query_func_name);
+  auto entry_func = module->getFunction(info->entry_func_name);
+  if (!query_func || !entry_func) {
+    LOG(WARNING) << "Skipped recompilation of " << info->entry_func_name
+                 << ": query or entry function is missing in the module";
+    return;
+  }
+  std::unordered_set<llvm::Function*> live_funcs;
+  for (const auto& name : info->live_func_names) {
+    if (auto func = module->getFunction(name)) {
+      live_funcs.insert(func);
+    }
+  }
+
+  auto co = info->co;
+  co.opt_level = ExecutorOptLevel::Default;
+#ifndef WITH_JIT_DEBUG
+  optimize_ir(query_func, module.get(), live_funcs, /*is_gpu_smem_used=*/false, co);
+#endif  // WITH_JIT_DEBUG
+  auto execution_engine = create_cpu_execution_engine(co, std::move(info->object_cache));
+  execution_engine->addModule(std::move(module), std::move(context));
+  auto func = execution_engine->getPointerToFunction(entry_func);
+  if (!func) {
+    LOG(WARNING) << "Skipped recompilation of " << info->entry_func_name
+                 << ": optimized code has no entry point";
+    return;
+  }
+  ctx.setOptimizedCode(std::move(execution_engine), func);
+  VLOG(1) << "Switched " << info->entry_func_name << " to optimized code";
+}
+
+// Single background thread performing recompilations with full optimization. Queued
+// contexts are held weakly, so kernels evicted from the code cache are skipped. The
+// worker is started by the first push and is stopped by stopTierUp() rather than during
+// static destruction, when LLVM may be already torn down.
+class TierUpQueue {
+ public:
+  static TierUpQueue& get() {
+    // Never destroyed, so the worker is not joined at exit.
+    static TierUpQueue* queue = new TierUpQueue();
+    return *queue;
+  }
+
+  void push(std::weak_ptr<CpuCompilationContext> ctx) {
+    std::lock_guard<std::mutex> worker_lock(worker_mutex_);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queue_.push_back(std::move(ctx));
+      stop_ = false;
+    }
+    if (!worker_.joinable()) {
+      worker_ = std::thread([this]() { run(); });
+    }
+    cv_.notify_one();
+  }
+
+  // Drops queued contexts and waits for the recompilation in progress.
+  void stop() {
+    std::lock_guard<std::mutex> worker_lock(worker_mutex_);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+      queue_.clear();
+    }
+    cv_.notify_one();
+    if (worker_.joinable()) {
+      worker_.join();
+    }
+  }
+
+ private:
+  TierUpQueue() = default;
+
+  void run() {
+    while (true) {
+      std::weak_ptr<CpuCompilationContext> weak_ctx;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+        if (stop_) {
+          return;
+        }
+        weak_ctx = std::move(queue_.front());
+        queue_.pop_front();
+      }
+      if (auto ctx = weak_ctx.lock()) {
+        try {
+          tier_up(*ctx);
+        } catch (const std::exception& e) {
+          LOG(WARNING) << "Recompilation failed: " << e.what();
+        }
+      }
+    }
+  }
+
+  // Serializes starting and stopping of the worker.
+  std::mutex worker_mutex_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::weak_ptr<CpuCompilationContext>> queue_;
+  bool stop_{false};
+  std::thread worker_;
+};
+
+}  // namespace
+
+void stopTierUp() {
+  TierUpQueue::get().stop();
+}
+
+std::shared_ptr<CpuCompilationContext> CPUBackend::generateNativeCPUCode(
+    llvm::Function* func,
+    const std::unordered_set<llvm::Function*>& live_funcs,
+    const CompilationOptions& co,
+    std::unique_ptr<llvm::ObjectCache> object_cache,
+    std::unique_ptr<TierUpInfo> tier_up_info) {
+  auto timer = DEBUG_TIMER(__func__);
+  llvm::Module* llvm_module = func->getParent();
+  // run optimizations
+#ifndef WITH_JIT_DEBUG
+  compiler::optimize_ir(func, llvm_module, live_funcs, /*is_gpu_smem_used=*/false, co);
+#endif  // WITH_JIT_DEBUG
+
+  if (tier_up_info) {
+    llvm::raw_string_ostream os(tier_up_info->bitcode);
+    llvm::WriteBitcodeToFile(*llvm_module, os);
+    os.flush();
+    tier_up_info->query_func_name = func->getName().str();
+    for (auto live_func : live_funcs) {
+      tier_up_info->live_func_names.push_back(live_func->getName().str());
+    }
+  }
+
+  std::unique_ptr<llvm::Module> owner(llvm_module);
+  auto execution_engine = create_cpu_execution_engine(co, std::move(object_cache));
   execution_engine->addModule(std::move(owner));
+  auto ctx = std::make_shared<CpuCompilationContext>(std::move(execution_engine));
+  if (tier_up_info) {
+    ctx->enableTierUp(std::move(tier_up_info));
+  }
+  return ctx;
+}
+
+std::shared_ptr<CpuCompilationContext> CPUBackend::loadNativeCPUCode(
+    std::unique_ptr<llvm::MemoryBuffer> object,
+    const CompilationOptions& co) {
+  auto timer = DEBUG_TIMER(__func__);
+  auto execution_engine = create_cpu_execution_engine(co, nullptr);
+  execution_engine->addObjectFile(std::move(object));
   return std::make_shared<CpuCompilationContext>(std::move(execution_engine));
 }
 
+}  // namespace compiler
+
+void CpuCompilationContext::registerRun(int64_t time_ms) const {
+  if (!tier_up_enabled_ || tier_up_scheduled_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  auto run_count = ++run_count_;
+  if ((run_count >= run_count_threshold_ ||
+       static_cast<size_t>(std::max<int64_t>(time_ms, 0)) >= run_time_threshold_ms_) &&
+      !tier_up_scheduled_.exchange(true)) {
+    ++tier_up_count_;
+    compiler::TierUpQueue::get().push(
+        std::const_pointer_cast<CpuCompilationContext>(shared_from_this()));
+  }
+}
+
+namespace compiler {
+
 std::unique_ptr<llvm::TargetMachine> CUDABackend::initializeNVPTXBackend(
     const CudaMgr_Namespace::NvidiaDeviceArch arch) {
   auto timer = DEBUG_TIMER(__func__);
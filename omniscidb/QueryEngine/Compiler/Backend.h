@@ -14,7 +14,9 @@
 
 #pragma once
 
+#include <llvm/ExecutionEngine/ObjectCache.h>
 #include <llvm/IR/Value.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <memory>
 
 #include "QueryEngine/ExtensionModules.h"
@@ -135,9 +137,19 @@ class CPUBackend : public Backend {
     CHECK(false) << "Unsupported Shared Memory on CPU";
   };
 
+  // If object_cache is provided, it is notified with the compiled object. If
+  // tier_up_info is provided, the module is saved to it after optimization and the
+  // returned context recompiles it with full optimization once the code becomes hot.
   static std::shared_ptr<CpuCompilationContext> generateNativeCPUCode(
       llvm::Function* func,
       const std::unordered_set<llvm::Function*>& live_funcs,
+      const CompilationOptions& co,
+      std::unique_ptr<llvm::ObjectCache> object_cache = nullptr,
+      std::unique_ptr<TierUpInfo> tier_up_info = nullptr);
+
+  // Creates a compilation context from a previously compiled object file.
+  static std::shared_ptr<CpuCompilationContext> loadNativeCPUCode(
+      std::unique_ptr<llvm::MemoryBuffer> object,
       const CompilationOptions& co);
 
  private:
@@ -234,4 +246,9 @@ void setSharedMemory(ExecutorDeviceType dt,
                      GPUTarget& gpu_target,
                      const std::shared_ptr<compiler::Backend>& backend);
 
+// Drops scheduled tier-up recompilations and joins the background worker. Has to be
+// called before compiled code or LLVM is torn down, later recompilations restart the
+// worker.
+void stopTierUp();
+
 }  // namespace compiler
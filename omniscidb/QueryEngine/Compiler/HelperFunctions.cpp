@@ -20,6 +20,7 @@
 #include <llvm/Passes/PassBuilder.h>
 #include <llvm/Transforms/IPO.h>
 #include <llvm/Transforms/IPO/AlwaysInliner.h>
+#include <llvm/Transforms/IPO/GlobalDCE.h>
 #include <llvm/Transforms/IPO/GlobalOpt.h>
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
 #include <llvm/Transforms/InstCombine/InstCombine.h>
@@ -126,6 +127,20 @@ void optimize_ir(llvm::Function* query_func,
   llvm::ModulePassManager MPM;
   llvm::FunctionPassManager FPM;
 
+  if (co.opt_level == ExecutorOptLevel::FastJIT) {
+    // Inline the row function into the query loop and drop unused runtime functions,
+    // anything else is left to the full optimization recompile.
+    MPM.addPass(llvm::AlwaysInlinerPass());
+    MPM.addPass(llvm::GlobalDCEPass());
+    FPM.addPass(llvm::PromotePass());
+    MPM.addPass(createModuleToFunctionPassAdaptor(std::move(FPM)));
+    MPM.run(*llvm_module, MAM);
+#if defined(HAVE_CUDA) || defined(HAVE_L0) || !defined(WITH_JIT_DEBUG)
+    eliminate_dead_self_recursive_funcs(*llvm_module, live_funcs);
+#endif
+    return;
+  }
+
   // the always inliner legacy pass must always run first
   FPM.addPass(llvm::VerifierPass());
   MPM.addPass(llvm::AlwaysInlinerPass());
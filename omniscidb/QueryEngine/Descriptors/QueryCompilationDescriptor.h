@@ -28,6 +28,9 @@
 #include "QueryEngine/CompilationContext.h"
 #include "QueryEngine/GpuSharedMemoryContext.h"
 #include "QueryEngine/PlanState.h"
+#include "ResultSet/QueryMemoryDescriptor.h"
+
+#include <optional>
 
 struct CompilationResult {
   std::shared_ptr<CompilationContext> generated_code;
@@ -49,6 +52,25 @@ struct CompilationResult {
   };
 };
 
+// A constant of the plan which doesn't affect code generation. Its value is loaded
+// from the literal buffer by index, unless the literal is shared with other constants or
+// the value was not hoisted. Then the plan can be reused only for the same value.
+struct PlanParam {
+  std::optional<size_t> literal_idx;
+  CgenState::LiteralValue value;
+};
+
+// Compilation result along with the state code generation leaves for the execution.
+// Used to reuse compiled kernels without generating IR.
+struct CompiledPlan {
+  CompilationResult compilation_result;
+  QueryMemoryDescriptor query_mem_desc;
+  std::vector<int64_t> init_agg_vals;
+  PlanState::InputColDescriptorSet columns_to_fetch;
+  PlanState::InputColDescriptorSet columns_to_not_fetch;
+  std::vector<PlanParam> params;
+};
+
 class QueryCompilationDescriptor {
  public:
   QueryCompilationDescriptor()
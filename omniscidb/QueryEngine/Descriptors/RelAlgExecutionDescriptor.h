@@ -20,6 +20,7 @@
 #include "ResultSet/QueryMemoryDescriptor.h"
 #include "ResultSet/ResultSet.h"
 #include "ResultSetRegistry/ResultSetRegistry.h"
+#include "Shared/QueryMemoryTracker.h"
 #include "Shared/TargetInfo.h"
 #include "Shared/toString.h"
 
@@ -95,6 +96,11 @@ class ExecutionResult {
   void addExecutionTime(int64_t execution_time_ms) {
     execution_time_ms_ += execution_time_ms;
   }
+  // Peak memory usage of the query producing the result.
+  const hdk::QueryMemoryStats& getMemoryStats() const { return memory_stats_; }
+  void setMemoryStats(const hdk::QueryMemoryStats& memory_stats) {
+    memory_stats_ = memory_stats;
+  }
 
  private:
   hdk::ResultSetTableTokenPtr result_token_;
@@ -107,6 +113,7 @@ class ExecutionResult {
   bool success_;
   uint64_t execution_time_ms_;
   RType type_;
+  hdk::QueryMemoryStats memory_stats_;
 };
 
 namespace hdk::ir {
@@ -110,6 +110,7 @@ std::unique_ptr<CodeCacheAccessor<CpuCompilationContext>> Executor::s_code_acces
 std::unique_ptr<CodeCacheAccessor<CpuCompilationContext>> Executor::cpu_code_accessor;
 std::unique_ptr<CodeCacheAccessor<CompilationContext>> Executor::gpu_code_accessor;
 size_t Executor::code_cache_size;
+std::unique_ptr<PersistentCodeCache> Executor::persistent_code_cache;
 namespace {
 
 void init_code_caches() {
@@ -130,9 +131,10 @@ void init_code_caches() {
  * Flushes and re-initializes the code caches. Any cached references will be dropped. The
  * re-initialized code caches will be empty, allowing for higher-level buffer mgrs to be
  * torn down. If code caches are used, this must be called before the DataMgr global is
- * destroyed at exit.
+ * destroyed at exit. Background recompilations are stopped first.
  */
 void Executor::resetCodeCache() {
+  compiler::stopTierUp();
   s_stubs_accessor.reset();
   s_code_accessor.reset();
   cpu_code_accessor.reset();
@@ -161,6 +163,10 @@ Executor::Executor(const ExecutorId executor_id,
   }
 
   extension_module_context_ = std::make_unique<ExtensionModuleContext>();
+  if (config_->cache.enable_plan_code_cache) {
+    plan_code_accessor_ = std::make_shared<CodeCacheAccessor<CompiledPlan>>(
+        config_->cache.code_cache_size, "plan_code_cache");
+  }
   cgen_state_ = std::make_unique<CgenState>(
       0, false, false, extension_module_context_.get(), getContext());
 
@@ -169,6 +175,10 @@ Executor::Executor(const ExecutorId executor_id,
         std::make_unique<QueryPlanDagCache>(config_->cache.dag_cache_size);
     code_cache_size = config_->cache.code_cache_size;
     init_code_caches();
+    if (!config_->cache.code_cache_dir.empty()) {
+      persistent_code_cache =
+          std::make_unique<PersistentCodeCache>(config_->cache.code_cache_dir);
+    }
   });
   Executor::initialize_extension_module_sources();
   update_extension_modules();
@@ -227,6 +237,18 @@ void Executor::reset(const bool discard_runtime_modules_only) {
 
   CHECK(extension_module_context_);
   extension_module_context_->clear(discard_runtime_modules_only);
+  {
+    std::lock_guard<std::mutex> lock(compilation_helpers_mutex_);
+    compilation_helpers_.clear();
+  }
+  {
+    std::lock_guard<std::mutex> lock(step_executors_mutex_);
+    step_executors_.clear();
+  }
+  {
+    std::lock_guard<std::mutex> lock(query_executors_mutex_);
+    query_executors_.clear();
+  }
 
   if (discard_runtime_modules_only) {
     cgen_state_->module_ = nullptr;
@@ -407,6 +429,73 @@ std::shared_ptr<Executor> Executor::getExecutor(Data_Namespace::DataMgr* data_mg
       executor_id_ctr_++, data_mgr, config, debug_dir, debug_file);
 }
 
+std::shared_ptr<Executor> Executor::getCompilationHelper(size_t idx) {
+  std::lock_guard<std::mutex> lock(compilation_helpers_mutex_);
+  while (compilation_helpers_.size() <= idx) {
+    auto helper = getExecutor(data_mgr_, config_, debug_dir_, debug_file_);
+    helper->plan_code_accessor_ = plan_code_accessor_;
+    compilation_helpers_.push_back(helper);
+  }
+  return compilation_helpers_[idx];
+}
+
+std::shared_ptr<Executor> Executor::getStepExecutor(size_t idx) {
+  std::lock_guard<std::mutex> lock(step_executors_mutex_);
+  while (step_executors_.size() <= idx) {
+    auto step_executor = getExecutor(data_mgr_, config_, debug_dir_, debug_file_);
+    step_executor->plan_code_accessor_ = plan_code_accessor_;
+    step_executors_.push_back(step_executor);
+  }
+  return step_executors_[idx];
+}
+
+std::shared_ptr<Executor> Executor::acquireQueryExecutor() {
+  if (!config_->exec.enable_concurrent_queries) {
+    // Queries share this executor and only their kernel launches are serialized by
+    // the kernel lock.
+    return std::shared_ptr<Executor>(this, [](Executor*) {});
+  }
+  // Run-time UDFs are registered in this executor's extension modules only.
+  if (getExtensionModuleContext()->getRTUdfModule()) {
+    return lockQueryExecutor(true, nullptr);
+  }
+  if (auto res = lockQueryExecutor(false, nullptr)) {
+    return res;
+  }
+
+  std::lock_guard<std::mutex> lock(query_executors_mutex_);
+  for (auto& query_executor : query_executors_) {
+    if (auto res = query_executor->lockQueryExecutor(false, query_executor)) {
+      return res;
+    }
+  }
+  auto query_executor = getExecutor(data_mgr_, config_, debug_dir_, debug_file_);
+  query_executor->plan_code_accessor_ = plan_code_accessor_;
+  query_executors_.push_back(query_executor);
+  VLOG(1) << "Created executor " << query_executor->getExecutorId()
+          << " to run a query concurrently with executor " << executor_id_;
+  auto res = query_executor->lockQueryExecutor(false, query_executor);
+  CHECK(res);
+  return res;
+}
+
+std::shared_ptr<Executor> Executor::lockQueryExecutor(bool wait,
+                                                      std::shared_ptr<Executor> owner) {
+  std::unique_lock<std::mutex> lock(query_running_mutex_);
+  if (query_running_ && !wait) {
+    return nullptr;
+  }
+  query_running_cv_.wait(lock, [this] { return !query_running_; });
+  query_running_ = true;
+  return std::shared_ptr<Executor>(this, [owner](Executor* executor) {
+    {
+      std::lock_guard<std::mutex> lock(executor->query_running_mutex_);
+      executor->query_running_ = false;
+    }
+    executor->query_running_cv_.notify_one();
+  });
+}
+
 void Executor::clearMemory(const Data_Namespace::MemoryLevel memory_level,
                            Data_Namespace::DataMgr* data_mgr) {
   switch (memory_level) {
@@ -1217,17 +1306,12 @@ ReductionCode get_reduction_code(
 
 }  // namespace
 
+// Non-grouped aggregates have a single entry, so there is no key space to partition.
+// Merging count distinct sets is expensive though, so results are reduced pairwise in
+// parallel.
 bool couldUseParallelReduce(const QueryMemoryDescriptor& desc) {
-  if (desc.getQueryDescriptionType() == QueryDescriptionType::NonGroupedAggregate &&
-      desc.getCountDistinctDescriptorsSize()) {
-    return true;
-  }
-
-  if (desc.getQueryDescriptionType() == QueryDescriptionType::GroupByPerfectHash) {
-    return true;
-  }
-
-  return false;
+  return desc.getQueryDescriptionType() == QueryDescriptionType::NonGroupedAggregate &&
+         desc.getCountDistinctDescriptorsSize();
 }
 
 ResultSetPtr Executor::reduceMultiDeviceResultSets(
@@ -1320,14 +1404,14 @@ ResultSetPtr Executor::reduceMultiDeviceResultSets(
           return lhs;
         });
   } else {
+    // Group-by results are merged in a single pass with workers owning disjoint parts
+    // of the key space.
+    std::vector<const ResultSetStorage*> storages;
     for (size_t i = 1; i < results_per_device.size(); ++i) {
-      ResultSetReduction::reduce(*reduced_results->getStorage(),
-                                 *(results_per_device[i].first->getStorage()),
-                                 {},
-                                 reduction_code,
-                                 getConfig(),
-                                 this);
+      storages.push_back(results_per_device[i].first->getStorage());
     }
+    ResultSetReduction::reducePartitioned(
+        *reduced_results->getStorage(), storages, reduction_code, getConfig(), this);
   }
   reduced_results->addCompilationQueueTime(compilation_queue_time);
   return reduced_results;
@@ -1919,6 +2003,49 @@ Executor::getExecutionPolicyForTargets(const RelAlgExecutionUnit& ra_exe_unit,
   return {std::move(exe_policy), requested_device_type};
 }
 
+namespace {
+
+// Returns the number of rows enough to produce the result of a projection with LIMIT
+// and without ORDER BY, or 0 if all kernels have to be executed. Kernels are taken in
+// fragment order and all taken kernels run to completion, so results of completed
+// kernels always cover a prefix of fragments, which preserves the result order.
+size_t get_early_termination_row_limit(const RelAlgExecutionUnit& ra_exe_unit,
+                                       const QueryMemoryDescriptor& query_mem_desc) {
+  if (query_mem_desc.getQueryDescriptionType() != QueryDescriptionType::Projection ||
+      !ra_exe_unit.sort_info.order_entries.empty() || !ra_exe_unit.sort_info.limit ||
+      ra_exe_unit.estimator) {
+    return 0;
+  }
+  return ra_exe_unit.sort_info.limit + ra_exe_unit.sort_info.offset;
+}
+
+// Registers a run of the query step with each CPU code used by its kernels, so that
+// tiered compilation counts query step executions rather than kernel launches.
+void register_cpu_code_runs(
+    const std::map<ExecutorDeviceType, std::unique_ptr<QueryCompilationDescriptor>>&
+        query_comp_descs,
+    const FragmentSpecializations& fragment_specializations,
+    const int64_t time_ms) {
+  std::unordered_set<const CpuCompilationContext*> native_codes;
+  auto register_run = [&](const QueryCompilationDescriptor& query_comp_desc) {
+    auto generated_code = query_comp_desc.getCompilationResult().generated_code;
+    auto native_code = dynamic_cast<const CpuCompilationContext*>(generated_code.get());
+    if (native_code && native_codes.insert(native_code).second) {
+      native_code->registerRun(time_ms);
+    }
+  };
+  for (const auto& [device_type, query_comp_desc] : query_comp_descs) {
+    if (device_type == ExecutorDeviceType::CPU) {
+      register_run(*query_comp_desc);
+    }
+  }
+  for (const auto& query_comp_desc : fragment_specializations.query_comp_descs) {
+    register_run(*query_comp_desc);
+  }
+}
+
+}  // namespace
+
 hdk::ResultSetTable Executor::executeWorkUnitImpl(
     size_t& max_groups_buffer_entry_guess,
     const bool is_agg,
@@ -1993,6 +2120,23 @@ hdk::ResultSetTable Executor::executeWorkUnitImpl(
       return {executeExplain(*query_comp_descs_owned.at(fallback_device))};
     }
 
+    FragmentSpecializations fragment_specializations;
+    if (!eo.just_validate && eo.executor_type == ExecutorType::Native &&
+        fallback_device == ExecutorDeviceType::CPU &&
+        !config_->exec.heterogeneous.enable_heterogeneous_execution &&
+        config_->exec.codegen.enable_fragment_specialization) {
+      fragment_specializations =
+          compileFragmentSpecializations(max_groups_buffer_entry_guess,
+                                         crt_min_byte_width,
+                                         has_cardinality_estimation,
+                                         ra_exe_unit,
+                                         query_infos,
+                                         column_fetcher,
+                                         co,
+                                         eo,
+                                         *query_mem_descs_owned.at(fallback_device));
+    }
+
     for (const auto target_expr : ra_exe_unit.target_exprs) {
       plan_state_->target_exprs_.push_back(target_expr);
     }
@@ -2030,9 +2174,16 @@ hdk::ResultSetTable Executor::executeWorkUnitImpl(
                                   *query_mem_descs_owned[fallback_device].get(),
                                   exe_policy.get(),
                                   available_gpus,
-                                  available_cpus);
+                                  available_cpus,
+                                  &fragment_specializations);
         }
-        launchKernels(shared_context, std::move(kernels), fallback_device, co);
+        shared_context.setRowLimit(get_early_termination_row_limit(
+            ra_exe_unit, *query_mem_descs_owned.at(fallback_device)));
+        auto launch_clock_begin = timer_start();
+        launchKernels(shared_context, std::move(kernels), fallback_device, co, eo);
+        register_cpu_code_runs(query_comp_descs_owned,
+                               fragment_specializations,
+                               timer_stop(launch_clock_begin));
       } catch (QueryExecutionError& e) {
         if (eo.with_dynamic_watchdog && interrupted_.load() &&
             e.getErrorCode() == ERR_OUT_OF_TIME) {
@@ -2140,7 +2291,10 @@ void Executor::executeWorkUnitPerFragment(
 
   {
     auto clock_begin = timer_start();
-    std::lock_guard<std::mutex> kernel_lock(kernel_mutex_);
+    std::unique_lock<std::mutex> kernel_lock(kernel_mutex_, std::defer_lock);
+    if (!runsConcurrentKernels() || co.device_type != ExecutorDeviceType::CPU) {
+      kernel_lock.lock();
+    }
     kernel_queue_time_ms_ += timer_stop(clock_begin);
 
     for (auto fragment_index : fragment_indexes) {
@@ -2407,6 +2561,104 @@ bool has_lazy_fetched_columns(const std::vector<ColumnLazyFetchInfo>& fetched_co
 
 }  // namespace
 
+FragmentSpecializations Executor::compileFragmentSpecializations(
+    const size_t max_groups_buffer_entry_guess,
+    const int8_t crt_min_byte_width,
+    const bool has_cardinality_estimation,
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const std::vector<InputTableInfo>& query_infos,
+    ColumnFetcher& column_fetcher,
+    const CompilationOptions& co,
+    const ExecutionOptions& eo,
+    const QueryMemoryDescriptor& query_mem_desc) {
+  FragmentSpecializations res;
+  // Without the plan code cache, specialized kernels would be compiled on each run.
+  // Lazy fetch info is kept in the plan state, which is shared by all kernels.
+  if (!plan_code_accessor_ || query_infos.size() != 1 ||
+      (plan_state_->allow_lazy_fetch_ &&
+       has_lazy_fetched_columns(getColLazyFetchInfo(ra_exe_unit.target_exprs)))) {
+    return res;
+  }
+  FragmentSpecializer specializer(ra_exe_unit);
+  if (specializer.empty()) {
+    return res;
+  }
+
+  auto& fragments = query_infos.front().info.fragments;
+  std::unordered_map<std::string, std::vector<size_t>> frags_by_key;
+  for (size_t frag_idx = 0; frag_idx < fragments.size(); ++frag_idx) {
+    auto key = specializer.getKey(fragments[frag_idx]);
+    if (!key.empty()) {
+      frags_by_key[key].push_back(frag_idx);
+    }
+  }
+  // Compile the most used specializations only.
+  std::vector<std::pair<std::string, std::vector<size_t>>> variants(
+      frags_by_key.begin(), frags_by_key.end());
+  std::sort(variants.begin(), variants.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.second.size() > rhs.second.size();
+  });
+  if (variants.size() > config_->exec.codegen.fragment_specialization_max_variants) {
+    variants.resize(config_->exec.codegen.fragment_specialization_max_variants);
+  }
+
+  // Compilation resets the plan state, while kernels use the generic one.
+  auto generic_plan_state = std::move(plan_state_);
+  ScopeGuard restore_plan_state = [this, &generic_plan_state] {
+    plan_state_ = std::move(generic_plan_state);
+  };
+  CompilationOptions spec_co = co;
+  spec_co.device_type = ExecutorDeviceType::CPU;
+  spec_co.allow_lazy_fetch = false;
+  for (auto& [key, frag_ids] : variants) {
+    auto& spec_ra_exe_unit = res.ra_exe_units.emplace_back(specializer.specialize(key));
+    // Kept specializations have the memory layout of the generic kernel, so their
+    // cache key is known before the compilation. Compilation of a cached kernel only
+    // builds the memory layout, IR generation is skipped.
+    if (getPlanCodeCacheKey(
+            spec_ra_exe_unit, query_mem_desc, query_infos, spec_co, eo, false)
+            .empty()) {
+      VLOG(1) << "Skipped fragment specialization " << key
+              << " not supported by the plan code cache.";
+      res.ra_exe_units.pop_back();
+      continue;
+    }
+    auto query_comp_desc = std::make_unique<QueryCompilationDescriptor>();
+    query_comp_desc->setUseGroupByBufferDesc(co.use_groupby_buffer_desc);
+    try {
+      auto groups_buffer_entry_guess = max_groups_buffer_entry_guess;
+      auto spec_query_mem_desc = query_comp_desc->compile(groups_buffer_entry_guess,
+                                                          crt_min_byte_width,
+                                                          has_cardinality_estimation,
+                                                          spec_ra_exe_unit,
+                                                          query_infos,
+                                                          column_fetcher,
+                                                          spec_co,
+                                                          eo,
+                                                          this);
+      if (!spec_query_mem_desc || !(*spec_query_mem_desc == query_mem_desc) ||
+          plan_state_->init_agg_vals_ != generic_plan_state->init_agg_vals_) {
+        VLOG(1) << "Discarded fragment specialization " << key
+                << " with incompatible memory layout.";
+        res.ra_exe_units.pop_back();
+        continue;
+      }
+    } catch (const std::exception& e) {
+      VLOG(1) << "Failed to compile fragment specialization " << key << ": "
+              << e.what();
+      res.ra_exe_units.pop_back();
+      continue;
+    }
+    VLOG(1) << "Compiled fragment specialization " << key << " for "
+            << frag_ids.size() << " fragments.";
+    for (auto frag_id : frag_ids) {
+      res.fragment_comp_descs[frag_id] = query_comp_desc.get();
+    }
+    res.query_comp_descs.emplace_back(std::move(query_comp_desc));
+  }
+  return res;
+}
+
 std::vector<std::unique_ptr<ExecutionKernel>> Executor::createKernels(
     SharedKernelContext& shared_context,
     const RelAlgExecutionUnit& ra_exe_unit,
@@ -2420,7 +2672,8 @@ std::vector<std::unique_ptr<ExecutionKernel>> Executor::createKernels(
     const QueryMemoryDescriptor& query_mem_desc,
     policy::ExecutionPolicy* policy,
     std::unordered_set<int>& available_gpus,
-    int& available_cpus) {
+    int& available_cpus,
+    const FragmentSpecializations* fragment_specializations) {
   std::vector<std::unique_ptr<ExecutionKernel>> execution_kernels;
 
   QueryFragmentDescriptor fragment_descriptor(
@@ -2511,7 +2764,8 @@ std::vector<std::unique_ptr<ExecutionKernel>> Executor::createKernels(
                                          &eo,
                                          &frag_list_idx,
                                          &query_comp_desc,
-                                         &query_mem_desc](
+                                         &query_mem_desc,
+                                         fragment_specializations](
                                             const int device_id,
                                             const FragmentsList& frag_list,
                                             const int64_t rowid_lookup_key,
@@ -2520,6 +2774,15 @@ std::vector<std::unique_ptr<ExecutionKernel>> Executor::createKernels(
         return;
       }
       CHECK_GE(device_id, 0);
+      auto kernel_comp_desc = &query_comp_desc;
+      if (fragment_specializations && frag_list.size() == 1 &&
+          frag_list.front().fragment_ids.size() == 1) {
+        auto& frag_comp_descs = fragment_specializations->fragment_comp_descs;
+        auto it = frag_comp_descs.find(frag_list.front().fragment_ids.front());
+        if (it != frag_comp_descs.end()) {
+          kernel_comp_desc = it->second;
+        }
+      }
       execution_kernels.emplace_back(
           std::make_unique<ExecutionKernel>(ra_exe_unit,
                                             device_type,
@@ -2527,7 +2790,7 @@ std::vector<std::unique_ptr<ExecutionKernel>> Executor::createKernels(
                                             co,
                                             eo,
                                             column_fetcher,
-                                            query_comp_desc,
+                                            *kernel_comp_desc,
                                             query_mem_desc,
                                             frag_list,
                                             ExecutorDispatchMode::KernelPerFragment,
@@ -2637,10 +2900,24 @@ std::vector<std::unique_ptr<ExecutionKernel>> Executor::createHeterogeneousKerne
 void Executor::launchKernels(SharedKernelContext& shared_context,
                              std::vector<std::unique_ptr<ExecutionKernel>>&& kernels,
                              const ExecutorDeviceType device_type,
-                             const CompilationOptions& co) {
+                             const CompilationOptions& co,
+                             const ExecutionOptions& eo) {
   auto clock_begin = timer_start();
-  std::lock_guard<std::mutex> kernel_lock(kernel_mutex_);
+  std::unique_lock<std::mutex> kernel_lock(kernel_mutex_, std::defer_lock);
+  if (!runsConcurrentKernels() || device_type != ExecutorDeviceType::CPU ||
+      config_->exec.heterogeneous.enable_heterogeneous_execution) {
+    kernel_lock.lock();
+  }
   kernel_queue_time_ms_ += timer_stop(clock_begin);
+  const bool is_batch = eo.priority == QueryPriority::Batch;
+  {
+    std::lock_guard<std::mutex> scheduler_lock(kernel_scheduler_mutex_);
+    ++(is_batch ? batch_kernel_queries_ : interactive_kernel_queries_);
+  }
+  ScopeGuard leave_kernel_queries = [is_batch] {
+    std::lock_guard<std::mutex> scheduler_lock(kernel_scheduler_mutex_);
+    --(is_batch ? batch_kernel_queries_ : interactive_kernel_queries_);
+  };
 
   threading::task_group tg;
   // A hack to have unused unit for results collection.
@@ -2659,20 +2936,125 @@ void Executor::launchKernels(SharedKernelContext& shared_context,
     VLOG(1) << "\t" << i << ' ' << (toString(kernels[i])) << ".";
   }
 
-  size_t kernel_idx = 1;
-  for (auto& kernel : kernels) {
+  if (query_progress_) {
+    for (auto& kernel : kernels) {
+      query_progress_->addFragments(kernel->outerFragmentCount());
+    }
+  }
+  // Kernels report processed fragments when they or their sub-tasks complete.
+  shared_context.setQueryProgress(query_progress_);
+
+  // Kernels are taken by workers from a shared queue. The launching thread is a worker
+  // itself and runs kernels until the queue is empty, so the query makes progress
+  // even when no other thread is available (e.g. with the serial threading backend
+  // or a single-threaded TBB arena). Between its kernels, it starts helper workers
+  // up to the query's share of CPU threads (see kernelThreadsShare). Helpers
+  // exceeding the share stop before taking the next kernel, so queries are
+  // rebalanced at kernel boundaries as other queries start and finish.
+  // The scheduler mutex is never held while starting or running workers.
+  const size_t threads = cpu_threads();
+  std::atomic<size_t> next_kernel_idx{0};
+  size_t active_workers = 1;
+  bool failed = false;
+  // Runs the next kernel. Returns false if there are no kernels left to run.
+  auto run_next_kernel = [this, &kernels, &shared_context, &next_kernel_idx, threads] {
+    // Kernels left when a LIMIT query has enough rows are skipped.
+    if (shared_context.rowLimitReached()) {
+      return false;
+    }
+    const size_t kernel_idx = next_kernel_idx++;
+    if (kernel_idx >= kernels.size()) {
+      return false;
+    }
+    auto& kernel = kernels[kernel_idx];
     CHECK(kernel.get());
-    tg.run([this,
-            &kernel,
-            &shared_context,
-            parent_thread_id = logger::thread_id(),
-            crt_kernel_idx = kernel_idx++] {
-      DEBUG_TIMER_NEW_THREAD(parent_thread_id);
-      const size_t thread_i = crt_kernel_idx % cpu_threads();
-      kernel->run(this, thread_i, shared_context);
-    });
-  }
-  tg.wait();
+    const size_t thread_i = (kernel_idx + 1) % threads;
+    kernel->run(this, thread_i, shared_context);
+    return true;
+  };
+  auto worker = [this,
+                 &run_next_kernel,
+                 &active_workers,
+                 &failed,
+                 &eo,
+                 parent_thread_id = logger::thread_id()] {
+    DEBUG_TIMER_NEW_THREAD(parent_thread_id);
+    bool left = false;
+    ScopeGuard leave_workers = [&active_workers, &failed, &left] {
+      if (!left) {
+        // Exception in a kernel.
+        std::lock_guard<std::mutex> scheduler_lock(kernel_scheduler_mutex_);
+        --active_workers;
+        failed = true;
+      }
+    };
+    while (true) {
+      {
+        std::lock_guard<std::mutex> scheduler_lock(kernel_scheduler_mutex_);
+        if (failed || active_workers > kernelThreadsShare(eo)) {
+          --active_workers;
+          left = true;
+          return;
+        }
+      }
+      if (!run_next_kernel()) {
+        std::lock_guard<std::mutex> scheduler_lock(kernel_scheduler_mutex_);
+        --active_workers;
+        left = true;
+        return;
+      }
+    }
+  };
+  std::exception_ptr launcher_error;
+  try {
+    while (true) {
+      size_t new_workers = 0;
+      {
+        std::lock_guard<std::mutex> scheduler_lock(kernel_scheduler_mutex_);
+        if (failed) {
+          break;
+        }
+        const size_t next_idx = std::min(next_kernel_idx.load(), kernels.size());
+        const size_t remaining_kernels = kernels.size() - next_idx;
+        const size_t target_workers =
+            std::min({kernelThreadsShare(eo), remaining_kernels, threads});
+        if (target_workers > active_workers) {
+          new_workers = target_workers - active_workers;
+          active_workers = target_workers;
+        }
+      }
+      for (size_t i = 0; i < new_workers; ++i) {
+        tg.run(worker);
+      }
+      if (!run_next_kernel()) {
+        break;
+      }
+    }
+  } catch (...) {
+    launcher_error = std::current_exception();
+    std::lock_guard<std::mutex> scheduler_lock(kernel_scheduler_mutex_);
+    failed = true;
+  }
+  // Helpers can still run kernels referencing the local state, so wait for them even
+  // if the launching thread failed. TBB runs pending helpers on this thread.
+  try {
+    tg.wait();
+  } catch (...) {
+    if (!launcher_error) {
+      launcher_error = std::current_exception();
+    }
+  }
+  if (launcher_error) {
+    std::rethrow_exception(launcher_error);
+  }
+
+  if (query_progress_) {
+    for (size_t kernel_idx = std::min(next_kernel_idx.load(), kernels.size());
+         kernel_idx < kernels.size();
+         ++kernel_idx) {
+      query_progress_->skipFragments(kernels[kernel_idx]->outerFragmentCount());
+    }
+  }
 
   for (auto& exec_ctx : shared_context.getTlsExecutionContext()) {
     // The first arg is used for GPU only, it's not our case.
@@ -2690,6 +3072,24 @@ void Executor::launchKernels(SharedKernelContext& shared_context,
   }
 }
 
+size_t Executor::kernelThreadsShare(const ExecutionOptions& eo) const {
+  const size_t threads = cpu_threads();
+  size_t share;
+  if (eo.priority == QueryPriority::Interactive) {
+    // Interactive queries split all threads, batch queries keep a single worker
+    // each to make progress.
+    share = threads / std::max(interactive_kernel_queries_, size_t(1));
+  } else if (interactive_kernel_queries_) {
+    share = 1;
+  } else {
+    share = threads / std::max(batch_kernel_queries_, size_t(1));
+  }
+  if (eo.max_threads) {
+    share = std::min(share, eo.max_threads);
+  }
+  return std::max(share, size_t(1));
+}
+
 std::vector<size_t> Executor::getTableFragmentIndices(
     const RelAlgExecutionUnit& ra_exe_unit,
     const ExecutorDeviceType device_type,
@@ -2880,7 +3280,7 @@ FetchResult Executor::fetchChunks(
     std::vector<const int8_t*> frag_col_buffers(
         plan_state_->global_to_local_col_ids_.size());
     for (const auto& col_id : col_global_ids) {
-      if (interrupted_.load()) {
+      if (isInterrupted()) {
         throw QueryExecutionError(ERR_INTERRUPTED);
       }
       CHECK(col_id);
@@ -3020,7 +3420,7 @@ FetchResult Executor::fetchUnionChunks(
         selected_fragments_crossjoin);
 
     for (const auto& selected_frag_ids : frag_ids_crossjoin) {
-      if (interrupted_.load()) {
+      if (isInterrupted()) {
         throw QueryExecutionError(ERR_INTERRUPTED);
       }
       std::vector<const int8_t*> frag_col_buffers(
@@ -3245,7 +3645,7 @@ int32_t Executor::executePlan(const RelAlgExecutionUnit& ra_exe_unit,
   auto hoist_buf = serializeLiterals(compilation_result.literal_values, device_id);
   int32_t error_code = device_type == ExecutorDeviceType::GPU ? 0 : start_rowid;
   const auto join_hash_table_ptrs = getJoinHashTablePtrs(device_type, device_id);
-  if (interrupted_.load()) {
+  if (isInterrupted()) {
     throw QueryExecutionError(ERR_INTERRUPTED);
   }
 
@@ -3269,8 +3669,7 @@ int32_t Executor::executePlan(const RelAlgExecutionUnit& ra_exe_unit,
     std::unique_ptr<OutVecOwner> output_memory_scope;
     std::vector<int64_t*> out_vec;
     if (device_type == ExecutorDeviceType::CPU) {
-      CpuCompilationContext* cpu_generated_code =
-          dynamic_cast<CpuCompilationContext*>(compilation_result.generated_code.get());
+      CompilationContext* cpu_generated_code = compilation_result.generated_code.get();
       CHECK(cpu_generated_code);
       out_vec = query_exe_context->launchCpuCode(ra_exe_unit,
                                                  cpu_generated_code,
@@ -3449,8 +3848,7 @@ int32_t Executor::executePlan(const RelAlgExecutionUnit& ra_exe_unit,
     const int32_t max_matched = scan_limit_for_query == 0
                                     ? query_exe_context->query_mem_desc_.getEntryCount()
                                     : scan_limit_for_query;
-    CpuCompilationContext* cpu_generated_code =
-        dynamic_cast<CpuCompilationContext*>(compilation_result.generated_code.get());
+    CompilationContext* cpu_generated_code = compilation_result.generated_code.get();
     CHECK(cpu_generated_code);
     query_exe_context->launchCpuCode(ra_exe_unit_copy,
                                      cpu_generated_code,
@@ -3600,6 +3998,19 @@ Executor::JoinHashTableOrError Executor::buildHashTableForQualifier(
                                      this,
                                      hashtable_build_dag_map,
                                      table_id_to_node_map);
+    // Hash tables can be cached and reused by other queries and query steps, so each
+    // table is accounted once until the end of the query.
+    if (query_memory_tracker_ && tbl) {
+      const auto device_type = tbl->getMemoryLevel() == MemoryLevel::GPU_LEVEL
+                                   ? ExecutorDeviceType::GPU
+                                   : ExecutorDeviceType::CPU;
+      size_t bytes = 0;
+      for (int device_id = 0; device_id < tbl->getDeviceCount(); ++device_id) {
+        bytes += tbl->getJoinHashBufferSize(device_type, device_id);
+      }
+      query_memory_tracker_->allocateShared(
+          tbl.get(), hdk::QueryMemoryCategory::kHashTables, bytes);
+    }
     return {tbl, ""};
   } catch (const HashJoinFail& e) {
     return {nullptr, e.what()};
@@ -4105,6 +4516,9 @@ void Executor::setupCaching(
     const std::unordered_set<std::pair<int, int>>& phys_table_ids) {
   row_set_mem_owner_ = std::make_shared<RowSetMemoryOwner>(
       data_provider, Executor::getArenaBlockSize(), cpu_threads());
+  if (query_memory_tracker_) {
+    row_set_mem_owner_->setMemoryTracker(query_memory_tracker_);
+  }
   string_dictionary_generations_ = computeStringDictionaryGenerations(col_descs);
   agg_col_range_cache_ = computeColRangesCache(col_descs);
   table_generations_ = computeTableGenerations(phys_table_ids);
@@ -4148,7 +4562,7 @@ bool Executor::checkNonKernelTimeInterrupted() const {
   // this function should be called within an executor which is assigned
   // to the specific query thread (that indicates we already enroll the session)
   // check whether this is called from non unitary executor
-  return interrupted_.load();
+  return isInterrupted();
 }
 
 const std::unique_ptr<llvm::Module>& ExtensionModuleContext::getRTUdfModule(
@@ -4166,6 +4580,9 @@ void* Executor::gpu_active_modules_[max_gpu_count];
 
 std::shared_mutex Executor::register_runtime_extension_functions_mutex_;
 std::mutex Executor::kernel_mutex_;
+std::mutex Executor::kernel_scheduler_mutex_;
+size_t Executor::interactive_kernel_queries_{0};
+size_t Executor::batch_kernel_queries_{0};
 std::atomic<size_t> Executor::executor_id_ctr_{0};
 
 std::unique_ptr<QueryPlanDagCache> Executor::query_plan_dag_cache_;
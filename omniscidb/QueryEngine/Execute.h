@@ -52,11 +52,14 @@
 #include "QueryEngine/Descriptors/QueryFragmentDescriptor.h"
 #include "QueryEngine/ExecutionKernel.h"
 #include "QueryEngine/ExtensionModules.h"
+#include "QueryEngine/FragmentSpecializer.h"
 #include "QueryEngine/GpuSharedMemoryContext.h"
 #include "QueryEngine/JoinHashTable/HashJoin.h"
 #include "QueryEngine/LoopControlFlow/JoinLoop.h"
+#include "QueryEngine/PersistentCodeCache.h"
 #include "QueryEngine/PlanState.h"
 #include "QueryEngine/QueryPlanDagCache.h"
+#include "QueryEngine/QueryProgress.h"
 #include "QueryEngine/RelAlgExecutionUnit.h"
 #include "QueryEngine/RelAlgTranslator.h"
 #include "QueryEngine/RowFuncBuilder.h"
@@ -71,6 +74,7 @@
 #include "ResultSetRegistry/ResultSetTable.h"
 #include "SchemaMgr/SchemaProvider.h"
 #include "Shared/Config.h"
+#include "Shared/QueryMemoryTracker.h"
 #include "Shared/funcannotations.h"
 #include "Shared/mapd_shared_mutex.h"
 #include "Shared/measure.h"
@@ -349,6 +353,12 @@ class Executor : public StringDictionaryProxyProvider {
 
   ConfigPtr getConfigPtr() const { return config_; }
 
+  // Returns the plan code cache shared with helper, step and query executors, or
+  // nullptr if the cache is disabled.
+  CodeCacheAccessor<CompiledPlan>* getPlanCodeAccessor() const {
+    return plan_code_accessor_.get();
+  }
+
   const std::shared_ptr<RowSetMemoryOwner> getRowSetMemoryOwner() const;
 
   TableFragmentsInfo getTableInfo(const int db_id, const int table_id) const;
@@ -368,6 +378,22 @@ class Executor : public StringDictionaryProxyProvider {
   void interrupt();
   void resetInterrupt();
 
+  // Sets the progress of the query run by this executor. Used to report processed
+  // fragments and to check for cancellation.
+  void setQueryProgress(std::shared_ptr<hdk::QueryProgress> query_progress) {
+    query_progress_ = std::move(query_progress);
+  }
+
+  // Sets the memory tracker of the query run by this executor. Memory acquired by
+  // the query is accounted by the tracker and checked against the query limit.
+  void setQueryMemoryTracker(std::shared_ptr<hdk::QueryMemoryTracker> memory_tracker) {
+    query_memory_tracker_ = std::move(memory_tracker);
+  }
+
+  const std::shared_ptr<hdk::QueryMemoryTracker>& getQueryMemoryTracker() const {
+    return query_memory_tracker_;
+  }
+
   static const size_t high_scan_limit{32000000};
 
   int8_t warpSize() const;
@@ -502,7 +528,27 @@ class Executor : public StringDictionaryProxyProvider {
       const QueryMemoryDescriptor& query_mem_desc,
       policy::ExecutionPolicy* policy,
       std::unordered_set<int>& available_gpus,
-      int& available_cpus);
+      int& available_cpus,
+      const FragmentSpecializations* fragment_specializations = nullptr);
+
+  /**
+   * Compiles CPU kernels with filters specialized for groups of fragments sharing
+   * the same chunk stats properties. Only specializations producing the same memory
+   * layout and initial aggregate values as the generic kernel are kept, so that
+   * kernels of all fragments share the output buffers setup and reduction.
+   * Specialized kernels are compiled once and reused through the plan code cache, so
+   * specialization is done only for execution units the cache can hold.
+   */
+  FragmentSpecializations compileFragmentSpecializations(
+      const size_t max_groups_buffer_entry_guess,
+      const int8_t crt_min_byte_width,
+      const bool has_cardinality_estimation,
+      const RelAlgExecutionUnit& ra_exe_unit,
+      const std::vector<InputTableInfo>& query_infos,
+      ColumnFetcher& column_fetcher,
+      const CompilationOptions& co,
+      const ExecutionOptions& eo,
+      const QueryMemoryDescriptor& query_mem_desc);
 
   /**
    * @brief Exprimental execution dispatch mode for heterogeneous kernel submission.
@@ -532,7 +578,12 @@ class Executor : public StringDictionaryProxyProvider {
   void launchKernels(SharedKernelContext& shared_context,
                      std::vector<std::unique_ptr<ExecutionKernel>>&& kernels,
                      const ExecutorDeviceType device_type,
-                     const CompilationOptions& co);
+                     const CompilationOptions& co,
+                     const ExecutionOptions& eo);
+
+  // Returns the number of CPU threads a query with the specified options may use
+  // to run its kernels. Should be called with kernel_scheduler_mutex_ locked.
+  size_t kernelThreadsShare(const ExecutionOptions& eo) const;
 
   std::vector<size_t> getTableFragmentIndices(
       const RelAlgExecutionUnit& ra_exe_unit,
@@ -696,6 +747,22 @@ class Executor : public StringDictionaryProxyProvider {
 
   std::vector<llvm::Value*> inlineHoistedLiterals();
 
+  // Derives the function evaluating only the filter of the row function for batched
+  // kernels. It returns non-zero for rows passing the filter.
+  llvm::Function* createRowFilterFunction();
+
+  // Returns a key of the plan code cache or an empty key if the compiled plan can't be
+  // cached. Plan parameters, which are constants not affecting the generated code, are
+  // returned through params.
+  CodeCacheKey getPlanCodeCacheKey(
+      const RelAlgExecutionUnit& ra_exe_unit,
+      const QueryMemoryDescriptor& query_mem_desc,
+      const std::vector<InputTableInfo>& query_infos,
+      const CompilationOptions& co,
+      const ExecutionOptions& eo,
+      const bool allow_lazy_fetch,
+      std::vector<const hdk::ir::Constant*>* params = nullptr) const;
+
   std::tuple<CompilationResult, std::unique_ptr<QueryMemoryDescriptor>> compileWorkUnit(
       const std::vector<InputTableInfo>& query_infos,
       const RelAlgExecutionUnit& ra_exe_unit,
@@ -858,10 +925,31 @@ class Executor : public StringDictionaryProxyProvider {
 
   ExecutorId getExecutorId() const { return executor_id_; };
 
+  // Returns an executor with the same config and plan code cache which can compile
+  // code concurrently with this executor.
+  std::shared_ptr<Executor> getCompilationHelper(size_t idx);
+
+  // Returns an executor with the same config and plan code cache which can execute
+  // a query step concurrently with this executor.
+  std::shared_ptr<Executor> getStepExecutor(size_t idx);
+
+  // Executor keeps the state of a running query (plan and codegen states, row set
+  // memory owner, metainfo caches). When concurrent queries are enabled, it runs one
+  // query at a time: returns this executor if it is idle, otherwise an idle executor
+  // sharing the config and plan code cache with this one. Queries using run-time UDFs
+  // wait for this executor instead. The executor is released when the returned pointer
+  // is destroyed. Without concurrent queries, always returns this executor.
+  std::shared_ptr<Executor> acquireQueryExecutor();
+
   // check whether the current session that this executor manages is interrupted
   // while performing non-kernel time task
   bool checkNonKernelTimeInterrupted() const;
 
+  // Returns true if the query is interrupted or cancelled through its progress.
+  bool isInterrupted() const {
+    return interrupted_.load() || (query_progress_ && query_progress_->isCancelled());
+  }
+
   // true when we have matched cardinality, and false otherwise
   using CachedCardinality = std::pair<bool, size_t>;
   void addToCardinalityCache(const std::string& cache_key, const size_t cache_value);
@@ -885,6 +973,16 @@ class Executor : public StringDictionaryProxyProvider {
       const std::unordered_map<int, CgenState::LiteralValues>& literals,
       const int device_id);
 
+  // Marks the executor as running a query. Returns nullptr if it is busy and `wait`
+  // is not set. The returned pointer keeps `owner` alive until the release.
+  std::shared_ptr<Executor> lockQueryExecutor(bool wait, std::shared_ptr<Executor> owner);
+
+  // Returns true if CPU kernels of different queries or query steps may run at the
+  // same time, sharing CPU threads, instead of being serialized by the kernel lock.
+  bool runsConcurrentKernels() const {
+    return config_->exec.enable_concurrent_queries || config_->exec.parallel_steps > 1;
+  }
+
   static size_t align(const size_t off_in, const size_t alignment) {
     size_t off = off_in;
     if (off % alignment != 0) {
@@ -947,6 +1045,22 @@ class Executor : public StringDictionaryProxyProvider {
   llvm::Value* spillDoubleElement(llvm::Value* elem_val, llvm::Type* elem_ty);
 
   std::unique_ptr<PlanState> plan_state_;
+  // Compiled CPU kernels keyed by the execution unit, used to skip IR generation.
+  // Unlike the code caches, it is per executor because cached plans depend on the
+  // executor's config. Shared with compilation helpers.
+  std::shared_ptr<CodeCacheAccessor<CompiledPlan>> plan_code_accessor_;
+  // Executors used to compile query steps in background, created on demand.
+  std::vector<std::shared_ptr<Executor>> compilation_helpers_;
+  std::mutex compilation_helpers_mutex_;
+  // Executors running independent query steps concurrently, created on demand.
+  std::vector<std::shared_ptr<Executor>> step_executors_;
+  std::mutex step_executors_mutex_;
+  // Executors running queries concurrently with this one, created on demand.
+  std::vector<std::shared_ptr<Executor>> query_executors_;
+  std::mutex query_executors_mutex_;
+  bool query_running_{false};
+  std::mutex query_running_mutex_;
+  std::condition_variable query_running_cv_;
   std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner_;
   StringDictionaryGenerations string_dictionary_generations_;
 
@@ -958,6 +1072,8 @@ class Executor : public StringDictionaryProxyProvider {
   static void* gpu_active_modules_[max_gpu_count];
   // indicates whether this executor has been interrupted
   std::atomic<bool> interrupted_{false};
+  std::shared_ptr<hdk::QueryProgress> query_progress_;
+  std::shared_ptr<hdk::QueryMemoryTracker> query_memory_tracker_;
 
   mutable std::mutex str_dict_mutex_;
 
@@ -967,6 +1083,8 @@ class Executor : public StringDictionaryProxyProvider {
   static std::unique_ptr<CodeCacheAccessor<CpuCompilationContext>> cpu_code_accessor;
   static std::unique_ptr<CodeCacheAccessor<CompilationContext>> gpu_code_accessor;
   static size_t code_cache_size;  // for re-initializing code caches
+  // optional on-disk cache of CPU kernels, survives resetCodeCache
+  static std::unique_ptr<PersistentCodeCache> persistent_code_cache;
 
   static void
   resetCodeCache();  // ensure code cache is destroyed before tearing down data mgr
@@ -1041,7 +1159,15 @@ class Executor : public StringDictionaryProxyProvider {
   // TODO(adb): move to ExtensionModuleContext?
   static std::shared_mutex register_runtime_extension_functions_mutex_;
 
-  static std::mutex kernel_mutex_;  // TODO: should this be executor-local mutex?
+  // Serializes kernel launches unless concurrent queries are enabled. GPU kernels are
+  // always serialized.
+  static std::mutex kernel_mutex_;
+  // Numbers of interactive and batch queries running kernels concurrently, used to
+  // share CPU threads. Guarded by kernel_scheduler_mutex_. Running queries pick up
+  // changes at kernel boundaries.
+  static std::mutex kernel_scheduler_mutex_;
+  static size_t interactive_kernel_queries_;
+  static size_t batch_kernel_queries_;
 
   static std::atomic<size_t> executor_id_ctr_;
 
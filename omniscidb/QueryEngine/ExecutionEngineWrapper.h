@@ -21,6 +21,7 @@
 
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/ExecutionEngine/JITEventListener.h>
+#include <llvm/ExecutionEngine/ObjectCache.h>
 #include <llvm/IR/Module.h>
 
 struct CompilationOptions;
@@ -46,9 +47,11 @@ class ORCJITExecutionEngineWrapper {
   ORCJITExecutionEngineWrapper(
       std::unique_ptr<llvm::orc::ExecutionSession>&& execution_session,
       llvm::orc::JITTargetMachineBuilder target_machine_builder,
-      std::unique_ptr<llvm::DataLayout> data_layout)
+      std::unique_ptr<llvm::DataLayout> data_layout,
+      std::unique_ptr<llvm::ObjectCache> object_cache = nullptr)
       : execution_session_(std::move(execution_session))
       , data_layout_(std::move(data_layout))
+      , object_cache_(std::move(object_cache))
       , mangle_(std::make_unique<llvm::orc::MangleAndInterner>(*this->execution_session_,
                                                                *data_layout_))
       , object_layer_(std::make_unique<llvm::orc::RTDyldObjectLinkingLayer>(
@@ -58,7 +61,8 @@ class ORCJITExecutionEngineWrapper {
             *execution_session_,
             *object_layer_,
             std::make_unique<llvm::orc::ConcurrentIRCompiler>(
-                std::move(target_machine_builder)))) {
+                std::move(target_machine_builder),
+                object_cache_.get()))) {
 #ifdef _WIN32
     object_layer_->setOverrideObjectFlagsWithResponsibilityFlags(true);
     object_layer_->setAutoClaimResponsibilityForObjectSymbols(true);
@@ -82,14 +86,29 @@ class ORCJITExecutionEngineWrapper {
   ORCJITExecutionEngineWrapper(ORCJITExecutionEngineWrapper&& other) = delete;
 
   void addModule(std::unique_ptr<llvm::Module> module) {
+    addModule(std::move(module), getGlobalLLVMThreadSafeContext());
+  }
+
+  // Adds a module owned by the given context, e.g. a private context of a background
+  // compilation.
+  void addModule(std::unique_ptr<llvm::Module> module,
+                 llvm::orc::ThreadSafeContext context) {
     module->setDataLayout(*data_layout_);
-    llvm::orc::ThreadSafeModule tsm(std::move(module), getGlobalLLVMThreadSafeContext());
+    llvm::orc::ThreadSafeModule tsm(std::move(module), std::move(context));
     auto err = compiler_layer_->add(*main_dylib_, std::move(tsm));
     if (err) {
       LOG(FATAL) << "Cannot add LLVM module: " << llvmErrorToString(err);
     }
   }
 
+  // Adds a precompiled object file, e.g. loaded from the persistent code cache.
+  void addObjectFile(std::unique_ptr<llvm::MemoryBuffer> object) {
+    auto err = object_layer_->add(*main_dylib_, std::move(object));
+    if (err) {
+      LOG(FATAL) << "Cannot add object file: " << llvmErrorToString(err);
+    }
+  }
+
   void* getPointerToFunction(llvm::Function* function) {
     CHECK(function);
     CHECK(execution_session_);
@@ -117,6 +136,7 @@ class ORCJITExecutionEngineWrapper {
  private:
   std::unique_ptr<llvm::orc::ExecutionSession> execution_session_;
   std::unique_ptr<llvm::DataLayout> data_layout_;
+  std::unique_ptr<llvm::ObjectCache> object_cache_;
   std::unique_ptr<llvm::orc::MangleAndInterner> mangle_;
   std::unique_ptr<llvm::orc::RTDyldObjectLinkingLayer> object_layer_;
   std::unique_ptr<llvm::orc::IRCompileLayer> compiler_layer_;
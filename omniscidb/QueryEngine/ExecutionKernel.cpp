@@ -109,6 +109,9 @@ void SharedKernelContext::addDeviceResults(ResultSetPtr&& device_results,
                                            std::vector<size_t> outer_table_fragment_ids) {
   std::lock_guard<std::mutex> lock(reduce_mutex_);
   if (!needs_skip_result(device_results)) {
+    if (row_limit_) {
+      result_rows_ += device_results->rowCount();
+    }
     device_results->setOuterTableId(outer_table_id);
     all_fragment_results_.emplace_back(std::move(device_results),
                                        outer_table_fragment_ids);
@@ -120,6 +123,26 @@ SharedKernelContext::getFragmentResults() {
   return all_fragment_results_;
 }
 
+#ifdef HAVE_TBB
+
+size_t SharedKernelContext::getSubtaskSize(size_t default_size,
+                                           size_t target_time_us) const {
+  constexpr size_t kMinSubtaskSize = 1'024;
+  const uint64_t rows = subtask_rows_.load();
+  const uint64_t time_us = subtask_time_us_.load();
+  if (!target_time_us || !rows || !time_us) {
+    return default_size;
+  }
+  return std::max(static_cast<size_t>(target_time_us * rows / time_us), kMinSubtaskSize);
+}
+
+void SharedKernelContext::addSubtaskStats(size_t num_rows, uint64_t time_us) {
+  subtask_rows_ += num_rows;
+  subtask_time_us_ += time_us;
+}
+
+#endif  // HAVE_TBB
+
 void ExecutionKernel::run(Executor* executor,
                           const size_t thread_idx,
                           SharedKernelContext& shared_context) {
@@ -148,6 +171,9 @@ void ExecutionKernel::run(Executor* executor,
   } catch (const QueryExecutionError& e) {
     throw e;
   }
+  if (!runs_subtasks_) {
+    shared_context.completeFragments(outerFragmentCount());
+  }
 }
 
 std::string ExecutionKernel::toString() const {
@@ -318,42 +344,90 @@ void ExecutionKernel::runImpl(Executor* executor,
 #ifdef HAVE_TBB
   bool can_run_subkernels = shared_context.getThreadPool() != nullptr;
 
-  // Sub-tasks are supported for groupby queries and estimators only for now.
+  // Sub-tasks are supported for groupby queries and estimators, which accumulate
+  // results in thread-local execution contexts, and for non-grouped aggregates, which
+  // produce a single row per sub-task. Projections are not split because their output
+  // buffers are sized for the whole fragment.
   bool is_groupby =
       (ra_exe_unit_.groupby_exprs.size() > 1) ||
       (ra_exe_unit_.groupby_exprs.size() == 1 && ra_exe_unit_.groupby_exprs.front());
-  can_run_subkernels = can_run_subkernels && (is_groupby || ra_exe_unit_.estimator);
+  bool is_non_grouped_agg = query_mem_desc.getQueryDescriptionType() ==
+                            QueryDescriptionType::NonGroupedAggregate;
+  can_run_subkernels = can_run_subkernels &&
+                       (is_groupby || ra_exe_unit_.estimator || is_non_grouped_agg);
 
   // In case some column is lazily fetched, we cannot mix different fragments in a single
   // ResultSet.
   can_run_subkernels =
       can_run_subkernels && !executor->hasLazyFetchColumns(ra_exe_unit_.target_exprs);
 
-  // TODO: Use another structure to hold chunks. Currently, ResultSet holds them, but with
-  // sub-tasks chunk can be referenced by many ResultSets. So, some outer structure to
-  // hold all ResultSets and all chunks is required.
-  can_run_subkernels =
-      can_run_subkernels &&
-      !need_to_hold_chunk(
-          chunks, ra_exe_unit_, std::vector<ColumnLazyFetchInfo>(), chosen_device_type);
-
   // TODO: check for literals? We serialize literals before execution and hold them in
   // result sets. Can we simply do it once and holdin an outer structure?
   if (can_run_subkernels) {
-    size_t total_rows = fetch_result->num_rows[0][0];
-    size_t sub_size = executor->getConfig().exec.sub_tasks.sub_task_size;
-    for (size_t sub_start = start_rowid; sub_start < total_rows; sub_start += sub_size) {
-      sub_size = (sub_start + sub_size > total_rows) ? total_rows - sub_start : sub_size;
-      auto subtask = std::make_shared<KernelSubtask>(*this,
-                                                     shared_context,
-                                                     fetch_result,
-                                                     chunk_iterators_ptr,
-                                                     total_num_input_rows,
-                                                     sub_start,
-                                                     sub_size,
-                                                     thread_idx);
-      shared_context.getThreadPool()->run(
-          [subtask, executor] { subtask->run(executor); });
+    // Sub-task results can reference chunks, which are held by the row set memory
+    // owner shared by all results of the query.
+    if (need_to_hold_chunk(chunks,
+                           ra_exe_unit_,
+                           std::vector<ColumnLazyFetchInfo>(),
+                           chosen_device_type)) {
+      executor->getRowSetMemoryOwner()->holdChunks(chunks, chunk_iterators_ptr);
+    }
+
+    // Workers take row ranges from the fragment until it is fully processed. Workers
+    // of all kernels run in the same task group, so idle threads steal them.
+    const size_t total_rows = fetch_result->num_rows[0][0];
+    const auto& sub_tasks_config = executor->getConfig().exec.sub_tasks;
+    const size_t sub_task_size = std::max(sub_tasks_config.sub_task_size, size_t(1));
+    const size_t target_time_us = sub_tasks_config.sub_task_target_time_us;
+    auto next_rowid = std::make_shared<std::atomic<size_t>>(start_rowid);
+    // The sub-task completing the last rows reports the fragment as processed.
+    auto processed_rows = std::make_shared<std::atomic<size_t>>(0);
+    const size_t rows = total_rows > start_rowid ? total_rows - start_rowid : 0;
+    const size_t first_sub_size =
+        shared_context.getSubtaskSize(sub_task_size, target_time_us);
+    const size_t num_workers = std::min(static_cast<size_t>(cpu_threads()),
+                                        (rows + first_sub_size - 1) / first_sub_size);
+    runs_subtasks_ = num_workers > 0;
+    for (size_t worker_idx = 0; worker_idx < num_workers; ++worker_idx) {
+      shared_context.getThreadPool()->run([this,
+                                           executor,
+                                           &shared_context,
+                                           fetch_result,
+                                           chunk_iterators_ptr,
+                                           total_num_input_rows,
+                                           next_rowid,
+                                           processed_rows,
+                                           rows,
+                                           total_rows,
+                                           sub_task_size,
+                                           target_time_us,
+                                           thread_idx] {
+        while (true) {
+          size_t sub_size = shared_context.getSubtaskSize(sub_task_size, target_time_us);
+          const size_t sub_start = next_rowid->fetch_add(sub_size);
+          if (sub_start >= total_rows) {
+            break;
+          }
+          sub_size = std::min(sub_size, total_rows - sub_start);
+          KernelSubtask subtask(*this,
+                                shared_context,
+                                fetch_result,
+                                chunk_iterators_ptr,
+                                total_num_input_rows,
+                                sub_start,
+                                sub_size,
+                                thread_idx);
+          auto clock_begin = timer_start();
+          subtask.run(executor);
+          shared_context.addSubtaskStats(
+              sub_size,
+              timer_stop<std::chrono::steady_clock::time_point,
+                         std::chrono::microseconds>(clock_begin));
+          if (processed_rows->fetch_add(sub_size) + sub_size == rows) {
+            shared_context.completeFragments(outerFragmentCount());
+          }
+        }
+      });
     }
 
     return;
@@ -477,7 +551,14 @@ void KernelSubtask::run(Executor* executor) {
 }
 
 void KernelSubtask::runImpl(Executor* executor) {
-  auto& query_exe_context_owned = shared_context_.getTlsExecutionContext().local();
+  // Non-grouped aggregates produce a result per sub-task, other queries accumulate
+  // results in thread-local contexts.
+  const bool use_tls_context =
+      !kernel_.ra_exe_unit_.groupby_exprs.empty() || kernel_.ra_exe_unit_.estimator;
+  std::unique_ptr<QueryExecutionContext> local_query_exe_context;
+  auto& query_exe_context_owned = use_tls_context
+                                      ? shared_context_.getTlsExecutionContext().local()
+                                      : local_query_exe_context;
   const CompilationResult& compilation_result =
       kernel_.query_comp_desc.getCompilationResult();
 
@@ -522,11 +603,12 @@ void KernelSubtask::runImpl(Executor* executor) {
   CHECK(query_exe_context);
   int32_t err{0};
 
+  ResultSetPtr device_results;
   if (kernel_.ra_exe_unit_.groupby_exprs.empty()) {
     err = executor->executePlan(kernel_.ra_exe_unit_,
                                 compilation_result,
                                 kernel_.query_comp_desc.hoistLiterals(),
-                                /*device_results=*/nullptr,
+                                use_tls_context ? nullptr : &device_results,
                                 kernel_.chosen_device_type,
                                 kernel_.co,
                                 fetch_result_->col_buffers,
@@ -567,6 +649,10 @@ void KernelSubtask::runImpl(Executor* executor) {
   if (err) {
     throw QueryExecutionError(err);
   }
+  if (device_results) {
+    shared_context_.addDeviceResults(
+        std::move(device_results), outer_table_id, outer_tab_frag_ids);
+  }
 }
 
 #endif  // HAVE_TBB
@@ -19,6 +19,7 @@
 #include "Logger/Logger.h"
 #include "QueryEngine/ColumnFetcher.h"
 #include "QueryEngine/Descriptors/QueryCompilationDescriptor.h"
+#include "QueryEngine/QueryProgress.h"
 
 #include "Compiler/Backend.h"
 #include "Shared/threading.h"
@@ -51,6 +52,23 @@ class SharedKernelContext {
 
   std::atomic_flag dynamic_watchdog_set = ATOMIC_FLAG_INIT;
 
+  // Sets the number of result rows enough for a projection with LIMIT and without
+  // ORDER BY. 0 means all rows are required.
+  void setRowLimit(size_t limit) { row_limit_ = limit; }
+  // Returns true if results collected so far have enough rows, so the remaining
+  // kernels can be skipped.
+  bool rowLimitReached() const { return row_limit_ && result_rows_ >= row_limit_; }
+
+  // Sets the progress to report fragments processed by kernels to.
+  void setQueryProgress(std::shared_ptr<hdk::QueryProgress> query_progress) {
+    query_progress_ = std::move(query_progress);
+  }
+  void completeFragments(size_t count) {
+    if (query_progress_) {
+      query_progress_->completeFragments(count);
+    }
+  }
+
 #ifdef HAVE_TBB
   auto getThreadPool() {
     return task_group_;
@@ -61,6 +79,12 @@ class SharedKernelContext {
   auto& getTlsExecutionContext() {
     return tls_execution_context_;
   }
+
+  // Returns the number of rows to process by the next sub-task. With a non-zero
+  // `target_time_us`, the size is chosen to run sub-tasks for about this time using
+  // the per-row cost measured for completed sub-tasks.
+  size_t getSubtaskSize(size_t default_size, size_t target_time_us) const;
+  void addSubtaskStats(size_t num_rows, uint64_t time_us);
 #endif  // HAVE_TBB
 
  private:
@@ -70,11 +94,16 @@ class SharedKernelContext {
   std::vector<uint64_t> all_frag_row_offsets_;
   std::mutex all_frag_row_offsets_mutex_;
   std::vector<InputTableInfo> query_infos_;
+  size_t row_limit_{0};
+  std::atomic<size_t> result_rows_{0};
+  std::shared_ptr<hdk::QueryProgress> query_progress_;
 
 #ifdef HAVE_TBB
   threading::task_group* task_group_;
   tbb::enumerable_thread_specific<std::unique_ptr<QueryExecutionContext>>
       tls_execution_context_;
+  std::atomic<uint64_t> subtask_rows_{0};
+  std::atomic<uint64_t> subtask_time_us_{0};
 #endif  // HAVE_TBB
 };
 
@@ -111,6 +140,11 @@ class ExecutionKernel {
 
   std::string toString() const;
 
+  // Number of outer table fragments processed by the kernel.
+  size_t outerFragmentCount() const {
+    return frag_list.empty() ? 0 : frag_list[0].fragment_ids.size();
+  }
+
  private:
   const ExecutorDeviceType chosen_device_type;
   int chosen_device_id;
@@ -124,6 +158,8 @@ class ExecutionKernel {
   const int64_t rowid_lookup_key;
 
   ResultSetPtr device_results_;
+  // Set if the fragment is processed by sub-tasks, which report its completion.
+  bool runs_subtasks_{false};
 
   void runImpl(Executor* executor,
                const size_t thread_idx,
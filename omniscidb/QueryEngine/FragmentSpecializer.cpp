@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "FragmentSpecializer.h"
+
+#include "DataMgr/ChunkMetadata.h"
+#include "IR/ExprCollector.h"
+#include "IR/ExprRewriter.h"
+
+#include <set>
+
+namespace {
+
+class NullableColumnsCollector
+    : public hdk::ir::ExprCollector<std::vector<const hdk::ir::ColumnVar*>,
+                                    NullableColumnsCollector> {
+ protected:
+  void visitColumnVar(const hdk::ir::ColumnVar* col_var) override {
+    auto type = col_var->type();
+    if (type->nullable() &&
+        (type->isNumber() || type->isBoolean() || type->isDateTime())) {
+      result_.push_back(col_var);
+    }
+  }
+};
+
+// Makes specified columns non-nullable, which removes null checks from the code
+// generated for expressions using them.
+class NotNullColumnsRewriter : public hdk::ir::ExprRewriter {
+ public:
+  NotNullColumnsRewriter(const std::set<int>& col_ids) : col_ids_(col_ids) {}
+
+ protected:
+  hdk::ir::ExprPtr visitColumnVar(const hdk::ir::ColumnVar* col_var) override {
+    if (col_var->rteIdx() == 0 && col_ids_.count(col_var->columnId())) {
+      return col_var->withType(col_var->type()->withNullable(false));
+    }
+    return defaultResult(col_var);
+  }
+
+ private:
+  const std::set<int>& col_ids_;
+};
+
+const ChunkStats* get_chunk_stats(const FragmentInfo& fragment, int col_id) {
+  auto& chunk_meta_map = fragment.getChunkMetadataMap();
+  auto it = chunk_meta_map.find(col_id);
+  return it == chunk_meta_map.end() ? nullptr : &it->second->chunkStats();
+}
+
+// Returns the column compared with a constant in a supported comparison.
+const hdk::ir::ColumnVar* get_compared_column(const hdk::ir::Expr* expr) {
+  auto bin_oper = expr->as<hdk::ir::BinOper>();
+  if (!bin_oper || !bin_oper->isComparison() || bin_oper->isBwEq()) {
+    return nullptr;
+  }
+  auto col_var = bin_oper->leftOperand()->as<hdk::ir::ColumnVar>();
+  auto constant = bin_oper->rightOperand()->as<hdk::ir::Constant>();
+  if (!col_var || !constant || constant->isNull() || col_var->isVirtual() ||
+      col_var->rteIdx() != 0) {
+    return nullptr;
+  }
+  if (!col_var->type()->isInteger() || !constant->type()->isInteger()) {
+    return nullptr;
+  }
+  return col_var;
+}
+
+}  // namespace
+
+FragmentSpecializer::FragmentSpecializer(const RelAlgExecutionUnit& ra_exe_unit)
+    : ra_exe_unit_(ra_exe_unit) {
+  if (ra_exe_unit.input_descs.size() != 1 || !ra_exe_unit.join_quals.empty()) {
+    return;
+  }
+  bool has_specializable_quals = false;
+  for (auto quals : {&ra_exe_unit.simple_quals, &ra_exe_unit.quals}) {
+    for (auto& qual : *quals) {
+      Qual spec_qual{qual,
+                     quals == &ra_exe_unit.simple_quals,
+                     NullableColumnsCollector::collect(qual)};
+      has_specializable_quals = has_specializable_quals ||
+                                !spec_qual.nullable_cols.empty() ||
+                                get_compared_column(qual.get());
+      quals_.emplace_back(std::move(spec_qual));
+    }
+  }
+  if (!has_specializable_quals) {
+    quals_.clear();
+  }
+}
+
+std::string FragmentSpecializer::getKey(const FragmentInfo& fragment) const {
+  std::string key;
+  bool is_generic = true;
+  for (auto& qual : quals_) {
+    char qual_key = kGeneric;
+    if (alwaysTrue(qual, fragment)) {
+      qual_key = kAlwaysTrue;
+    } else if (!qual.nullable_cols.empty()) {
+      qual_key = kNoNulls;
+      for (auto col_var : qual.nullable_cols) {
+        auto stats = get_chunk_stats(fragment, col_var->columnId());
+        if (!stats || stats->has_nulls) {
+          qual_key = kGeneric;
+          break;
+        }
+      }
+    }
+    is_generic = is_generic && qual_key == kGeneric;
+    key += qual_key;
+  }
+  return is_generic ? std::string() : key;
+}
+
+RelAlgExecutionUnit FragmentSpecializer::specialize(const std::string& key) const {
+  CHECK_EQ(key.size(), quals_.size());
+  std::set<int> not_null_col_ids;
+  for (size_t qual_idx = 0; qual_idx < quals_.size(); ++qual_idx) {
+    if (key[qual_idx] == kNoNulls) {
+      for (auto col_var : quals_[qual_idx].nullable_cols) {
+        not_null_col_ids.insert(col_var->columnId());
+      }
+    }
+  }
+
+  NotNullColumnsRewriter rewriter(not_null_col_ids);
+  RelAlgExecutionUnit res = ra_exe_unit_;
+  res.simple_quals.clear();
+  res.quals.clear();
+  for (size_t qual_idx = 0; qual_idx < quals_.size(); ++qual_idx) {
+    auto& qual = quals_[qual_idx];
+    if (key[qual_idx] == kAlwaysTrue) {
+      continue;
+    }
+    auto expr =
+        key[qual_idx] == kNoNulls ? rewriter.visit(qual.expr.get()) : qual.expr;
+    (qual.is_simple ? res.simple_quals : res.quals).push_back(expr);
+  }
+  return res;
+}
+
+bool FragmentSpecializer::alwaysTrue(const Qual& qual,
+                                     const FragmentInfo& fragment) const {
+  auto col_var = get_compared_column(qual.expr.get());
+  if (!col_var) {
+    return false;
+  }
+  auto stats = get_chunk_stats(fragment, col_var->columnId());
+  // Comparisons with nulls are never true.
+  if (!stats || stats->has_nulls || !fragment.getNumTuples()) {
+    return false;
+  }
+  auto min = extract_min_stat_int_type(*stats, col_var->type());
+  auto max = extract_max_stat_int_type(*stats, col_var->type());
+  if (min > max) {
+    // Invalid metadata range.
+    return false;
+  }
+  auto bin_oper = qual.expr->as<hdk::ir::BinOper>();
+  auto val = bin_oper->rightOperand()->as<hdk::ir::Constant>()->intVal();
+  switch (bin_oper->opType()) {
+    case hdk::ir::OpType::kEq:
+      return min == val && max == val;
+    case hdk::ir::OpType::kNe:
+      return val < min || val > max;
+    case hdk::ir::OpType::kLt:
+      return max < val;
+    case hdk::ir::OpType::kLe:
+      return max <= val;
+    case hdk::ir::OpType::kGt:
+      return min > val;
+    case hdk::ir::OpType::kGe:
+      return min >= val;
+    default:
+      break;
+  }
+  return false;
+}
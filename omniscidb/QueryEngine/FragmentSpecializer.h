@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "DataProvider/TableFragmentsInfo.h"
+#include "QueryEngine/RelAlgExecutionUnit.h"
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class QueryCompilationDescriptor;
+
+/**
+ * Builds execution units with filters specialized for fragments of a single table
+ * using the fragments' chunk stats:
+ *  - comparisons of a column with a constant, which hold for all rows of a fragment,
+ *    are removed from the filter;
+ *  - other filters are evaluated without null checks for columns having no nulls in
+ *    the fragment.
+ * Comparisons which are false for all rows of a fragment are not considered, such
+ * fragments are skipped by the executor.
+ *
+ * Fragments are classified by a key describing the specialization of each filter.
+ * Fragments with the same key are executed by the same specialized kernel. Target
+ * expressions are never changed, so specialized kernels produce results of the same
+ * layout as the generic one.
+ */
+class FragmentSpecializer {
+ public:
+  FragmentSpecializer(const RelAlgExecutionUnit& ra_exe_unit);
+
+  // Returns true if no filter of the unit can be specialized.
+  bool empty() const { return quals_.empty(); }
+
+  // Returns an empty key if the fragment should use the generic kernel.
+  std::string getKey(const FragmentInfo& fragment) const;
+
+  RelAlgExecutionUnit specialize(const std::string& key) const;
+
+ private:
+  static constexpr char kGeneric = 'g';
+  static constexpr char kNoNulls = 'n';
+  static constexpr char kAlwaysTrue = 't';
+
+  struct Qual {
+    hdk::ir::ExprPtr expr;
+    bool is_simple;
+    // Nullable columns referenced by the filter.
+    std::vector<const hdk::ir::ColumnVar*> nullable_cols;
+  };
+
+  bool alwaysTrue(const Qual& qual, const FragmentInfo& fragment) const;
+
+  const RelAlgExecutionUnit& ra_exe_unit_;
+  std::vector<Qual> quals_;
+};
+
+// Kernels compiled for fragment specializations of a query step.
+struct FragmentSpecializations {
+  std::list<RelAlgExecutionUnit> ra_exe_units;
+  std::vector<std::unique_ptr<QueryCompilationDescriptor>> query_comp_descs;
+  // Specialized compilation descriptors by fragment index. Other fragments use the
+  // generic kernel.
+  std::unordered_map<size_t, const QueryCompilationDescriptor*> fragment_comp_descs;
+};
@@ -53,6 +53,15 @@ void Executor::interrupt() {
   if (allow_interrupt) {
     // mark the interrupted status of this executor
     interrupted_.store(true);
+    // and executors running queries submitted to it or its query steps concurrently
+    std::lock_guard<std::mutex> lock(query_executors_mutex_);
+    for (auto& query_executor : query_executors_) {
+      query_executor->interrupted_.store(true);
+    }
+    std::lock_guard<std::mutex> steps_lock(step_executors_mutex_);
+    for (auto& step_executor : step_executors_) {
+      step_executor->interrupted_.store(true);
+    }
   }
 
   // for both GPU and CPU kernel execution, interrupt flag that running kernel accesses
@@ -0,0 +1,332 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "MetadataAggregates.h"
+
+#include "DataMgr/ChunkMetadata.h"
+#include "ResultSet/ResultSet.h"
+#include "Shared/InlineNullValues.h"
+
+namespace hdk {
+
+namespace {
+
+// Types whose stats are compared and aggregated as integers.
+bool is_int_stats_type(const ir::Type* type) {
+  return type->isInteger() || type->isDecimal() || type->isTimestamp() ||
+         type->isTime();
+}
+
+bool is_supported_type(const ir::Type* type) {
+  return is_int_stats_type(type) || type->isFp64();
+}
+
+const ir::ColumnVar* get_column(const ir::Expr* expr) {
+  auto col = expr ? expr->as<ir::ColumnVar>() : nullptr;
+  if (!col || col->rteIdx() || col->isVirtual() || !is_supported_type(col->type())) {
+    return nullptr;
+  }
+  return col;
+}
+
+const ChunkMetadata* get_chunk_metadata(const FragmentInfo& fragment,
+                                        const ir::ColumnVar* col) {
+  const auto& metadata_map = fragment.getChunkMetadataMap();
+  auto it = metadata_map.find(col->columnId());
+  return it == metadata_map.end() ? nullptr : it->second.get();
+}
+
+// Ordered so that the coverage of a conjunction is the minimal coverage of its parts.
+enum class Coverage { kNone, kPartial, kFull };
+
+template <typename T>
+Coverage get_coverage(ir::OpType op_type, T min, T max, T val, bool has_nulls) {
+  // Nulls never pass a comparison, so they prevent full coverage only.
+  bool all = false;
+  bool none = false;
+  switch (op_type) {
+    case ir::OpType::kGe:
+      all = min >= val;
+      none = max < val;
+      break;
+    case ir::OpType::kGt:
+      all = min > val;
+      none = max <= val;
+      break;
+    case ir::OpType::kLe:
+      all = max <= val;
+      none = min > val;
+      break;
+    case ir::OpType::kLt:
+      all = max < val;
+      none = min >= val;
+      break;
+    case ir::OpType::kEq:
+      all = min == val && max == val;
+      none = val < min || val > max;
+      break;
+    case ir::OpType::kNe:
+      all = val < min || val > max;
+      none = min == val && max == val;
+      break;
+    default:
+      return Coverage::kPartial;
+  }
+  if (none) {
+    return Coverage::kNone;
+  }
+  return all && !has_nulls ? Coverage::kFull : Coverage::kPartial;
+}
+
+Coverage get_qual_coverage(const ir::Expr* qual, const FragmentInfo& fragment) {
+  auto bin_oper = qual->as<ir::BinOper>();
+  if (!bin_oper) {
+    return Coverage::kPartial;
+  }
+  auto col = get_column(bin_oper->leftOperand());
+  auto cst = bin_oper->rightOperand()->as<ir::Constant>();
+  // Casts are not expected here, so the constant and the stats should have the same
+  // type, including timestamp units and decimal scales.
+  if (!col || !cst || cst->isNull() ||
+      !col->type()->withNullable(false)->equal(cst->type()->withNullable(false))) {
+    return Coverage::kPartial;
+  }
+  auto metadata = get_chunk_metadata(fragment, col);
+  if (!metadata) {
+    return Coverage::kPartial;
+  }
+  if (!metadata->numElements()) {
+    return Coverage::kNone;
+  }
+  const auto& stats = metadata->chunkStats();
+  if (col->type()->isFp64()) {
+    auto min = extract_min_stat_fp_type(stats, col->type());
+    auto max = extract_max_stat_fp_type(stats, col->type());
+    if (min > max) {
+      // Empty range means all values are nulls.
+      return stats.has_nulls ? Coverage::kNone : Coverage::kPartial;
+    }
+    return get_coverage(bin_oper->opType(), min, max, cst->fpVal(), stats.has_nulls);
+  }
+  auto min = extract_min_stat_int_type(stats, col->type());
+  auto max = extract_max_stat_int_type(stats, col->type());
+  if (min > max) {
+    return stats.has_nulls ? Coverage::kNone : Coverage::kPartial;
+  }
+  return get_coverage(bin_oper->opType(), min, max, cst->intVal(), stats.has_nulls);
+}
+
+template <typename T>
+void update_value(T& agg_val, bool& is_null, ir::AggType agg_type, T val) {
+  if (is_null) {
+    agg_val = val;
+    is_null = false;
+  } else if (agg_type == ir::AggType::kMin) {
+    agg_val = std::min(agg_val, val);
+  } else {
+    CHECK(agg_type == ir::AggType::kMax);
+    agg_val = std::max(agg_val, val);
+  }
+}
+
+Datum make_int_datum(const ir::Type* type, int64_t val) {
+  Datum datum{0};
+  switch (type->size()) {
+    case 1:
+      datum.tinyintval = static_cast<int8_t>(val);
+      break;
+    case 2:
+      datum.smallintval = static_cast<int16_t>(val);
+      break;
+    case 4:
+      datum.intval = static_cast<int32_t>(val);
+      break;
+    case 8:
+      datum.bigintval = val;
+      break;
+    default:
+      CHECK(false);
+  }
+  return datum;
+}
+
+}  // namespace
+
+std::optional<MetadataAggregates> MetadataAggregates::compute(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const std::vector<TargetMetaInfo>& targets_meta,
+    const std::vector<InputTableInfo>& table_infos) {
+  if (ra_exe_unit.input_descs.size() != 1 || table_infos.size() != 1 ||
+      !ra_exe_unit.join_quals.empty() || !ra_exe_unit.quals.empty() ||
+      ra_exe_unit.groupby_exprs.size() != 1 || ra_exe_unit.groupby_exprs.front() ||
+      ra_exe_unit.estimator || ra_exe_unit.union_all ||
+      ra_exe_unit.target_exprs.empty() ||
+      ra_exe_unit.target_exprs.size() != targets_meta.size()) {
+    return std::nullopt;
+  }
+
+  MetadataAggregates res;
+  for (size_t i = 0; i < ra_exe_unit.target_exprs.size(); ++i) {
+    auto agg = ra_exe_unit.target_exprs[i]->as<ir::AggExpr>();
+    if (!agg || agg->isDistinct()) {
+      return std::nullopt;
+    }
+    auto type = targets_meta[i].type();
+    if (!type->withNullable(false)->equal(agg->type()->withNullable(false))) {
+      return std::nullopt;
+    }
+    switch (agg->aggType()) {
+      case ir::AggType::kCount:
+        if (agg->arg() && !get_column(agg->arg())) {
+          return std::nullopt;
+        }
+        break;
+      case ir::AggType::kMin:
+      case ir::AggType::kMax:
+        if (!get_column(agg->arg()) ||
+            !type->withNullable(false)->equal(agg->arg()->type()->withNullable(false))) {
+          return std::nullopt;
+        }
+        break;
+      default:
+        return std::nullopt;
+    }
+    res.aggs_.push_back(agg);
+    res.types_.push_back(type);
+  }
+  res.values_.resize(res.aggs_.size());
+
+  const auto& fragments = table_infos.front().info.fragments;
+  for (size_t frag_idx = 0; frag_idx < fragments.size(); ++frag_idx) {
+    const auto& fragment = fragments[frag_idx];
+    auto coverage = fragment.getNumTuples() ? Coverage::kFull : Coverage::kNone;
+    for (const auto& qual : ra_exe_unit.simple_quals) {
+      if (coverage == Coverage::kNone) {
+        break;
+      }
+      coverage = std::min(coverage, get_qual_coverage(qual.get(), fragment));
+    }
+    if (coverage == Coverage::kFull && !res.addFragment(fragment)) {
+      coverage = Coverage::kPartial;
+    }
+    if (coverage == Coverage::kPartial) {
+      res.fragments_to_scan_.push_back(frag_idx);
+    }
+  }
+  if (!fragments.empty() && res.fragments_to_scan_.size() == fragments.size()) {
+    return std::nullopt;
+  }
+
+  return res;
+}
+
+bool MetadataAggregates::addFragment(const FragmentInfo& fragment) {
+  // Fragment is either fully processed or left for the scan.
+  auto values = values_;
+  for (size_t i = 0; i < aggs_.size(); ++i) {
+    auto agg = aggs_[i];
+    auto& val = values[i];
+    auto col = get_column(agg->arg());
+    auto metadata = col ? get_chunk_metadata(fragment, col) : nullptr;
+    if (col && !metadata) {
+      return false;
+    }
+
+    if (agg->aggType() == ir::AggType::kCount) {
+      // Stats don't have the number of nulls.
+      if (col && col->type()->nullable() && metadata->chunkStats().has_nulls) {
+        return false;
+      }
+      val.int_val += fragment.getNumTuples();
+      val.is_null = false;
+      continue;
+    }
+
+    const auto& stats = metadata->chunkStats();
+    if (col->type()->isFp64()) {
+      auto min = extract_min_stat_fp_type(stats, col->type());
+      auto max = extract_max_stat_fp_type(stats, col->type());
+      if (min > max) {
+        if (stats.has_nulls) {
+          continue;
+        }
+        return false;
+      }
+      update_value(val.fp_val,
+                   val.is_null,
+                   agg->aggType(),
+                   agg->aggType() == ir::AggType::kMin ? min : max);
+    } else {
+      auto min = extract_min_stat_int_type(stats, col->type());
+      auto max = extract_max_stat_int_type(stats, col->type());
+      if (min > max) {
+        if (stats.has_nulls) {
+          continue;
+        }
+        return false;
+      }
+      update_value(val.int_val,
+                   val.is_null,
+                   agg->aggType(),
+                   agg->aggType() == ir::AggType::kMin ? min : max);
+    }
+  }
+  values_ = std::move(values);
+  return true;
+}
+
+void MetadataAggregates::merge(const ResultSet& rs) {
+  CHECK_EQ(rs.rowCount(), size_t(1));
+  auto row = rs.getRowAt(0, /*translate_strings=*/false, /*decimal_to_double=*/false);
+  CHECK_EQ(row.size(), aggs_.size());
+  for (size_t i = 0; i < aggs_.size(); ++i) {
+    auto agg = aggs_[i];
+    auto& val = values_[i];
+    auto scalar = boost::get<ScalarTargetValue>(&row[i]);
+    CHECK(scalar);
+    if (agg->aggType() == ir::AggType::kCount) {
+      auto count = boost::get<int64_t>(scalar);
+      CHECK(count);
+      val.int_val += *count;
+      val.is_null = false;
+    } else if (types_[i]->isFp64()) {
+      auto fp_val = boost::get<double>(scalar);
+      CHECK(fp_val);
+      if (*fp_val != inline_fp_null_value<double>()) {
+        update_value(val.fp_val, val.is_null, agg->aggType(), *fp_val);
+      }
+    } else {
+      auto int_val = boost::get<int64_t>(scalar);
+      CHECK(int_val);
+      if (*int_val != inline_int_null_value(types_[i])) {
+        update_value(val.int_val, val.is_null, agg->aggType(), *int_val);
+      }
+    }
+  }
+}
+
+ir::ExprPtrVector MetadataAggregates::values() const {
+  ir::ExprPtrVector res;
+  for (size_t i = 0; i < aggs_.size(); ++i) {
+    auto type = types_[i];
+    const auto& val = values_[i];
+    if (aggs_[i]->aggType() == ir::AggType::kCount) {
+      res.push_back(ir::Constant::make(type, val.int_val));
+    } else if (val.is_null) {
+      res.push_back(ir::makeExpr<ir::Constant>(type, true, Datum{0}));
+    } else if (type->isFp64()) {
+      Datum datum{0};
+      datum.doubleval = val.fp_val;
+      res.push_back(ir::makeExpr<ir::Constant>(type, false, datum));
+    } else {
+      res.push_back(
+          ir::makeExpr<ir::Constant>(type, false, make_int_datum(type, val.int_val)));
+    }
+  }
+  return res;
+}
+
+}  // namespace hdk
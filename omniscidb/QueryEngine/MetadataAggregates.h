@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "IR/Expr.h"
+#include "QueryEngine/InputMetadata.h"
+#include "QueryEngine/RelAlgExecutionUnit.h"
+#include "QueryEngine/TargetMetaInfo.h"
+
+#include <optional>
+
+class ResultSet;
+
+namespace hdk {
+
+/**
+ * Non-grouped COUNT, MIN and MAX aggregates of a single table computed from fragment
+ * metadata.
+ *
+ * Fragments are classified using simple filter conditions and column stats. Fragments
+ * where all rows pass the filter are aggregated using their row counts and min/max
+ * stats, fragments without passing rows are ignored. Other fragments, and fragments
+ * with stats not enough for some aggregate (e.g. COUNT of a column with nulls), have
+ * to be scanned and the scan result merged.
+ */
+class MetadataAggregates {
+ public:
+  // Returns std::nullopt if the execution unit is not supported or all fragments have
+  // to be scanned anyway.
+  static std::optional<MetadataAggregates> compute(
+      const RelAlgExecutionUnit& ra_exe_unit,
+      const std::vector<TargetMetaInfo>& targets_meta,
+      const std::vector<InputTableInfo>& table_infos);
+
+  // Indices of the outer table fragments to scan.
+  const std::vector<size_t>& fragmentsToScan() const { return fragments_to_scan_; }
+
+  // Merges aggregates computed by the scan of fragmentsToScan().
+  void merge(const ResultSet& rs);
+
+  // Returns aggregate values as constants of the target types.
+  ir::ExprPtrVector values() const;
+
+ private:
+  struct AggValue {
+    bool is_null = true;
+    int64_t int_val = 0;
+    double fp_val = 0;
+  };
+
+  bool addFragment(const FragmentInfo& fragment);
+
+  std::vector<const ir::AggExpr*> aggs_;
+  std::vector<const ir::Type*> types_;
+  std::vector<AggValue> values_;
+  std::vector<size_t> fragments_to_scan_;
+};
+
+}  // namespace hdk
@@ -52,11 +52,15 @@ static_assert(false, "LLVM Version >= 12 is required.");
 #include <llvm/Transforms/Utils.h>
 #include <llvm/Transforms/Utils/BasicBlockUtils.h>
 #include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/Local.h>
 
 #include "CudaMgr/CudaMgr.h"
+#include "IR/ExprRewriter.h"
+#include "IR/ExprVisitor.h"
 #include "QueryEngine/CodeGenerator.h"
 #include "QueryEngine/Compiler/Backend.h"
 #include "QueryEngine/Compiler/HelperFunctions.h"
+#include "QueryEngine/ExpressionRange.h"
 #include "QueryEngine/ExtensionFunctionsWhitelist.h"
 #include "QueryEngine/GpuSharedMemoryUtils.h"
 #include "QueryEngine/LLVMFunctionAttributesUtil.h"
@@ -64,6 +68,7 @@ static_assert(false, "LLVM Version >= 12 is required.");
 #include "QueryEngine/NvidiaKernel.h"
 #include "QueryEngine/OutputBufferInitialization.h"
 #include "QueryEngine/QueryTemplateGenerator.h"
+#include "QueryEngine/VectorizedKernel.h"
 #include "Shared/InlineNullValues.h"
 #include "Shared/MathUtils.h"
 #include "StreamingTopN.h"
@@ -220,9 +225,44 @@ std::shared_ptr<CompilationContext> Executor::optimizeAndCodegenCPU(
     return cached_code;
   }
 
-  std::shared_ptr<CpuCompilationContext> cpu_compilation_context =
-      std::dynamic_pointer_cast<CpuCompilationContext>(
-          backend->generateNativeCode(query_func, nullptr, live_funcs, co));
+  // Objects linked with UDF modules depend on code which is not a part of the key, so
+  // they are not stored on disk.
+  const bool use_persistent_cache =
+      persistent_code_cache && !has_udf_module() && !has_rt_udf_module();
+  CodeCacheKey disk_key;
+  std::unique_ptr<llvm::MemoryBuffer> object;
+  if (use_persistent_cache) {
+    disk_key = key;
+    disk_key.push_back("opt_level=" + std::to_string(static_cast<int>(co.opt_level)));
+    object = persistent_code_cache->load(disk_key);
+  }
+
+  std::shared_ptr<CpuCompilationContext> cpu_compilation_context;
+  if (object) {
+    VLOG(1) << "Loaded CPU kernel from the persistent code cache";
+    cpu_compilation_context =
+        compiler::CPUBackend::loadNativeCPUCode(std::move(object), co);
+  } else if (config_->exec.codegen.enable_tiered_compilation &&
+             co.opt_level == ExecutorOptLevel::Default) {
+    // Only the fully optimized code is stored on disk, after the recompilation.
+    auto tier_up_info = std::make_unique<TierUpInfo>();
+    tier_up_info->co = co;
+    tier_up_info->run_count_threshold = config_->exec.codegen.tier_up_run_count;
+    tier_up_info->run_time_threshold_ms = config_->exec.codegen.tier_up_run_time_ms;
+    if (use_persistent_cache) {
+      tier_up_info->object_cache = persistent_code_cache->makeObjectCache(disk_key);
+    }
+    auto fast_co = co;
+    fast_co.opt_level = ExecutorOptLevel::FastJIT;
+    cpu_compilation_context = compiler::CPUBackend::generateNativeCPUCode(
+        query_func, live_funcs, fast_co, nullptr, std::move(tier_up_info));
+  } else if (use_persistent_cache) {
+    cpu_compilation_context = compiler::CPUBackend::generateNativeCPUCode(
+        query_func, live_funcs, co, persistent_code_cache->makeObjectCache(disk_key));
+  } else {
+    cpu_compilation_context = std::dynamic_pointer_cast<CpuCompilationContext>(
+        backend->generateNativeCode(query_func, nullptr, live_funcs, co));
+  }
   cpu_compilation_context->setFunctionPointer(multifrag_query_func);
   cpu_code_accessor->put(key, cpu_compilation_context);
   return std::dynamic_pointer_cast<CompilationContext>(cpu_compilation_context);
@@ -1314,6 +1354,49 @@ std::vector<llvm::Value*> Executor::inlineHoistedLiterals() {
   return hoisted_literals;
 }
 
+llvm::Function* Executor::createRowFilterFunction() {
+  AUTOMATIC_IR_METADATA(cgen_state_.get());
+
+  // The filter is evaluated either in the row function or in the filter function
+  // called from it. Clone that function and return the filter value instead of
+  // branching on it, which makes the rest of the row processing unreachable.
+  // Short-circuited quals keep returning zero. Error returns of the filter code (e.g.
+  // division by zero or overflow) keep returning their non-zero error codes, so the
+  // row is selected and the row function, evaluating the same filter, reports the
+  // error through the regular error check of the query function.
+  auto filter_br = cgen_state_->filter_br_;
+  CHECK(filter_br && filter_br->isConditional());
+  auto filter_parent = filter_br->getFunction();
+  llvm::ValueToValueMapTy vmap;
+  auto filter_clone = llvm::CloneFunction(filter_parent, vmap);
+  llvm::Value* cloned_br = vmap[filter_br];
+  auto cloned_filter_br = llvm::cast<llvm::BranchInst>(cloned_br);
+  llvm::IRBuilder<> ir_builder(cloned_filter_br);
+  ir_builder.CreateRet(ir_builder.CreateZExt(cloned_filter_br->getCondition(),
+                                             get_int_type(32, cgen_state_->context_)));
+  cloned_filter_br->eraseFromParent();
+  llvm::removeUnreachableBlocks(*filter_clone);
+
+  if (filter_parent == cgen_state_->row_func_) {
+    filter_clone->setName("row_filter_func");
+    return filter_clone;
+  }
+
+  CHECK(filter_parent == cgen_state_->filter_func_);
+  filter_clone->setName("filter_func_row_filter");
+  mark_function_always_inline(filter_clone, cgen_state_->context_);
+  llvm::ValueToValueMapTy row_vmap;
+  auto row_filter_func = llvm::CloneFunction(cgen_state_->row_func_, row_vmap);
+  row_filter_func->setName("row_filter_func");
+  for (auto& inst : llvm::instructions(*row_filter_func)) {
+    auto call = llvm::dyn_cast<llvm::CallInst>(&inst);
+    if (call && call->getCalledFunction() == filter_parent) {
+      call->setCalledFunction(filter_clone);
+    }
+  }
+  return row_filter_func;
+}
+
 namespace {
 
 #ifndef NDEBUG
@@ -1387,6 +1470,312 @@ std::string serialize_llvm_metadata_footnotes(llvm::Function* query_func,
 
 }  // namespace
 
+namespace {
+
+// Returns the constant of a comparison with a column of the same type. Such constants
+// are loaded from the literal buffer and code generation doesn't look at their values,
+// so plans which differ only by them can share the code.
+const hdk::ir::Constant* get_plan_param(const hdk::ir::Expr* expr) {
+  auto bin_oper = expr->as<hdk::ir::BinOper>();
+  if (!bin_oper || !bin_oper->isComparison() || bin_oper->isBwEq()) {
+    return nullptr;
+  }
+  auto col_var = bin_oper->leftOperand()->as<hdk::ir::ColumnVar>();
+  auto constant = bin_oper->rightOperand()->as<hdk::ir::Constant>();
+  if (!col_var) {
+    col_var = bin_oper->rightOperand()->as<hdk::ir::ColumnVar>();
+    constant = bin_oper->leftOperand()->as<hdk::ir::Constant>();
+  }
+  if (!col_var || !constant || constant->isNull() || col_var->isVirtual()) {
+    return nullptr;
+  }
+  auto type = constant->type();
+  if (!type->isInteger() && !type->isDecimal() && !type->isFloatingPoint() &&
+      !type->isDateTime()) {
+    return nullptr;
+  }
+  return type->equal(col_var->type()->withNullable(false)) ? constant : nullptr;
+}
+
+// Replaces values of plan parameters with zeros.
+class PlanParamsMasker : public hdk::ir::ExprRewriter {
+ public:
+  PlanParamsMasker(const std::vector<const hdk::ir::Constant*>& params)
+      : params_(params.begin(), params.end()) {}
+
+ protected:
+  hdk::ir::ExprPtr visitConstant(const hdk::ir::Constant* constant) override {
+    if (params_.count(constant)) {
+      return hdk::ir::makeExpr<hdk::ir::Constant>(constant->type(), false, Datum{});
+    }
+    return defaultResult(constant);
+  }
+
+ private:
+  const std::unordered_set<const hdk::ir::Constant*> params_;
+};
+
+// Checks whether code generated for expressions can be reused by other queries and
+// collects types of visited expressions, which are not a part of their string
+// representation. Code generated for strings and arrays may bake in ids of dictionary
+// strings or refer to dictionary proxies and buffers owned by the current query. Window
+// functions and IN lists refer to contexts and bitmaps built for the current query.
+// With hoisted literals, it also collects plan parameters.
+class PlanCodeCacheKeyBuilder : public hdk::ir::ExprVisitor<void> {
+ public:
+  PlanCodeCacheKeyBuilder(bool collect_params) : collect_params_(collect_params) {}
+
+  void visit(const hdk::ir::Expr* expr) override {
+    if (!cacheable_) {
+      return;
+    }
+    if (collect_params_) {
+      if (auto param = get_plan_param(expr)) {
+        params_.push_back(param);
+      }
+    }
+    auto type = expr->type();
+    types_ += type->toString() + ";";
+    if (type->isString() || type->isExtDictionary() || type->isArray() ||
+        expr->is<hdk::ir::WindowFunction>() || expr->is<hdk::ir::InValues>() ||
+        expr->is<hdk::ir::InIntegerSet>() || expr->is<hdk::ir::InSubquery>() ||
+        expr->is<hdk::ir::ScalarSubquery>()) {
+      cacheable_ = false;
+      return;
+    }
+    ExprVisitor::visit(expr);
+  }
+
+  // Dictionary encoded columns are allowed as group by keys, targets and aggregate
+  // arguments, where only their ids are used.
+  void visitTopLevel(const hdk::ir::Expr* expr) {
+    auto agg = expr->as<hdk::ir::AggExpr>();
+    auto col = agg ? agg->arg() : expr;
+    if (col && col->is<hdk::ir::ColumnVar>() && col->type()->isExtDictionary()) {
+      types_ += expr->type()->toString() + ";";
+      if (agg && agg->arg1()) {
+        visit(agg->arg1());
+      }
+      return;
+    }
+    visit(expr);
+  }
+
+  bool cacheable() const { return cacheable_; }
+
+  const std::string& types() const { return types_; }
+
+  const std::vector<const hdk::ir::Constant*>& params() const { return params_; }
+
+ private:
+  const bool collect_params_;
+  bool cacheable_{true};
+  std::string types_;
+  std::vector<const hdk::ir::Constant*> params_;
+};
+
+// Returns the number of rows in a block of a batched kernel or zero if rows should be
+// processed one at a time. Batching is limited to single table CPU kernels with
+// filters. Scan limit, dynamic watchdog and interrupt checks rely on the row at a time
+// loop.
+size_t get_codegen_batch_size(const RelAlgExecutionUnit& ra_exe_unit,
+                              const CompilationOptions& co,
+                              const ExecutionOptions& eo,
+                              const Config& config) {
+  if (!config.exec.codegen.enable_batch_codegen ||
+      co.device_type != ExecutorDeviceType::CPU) {
+    return 0;
+  }
+  if (ra_exe_unit.input_descs.size() != 1 || !ra_exe_unit.join_quals.empty() ||
+      ra_exe_unit.estimator || ra_exe_unit.scan_limit || eo.with_dynamic_watchdog ||
+      eo.allow_runtime_query_interrupt) {
+    return 0;
+  }
+  if (ra_exe_unit.quals.empty() && ra_exe_unit.simple_quals.empty()) {
+    return 0;
+  }
+  return config.exec.codegen.batch_codegen_size;
+}
+
+// Returns the description of the execution unit with masked values of plan parameters.
+std::string get_plan_desc(const RelAlgExecutionUnit& ra_exe_unit,
+                          const std::vector<const hdk::ir::Constant*>& params) {
+  if (params.empty()) {
+    return ra_exec_unit_desc_for_caching(ra_exe_unit);
+  }
+  PlanParamsMasker masker(params);
+  auto masked_ra_exe_unit = ra_exe_unit;
+  for (auto quals : {&masked_ra_exe_unit.simple_quals, &masked_ra_exe_unit.quals}) {
+    for (auto& qual : *quals) {
+      qual = masker.visit(qual.get());
+    }
+  }
+  return ra_exec_unit_desc_for_caching(masked_ra_exe_unit);
+}
+
+// Returns a key for the plan code cache or an empty key if the execution unit is not
+// cacheable. Besides the execution unit and the memory layout, code generation depends
+// on ranges of input columns (e.g. to skip overflow checks), on fragment counts and on
+// the block size of batched kernels. Values of plan parameters in filters are not a
+// part of the key, but the key tells which parameters are equal, because equal literals
+// share a slot of the literal buffer.
+CodeCacheKey get_plan_code_cache_key(const RelAlgExecutionUnit& ra_exe_unit,
+                                     const QueryMemoryDescriptor& query_mem_desc,
+                                     const std::vector<InputTableInfo>& query_infos,
+                                     const CompilationOptions& co,
+                                     const ExecutionOptions& eo,
+                                     const bool allow_lazy_fetch,
+                                     const Executor* executor,
+                                     std::vector<const hdk::ir::Constant*>* params) {
+  if (co.device_type != ExecutorDeviceType::CPU || eo.just_explain ||
+      ra_exe_unit.input_descs.size() != 1 || !ra_exe_unit.join_quals.empty() ||
+      ra_exe_unit.estimator || ra_exe_unit.union_all) {
+    return {};
+  }
+
+  PlanCodeCacheKeyBuilder key_builder(co.hoist_literals);
+  for (const auto& qual : ra_exe_unit.simple_quals) {
+    key_builder.visit(qual.get());
+  }
+  for (const auto& qual : ra_exe_unit.quals) {
+    key_builder.visit(qual.get());
+  }
+  // Parameters of targets and group by keys are not masked in the description, so only
+  // the ones of filters are used.
+  const auto filter_params = key_builder.params();
+  for (const auto& expr : ra_exe_unit.groupby_exprs) {
+    if (expr) {
+      key_builder.visitTopLevel(expr.get());
+    }
+  }
+  for (const auto expr : ra_exe_unit.target_exprs) {
+    key_builder.visitTopLevel(expr);
+  }
+  if (!key_builder.cacheable()) {
+    return {};
+  }
+
+  std::ostringstream param_groups;
+  std::vector<CgenState::LiteralValue> param_values;
+  for (auto param : filter_params) {
+    auto value = CgenState::getLiteralValue(param, false, 0);
+    param_groups << std::distance(
+                        param_values.begin(),
+                        std::find(param_values.begin(), param_values.end(), value))
+                 << ";";
+    param_values.push_back(std::move(value));
+  }
+
+  std::ostringstream inputs;
+  for (const auto& input_desc : ra_exe_unit.input_descs) {
+    inputs << input_desc.getTableId() << "," << input_desc.getNestLevel() << ";";
+  }
+  for (const auto& query_info : query_infos) {
+    inputs << query_info.info.fragments.size() << ";";
+  }
+  for (const auto& input_col_desc : ra_exe_unit.input_col_descs) {
+    hdk::ir::ColumnVar col_var(input_col_desc->getColInfo(),
+                               input_col_desc->getNestLevel());
+    inputs << getLeafColumnRange(&col_var, query_infos, executor, false).toString()
+           << ";";
+  }
+
+  std::ostringstream options;
+  options << co.hoist_literals << static_cast<int>(co.opt_level)
+          << co.with_dynamic_watchdog << allow_lazy_fetch << co.filter_on_deleted_column
+          << co.use_groupby_buffer_desc << eo.allow_multifrag << eo.with_dynamic_watchdog
+          << eo.allow_runtime_query_interrupt << ";"
+          << static_cast<int>(ra_exe_unit.sort_info.algorithm) << ","
+          << ra_exe_unit.sort_info.limit << "," << ra_exe_unit.sort_info.offset << ";"
+          << get_codegen_batch_size(ra_exe_unit, co, eo, executor->getConfig());
+
+  if (params) {
+    *params = filter_params;
+  }
+  return {get_plan_desc(ra_exe_unit, filter_params),
+          key_builder.types(),
+          param_groups.str(),
+          query_mem_desc.toString(),
+          inputs.str(),
+          options.str()};
+}
+
+// Collects plan parameters after code generation. A parameter is bound by the literal
+// index only if all constants loaded from its literal are parameters, which have equal
+// values as the cache key tells.
+std::vector<PlanParam> get_plan_params(
+    const std::vector<const hdk::ir::Constant*>& params,
+    CgenState* cgen_state) {
+  std::vector<PlanParam> res;
+  if (params.empty()) {
+    return res;
+  }
+  const std::unordered_set<const hdk::ir::Constant*> param_set(params.begin(),
+                                                               params.end());
+  std::unordered_map<size_t, bool> params_only_literals;
+  std::unordered_map<const hdk::ir::Constant*, size_t> param_offsets;
+  for (const auto& [constant, lit_off] : cgen_state->getHoistedConstants(0)) {
+    const bool is_param = param_set.count(constant);
+    auto it = params_only_literals.emplace(lit_off, true).first;
+    it->second = it->second && is_param;
+    if (is_param) {
+      param_offsets[constant] = lit_off;
+    }
+  }
+  const auto& literals = cgen_state->getLiterals();
+  const auto lit_offsets = literals.count(0)
+                               ? CgenState::getLiteralOffsets(literals.at(0))
+                               : std::vector<size_t>{};
+  for (auto param : params) {
+    auto& plan_param = res.emplace_back(
+        PlanParam{std::nullopt, CgenState::getLiteralValue(param, false, 0)});
+    auto it = param_offsets.find(param);
+    if (it != param_offsets.end() && params_only_literals.at(it->second)) {
+      auto idx_it = std::find(lit_offsets.begin(), lit_offsets.end(), it->second);
+      CHECK(idx_it != lit_offsets.end());
+      plan_param.literal_idx = std::distance(lit_offsets.begin(), idx_it);
+    }
+  }
+  return res;
+}
+
+// Writes values of plan parameters to literals of the cached plan. Returns false if the
+// cached code depends on a different value of some parameter.
+bool bind_plan_params(const std::vector<PlanParam>& plan_params,
+                      const std::vector<const hdk::ir::Constant*>& params,
+                      std::unordered_map<int, CgenState::LiteralValues>& literal_values) {
+  CHECK_EQ(plan_params.size(), params.size());
+  for (size_t param_idx = 0; param_idx < params.size(); ++param_idx) {
+    auto value = CgenState::getLiteralValue(params[param_idx], false, 0);
+    auto& plan_param = plan_params[param_idx];
+    if (plan_param.literal_idx) {
+      auto& literals = literal_values.at(0);
+      CHECK_LT(*plan_param.literal_idx, literals.size());
+      literals[*plan_param.literal_idx] = std::move(value);
+    } else if (!(value == plan_param.value)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+CodeCacheKey Executor::getPlanCodeCacheKey(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const QueryMemoryDescriptor& query_mem_desc,
+    const std::vector<InputTableInfo>& query_infos,
+    const CompilationOptions& co,
+    const ExecutionOptions& eo,
+    const bool allow_lazy_fetch,
+    std::vector<const hdk::ir::Constant*>* params) const {
+  if (!plan_code_accessor_ || has_udf_module() || has_rt_udf_module()) {
+    return {};
+  }
+  return get_plan_code_cache_key(
+      ra_exe_unit, query_mem_desc, query_infos, co, eo, allow_lazy_fetch, this, params);
+}
+
 std::tuple<CompilationResult, std::unique_ptr<QueryMemoryDescriptor>>
 Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
                           const RelAlgExecutionUnit& ra_exe_unit,
@@ -1462,6 +1851,59 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
 
   const GpuSharedMemoryContext gpu_smem_context(shared_memory_size);
 
+  std::vector<const hdk::ir::Constant*> plan_params;
+  auto plan_key = getPlanCodeCacheKey(
+      ra_exe_unit, *query_mem_desc, query_infos, co, eo, allow_lazy_fetch, &plan_params);
+  bool replace_cached_plan = false;
+  if (!plan_key.empty()) {
+    if (auto cached_plan = plan_code_accessor_->get_value(plan_key)) {
+      auto compilation_result = cached_plan->compilation_result;
+      if (bind_plan_params(
+              cached_plan->params, plan_params, compilation_result.literal_values)) {
+        VLOG(1) << "Reusing compiled plan, IR generation is skipped";
+        plan_state_->allocateLocalColumnIds(ra_exe_unit.input_col_descs);
+        for (auto& simple_qual : ra_exe_unit.simple_quals) {
+          plan_state_->addSimpleQual(simple_qual);
+        }
+        plan_state_->init_agg_vals_ = cached_plan->init_agg_vals;
+        plan_state_->columns_to_fetch_ = cached_plan->columns_to_fetch;
+        plan_state_->columns_to_not_fetch_ = cached_plan->columns_to_not_fetch;
+        return std::make_tuple(
+            std::move(compilation_result),
+            std::make_unique<QueryMemoryDescriptor>(cached_plan->query_mem_desc));
+      }
+      VLOG(1) << "Cached plan has different constants in the code, recompiling";
+      replace_cached_plan = true;
+    }
+  }
+
+  if (co.device_type == ExecutorDeviceType::CPU && !eo.just_explain &&
+      config_->exec.codegen.enable_vectorized_interpreter && !has_udf_module() &&
+      !has_rt_udf_module() && !query_infos.empty()) {
+    const auto num_tuples = query_infos.front().info.getNumTuplesUpperBound();
+    if (num_tuples <= config_->exec.codegen.vectorized_interpreter_max_rows) {
+      const bool bigint_count = config_->exec.group_by.bigint_count;
+      if (auto kernel =
+              VectorizedKernel::build(ra_exe_unit, *query_mem_desc, eo, bigint_count)) {
+        VLOG(1) << "Using vectorized kernel for " << num_tuples
+                << " rows, code generation is skipped";
+        plan_state_->allocateLocalColumnIds(ra_exe_unit.input_col_descs);
+        for (auto& simple_qual : ra_exe_unit.simple_quals) {
+          plan_state_->addSimpleQual(simple_qual);
+        }
+        kernel->bindColumns(plan_state_.get());
+        plan_state_->init_agg_vals_ = init_agg_val_vec(
+            ra_exe_unit.target_exprs, ra_exe_unit.quals, *query_mem_desc, bigint_count);
+        return std::make_tuple(CompilationResult{std::move(kernel),
+                                                 {},
+                                                 query_mem_desc->didOutputColumnar(),
+                                                 "",
+                                                 std::move(gpu_smem_context)},
+                               std::move(query_mem_desc));
+      }
+    }
+  }
+
   compiler::setSharedMemory(
       co.device_type, gpu_smem_context.isSharedMemoryUsed(), target, backend);
 
@@ -1519,15 +1961,23 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
 
   const auto agg_slot_count = ra_exe_unit.estimator ? size_t(1) : agg_fnames.size();
 
-  auto [query_func, row_func_call] = query_template(cgen_state_->module_,
-                                                    agg_slot_count,
-                                                    !!ra_exe_unit.estimator,
-                                                    co_codegen_traits.hoist_literals,
-                                                    *query_mem_desc,
-                                                    co_codegen_traits.device_type,
-                                                    ra_exe_unit.scan_limit,
-                                                    gpu_smem_context,
-                                                    traits);
+  const size_t batch_size =
+      get_codegen_batch_size(ra_exe_unit, co_codegen_traits, eo, getConfig());
+  if (batch_size) {
+    VLOG(1) << "Generating batched kernel with " << batch_size << " rows per block";
+  }
+
+  auto [query_func, row_func_call, row_filter_call] =
+      query_template(cgen_state_->module_,
+                     agg_slot_count,
+                     !!ra_exe_unit.estimator,
+                     co_codegen_traits.hoist_literals,
+                     *query_mem_desc,
+                     co_codegen_traits.device_type,
+                     ra_exe_unit.scan_limit,
+                     batch_size,
+                     gpu_smem_context,
+                     traits);
 
   bind_pos_placeholders("pos_start", true, query_func, cgen_state_->module_);
   bind_pos_placeholders("group_buff_idx", false, query_func, cgen_state_->module_);
@@ -1653,6 +2103,23 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
         llvm::CallInst::Create(cgen_state_->filter_func_, filter_func_args, ""));
   }
 
+  // replace the row filter placeholder call of a batched kernel with the call to the
+  // row filter func, which takes the same arguments as the row func
+  llvm::Function* row_filter_func{nullptr};
+  if (row_filter_call) {
+    row_filter_func = createRowFilterFunction();
+    std::vector<llvm::Value*> row_filter_args;
+    for (size_t i = 0; i < LLVM_NUM_OPERANDS(row_filter_call); ++i) {
+      row_filter_args.push_back(row_filter_call->getArgOperand(i));
+    }
+    row_filter_args.insert(row_filter_args.end(), col_heads.begin(), col_heads.end());
+    row_filter_args.push_back(get_arg_by_name(query_func, "join_hash_tables"));
+    row_filter_args.insert(
+        row_filter_args.end(), hoisted_literals.begin(), hoisted_literals.end());
+    llvm::ReplaceInstWithInst(
+        row_filter_call, llvm::CallInst::Create(row_filter_func, row_filter_args, ""));
+  }
+
   // Aggregate
   plan_state_->init_agg_vals_ = init_agg_val_vec(ra_exe_unit.target_exprs,
                                                  ra_exe_unit.quals,
@@ -1712,6 +2179,9 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
   if (cgen_state_->filter_func_) {
     root_funcs.push_back(cgen_state_->filter_func_);
   }
+  if (row_filter_func) {
+    root_funcs.push_back(row_filter_func);
+  }
   auto live_funcs = CodeGenerator::markDeadRuntimeFuncs(
       *cgen_state_->module_, root_funcs, {multifrag_query_func});
 
@@ -1723,6 +2193,9 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
   if (cgen_state_->filter_func_) {
     mark_function_always_inline(cgen_state_->filter_func_, cgen_state_->context_);
   }
+  if (row_filter_func) {
+    mark_function_always_inline(row_filter_func, cgen_state_->context_);
+  }
 
 #ifndef NDEBUG
   // Add helpful metadata to the LLVM IR for debugging.
@@ -1750,7 +2223,8 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
         serialize_llvm_object(multifrag_query_func) + serialize_llvm_object(query_func) +
         serialize_llvm_object(cgen_state_->row_func_) +
         (cgen_state_->filter_func_ ? serialize_llvm_object(cgen_state_->filter_func_)
-                                   : "");
+                                   : "") +
+        (row_filter_func ? serialize_llvm_object(row_filter_func) : "");
 
 #ifndef NDEBUG
     llvm_ir += serialize_llvm_metadata_footnotes(query_func, cgen_state_.get());
@@ -1794,23 +2268,31 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
   }
 
   // Generate final native code from the LLVM IR.
-  return std::make_tuple(
-      CompilationResult{co.device_type == ExecutorDeviceType::CPU
-                            ? optimizeAndCodegenCPU(query_func,
-                                                    multifrag_query_func,
-                                                    backend,
-                                                    live_funcs,
-                                                    co_codegen_traits)
-                            : optimizeAndCodegenGPU(query_func,
-                                                    multifrag_query_func,
-                                                    backend,
-                                                    live_funcs,
-                                                    co_codegen_traits),
-                        cgen_state_->getLiterals(),
-                        output_columnar,
-                        llvm_ir,
-                        std::move(gpu_smem_context)},
-      std::move(query_mem_desc));
+  CompilationResult compilation_result{
+      co.device_type == ExecutorDeviceType::CPU
+          ? optimizeAndCodegenCPU(
+                query_func, multifrag_query_func, backend, live_funcs, co_codegen_traits)
+          : optimizeAndCodegenGPU(
+                query_func, multifrag_query_func, backend, live_funcs, co_codegen_traits),
+      cgen_state_->getLiterals(),
+      output_columnar,
+      llvm_ir,
+      std::move(gpu_smem_context)};
+  if (!plan_key.empty()) {
+    auto compiled_plan = std::make_shared<CompiledPlan>(
+        CompiledPlan{compilation_result,
+                     *query_mem_desc,
+                     plan_state_->init_agg_vals_,
+                     plan_state_->columns_to_fetch_,
+                     plan_state_->columns_to_not_fetch_,
+                     get_plan_params(plan_params, cgen_state_.get())});
+    if (replace_cached_plan) {
+      plan_code_accessor_->replace(plan_key, compiled_plan);
+    } else {
+      plan_code_accessor_->put(plan_key, compiled_plan);
+    }
+  }
+  return std::make_tuple(std::move(compilation_result), std::move(query_mem_desc));
 }
 
 void Executor::insertErrorCodeChecker(llvm::Function* query_func,
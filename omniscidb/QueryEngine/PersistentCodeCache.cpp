@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "QueryEngine/PersistentCodeCache.h"
+
+#include "Logger/Logger.h"
+#include "MapDRelease.h"
+
+#include <llvm/ADT/StringMap.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Object/ObjectFile.h>
+#include <llvm/Support/Host.h>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <string_view>
+
+namespace {
+
+constexpr char kEntryMagic[8] = {'H', 'D', 'K', 'J', 'I', 'T', 'C', '1'};
+
+// Objects are only valid for the build which generated them (runtime functions are
+// compiled into objects) and for the CPU they were compiled for.
+std::string get_host_tag() {
+  std::string tag = MAPD_RELEASE + ";llvm-" + LLVM_VERSION_STRING + ";" +
+                    llvm::sys::getHostCPUName().str();
+  llvm::StringMap<bool> features;
+  if (llvm::sys::getHostCPUFeatures(features)) {
+    std::vector<std::string> enabled_features;
+    for (const auto& feature : features) {
+      if (feature.second) {
+        enabled_features.push_back(feature.first().str());
+      }
+    }
+    std::sort(enabled_features.begin(), enabled_features.end());
+    for (const auto& feature : enabled_features) {
+      tag += ";+" + feature;
+    }
+  }
+  return tag;
+}
+
+void write_string(std::ostream& out, const std::string_view str) {
+  const uint64_t size = str.size();
+  out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  out.write(str.data(), size);
+}
+
+bool read_uint64(const std::string& data, size_t& pos, uint64_t& val) {
+  if (data.size() - pos < sizeof(val)) {
+    return false;
+  }
+  memcpy(&val, data.data() + pos, sizeof(val));
+  pos += sizeof(val);
+  return true;
+}
+
+bool read_string(const std::string& data, size_t& pos, std::string_view& str) {
+  uint64_t size;
+  if (!read_uint64(data, pos, size) || data.size() - pos < size) {
+    return false;
+  }
+  str = std::string_view(data.data() + pos, size);
+  pos += size;
+  return true;
+}
+
+class ObjectCacheWriter : public llvm::ObjectCache {
+ public:
+  ObjectCacheWriter(const PersistentCodeCache& cache, const CodeCacheKey& key)
+      : cache_(cache), key_(key) {}
+
+  void notifyObjectCompiled(const llvm::Module*, llvm::MemoryBufferRef object) override {
+    cache_.store(key_, object);
+  }
+
+  // Cached objects are loaded before compilation is requested.
+  std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module*) override {
+    return nullptr;
+  }
+
+ private:
+  const PersistentCodeCache& cache_;
+  const CodeCacheKey key_;
+};
+
+}  // namespace
+
+PersistentCodeCache::PersistentCodeCache(const std::string& dir)
+    : dir_(dir), tag_(get_host_tag()) {
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(dir_, ec);
+  if (ec) {
+    throw std::runtime_error("Cannot create code cache directory " + dir_ + ": " +
+                             ec.message());
+  }
+  VLOG(1) << "Using persistent code cache in " << dir_ << " with tag " << tag_;
+}
+
+std::unique_ptr<llvm::MemoryBuffer> PersistentCodeCache::load(
+    const CodeCacheKey& key) const {
+  const auto path = entryPath(key);
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return nullptr;
+  }
+  const std::string data((std::istreambuf_iterator<char>(in)),
+                         std::istreambuf_iterator<char>());
+  in.close();
+
+  size_t pos = sizeof(kEntryMagic);
+  std::string_view tag;
+  uint64_t key_size = 0;
+  bool valid = data.size() >= pos && !memcmp(data.data(), kEntryMagic, pos) &&
+               read_string(data, pos, tag) && tag == tag_ &&
+               read_uint64(data, pos, key_size) && key_size == key.size();
+  for (size_t i = 0; valid && i < key.size(); ++i) {
+    std::string_view key_part;
+    valid = read_string(data, pos, key_part) && key_part == key[i];
+  }
+  std::string_view object;
+  valid = valid && read_string(data, pos, object) && pos == data.size();
+
+  std::unique_ptr<llvm::MemoryBuffer> buffer;
+  if (valid) {
+    buffer = llvm::MemoryBuffer::getMemBufferCopy(
+        llvm::StringRef(object.data(), object.size()), path);
+    auto object_or_err =
+        llvm::object::ObjectFile::createObjectFile(buffer->getMemBufferRef());
+    if (!object_or_err) {
+      llvm::consumeError(object_or_err.takeError());
+      valid = false;
+    }
+  }
+  if (!valid) {
+    VLOG(1) << "Removing stale code cache entry " << path;
+    boost::system::error_code ec;
+    boost::filesystem::remove(path, ec);
+    return nullptr;
+  }
+  return buffer;
+}
+
+std::unique_ptr<llvm::ObjectCache> PersistentCodeCache::makeObjectCache(
+    const CodeCacheKey& key) const {
+  return std::make_unique<ObjectCacheWriter>(*this, key);
+}
+
+void PersistentCodeCache::store(const CodeCacheKey& key,
+                                llvm::MemoryBufferRef object) const {
+  const auto path = entryPath(key);
+  // Write to a temporary file and rename it, so that concurrent readers, possibly in
+  // other processes, never see a partially written entry.
+  const auto tmp_path =
+      path + "." + boost::filesystem::unique_path("%%%%-%%%%-%%%%").string() + ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    out.write(kEntryMagic, sizeof(kEntryMagic));
+    write_string(out, tag_);
+    const uint64_t key_size = key.size();
+    out.write(reinterpret_cast<const char*>(&key_size), sizeof(key_size));
+    for (const auto& key_part : key) {
+      write_string(out, key_part);
+    }
+    write_string(out, {object.getBufferStart(), object.getBufferSize()});
+    out.close();
+    if (!out) {
+      LOG(WARNING) << "Cannot write code cache entry " << tmp_path;
+      boost::system::error_code ec;
+      boost::filesystem::remove(tmp_path, ec);
+      return;
+    }
+  }
+  boost::system::error_code ec;
+  boost::filesystem::rename(tmp_path, path, ec);
+  if (ec) {
+    LOG(WARNING) << "Cannot store code cache entry " << path << ": " << ec.message();
+    boost::filesystem::remove(tmp_path, ec);
+  }
+}
+
+std::string PersistentCodeCache::entryPath(const CodeCacheKey& key) const {
+  size_t hash = boost::hash_value(key);
+  boost::hash_combine(hash, tag_);
+  std::ostringstream file_name;
+  file_name << std::hex << std::setw(16) << std::setfill('0') << hash << ".o.cache";
+  return (boost::filesystem::path(dir_) / file_name.str()).string();
+}
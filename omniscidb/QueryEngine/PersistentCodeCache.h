@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "QueryEngine/CodeCache.h"
+
+#include <llvm/ExecutionEngine/ObjectCache.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <memory>
+#include <string>
+
+/**
+ * On-disk cache of native objects produced by the CPU JIT, shared across process
+ * restarts. Entries are keyed by the code cache key and tagged with the HDK build,
+ * LLVM version and host CPU features. An entry whose tag or key doesn't match, or
+ * which fails to parse, is treated as missing and removed, so a stale or corrupted
+ * cache can only cost a recompilation.
+ */
+class PersistentCodeCache {
+ public:
+  PersistentCodeCache(const std::string& dir);
+
+  // Returns the cached object file for the key or nullptr.
+  std::unique_ptr<llvm::MemoryBuffer> load(const CodeCacheKey& key) const;
+
+  // Returns an object cache to pass to the JIT compiler. It stores the compiled object
+  // under the key.
+  std::unique_ptr<llvm::ObjectCache> makeObjectCache(const CodeCacheKey& key) const;
+
+  void store(const CodeCacheKey& key, llvm::MemoryBufferRef object) const;
+
+ private:
+  std::string entryPath(const CodeCacheKey& key) const;
+
+  const std::string dir_;
+  const std::string tag_;
+};
@@ -0,0 +1,438 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "PreparedQuery.h"
+#include "Logger/Logger.h"
+#include "QueryEngine/RelAlgDagBuilder.h"
+#include "Shared/scope.h"
+
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace hdk {
+
+namespace {
+
+// Marker values are far from values met in queries, so literals close to them can
+// only come from folding of expressions with markers. Integer parameters fitting INT
+// and the ones requiring BIGINT use different markers, so the literal types in the
+// template match the ones of parameter values.
+constexpr int64_t kIntMarkerBase = 2'046'820'351;
+constexpr int64_t kIntMarkerVicinity = int64_t(1) << 20;
+constexpr int64_t kBigIntMarkerBase = 7'205'759'403'792'793'599;
+constexpr int64_t kBigIntMarkerVicinity = int64_t(1) << 32;
+// Numbers of this magnitude are exactly representable with a half fraction.
+constexpr double kFpMarkerBase = 2'251'799'813'685'248.5;
+constexpr double kFpMarkerVicinity = 1 << 20;
+const std::string kStrMarkerPrefix = "hdk$param$";
+
+int64_t int_marker(size_t idx, bool big_int) {
+  return (big_int ? kBigIntMarkerBase : kIntMarkerBase) + static_cast<int64_t>(idx);
+}
+
+double fp_marker(size_t idx) {
+  return kFpMarkerBase + static_cast<double>(idx);
+}
+
+std::string str_marker(size_t idx) {
+  return kStrMarkerPrefix + std::to_string(idx) + "$";
+}
+
+std::string fp_to_sql(double val) {
+  if (!std::isfinite(val)) {
+    throw std::runtime_error("Cannot bind non-finite floating point query parameter.");
+  }
+  // Exponent makes Calcite parse the literal as DOUBLE rather than DECIMAL.
+  std::ostringstream ss;
+  ss << std::scientific << std::setprecision(17) << val;
+  return ss.str();
+}
+
+std::string str_to_sql(const std::string& val) {
+  std::string res = "'";
+  for (auto c : val) {
+    if (c == '\'') {
+      res += '\'';
+    }
+    res += c;
+  }
+  res += '\'';
+  return res;
+}
+
+bool is_bindable(const std::vector<QueryParameter>& params) {
+  for (auto& param : params) {
+    if (param.kind() == QueryParameter::Kind::kNull ||
+        param.kind() == QueryParameter::Kind::kBoolean) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Calcite types integer literals out of the INT range as BIGINT.
+bool is_big_int(const QueryParameter& param) {
+  return param.kind() == QueryParameter::Kind::kInteger &&
+         (param.intVal() <= std::numeric_limits<int32_t>::min() ||
+          param.intVal() > std::numeric_limits<int32_t>::max());
+}
+
+std::string get_template_key(const std::vector<QueryParameter>& params) {
+  std::string res;
+  for (auto& param : params) {
+    res += is_big_int(param) ? 'b'
+                             : static_cast<char>('0' + static_cast<int>(param.kind()));
+  }
+  return res;
+}
+
+}  // namespace
+
+QueryParameter QueryParameter::boolean(bool val) {
+  QueryParameter res(Kind::kBoolean);
+  res.bool_val_ = val;
+  return res;
+}
+
+QueryParameter QueryParameter::integer(int64_t val) {
+  QueryParameter res(Kind::kInteger);
+  res.int_val_ = val;
+  return res;
+}
+
+QueryParameter QueryParameter::fp(double val) {
+  QueryParameter res(Kind::kFloatingPoint);
+  res.fp_val_ = val;
+  return res;
+}
+
+QueryParameter QueryParameter::string(std::string val) {
+  QueryParameter res(Kind::kString);
+  res.str_val_ = std::move(val);
+  return res;
+}
+
+std::string QueryParameter::toSql() const {
+  switch (kind_) {
+    case Kind::kNull:
+      return "NULL";
+    case Kind::kBoolean:
+      return bool_val_ ? "TRUE" : "FALSE";
+    case Kind::kInteger:
+      return std::to_string(int_val_);
+    case Kind::kFloatingPoint:
+      return fp_to_sql(fp_val_);
+    case Kind::kString:
+      return str_to_sql(str_val_);
+  }
+  UNREACHABLE();
+  return "";
+}
+
+struct PreparedQuery::Template {
+  // Indices of array elements and object members leading to a value. Paths stay valid
+  // in copies of the document.
+  using ValuePath = std::vector<rapidjson::SizeType>;
+
+  rapidjson::Document ra;
+  // Paths to literal objects holding markers of each parameter. Empty if markers
+  // couldn't be located in the RA or the template SQL failed to translate.
+  std::vector<std::vector<ValuePath>> literals;
+  std::vector<std::string> str_markers;
+
+  // Unusable template.
+  Template() {}
+
+  Template(const std::string& query_ra, size_t param_count) {
+    ra.Parse(query_ra.c_str());
+    if (ra.HasParseError()) {
+      throw std::runtime_error("Failed to parse relational algebra of the query.");
+    }
+    for (size_t idx = 0; idx < param_count; ++idx) {
+      str_markers.emplace_back(str_marker(idx));
+    }
+    literals.resize(param_count);
+    ValuePath path;
+    if (!collectLiterals(ra, path)) {
+      literals.clear();
+      return;
+    }
+    for (auto& param_literals : literals) {
+      if (param_literals.empty()) {
+        literals.clear();
+        return;
+      }
+    }
+  }
+
+  bool usable() const { return !literals.empty(); }
+
+  // Returns false if a literal derived from a marker is met.
+  bool collectLiterals(const rapidjson::Value& val, ValuePath& path) {
+    if (val.IsArray()) {
+      for (rapidjson::SizeType idx = 0; idx < val.Size(); ++idx) {
+        path.push_back(idx);
+        ScopeGuard pop_path = [&path] { path.pop_back(); };
+        if (!collectLiterals(val[idx], path)) {
+          return false;
+        }
+      }
+    } else if (val.IsObject()) {
+      auto literal_it = val.FindMember("literal");
+      if (literal_it != val.MemberEnd()) {
+        return collectLiteral(path, literal_it->value);
+      }
+      for (auto it = val.MemberBegin(); it != val.MemberEnd(); ++it) {
+        path.push_back(static_cast<rapidjson::SizeType>(it - val.MemberBegin()));
+        ScopeGuard pop_path = [&path] { path.pop_back(); };
+        if (!collectLiterals(it->value, path)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  bool collectLiteral(const ValuePath& path, const rapidjson::Value& literal) {
+    if (literal.IsInt64()) {
+      auto val = literal.GetInt64();
+      for (auto [base, vicinity] : {std::make_pair(kIntMarkerBase, kIntMarkerVicinity),
+                                    std::make_pair(kBigIntMarkerBase,
+                                                   kBigIntMarkerVicinity)}) {
+        if (val >= base && val - base < static_cast<int64_t>(literals.size())) {
+          literals[val - base].push_back(path);
+          return true;
+        }
+        if ((val >= base - vicinity && val <= base + vicinity) ||
+            (val >= -base - vicinity && val <= -base + vicinity)) {
+          return false;
+        }
+      }
+      return true;
+    }
+    if (literal.IsDouble()) {
+      auto val = literal.GetDouble();
+      for (size_t idx = 0; idx < literals.size(); ++idx) {
+        if (val == fp_marker(idx)) {
+          literals[idx].push_back(path);
+          return true;
+        }
+      }
+      return std::abs(std::abs(val) - kFpMarkerBase) > kFpMarkerVicinity;
+    }
+    if (literal.IsString()) {
+      std::string val = literal.GetString();
+      for (size_t idx = 0; idx < literals.size(); ++idx) {
+        if (val == str_markers[idx]) {
+          literals[idx].push_back(path);
+          return true;
+        }
+      }
+      return val.find(kStrMarkerPrefix) == std::string::npos;
+    }
+    return true;
+  }
+
+  static rapidjson::Value& getValue(rapidjson::Value& root, const ValuePath& path) {
+    auto val = &root;
+    for (auto idx : path) {
+      if (val->IsArray()) {
+        CHECK_LT(idx, val->Size());
+        val = &(*val)[idx];
+      } else {
+        CHECK(val->IsObject());
+        CHECK_LT(idx, val->MemberCount());
+        val = &(val->MemberBegin() + idx)->value;
+      }
+    }
+    return *val;
+  }
+
+  // Writes parameter values to a copy of the template RA. Strings are referenced, not
+  // copied, so parameters should outlive the document.
+  void setValues(rapidjson::Document& doc,
+                 const std::vector<QueryParameter>& params) const {
+    for (size_t idx = 0; idx < params.size(); ++idx) {
+      for (auto& path : literals[idx]) {
+        auto& literal = getValue(doc, path)["literal"];
+        switch (params[idx].kind()) {
+          case QueryParameter::Kind::kInteger:
+            literal.SetInt64(params[idx].intVal());
+            break;
+          case QueryParameter::Kind::kFloatingPoint:
+            literal.SetDouble(params[idx].fpVal());
+            break;
+          case QueryParameter::Kind::kString:
+            literal.SetString(rapidjson::StringRef(params[idx].strVal().data(),
+                                                   params[idx].strVal().size()));
+            break;
+          default:
+            UNREACHABLE();
+        }
+      }
+    }
+  }
+};
+
+PreparedQuery::PreparedQuery(std::string sql) : sql_(std::move(sql)) {
+  enum class State { kCode, kString, kIdentifier, kLineComment, kBlockComment };
+  State state = State::kCode;
+  for (size_t pos = 0; pos < sql_.size(); ++pos) {
+    auto c = sql_[pos];
+    auto next = pos + 1 < sql_.size() ? sql_[pos + 1] : '\0';
+    switch (state) {
+      case State::kCode:
+        if (c == '?') {
+          placeholders_.push_back(pos);
+        } else if (c == '\'') {
+          state = State::kString;
+        } else if (c == '"') {
+          state = State::kIdentifier;
+        } else if (c == '-' && next == '-') {
+          state = State::kLineComment;
+          ++pos;
+        } else if (c == '/' && next == '*') {
+          state = State::kBlockComment;
+          ++pos;
+        }
+        break;
+      case State::kString:
+        // Escaped quotes are handled as two consecutive strings.
+        if (c == '\'') {
+          state = State::kCode;
+        }
+        break;
+      case State::kIdentifier:
+        if (c == '"') {
+          state = State::kCode;
+        }
+        break;
+      case State::kLineComment:
+        if (c == '\n') {
+          state = State::kCode;
+        }
+        break;
+      case State::kBlockComment:
+        if (c == '*' && next == '/') {
+          state = State::kCode;
+          ++pos;
+        }
+        break;
+    }
+  }
+}
+
+PreparedQuery::~PreparedQuery() {}
+
+bool PreparedQuery::needsTemplate(const std::vector<QueryParameter>& params) const {
+  checkParameters(params);
+  if (!is_bindable(params)) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  return !templates_.count(get_template_key(params));
+}
+
+std::string PreparedQuery::templateSql(const std::vector<QueryParameter>& params) const {
+  checkParameters(params);
+  std::vector<std::string> markers;
+  for (size_t idx = 0; idx < params.size(); ++idx) {
+    switch (params[idx].kind()) {
+      case QueryParameter::Kind::kInteger:
+        markers.push_back(std::to_string(int_marker(idx, is_big_int(params[idx]))));
+        break;
+      case QueryParameter::Kind::kFloatingPoint:
+        markers.push_back(fp_to_sql(fp_marker(idx)));
+        break;
+      case QueryParameter::Kind::kString:
+        markers.push_back(str_to_sql(str_marker(idx)));
+        break;
+      default:
+        throw std::runtime_error("Parameter " + std::to_string(idx) +
+                                 " cannot be bound to a query template.");
+    }
+  }
+  return substitute(markers);
+}
+
+void PreparedQuery::addTemplate(const std::vector<QueryParameter>& params,
+                                const std::string& query_ra) {
+  checkParameters(params);
+  auto tmpl = std::make_shared<const Template>(query_ra, params.size());
+  if (!tmpl->usable()) {
+    LOG(INFO) << "Parameters of the prepared query are folded by the optimizer and "
+                 "cannot be bound: "
+              << sql_;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  templates_.emplace(get_template_key(params), std::move(tmpl));
+}
+
+void PreparedQuery::addUnusableTemplate(const std::vector<QueryParameter>& params) {
+  checkParameters(params);
+  std::lock_guard<std::mutex> lock(mutex_);
+  templates_.emplace(get_template_key(params), std::make_shared<const Template>());
+}
+
+std::unique_ptr<hdk::ir::QueryDag> PreparedQuery::bind(
+    const std::vector<QueryParameter>& params,
+    int db_id,
+    SchemaProviderPtr schema_provider,
+    ConfigPtr config) const {
+  checkParameters(params);
+  if (!is_bindable(params)) {
+    return nullptr;
+  }
+
+  std::shared_ptr<const Template> tmpl;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = templates_.find(get_template_key(params));
+    if (it == templates_.end() || !it->second->usable()) {
+      return nullptr;
+    }
+    tmpl = it->second;
+  }
+  // Templates are immutable, so concurrent executions bind their own copies.
+  rapidjson::Document ra;
+  ra.CopyFrom(tmpl->ra, ra.GetAllocator());
+  tmpl->setValues(ra, params);
+  return std::make_unique<RelAlgDagBuilder>(ra, db_id, schema_provider, config);
+}
+
+std::string PreparedQuery::literalSql(const std::vector<QueryParameter>& params) const {
+  checkParameters(params);
+  std::vector<std::string> literals;
+  for (auto& param : params) {
+    literals.push_back(param.toSql());
+  }
+  return substitute(literals);
+}
+
+void PreparedQuery::checkParameters(const std::vector<QueryParameter>& params) const {
+  if (params.size() != placeholders_.size()) {
+    throw std::runtime_error("Expected " + std::to_string(placeholders_.size()) +
+                             " query parameters, got " + std::to_string(params.size()) +
+                             ".");
+  }
+}
+
+std::string PreparedQuery::substitute(const std::vector<std::string>& literals) const {
+  CHECK_EQ(literals.size(), placeholders_.size());
+  std::string res;
+  size_t start = 0;
+  for (size_t idx = 0; idx < placeholders_.size(); ++idx) {
+    res.append(sql_, start, placeholders_[idx] - start);
+    res.append(literals[idx]);
+    start = placeholders_[idx] + 1;
+  }
+  res.append(sql_, start, std::string::npos);
+  return res;
+}
+
+}  // namespace hdk
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "IR/Node.h"
+#include "SchemaMgr/SchemaProvider.h"
+#include "Shared/Config.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hdk {
+
+// A value bound to a parameter of a prepared query.
+class QueryParameter {
+ public:
+  enum class Kind { kNull, kBoolean, kInteger, kFloatingPoint, kString };
+
+  QueryParameter() : kind_(Kind::kNull) {}
+
+  static QueryParameter null() { return QueryParameter(); }
+  static QueryParameter boolean(bool val);
+  static QueryParameter integer(int64_t val);
+  static QueryParameter fp(double val);
+  static QueryParameter string(std::string val);
+
+  Kind kind() const { return kind_; }
+  bool boolVal() const { return bool_val_; }
+  int64_t intVal() const { return int_val_; }
+  double fpVal() const { return fp_val_; }
+  const std::string& strVal() const { return str_val_; }
+
+  // SQL literal representing the value.
+  std::string toSql() const;
+
+ private:
+  QueryParameter(Kind kind) : kind_(kind) {}
+
+  Kind kind_;
+  bool bool_val_ = false;
+  int64_t int_val_ = 0;
+  double fp_val_ = 0.0;
+  std::string str_val_;
+};
+
+/**
+ * SQL query with '?' parameter placeholders, which is translated to relational
+ * algebra once and then executed with different parameter values.
+ *
+ * To translate the query, each placeholder is replaced with a unique marker literal
+ * of the parameter's kind. Marker literals are then located in the resulting RA and
+ * replaced with actual parameter values each time a DAG is built, which skips SQL
+ * parsing and optimization. Since literals are hoisted by the code generator, the
+ * generated code doesn't depend on parameter values and is reused through the code
+ * cache.
+ *
+ * RA is kept per combination of parameter kinds. NULL and boolean parameters cannot
+ * be represented by unique markers, and parameters can be folded into other literals
+ * by the SQL optimizer (e.g. in 'col > ? + 1'). Markers can also make the SQL invalid
+ * (e.g. a string marker compared with a date column). In these cases the query is
+ * translated with the parameter values substituted into the SQL text.
+ */
+class PreparedQuery {
+ public:
+  PreparedQuery(std::string sql);
+  ~PreparedQuery();
+
+  const std::string& sql() const { return sql_; }
+  size_t parameterCount() const { return placeholders_.size(); }
+
+  // Returns true if RA for kinds of the specified parameters is not known yet. In
+  // this case, templateSql() should be translated and passed to addTemplate(). If the
+  // translation fails, addUnusableTemplate() should be called instead, so that
+  // literalSql() is used for these kinds of parameters.
+  bool needsTemplate(const std::vector<QueryParameter>& params) const;
+  std::string templateSql(const std::vector<QueryParameter>& params) const;
+  void addTemplate(const std::vector<QueryParameter>& params,
+                   const std::string& query_ra);
+  void addUnusableTemplate(const std::vector<QueryParameter>& params);
+
+  // Builds a DAG from the template RA with the parameters bound. Returns nullptr if
+  // the template cannot be used for the parameters, in this case literalSql() should
+  // be translated instead.
+  std::unique_ptr<hdk::ir::QueryDag> bind(const std::vector<QueryParameter>& params,
+                                          int db_id,
+                                          SchemaProviderPtr schema_provider,
+                                          ConfigPtr config) const;
+
+  // SQL with parameter values substituted for placeholders.
+  std::string literalSql(const std::vector<QueryParameter>& params) const;
+
+ private:
+  struct Template;
+
+  void checkParameters(const std::vector<QueryParameter>& params) const;
+  std::string substitute(const std::vector<std::string>& literals) const;
+
+  const std::string sql_;
+  // Positions of placeholders in the SQL text.
+  std::vector<size_t> placeholders_;
+  // Templates keyed by kinds of parameters. A template without markers is kept for
+  // kinds which cannot be bound to avoid repeated translation attempts. Templates are
+  // immutable once added.
+  std::unordered_map<std::string, std::shared_ptr<const Template>> templates_;
+  mutable std::mutex mutex_;
+};
+
+}  // namespace hdk
@@ -27,6 +27,7 @@
 #include "ResultSetReduction.h"
 #include "SpeculativeTopN.h"
 #include "StreamingTopN.h"
+#include "VectorizedKernel.h"
 
 #include "ResultSet/QueryMemoryDescriptor.h"
 #include "ResultSet/ResultSet.h"
@@ -550,7 +551,7 @@ std::vector<int64_t*> QueryExecutionContext::launchGpuCode(
 
 std::vector<int64_t*> QueryExecutionContext::launchCpuCode(
     const RelAlgExecutionUnit& ra_exe_unit,
-    const CpuCompilationContext* native_code,
+    const CompilationContext* generated_code,
     const bool hoist_literals,
     const std::vector<int8_t>& literal_buff,
     std::vector<std::vector<const int8_t*>> col_buffers,
@@ -626,12 +627,27 @@ std::vector<int64_t*> QueryExecutionContext::launchCpuCode(
                           query_mem_desc_);
   }
 
-  CHECK(native_code);
+  CHECK(generated_code);
+  const auto vectorized_kernel = dynamic_cast<const VectorizedKernel*>(generated_code);
+  const auto native_code = dynamic_cast<const CpuCompilationContext*>(generated_code);
+  CHECK(vectorized_kernel || native_code);
   const int64_t* join_hash_tables_ptr =
       join_hash_tables.size() == 1
           ? reinterpret_cast<int64_t*>(join_hash_tables[0])
           : (join_hash_tables.size() > 1 ? &join_hash_tables[0] : nullptr);
-  if (hoist_literals) {
+  if (vectorized_kernel) {
+    vectorized_kernel->run(multifrag_cols_ptr,
+                           num_fragments,
+                           num_rows_ptr,
+                           flatened_frag_offsets.data(),
+                           num_tables,
+                           scan_limit,
+                           &total_matched_init,
+                           init_agg_vals,
+                           is_group_by ? query_buffers_->getGroupByBuffersPtr()
+                                       : out_vec.data(),
+                           error_code);
+  } else if (hoist_literals) {
     using agg_query = void (*)(const int8_t***,  // col_buffers
                                const uint64_t*,  // num_fragments
                                const int8_t*,    // literals
@@ -26,7 +26,7 @@
 #include <boost/core/noncopyable.hpp>
 #include <vector>
 
-class CpuCompilationContext;
+class CompilationContext;
 
 struct RelAlgExecutionUnit;
 class QueryMemoryDescriptor;
@@ -94,7 +94,7 @@ class QueryExecutionContext : boost::noncopyable {
 
   std::vector<int64_t*> launchCpuCode(
       const RelAlgExecutionUnit& ra_exe_unit,
-      const CpuCompilationContext* fn_ptrs,
+      const CompilationContext* generated_code,
       const bool hoist_literals,
       const std::vector<int8_t>& literal_buff,
       std::vector<std::vector<const int8_t*>> col_buffers,
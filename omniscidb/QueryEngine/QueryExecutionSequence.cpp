@@ -45,11 +45,38 @@ class CoalesceSecondaryProjectVisitor : public ScalarExprVisitor<bool> {
   bool defaultResult() const final { return true; }
 };
 
+// Checks that an expression is deterministic and cheap enough to be computed by each
+// user of its node. Functions are UDFs or extension functions with unknown cost and
+// possibly non-deterministic results, e.g. random numbers.
+class FusibleExprVisitor : public ScalarExprVisitor<bool> {
+ public:
+  bool visitRegexpExpr(const hdk::ir::RegexpExpr*) const final { return false; }
+
+  bool visitFunctionOper(const hdk::ir::FunctionOper*) const final { return false; }
+
+  bool visitWindowFunction(const hdk::ir::WindowFunction*) const final { return false; }
+
+  bool visitInSubquery(const hdk::ir::InSubquery*) const final { return false; }
+
+  bool visitScalarSubquery(const hdk::ir::ScalarSubquery*) const final { return false; }
+
+ protected:
+  bool aggregateResult(const bool& aggregate, const bool& next_result) const final {
+    return aggregate && next_result;
+  }
+
+  bool defaultResult() const final { return true; }
+};
+
 class QueryExecutionSequenceImpl {
  public:
-  static std::vector<const ir::Node*> buildSteps(const ir::Node* root, ConfigPtr config) {
+  static void buildSteps(const ir::Node* root,
+                         ConfigPtr config,
+                         std::vector<const ir::Node*>& steps,
+                         std::vector<std::vector<size_t>>& deps) {
     QueryExecutionSequenceImpl impl(root, config);
-    return std::move(impl.execution_steps_);
+    steps = std::move(impl.execution_steps_);
+    deps = std::move(impl.execution_deps_);
   }
 
  protected:
@@ -104,7 +131,8 @@ class QueryExecutionSequenceImpl {
     // to avoid execution of the same operation multiple times.
     // Optimizers are free to duplicate sub-graphs if it's better
     // to not materizlie such nodes.
-    if (boost::in_degree(node_to_vertex_[node], graph_) > 1) {
+    if (boost::in_degree(node_to_vertex_[node], graph_) > 1 &&
+        !(config_->exec.fuse_shared_projections && isScanProjection(node))) {
       execution_points_.insert(node);
     }
 
@@ -157,6 +185,28 @@ class QueryExecutionSequenceImpl {
     }
   }
 
+  // Returns true for filters and projections of deterministic and cheap expressions
+  // applied to a single table. Such nodes can be fused into each of their users
+  // instead of materializing their results to be read by the users.
+  bool isScanProjection(const ir::Node* node) {
+    FusibleExprVisitor visitor;
+    while (node->is<ir::Filter>() || node->is<ir::Project>()) {
+      if (auto filter = node->as<ir::Filter>()) {
+        if (!visitor.visit(filter->getConditionExpr())) {
+          return false;
+        }
+      } else {
+        for (auto& expr : node->as<ir::Project>()->getExprs()) {
+          if (!visitor.visit(expr.get())) {
+            return false;
+          }
+        }
+      }
+      node = node->getInput(0);
+    }
+    return node->is<ir::Scan>();
+  }
+
   void mergeExecutionPointsWithSimpleProject() {
     std::vector<const ir::Node*> simple_projects;
     for (auto input : execution_points_) {
@@ -256,22 +306,33 @@ class QueryExecutionSequenceImpl {
     boost::topological_sort(graph_, std::back_inserter(vertexes));
 
     execution_steps_.reserve(vertexes.size());
+    std::vector<size_t> vertex_to_step(vertexes.size());
     for (auto vertex : vertexes) {
+      vertex_to_step[vertex] = execution_steps_.size();
       execution_steps_.push_back(graph_[vertex]);
     }
+
+    execution_deps_.resize(vertexes.size());
+    for (size_t step_idx = 0; step_idx < vertexes.size(); ++step_idx) {
+      auto [start, end] = boost::out_edges(vertexes[step_idx], graph_);
+      for (auto it = start; it != end; ++it) {
+        execution_deps_[step_idx].push_back(vertex_to_step[it->m_target]);
+      }
+    }
   }
 
   DAG graph_;
   std::unordered_map<const hdk::ir::Node*, size_t> node_to_vertex_;
   std::unordered_set<const ir::Node*> execution_points_;
   std::vector<const ir::Node*> execution_steps_;
+  std::vector<std::vector<size_t>> execution_deps_;
   ConfigPtr config_;
 };
 
 }  // namespace
 
 QueryExecutionSequence::QueryExecutionSequence(const ir::Node* root, ConfigPtr config) {
-  steps_ = QueryExecutionSequenceImpl::buildSteps(root, config);
+  QueryExecutionSequenceImpl::buildSteps(root, config, steps_, deps_);
 }
 
 }  // namespace hdk
@@ -17,9 +17,13 @@ class QueryExecutionSequence {
   const std::vector<const ir::Node*>& steps() const { return steps_; }
   size_t size() const { return steps_.size(); }
   const ir::Node* step(size_t idx) const { return steps_[idx]; }
+  // Indices of steps whose results are inputs of the specified step. All of them
+  // precede the step in the sequence.
+  const std::vector<size_t>& dependencies(size_t idx) const { return deps_[idx]; }
 
  protected:
   std::vector<const ir::Node*> steps_;
+  std::vector<std::vector<size_t>> deps_;
 };
 
 }  // namespace hdk
\ No newline at end of file
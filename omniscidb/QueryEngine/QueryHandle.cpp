@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "QueryHandle.h"
+
+#include "Logger/Logger.h"
+#include "QueryEngine/RelAlgExecutor.h"
+
+namespace hdk {
+
+QueryHandle::QueryHandle(QueryFn query)
+    : progress_(std::make_shared<QueryProgress>()) {
+  result_ = std::async(std::launch::async,
+                       [query = std::move(query),
+                        progress = progress_,
+                        parent_thread_id = logger::thread_id()] {
+                         DEBUG_TIMER_NEW_THREAD(parent_thread_id);
+                         return query(progress);
+                       })
+                .share();
+}
+
+std::shared_ptr<QueryHandle> QueryHandle::start(
+    std::shared_ptr<RelAlgExecutor> ra_executor,
+    const CompilationOptions& co,
+    const ExecutionOptions& eo) {
+  return std::make_shared<QueryHandle>(
+      [ra_executor, co, eo](std::shared_ptr<QueryProgress> progress) {
+        ra_executor->setQueryProgress(progress);
+        return ra_executor->executeRelAlgQuery(co, eo, /*just_explain_plan=*/false);
+      });
+}
+
+QueryHandle::~QueryHandle() {
+  if (!poll()) {
+    cancel();
+    result_.wait();
+  }
+}
+
+bool QueryHandle::poll() const {
+  return waitFor(0);
+}
+
+bool QueryHandle::waitFor(size_t timeout_ms) const {
+  return result_.wait_for(std::chrono::milliseconds(timeout_ms)) ==
+         std::future_status::ready;
+}
+
+const ExecutionResult& QueryHandle::wait() const {
+  return result_.get();
+}
+
+}  // namespace hdk
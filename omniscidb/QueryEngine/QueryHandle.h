@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "QueryEngine/CompilationOptions.h"
+#include "QueryEngine/Descriptors/RelAlgExecutionDescriptor.h"
+#include "QueryEngine/QueryProgress.h"
+
+#include <functional>
+#include <future>
+#include <memory>
+
+class RelAlgExecutor;
+
+namespace hdk {
+
+// Query executed asynchronously in a separate thread. Destroying the handle of
+// a running query cancels it and waits for its completion.
+class QueryHandle {
+ public:
+  using QueryFn = std::function<ExecutionResult(std::shared_ptr<QueryProgress>)>;
+
+  // Starts the query. The function should pass the progress to the executor.
+  explicit QueryHandle(QueryFn query);
+  ~QueryHandle();
+
+  // Starts the query execution by the specified RelAlgExecutor.
+  static std::shared_ptr<QueryHandle> start(std::shared_ptr<RelAlgExecutor> ra_executor,
+                                            const CompilationOptions& co,
+                                            const ExecutionOptions& eo);
+
+  // Returns true if the query is finished.
+  bool poll() const;
+
+  // Waits for the query completion up to the specified time. Returns true if the
+  // query is finished.
+  bool waitFor(size_t timeout_ms) const;
+
+  // Waits for the query completion and returns its result. Rethrows the query
+  // execution error.
+  const ExecutionResult& wait() const;
+
+  // Requests the query cancellation. The query fails with the interruption error
+  // unless it is finished before the request is noticed.
+  void cancel() { progress_->cancel(); }
+
+  bool isCancelled() const { return progress_->isCancelled(); }
+
+  size_t totalFragments() const { return progress_->totalFragments(); }
+  size_t completedFragments() const { return progress_->completedFragments(); }
+  size_t skippedFragments() const { return progress_->skippedFragments(); }
+
+ private:
+  std::shared_ptr<QueryProgress> progress_;
+  std::shared_future<ExecutionResult> result_;
+};
+
+}  // namespace hdk
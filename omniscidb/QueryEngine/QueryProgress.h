@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace hdk {
+
+/**
+ * Progress of a running query and its cancellation request. Shared by the query
+ * handle and executors running the query.
+ *
+ * Progress is measured in outer table fragments processed by execution kernels.
+ * Fragments of a query step are added to the total when the step launches its
+ * kernels, so the total grows while a multi-step query is running. A fragment split
+ * into CPU sub-tasks is processed when its last sub-task completes. Fragments left
+ * when a projection with LIMIT has collected enough rows are skipped and count as
+ * completed. Skipping works at the kernel granularity, so kernels which have already
+ * started complete.
+ *
+ * Cancellation is cooperative: it is checked before each query step and before
+ * each kernel launch, so kernels running when the query is cancelled complete.
+ */
+class QueryProgress {
+ public:
+  void addFragments(size_t count) { total_fragments_ += count; }
+  void completeFragments(size_t count) { completed_fragments_ += count; }
+  void skipFragments(size_t count) {
+    completed_fragments_ += count;
+    skipped_fragments_ += count;
+  }
+
+  size_t totalFragments() const { return total_fragments_.load(); }
+  size_t completedFragments() const { return completed_fragments_.load(); }
+  size_t skippedFragments() const { return skipped_fragments_.load(); }
+
+  void cancel() { cancelled_ = true; }
+  bool isCancelled() const { return cancelled_.load(); }
+
+ private:
+  std::atomic<size_t> total_fragments_{0};
+  std::atomic<size_t> completed_fragments_{0};
+  std::atomic<size_t> skipped_fragments_{0};
+  std::atomic<bool> cancelled_{false};
+};
+
+}  // namespace hdk
@@ -24,6 +24,8 @@
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/Verifier.h>
 
+#include <functional>
+
 #if LLVM_VERSION_MAJOR > 13
 #define ATTR_BUILDER(ctx) llvm::AttrBuilder B(ctx);
 #else
@@ -240,7 +242,7 @@ struct RowFuncCallGenerator {
 
 class QueryTemplateGenerator {
  public:
-  static std::tuple<llvm::Function*, llvm::CallInst*> generate(
+  static std::tuple<llvm::Function*, llvm::CallInst*, llvm::CallInst*> generate(
       llvm::Module* mod,
       const size_t aggr_col_count,
       const bool hoist_literals,
@@ -248,6 +250,7 @@ class QueryTemplateGenerator {
       const QueryMemoryDescriptor& query_mem_desc,
       const ExecutorDeviceType device_type,
       const bool check_scan_limit,
+      const size_t batch_size,
       const GpuSharedMemoryContext& gpu_smem_context,
       const compiler::CodegenTraits& traits);
 
@@ -258,18 +261,23 @@ class QueryTemplateGenerator {
                          const bool hoist_literals,
                          const QueryMemoryDescriptor& query_mem_desc,
                          const ExecutorDeviceType device_type,
+                         const size_t batch_size,
                          const GpuSharedMemoryContext& gpu_smem_context,
                          const compiler::CodegenTraits& traits)
       : mod(mod)
       , hoist_literals(hoist_literals)
       , query_mem_desc(query_mem_desc)
       , device_type(device_type)
+      , batch_size(batch_size)
       , gpu_smem_context(gpu_smem_context)
       , codegen_traits(traits) {
     // sanity checks
     if (gpu_smem_context.isSharedMemoryUsed()) {
       CHECK(device_type == ExecutorDeviceType::GPU);
     }
+    if (batch_size) {
+      CHECK(device_type == ExecutorDeviceType::CPU);
+    }
 
     // initialize types
     CHECK(mod);
@@ -432,17 +440,131 @@ class QueryTemplateGenerator {
     llvm::ReturnInst::Create(mod->getContext(), bb_exit);
   }
 
-  virtual std::tuple<llvm::Function*, llvm::CallInst*> finalize() {
+  /**
+   * Generates the loop body processing rows in blocks of batch_size rows. For each
+   * block, a loop without branches (besides the ones of the filter itself) calls the
+   * row filter for every row and appends the row position to the selection vector
+   * advancing its end only if the row passes the filter. Then the row function is
+   * called for the selected positions only. The row filter placeholder takes the same
+   * arguments as the row function and is bound to a function returning non-zero for
+   * rows passing the filter.
+   */
+  void generateBatchedForBody(
+      llvm::Function* func_row_process,
+      const std::function<std::vector<llvm::Value*>(llvm::Value*)>& get_params) {
+    CHECK(batch_size);
+    auto& context = mod->getContext();
+    auto func_row_filter = llvm::cast<llvm::Function>(
+        mod->getOrInsertFunction("row_filter", func_row_process->getFunctionType())
+            .getCallee());
+    func_row_filter->setCallingConv(codegen_traits.callingConv());
+
+    auto sel_vec = new llvm::AllocaInst(i64_type,
+                                        0,
+                                        llvm::ConstantInt::get(i32_type, batch_size),
+                                        "sel_vec",
+                                        &*bb_entry->getFirstInsertionPt());
+    sel_vec->setAlignment(LLVM_ALIGN(8));
+    auto zero_i64 = llvm::ConstantInt::get(i64_type, 0);
+    auto one_i64 = llvm::ConstantInt::get(i64_type, 1);
+
+    auto bb_batch_filter = llvm::BasicBlock::Create(
+        context, ".batch_filter", query_func_ptr, bb_crit_edge);
+    auto bb_batch_check = llvm::BasicBlock::Create(
+        context, ".batch_check", query_func_ptr, bb_crit_edge);
+    auto bb_batch_rows =
+        llvm::BasicBlock::Create(context, ".batch_rows", query_func_ptr, bb_crit_edge);
+    auto bb_batch_next =
+        llvm::BasicBlock::Create(context, ".batch_next", query_func_ptr, bb_crit_edge);
+
+    // Bounds of the current block.
+    auto block_start = llvm::PHINode::Create(i64_type, 2, "block_start", bb_forbody);
+    block_start->addIncoming(pos_start_i64, bb_preheader);
+    auto block_limit = llvm::BinaryOperator::CreateAdd(
+        block_start,
+        llvm::BinaryOperator::CreateMul(
+            pos_step_i64, llvm::ConstantInt::get(i64_type, batch_size), "", bb_forbody),
+        "",
+        bb_forbody);
+    auto is_full_block = new llvm::ICmpInst(
+        *bb_forbody, llvm::ICmpInst::ICMP_SLT, block_limit, row_count, "");
+    auto block_end = llvm::SelectInst::Create(
+        is_full_block, block_limit, row_count, "block_end", bb_forbody);
+    llvm::BranchInst::Create(bb_batch_filter, bb_forbody);
+
+    // Filter the block into the selection vector.
+    auto filter_pos = llvm::PHINode::Create(i64_type, 2, "filter_pos", bb_batch_filter);
+    auto sel_count = llvm::PHINode::Create(i64_type, 2, "sel_count", bb_batch_filter);
+    filter_pos->addIncoming(block_start, bb_forbody);
+    sel_count->addIncoming(zero_i64, bb_forbody);
+    row_filter = llvm::CallInst::Create(
+        func_row_filter, get_params(filter_pos), "row_filter", bb_batch_filter);
+    row_filter->setCallingConv(codegen_traits.callingConv());
+    auto sel_gep = llvm::GetElementPtrInst::CreateInBounds(
+        i64_type, sel_vec, sel_count, "", bb_batch_filter);
+    new llvm::StoreInst(filter_pos, sel_gep, false, LLVM_ALIGN(8), bb_batch_filter);
+    auto is_selected = new llvm::ICmpInst(*bb_batch_filter,
+                                          llvm::ICmpInst::ICMP_NE,
+                                          row_filter,
+                                          llvm::ConstantInt::get(i32_type, 0),
+                                          "");
+    auto sel_count_inc = llvm::BinaryOperator::CreateAdd(
+        sel_count,
+        new llvm::ZExtInst(is_selected, i64_type, "", bb_batch_filter),
+        "",
+        bb_batch_filter);
+    auto filter_pos_inc = llvm::BinaryOperator::CreateAdd(
+        filter_pos, pos_step_i64, "", bb_batch_filter);
+    filter_pos->addIncoming(filter_pos_inc, bb_batch_filter);
+    sel_count->addIncoming(sel_count_inc, bb_batch_filter);
+    auto filter_loop = new llvm::ICmpInst(
+        *bb_batch_filter, llvm::ICmpInst::ICMP_SLT, filter_pos_inc, block_end, "");
+    llvm::BranchInst::Create(
+        bb_batch_filter, bb_batch_check, filter_loop, bb_batch_filter);
+
+    auto has_selected = new llvm::ICmpInst(
+        *bb_batch_check, llvm::ICmpInst::ICMP_SGT, sel_count_inc, zero_i64, "");
+    llvm::BranchInst::Create(bb_batch_rows, bb_batch_next, has_selected, bb_batch_check);
+
+    // Process the selected rows.
+    auto sel_idx = llvm::PHINode::Create(i64_type, 2, "sel_idx", bb_batch_rows);
+    sel_idx->addIncoming(zero_i64, bb_batch_check);
+    auto pos_gep = llvm::GetElementPtrInst::CreateInBounds(
+        i64_type, sel_vec, sel_idx, "", bb_batch_rows);
+    auto pos = new llvm::LoadInst(
+        i64_type, pos_gep, "sel_pos", false, LLVM_ALIGN(8), bb_batch_rows);
+    row_process = llvm::CallInst::Create(
+        func_row_process, get_params(pos), "", bb_batch_rows);
+    row_process->setCallingConv(codegen_traits.callingConv());
+    row_process->setTailCall(false);
+    llvm::AttributeList row_process_pal;
+    row_process->setAttributes(row_process_pal);
+    auto sel_idx_inc =
+        llvm::BinaryOperator::CreateAdd(sel_idx, one_i64, "", bb_batch_rows);
+    sel_idx->addIncoming(sel_idx_inc, bb_batch_rows);
+    auto rows_loop = new llvm::ICmpInst(
+        *bb_batch_rows, llvm::ICmpInst::ICMP_SLT, sel_idx_inc, sel_count_inc, "");
+    llvm::BranchInst::Create(bb_batch_rows, bb_batch_next, rows_loop, bb_batch_rows);
+
+    block_start->addIncoming(block_end, bb_batch_next);
+    auto blocks_loop = new llvm::ICmpInst(
+        *bb_batch_next, llvm::ICmpInst::ICMP_SLT, block_end, row_count, "");
+    llvm::BranchInst::Create(bb_forbody, bb_crit_edge, blocks_loop, bb_batch_next);
+  }
+
+  virtual std::tuple<llvm::Function*, llvm::CallInst*, llvm::CallInst*> finalize() {
     // Resolve Forward References
-    pos_inc_pre->replaceAllUsesWith(pos_inc);
-    delete pos_inc_pre;
+    if (pos_inc_pre) {
+      pos_inc_pre->replaceAllUsesWith(pos_inc);
+      delete pos_inc_pre;
+    }
 
     if (llvm::verifyFunction(*query_func_ptr, &llvm::errs())) {
       LOG(FATAL) << "Generated invalid code. ";
     }
 
     CHECK(row_process);
-    return std::make_tuple(query_func_ptr, row_process);
+    return std::make_tuple(query_func_ptr, row_process, row_filter);
   }
 
   // generic
@@ -450,6 +572,7 @@ class QueryTemplateGenerator {
   const bool hoist_literals;
   const QueryMemoryDescriptor& query_mem_desc;
   const ExecutorDeviceType device_type;
+  const size_t batch_size;
   const GpuSharedMemoryContext& gpu_smem_context;
   const compiler::CodegenTraits& codegen_traits;
 
@@ -492,6 +615,7 @@ class QueryTemplateGenerator {
 
   // returned values after query template generation
   llvm::CallInst* row_process{nullptr};     // pointer to row func
+  llvm::CallInst* row_filter{nullptr};      // pointer to row filter func, if batched
   llvm::Function* query_func_ptr{nullptr};  // generated query template func
 
   // misc query template state
@@ -506,6 +630,7 @@ class GroupByQueryTemplateGenerator : public QueryTemplateGenerator {
       const QueryMemoryDescriptor& query_mem_desc,
       const ExecutorDeviceType device_type,
       const bool check_scan_limit,
+      const size_t batch_size,
       const GpuSharedMemoryContext& gpu_smem_context,
       const compiler::CodegenTraits& traits) {
     return std::unique_ptr<GroupByQueryTemplateGenerator>(
@@ -514,6 +639,7 @@ class GroupByQueryTemplateGenerator : public QueryTemplateGenerator {
                                           query_mem_desc,
                                           device_type,
                                           check_scan_limit,
+                                          batch_size,
                                           gpu_smem_context,
                                           traits));
   }
@@ -524,18 +650,23 @@ class GroupByQueryTemplateGenerator : public QueryTemplateGenerator {
                                 const QueryMemoryDescriptor& query_mem_desc,
                                 const ExecutorDeviceType device_type,
                                 const bool check_scan_limit,
+                                const size_t batch_size,
                                 const GpuSharedMemoryContext& gpu_smem_context,
                                 const compiler::CodegenTraits& traits)
       : QueryTemplateGenerator(mod,
                                hoist_literals,
                                query_mem_desc,
                                device_type,
+                               batch_size,
                                gpu_smem_context,
                                traits)
       , check_scan_limit(check_scan_limit)
       , row_func_call_args(std::make_unique<RowFuncCallGenerator>()) {
     const bool is_group_by = query_mem_desc.isGroupBy();
     CHECK(is_group_by);
+    if (batch_size) {
+      CHECK(!check_scan_limit);
+    }
 
     func_init_shared_mem = gpu_smem_context.isSharedMemoryUsed()
                                ? mod->getFunction("init_shared_mem")
@@ -666,17 +797,11 @@ class GroupByQueryTemplateGenerator : public QueryTemplateGenerator {
   }
 
   virtual void generateForBodyBlock() override {
-    CHECK(!pos_inc_pre);
-    pos_inc_pre = new llvm::Argument(i64_type);
-    llvm::PHINode* pos =
-        llvm::PHINode::Create(i64_type, check_scan_limit ? 3 : 2, "pos", bb_forbody);
-
     CHECK(row_func_call_args);
     row_func_call_args->result_buffer = result_buffer;
     row_func_call_args->crt_matched_ptr = crt_matched_ptr;
     row_func_call_args->total_matched = total_matched;
     row_func_call_args->agg_init_val = agg_init_val;
-    row_func_call_args->pos = pos;
     row_func_call_args->frag_row_off_ptr = frag_row_off_ptr;
     row_func_call_args->row_count_ptr = row_count_ptr;
     if (hoist_literals) {
@@ -684,6 +809,23 @@ class GroupByQueryTemplateGenerator : public QueryTemplateGenerator {
       row_func_call_args->literals = literals;
     }
 
+    if (batch_size) {
+      auto func_row_process =
+          ::row_process<llvm::AttributeList>(mod, 0, hoist_literals, codegen_traits);
+      CHECK(func_row_process);
+      generateBatchedForBody(func_row_process, [this](llvm::Value* pos) {
+        row_func_call_args->pos = pos;
+        return row_func_call_args->getParams(hoist_literals);
+      });
+      return;
+    }
+
+    CHECK(!pos_inc_pre);
+    pos_inc_pre = new llvm::Argument(i64_type);
+    llvm::PHINode* pos =
+        llvm::PHINode::Create(i64_type, check_scan_limit ? 3 : 2, "pos", bb_forbody);
+    row_func_call_args->pos = pos;
+
     const std::vector<llvm::Value*> row_process_params =
         row_func_call_args->getParams(hoist_literals);
 
@@ -804,6 +946,7 @@ class NonGroupedQueryTemplateGenerator : public QueryTemplateGenerator {
       const bool is_estimate_query,
       const QueryMemoryDescriptor& query_mem_desc,
       const ExecutorDeviceType device_type,
+      const size_t batch_size,
       const GpuSharedMemoryContext& gpu_smem_context,
       const compiler::CodegenTraits& traits) {
     return std::unique_ptr<NonGroupedQueryTemplateGenerator>(
@@ -813,6 +956,7 @@ class NonGroupedQueryTemplateGenerator : public QueryTemplateGenerator {
                                              is_estimate_query,
                                              query_mem_desc,
                                              device_type,
+                                             batch_size,
                                              gpu_smem_context,
                                              traits));
   }
@@ -824,18 +968,23 @@ class NonGroupedQueryTemplateGenerator : public QueryTemplateGenerator {
                                    const bool is_estimate_query,
                                    const QueryMemoryDescriptor& query_mem_desc,
                                    const ExecutorDeviceType device_type,
+                                   const size_t batch_size,
                                    const GpuSharedMemoryContext& gpu_smem_context,
                                    const compiler::CodegenTraits& traits)
       : QueryTemplateGenerator(mod,
                                hoist_literals,
                                query_mem_desc,
                                device_type,
+                               batch_size,
                                gpu_smem_context,
                                traits)
       , aggr_col_count(aggr_col_count)
       , is_estimate_query(is_estimate_query) {
     const bool is_group_by = query_mem_desc.isGroupBy();
     CHECK(!is_group_by);
+    if (batch_size) {
+      CHECK(!is_estimate_query);
+    }
   }
 
   virtual void generateEntryBlock() override {
@@ -921,6 +1070,26 @@ class NonGroupedQueryTemplateGenerator : public QueryTemplateGenerator {
   }
 
   virtual void generateForBodyBlock() override {
+    if (batch_size) {
+      auto func_row_process = ::row_process<llvm::AttributeList>(
+          mod, aggr_col_count, hoist_literals, codegen_traits);
+      CHECK(func_row_process);
+      generateBatchedForBody(func_row_process, [this](llvm::Value* pos) {
+        std::vector<llvm::Value*> row_process_params(result_ptr_vec.begin(),
+                                                     result_ptr_vec.end());
+        row_process_params.push_back(agg_init_val);
+        row_process_params.push_back(pos);
+        row_process_params.push_back(frag_row_off_ptr);
+        row_process_params.push_back(row_count_ptr);
+        if (hoist_literals) {
+          CHECK(literals);
+          row_process_params.push_back(literals);
+        }
+        return row_process_params;
+      });
+      return;
+    }
+
     pos_inc_pre = new llvm::Argument(i64_type);
     llvm::PHINode* pos = llvm::PHINode::Create(i64_type, 2, "pos", bb_forbody);
     pos->addIncoming(pos_start_i64, bb_preheader);
@@ -1094,16 +1263,17 @@ class NonGroupedQueryTemplateGenerator : public QueryTemplateGenerator {
   llvm::CallInst* group_buff_idx = nullptr;
 };
 
-std::tuple<llvm::Function*, llvm::CallInst*> QueryTemplateGenerator::generate(
-    llvm::Module* mod,
-    const size_t aggr_col_count,
-    const bool hoist_literals,
-    const bool is_estimate_query,
-    const QueryMemoryDescriptor& query_mem_desc,
-    const ExecutorDeviceType device_type,
-    const bool check_scan_limit,
-    const GpuSharedMemoryContext& gpu_smem_context,
-    const compiler::CodegenTraits& traits) {
+std::tuple<llvm::Function*, llvm::CallInst*, llvm::CallInst*>
+QueryTemplateGenerator::generate(llvm::Module* mod,
+                                 const size_t aggr_col_count,
+                                 const bool hoist_literals,
+                                 const bool is_estimate_query,
+                                 const QueryMemoryDescriptor& query_mem_desc,
+                                 const ExecutorDeviceType device_type,
+                                 const bool check_scan_limit,
+                                 const size_t batch_size,
+                                 const GpuSharedMemoryContext& gpu_smem_context,
+                                 const compiler::CodegenTraits& traits) {
   const bool is_group_by = query_mem_desc.isGroupBy();
   auto query_template = is_group_by
                             ? GroupByQueryTemplateGenerator::build(mod,
@@ -1111,6 +1281,7 @@ std::tuple<llvm::Function*, llvm::CallInst*> QueryTemplateGenerator::generate(
                                                                    query_mem_desc,
                                                                    device_type,
                                                                    check_scan_limit,
+                                                                   batch_size,
                                                                    gpu_smem_context,
                                                                    traits)
                             : NonGroupedQueryTemplateGenerator::build(mod,
@@ -1119,6 +1290,7 @@ std::tuple<llvm::Function*, llvm::CallInst*> QueryTemplateGenerator::generate(
                                                                       is_estimate_query,
                                                                       query_mem_desc,
                                                                       device_type,
+                                                                      batch_size,
                                                                       gpu_smem_context,
                                                                       traits);
   CHECK(query_template);
@@ -1133,7 +1305,7 @@ std::tuple<llvm::Function*, llvm::CallInst*> QueryTemplateGenerator::generate(
 
 }  // namespace
 
-std::tuple<llvm::Function*, llvm::CallInst*> query_template(
+std::tuple<llvm::Function*, llvm::CallInst*, llvm::CallInst*> query_template(
     llvm::Module* mod,
     const size_t aggr_col_count,
     const bool is_estimate_query,
@@ -1141,6 +1313,7 @@ std::tuple<llvm::Function*, llvm::CallInst*> query_template(
     const QueryMemoryDescriptor& query_mem_desc,
     const ExecutorDeviceType device_type,
     const bool check_scan_limit,
+    const size_t batch_size,
     const GpuSharedMemoryContext& gpu_smem_context,
     const compiler::CodegenTraits& traits) {
   return QueryTemplateGenerator::generate(mod,
@@ -1150,6 +1323,7 @@ std::tuple<llvm::Function*, llvm::CallInst*> query_template(
                                           query_mem_desc,
                                           device_type,
                                           check_scan_limit,
+                                          batch_size,
                                           gpu_smem_context,
                                           traits);
 }
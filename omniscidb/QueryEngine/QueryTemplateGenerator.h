@@ -19,7 +19,11 @@
 
 #include <llvm/IR/Module.h>
 
-std::tuple<llvm::Function*, llvm::CallInst*> query_template(
+// Returns the query function with the placeholder calls of the row function and, for
+// a non-zero batch_size, of the row filter function. In the latter case rows are
+// processed in blocks of batch_size rows, rows passing the filter are collected into a
+// selection vector first and the row function is called for selected rows only.
+std::tuple<llvm::Function*, llvm::CallInst*, llvm::CallInst*> query_template(
     llvm::Module* mod,
     const size_t aggr_col_count,
     const bool is_estimate_query,
@@ -27,6 +31,7 @@ std::tuple<llvm::Function*, llvm::CallInst*> query_template(
     const QueryMemoryDescriptor& query_mem_desc,
     const ExecutorDeviceType device_type,
     const bool check_scan_limit,
+    const size_t batch_size,
     const GpuSharedMemoryContext& gpu_smem_context,
     const compiler::CodegenTraits& traits);
 
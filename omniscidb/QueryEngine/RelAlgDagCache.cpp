@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "RelAlgDagCache.h"
+
+#include <unordered_set>
+
+namespace {
+
+// Nodes of the query and its subqueries.
+std::vector<const hdk::ir::Node*> collect_nodes(const hdk::ir::QueryDag& dag) {
+  std::vector<const hdk::ir::Node*> res;
+  std::unordered_set<const hdk::ir::Node*> visited;
+  std::vector<const hdk::ir::Node*> stack;
+  stack.push_back(dag.getRootNode());
+  for (auto& subquery : dag.getSubqueries()) {
+    stack.push_back(subquery->node());
+  }
+  while (!stack.empty()) {
+    auto node = stack.back();
+    stack.pop_back();
+    if (!visited.insert(node).second) {
+      continue;
+    }
+    res.push_back(node);
+    for (size_t i = 0; i < node->inputCount(); ++i) {
+      stack.push_back(node->getInput(i));
+    }
+  }
+  return res;
+}
+
+bool has_current_schema(const hdk::ir::QueryDag& dag,
+                        const SchemaProvider& schema_provider) {
+  for (auto node : collect_nodes(dag)) {
+    auto scan = node->as<hdk::ir::Scan>();
+    if (!scan) {
+      continue;
+    }
+    auto table_info = scan->getTableInfo();
+    if (schema_provider.getTableInfo(table_info->db_id, table_info->table_id) !=
+        table_info) {
+      return false;
+    }
+    for (size_t col_idx = 0; col_idx < scan->size(); ++col_idx) {
+      auto col_info = scan->getColumnInfo(col_idx);
+      if (schema_provider.getColumnInfo(
+              col_info->db_id, col_info->table_id, col_info->column_id) != col_info) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool uses_current_time(const std::string& query_ra) {
+  for (auto op : {"\"CURRENT_DATE\"",
+                  "\"CURRENT_TIME\"",
+                  "\"CURRENT_TIMESTAMP\"",
+                  "\"NOW\"",
+                  "\"DATETIME\""}) {
+    if (query_ra.find(op) != std::string::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+std::unique_ptr<hdk::ir::QueryDag> RelAlgDagCache::get(
+    const std::string& query_ra,
+    int db_id,
+    const SchemaProvider& schema_provider,
+    ConfigPtr config) {
+  if (!max_size_) {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto entry = cache_.get(getKey(query_ra, db_id));
+  // Entries of DAGs being executed are empty.
+  if (!entry || !*entry) {
+    return nullptr;
+  }
+  std::unique_ptr<hdk::ir::QueryDag> res = std::move(*entry);
+  if (res->config() != config || !has_current_schema(*res, schema_provider)) {
+    return nullptr;
+  }
+  return res;
+}
+
+void RelAlgDagCache::put(const std::string& query_ra,
+                         int db_id,
+                         std::unique_ptr<hdk::ir::QueryDag> dag) {
+  if (!max_size_ || !dag || uses_current_time(query_ra)) {
+    return;
+  }
+
+  // Drop the execution state, including step results holding temporary tables.
+  dag->resetQueryExecutionState();
+  for (auto node : collect_nodes(*dag)) {
+    node->clearContextData();
+    node->setOutputMetainfo({});
+    node->setResult(nullptr);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache_.put(getKey(query_ra, db_id), std::move(dag));
+}
+
+void RelAlgDagCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache_.clear();
+}
+
+size_t RelAlgDagCache::size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return cache_.size();
+}
+
+std::string RelAlgDagCache::getKey(const std::string& query_ra, int db_id) {
+  return std::to_string(db_id) + ":" + query_ra;
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "IR/Node.h"
+#include "SchemaMgr/SchemaProvider.h"
+#include "StringDictionary/LruCache.hpp"
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * Cache of DAGs built and optimized by RelAlgDagBuilder, keyed by the relational
+ * algebra JSON they were built from and the database ID.
+ *
+ * Execution stores its state and step results in DAG nodes, so a DAG is used by a
+ * single query at a time: get() removes it from the cache and put() returns it after
+ * execution. Concurrent executions of the same query miss and build their own DAGs.
+ *
+ * Tables and columns referenced by a DAG are validated on lookup. Schema changes and
+ * appends create new table and column infos, so the DAG is rebuilt when any of its
+ * tables is altered, appended to, dropped or re-created (DAG building depends on the
+ * number of table fragments). Built DAGs don't depend on dictionaries. DAGs with
+ * current date and time functions are not cached because these functions are
+ * evaluated while building.
+ */
+class RelAlgDagCache {
+ public:
+  RelAlgDagCache(size_t max_size) : cache_(max_size), max_size_(max_size) {}
+
+  // Returns nullptr if there is no valid DAG for the query.
+  std::unique_ptr<hdk::ir::QueryDag> get(const std::string& query_ra,
+                                         int db_id,
+                                         const SchemaProvider& schema_provider,
+                                         ConfigPtr config);
+
+  // Stores an executed DAG built from the specified query.
+  void put(const std::string& query_ra,
+           int db_id,
+           std::unique_ptr<hdk::ir::QueryDag> dag);
+
+  void clear();
+
+  size_t size();
+
+ private:
+  static std::string getKey(const std::string& query_ra, int db_id);
+
+  std::mutex mutex_;
+  LruCache<std::string, std::unique_ptr<hdk::ir::QueryDag>> cache_;
+  const size_t max_size_;
+};
@@ -51,7 +51,11 @@
 #include <boost/range/adaptor/reversed.hpp>
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <functional>
+#include <future>
 #include <numeric>
 
 using namespace std::string_literals;
@@ -141,7 +145,9 @@ RelAlgExecutor::~RelAlgExecutor() {
   // may still remain pinned by the final query result though.
   std::set<int, std::greater<int>> tmp_table_ids;
   for (auto& pr : temporary_tables_) {
-    tmp_table_ids.insert(pr.second->tableId());
+    if (!borrowed_table_ids_.count(pr.second->tableId())) {
+      tmp_table_ids.insert(pr.second->tableId());
+    }
   }
   auto data_mgr = executor_->getDataMgr();
   ChunkKey prefix = {hdk::ResultSetRegistry::DB_ID, 0};
@@ -158,8 +164,24 @@ ExecutionResult RelAlgExecutor::executeRelAlgQuery(const CompilationOptions& co,
   auto timer = DEBUG_TIMER(__func__);
   INJECT_TIMER(executeRelAlgQuery);
 
+  // With concurrent queries enabled, run on an executor not used by other queries.
+  auto query_executor = executor_->acquireQueryExecutor();
+  auto orig_executor = executor_;
+  executor_ = query_executor.get();
+  auto memory_tracker =
+      std::make_shared<hdk::QueryMemoryTracker>(config_.exec.max_query_memory);
+  executor_->setQueryProgress(query_progress_);
+  executor_->setQueryMemoryTracker(memory_tracker);
+  ScopeGuard restore_executor = [this, orig_executor, memory_tracker] {
+    memory_tracker->releaseShared();
+    executor_->setQueryProgress(nullptr);
+    executor_->setQueryMemoryTracker(nullptr);
+    executor_ = orig_executor;
+  };
+
   auto run_query = [&](const CompilationOptions& co_in) {
     auto execution_result = executeRelAlgQueryNoRetry(co_in, eo, just_explain_plan);
+    execution_result.setMemoryStats(memory_tracker->stats());
 
     constexpr bool vlog_result_set_summary{false};
     if constexpr (vlog_result_set_summary) {
@@ -333,6 +355,9 @@ void RelAlgExecutor::prepareLeafExecution(
   queue_time_ms_ = timer_stop(clock_begin);
   executor_->row_set_mem_owner_ = std::make_shared<RowSetMemoryOwner>(
       data_provider_, Executor::getArenaBlockSize(), cpu_threads());
+  if (executor_->query_memory_tracker_) {
+    executor_->row_set_mem_owner_->setMemoryTracker(executor_->query_memory_tracker_);
+  }
   executor_->string_dictionary_generations_ = string_dictionary_generations;
   executor_->table_generations_ = table_generations;
   executor_->agg_col_range_cache_ = agg_col_range;
@@ -373,11 +398,83 @@ std::shared_ptr<const ExecutionResult> RelAlgExecutor::execute(
   };
 
   const auto exec_desc_count = get_descriptor_count();
-  // this join info needs to be maintained throughout an entire query runtime
-  for (size_t i = 0; i < exec_desc_count; i++) {
+
+  // Steps which don't consume results of other steps are compiled by helper
+  // executors while preceding steps are executed. Generated code is shared
+  // through the code caches, so the main executor gets a cache hit when it
+  // reaches the step. Each step is compiled either by a helper or by the main
+  // thread, whichever claims it first.
+  std::vector<size_t> precompiled_steps;
+  std::vector<int> step_to_precompiled(exec_desc_count, -1);
+  const auto compilation_threads = config_.exec.codegen.parallel_compilation_threads;
+  if (compilation_threads && co.device_type == ExecutorDeviceType::CPU &&
+      eo.executor_type == ::ExecutorType::Native && !eo.just_explain) {
+    for (size_t i = 1; i < exec_desc_count; ++i) {
+      auto step = seq.step(i);
+      if (seq.dependencies(i).empty() && !step->is<hdk::ir::LogicalValues>() &&
+          !step->is<hdk::ir::LogicalUnion>()) {
+        step_to_precompiled[i] = precompiled_steps.size();
+        precompiled_steps.push_back(i);
+      }
+    }
+  }
+  std::vector<std::atomic<bool>> step_claimed(precompiled_steps.size());
+  std::vector<std::promise<void>> step_compiled(precompiled_steps.size());
+  std::vector<std::shared_ptr<Executor>> helpers;
+  std::vector<std::future<void>> compilation_workers;
+  std::atomic<bool> stop_compilation{false};
+  ScopeGuard join_compilation_workers = [&] {
+    stop_compilation = true;
+    for (auto& worker : compilation_workers) {
+      worker.wait();
+    }
+    for (auto& helper : helpers) {
+      helper->clearMetaInfoCache();
+      helper->row_set_mem_owner_.reset();
+      helper->query_memory_tracker_.reset();
+    }
+  };
+  for (size_t i = 0; i < std::min(compilation_threads, precompiled_steps.size()); ++i) {
+    auto helper = executor_->getCompilationHelper(i);
+    helper->setSchemaProvider(schema_provider_);
+    helper->row_set_mem_owner_ = std::make_shared<RowSetMemoryOwner>(
+        data_provider_, Executor::getArenaBlockSize(), cpu_threads());
+    helper->string_dictionary_generations_ = executor_->string_dictionary_generations_;
+    helper->table_generations_ = executor_->table_generations_;
+    helper->agg_col_range_cache_ = executor_->agg_col_range_cache_;
+    helper->query_memory_tracker_ = executor_->query_memory_tracker_;
+    helpers.push_back(helper);
+    compilation_workers.emplace_back(std::async(std::launch::async, [&, helper] {
+      for (size_t idx = 0; idx < precompiled_steps.size() && !stop_compilation; ++idx) {
+        if (step_claimed[idx].exchange(true)) {
+          continue;
+        }
+        ScopeGuard notify_compiled = [&step_compiled, idx] {
+          step_compiled[idx].set_value();
+        };
+        try {
+          precompileStep(seq.step(precompiled_steps[idx]), helper.get(), co, eo);
+        } catch (const std::exception& e) {
+          VLOG(1) << "Failed to precompile query step " << precompiled_steps[idx]
+                  << ": " << e.what();
+        }
+      }
+    }));
+  }
+
+  auto run_step = [&](RelAlgExecutor& ra_executor, size_t i) {
+    if (query_progress_ && query_progress_->isCancelled()) {
+      throw std::runtime_error(getErrorMessageFromCode(Executor::ERR_INTERRUPTED));
+    }
+    if (step_to_precompiled[i] >= 0) {
+      auto idx = static_cast<size_t>(step_to_precompiled[i]);
+      if (step_claimed[idx].exchange(true)) {
+        step_compiled[idx].get_future().wait();
+      }
+    }
     VLOG(1) << "Executing query step " << i;
     try {
-      executeStep(seq.step(i), co, eo, queue_time_ms);
+      ra_executor.executeStep(seq.step(i), co, eo, queue_time_ms);
     } catch (const QueryMustRunOnCpu&) {
       CHECK(co.device_type == ExecutorDeviceType::GPU);
       if (!config_.exec.heterogeneous.allow_query_step_cpu_retry) {
@@ -385,20 +482,178 @@ std::shared_ptr<const ExecutionResult> RelAlgExecutor::execute(
       }
       LOG(INFO) << "Retrying current query step " << i << " on CPU";
       const auto co_cpu = CompilationOptions::makeCpuOnly(co);
-      executeStep(seq.step(i), co_cpu, eo, queue_time_ms);
+      ra_executor.executeStep(seq.step(i), co_cpu, eo, queue_time_ms);
     } catch (const NativeExecutionError&) {
       if (!config_.exec.enable_interop) {
         throw;
       }
       auto eo_extern = eo;
       eo_extern.executor_type = ::ExecutorType::Extern;
-      executeStep(seq.step(i), co, eo_extern, queue_time_ms);
+      ra_executor.executeStep(seq.step(i), co, eo_extern, queue_time_ms);
+    }
+  };
+
+  if (config_.exec.parallel_steps > 1 && co.device_type == ExecutorDeviceType::CPU &&
+      eo.executor_type == ::ExecutorType::Native && !eo.just_explain &&
+      exec_desc_count > 2) {
+    executeStepsInParallel(seq, run_step);
+  } else {
+    // this join info needs to be maintained throughout an entire query runtime
+    for (size_t i = 0; i < exec_desc_count; i++) {
+      run_step(*this, i);
     }
   }
 
   return seq.step(exec_desc_count - 1)->getResult();
 }
 
+void RelAlgExecutor::executeStepsInParallel(
+    const hdk::QueryExecutionSequence& seq,
+    const std::function<void(RelAlgExecutor&, size_t)>& run_step) {
+  auto timer = DEBUG_TIMER(__func__);
+  // Steps are executed as soon as all steps they depend on are finished. The main
+  // thread executes a ready step itself when no other step is running, so a chain of
+  // dependent steps is executed as usual. Otherwise, ready steps are executed by
+  // step executors, each getting its own RelAlgExecutor with a snapshot of the
+  // temporary tables. The snapshot is taken because finished steps add their results
+  // to the main executor while other steps are running. Tables of the snapshot and
+  // the step result are borrowed: they are used by other steps and dropped by the
+  // main executor only. Step executors share the row set memory owner with the main
+  // executor to keep string dictionary proxies of all step results in one place.
+  std::vector<size_t> deps_left(seq.size());
+  std::vector<std::vector<size_t>> users(seq.size());
+  std::deque<size_t> ready;
+  for (size_t i = 0; i < seq.size(); ++i) {
+    deps_left[i] = seq.dependencies(i).size();
+    for (auto dep : seq.dependencies(i)) {
+      users[dep].push_back(i);
+    }
+    if (!deps_left[i]) {
+      ready.push_back(i);
+    }
+  }
+
+  std::mutex finished_mutex;
+  std::condition_variable finished_cv;
+  // Finished steps with the indexes of step executors which executed them.
+  std::vector<std::pair<size_t, size_t>> finished;
+  std::exception_ptr error;
+  std::vector<size_t> free_step_executors;
+  for (size_t i = config_.exec.parallel_steps; i > 0; --i) {
+    free_step_executors.push_back(i - 1);
+  }
+  std::vector<std::future<void>> workers;
+  ScopeGuard join_workers = [&workers] {
+    for (auto& worker : workers) {
+      worker.wait();
+    }
+  };
+
+  auto step_done = [&](size_t step_idx) {
+    for (auto user : users[step_idx]) {
+      if (!--deps_left[user]) {
+        ready.push_back(user);
+      }
+    }
+  };
+
+  size_t done = 0;
+  size_t running = 0;
+  while (done < seq.size()) {
+    while (!ready.empty() && !error) {
+      auto step_idx = ready.front();
+      if (!running && ready.size() == 1) {
+        ready.pop_front();
+        run_step(*this, step_idx);
+        step_done(step_idx);
+        ++done;
+        continue;
+      }
+      if (free_step_executors.empty()) {
+        break;
+      }
+      ready.pop_front();
+      auto step_executor_idx = free_step_executors.back();
+      free_step_executors.pop_back();
+      auto step_executor = executor_->getStepExecutor(step_executor_idx);
+      step_executor->setSchemaProvider(schema_provider_);
+      step_executor->row_set_mem_owner_ = executor_->row_set_mem_owner_;
+      step_executor->string_dictionary_generations_ =
+          executor_->string_dictionary_generations_;
+      step_executor->table_generations_ = executor_->table_generations_;
+      step_executor->agg_col_range_cache_ = executor_->agg_col_range_cache_;
+      step_executor->interrupted_.store(executor_->interrupted_.load());
+      step_executor->query_progress_ = executor_->query_progress_;
+      step_executor->query_memory_tracker_ = executor_->query_memory_tracker_;
+      std::shared_ptr<RelAlgExecutor> ra_executor(
+          new RelAlgExecutor(step_executor.get(), schema_provider_));
+      ra_executor->temporary_tables_ = temporary_tables_;
+      for (auto& pr : temporary_tables_) {
+        ra_executor->borrowed_table_ids_.insert(pr.second->tableId());
+      }
+      ra_executor->now_ = now_;
+      step_executor->temporary_tables_ = &ra_executor->temporary_tables_;
+      ++running;
+      VLOG(1) << "Executing query step " << step_idx << " on executor "
+              << step_executor->getExecutorId();
+      workers.emplace_back(std::async(
+          std::launch::async,
+          [&, step_idx, step_executor_idx, step_executor, ra_executor,
+           parent_thread_id = logger::thread_id()] {
+            DEBUG_TIMER_NEW_THREAD(parent_thread_id);
+            std::exception_ptr step_error;
+            try {
+              run_step(*ra_executor, step_idx);
+              // The result is handed over to the main executor.
+              if (auto res = seq.step(step_idx)->getResult()) {
+                ra_executor->borrowed_table_ids_.insert(res->getToken()->tableId());
+              }
+            } catch (...) {
+              step_error = std::current_exception();
+            }
+            step_executor->temporary_tables_ = nullptr;
+            step_executor->query_progress_.reset();
+            step_executor->query_memory_tracker_.reset();
+            step_executor->row_set_mem_owner_.reset();
+            step_executor->clearMetaInfoCache();
+            {
+              std::lock_guard<std::mutex> lock(finished_mutex);
+              finished.emplace_back(step_idx, step_executor_idx);
+              if (step_error && !error) {
+                error = step_error;
+              }
+            }
+            finished_cv.notify_one();
+          }));
+    }
+
+    if (!running) {
+      if (error) {
+        std::rethrow_exception(error);
+      }
+      CHECK(done == seq.size() || !ready.empty());
+      continue;
+    }
+
+    std::vector<std::pair<size_t, size_t>> newly_finished;
+    {
+      std::unique_lock<std::mutex> lock(finished_mutex);
+      finished_cv.wait(lock, [&finished] { return !finished.empty(); });
+      newly_finished.swap(finished);
+    }
+    for (auto [step_idx, step_executor_idx] : newly_finished) {
+      --running;
+      free_step_executors.push_back(step_executor_idx);
+      auto step_root = seq.step(step_idx);
+      if (auto res = step_root->getResult()) {
+        addTemporaryTable(-step_root->getId(), res->getToken());
+        step_done(step_idx);
+        ++done;
+      }
+    }
+  }
+}
+
 void RelAlgExecutor::handleNop(RaExecutionDesc& ed) {
   // just set the result of the previous node as the result of no op
   auto body = ed.getBody();
@@ -932,6 +1187,27 @@ ExecutionResult RelAlgExecutor::executeLogicalValues(
   return registerResultSetTable({rs}, tuple_type, false);
 }
 
+ExecutionResult RelAlgExecutor::executeMetadataAggregates(
+    hdk::MetadataAggregates& metadata_aggs,
+    const WorkUnit& work_unit,
+    const std::vector<TargetMetaInfo>& targets_meta,
+    const CompilationOptions& co,
+    const ExecutionOptions& eo,
+    const int64_t queue_time_ms) {
+  auto timer = DEBUG_TIMER(__func__);
+  if (!metadata_aggs.fragmentsToScan().empty()) {
+    VLOG(1) << "Scanning " << metadata_aggs.fragmentsToScan().size()
+            << " fragments not covered by metadata aggregates.";
+    auto eo_scan = eo;
+    eo_scan.outer_fragment_indices = metadata_aggs.fragmentsToScan();
+    auto scan_res =
+        executeWorkUnit(work_unit, targets_meta, true, co, eo_scan, queue_time_ms);
+    metadata_aggs.merge(*scan_res.getRows());
+  }
+  hdk::ir::LogicalValues values(targets_meta, {metadata_aggs.values()});
+  return executeLogicalValues(&values, eo);
+}
+
 namespace {
 
 /**
@@ -1086,6 +1362,17 @@ ExecutionResult RelAlgExecutor::executeWorkUnit(
   CHECK(body);
   const auto table_infos = get_table_infos(work_unit.exe_unit, executor_);
 
+  if (config_.opts.enable_metadata_aggregates && is_agg && !eo.just_explain &&
+      !eo.just_validate && eo.executor_type == ::ExecutorType::Native &&
+      eo.outer_fragment_indices.empty()) {
+    auto metadata_aggs =
+        hdk::MetadataAggregates::compute(work_unit.exe_unit, targets_meta, table_infos);
+    if (metadata_aggs) {
+      return executeMetadataAggregates(
+          *metadata_aggs, work_unit, targets_meta, co, eo, queue_time_ms);
+    }
+  }
+
   auto ra_exe_unit = decide_approx_count_distinct_implementation(
       work_unit.exe_unit, table_infos, executor_, co.device_type, target_exprs_owned_);
 
@@ -1224,6 +1511,8 @@ std::optional<size_t> RelAlgExecutor::getFilteredCountAll(const WorkUnit& work_u
   } catch (const QueryMustRunOnCpu&) {
     // force a retry of the top level query on CPU
     throw;
+  } catch (const hdk::QueryMemoryLimitExceeded&) {
+    throw;
   } catch (const std::exception& e) {
     LOG(WARNING) << "Failed to run pre-flight filtered count with error " << e.what();
     return std::nullopt;
@@ -1241,6 +1530,87 @@ std::optional<size_t> RelAlgExecutor::getFilteredCountAll(const WorkUnit& work_u
   return std::max(count_upper_bound, size_t(1));
 }
 
+void RelAlgExecutor::precompileStep(const hdk::ir::Node* step_root,
+                                    Executor* executor,
+                                    const CompilationOptions& co,
+                                    const ExecutionOptions& eo) {
+  auto timer = DEBUG_TIMER(__func__);
+  // The step doesn't depend on other steps, so it reads physical tables only and
+  // doesn't need temporary tables being added by the main thread.
+  TemporaryTables temporary_tables;
+  executor->temporary_tables_ = &temporary_tables;
+  ScopeGuard reset_temporary_tables = [executor] {
+    executor->temporary_tables_ = nullptr;
+  };
+
+  // Mirror createWorkUnit and executeWorkUnit without touching the node and
+  // executor state used by the main thread.
+  hdk::WorkUnitBuilder builder(step_root,
+                               query_dag_.get(),
+                               executor,
+                               schema_provider_,
+                               temporary_tables,
+                               eo,
+                               co,
+                               now_,
+                               false,
+                               true);
+  auto exe_unit = builder.exeUnit();
+  if (is_window_execution_unit(exe_unit)) {
+    return;
+  }
+  const auto query_infos = get_table_infos(exe_unit.input_descs, executor);
+  QueryRewriter query_rewriter(query_infos, executor);
+  WorkUnit work_unit{query_rewriter.rewrite(exe_unit),
+                     step_root,
+                     builder.maxGroupsBufferEntryGuess(),
+                     nullptr,
+                     {},
+                     {}};
+  auto target_exprs_owned = builder.releaseTargetExprsOwned();
+  const auto table_infos = get_table_infos(work_unit.exe_unit, executor);
+  const auto eo_validate = eo.with_just_validate(true);
+  ColumnCacheMap column_cache;
+
+  if (compute_output_buffer_size(work_unit.exe_unit) && !isRowidLookup(work_unit)) {
+    // The output buffer size comes from the filtered count query executed
+    // first, so only that query can be compiled in advance.
+    auto count_type = hdk::ir::Context::defaultCtx().integer(
+        config_.exec.group_by.bigint_count ? 8 : 4);
+    const auto count = hdk::ir::makeExpr<hdk::ir::AggExpr>(
+        count_type,
+        hdk::ir::AggType::kCount,
+        nullptr,
+        false,
+        nullptr);
+    size_t one{1};
+    executor->executeWorkUnit(one,
+                              true,
+                              table_infos,
+                              create_count_all_execution_unit(work_unit.exe_unit, count),
+                              co,
+                              eo_validate,
+                              false,
+                              data_provider_,
+                              column_cache);
+    return;
+  }
+
+  auto ra_exe_unit = decide_approx_count_distinct_implementation(
+      work_unit.exe_unit, table_infos, executor, co.device_type, target_exprs_owned);
+  auto max_groups_buffer_entry_guess = work_unit.max_groups_buffer_entry_guess;
+  executor->executeWorkUnit(
+      max_groups_buffer_entry_guess,
+      is_agg_step(step_root),
+      table_infos,
+      ra_exe_unit,
+      co,
+      eo_validate,
+      groups_approx_upper_bound(table_infos) <= config_.exec.group_by.big_group_threshold,
+      data_provider_,
+      column_cache);
+}
+
 bool RelAlgExecutor::isRowidLookup(const WorkUnit& work_unit) {
   const auto& ra_exe_unit = work_unit.exe_unit;
   if (ra_exe_unit.input_descs.size() != 1) {
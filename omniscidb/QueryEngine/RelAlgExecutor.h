@@ -22,6 +22,7 @@
 #include "QueryEngine/Execute.h"
 #include "QueryEngine/InputMetadata.h"
 #include "QueryEngine/JoinFilterPushDown.h"
+#include "QueryEngine/MetadataAggregates.h"
 #include "QueryEngine/QueryExecutionSequence.h"
 #include "QueryEngine/QueryRewrite.h"
 #include "QueryEngine/RelAlgDagBuilder.h"
@@ -33,6 +34,7 @@
 
 #include <ctime>
 #include <sstream>
+#include <unordered_set>
 
 enum class MergeType { Union, Reduce };
 
@@ -88,6 +90,9 @@ class RelAlgExecutor {
     return query_dag_->getRootNodeShPtr();
   }
 
+  // Takes the executed DAG back, e.g. to reuse it for the same query.
+  std::unique_ptr<hdk::ir::QueryDag> releaseQueryDag() { return std::move(query_dag_); }
+
   std::pair<std::vector<unsigned>, std::unordered_map<unsigned, JoinQualsPerNestingLevel>>
   getJoinInfo(const hdk::ir::Node* root_node);
 
@@ -111,6 +116,12 @@ class RelAlgExecutor {
 
   void executePostExecutionCallback();
 
+  // Sets the progress object used to report processed fragments and to cancel the
+  // query. Should be set before the query execution.
+  void setQueryProgress(std::shared_ptr<hdk::QueryProgress> query_progress) {
+    query_progress_ = std::move(query_progress);
+  }
+
   static const SpeculativeTopNBlacklist& speculativeTopNBlacklist() {
     return speculative_topn_blacklist_;
   }
@@ -132,6 +143,12 @@ class RelAlgExecutor {
                               const int64_t queue_time_ms,
                               bool allow_speculative_sort);
 
+  // Executes steps of the sequence concurrently, respecting their dependencies.
+  // `run_step` executes the specified step using the specified RelAlgExecutor.
+  void executeStepsInParallel(
+      const hdk::QueryExecutionSequence& seq,
+      const std::function<void(RelAlgExecutor&, size_t)>& run_step);
+
   // Computes the window function results to be used by the query.
   void computeWindow(const RelAlgExecutionUnit& ra_exe_unit,
                      const CompilationOptions& co,
@@ -172,6 +189,16 @@ class RelAlgExecutor {
       const int64_t queue_time_ms,
       const std::optional<size_t> previous_count = std::nullopt);
 
+  // Computes aggregates using fragment metadata and merges them with the result of
+  // the scan of fragments not covered by metadata.
+  ExecutionResult executeMetadataAggregates(
+      hdk::MetadataAggregates& metadata_aggs,
+      const WorkUnit& work_unit,
+      const std::vector<TargetMetaInfo>& targets_meta,
+      const CompilationOptions& co,
+      const ExecutionOptions& eo,
+      const int64_t queue_time_ms);
+
   size_t getNDVEstimation(const WorkUnit& work_unit,
                           const int64_t range,
                           const bool is_agg,
@@ -207,6 +234,13 @@ class RelAlgExecutor {
   // appropriate exception corresponding to the query error code.
   void handlePersistentError(const int32_t error_code);
 
+  // Compiles the step using the specified helper executor without executing it.
+  // Used for steps which don't depend on other steps only.
+  void precompileStep(const hdk::ir::Node* step_root,
+                      Executor* executor,
+                      const CompilationOptions& co,
+                      const ExecutionOptions& eo);
+
   WorkUnit createWorkUnit(const hdk::ir::Node*,
                           const SortInfo&,
                           const ExecutionOptions& eo);
@@ -239,6 +273,9 @@ class RelAlgExecutor {
   std::shared_ptr<hdk::ResultSetRegistry> rs_registry_;
   const Config& config_;
   TemporaryTables temporary_tables_;
+  // Ids of temporary tables owned by another executor, which are not dropped on
+  // destruction. Used by step executors of parallel steps.
+  std::unordered_set<int> borrowed_table_ids_;
   time_t now_;
   std::unordered_map<unsigned, JoinQualsPerNestingLevel> left_deep_join_info_;
   std::vector<hdk::ir::ExprPtr> target_exprs_owned_;  // TODO(alex): remove
@@ -249,6 +286,8 @@ class RelAlgExecutor {
 
   std::shared_ptr<StreamExecutionContext> stream_execution_context_;
 
+  std::shared_ptr<hdk::QueryProgress> query_progress_;
+
   TemplateAggregationVisitor templVisitor;
 
   friend class PendingExecutionClosure;
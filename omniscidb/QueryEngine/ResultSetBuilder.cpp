@@ -114,7 +114,12 @@ ResultSet* ResultSetLogicalValuesBuilder::build() {
 
         if (constant->isNull()) {
           CHECK(!targets[j].type->isString() && !targets[j].type->isArray());
-          *reinterpret_cast<int64_t*>(ptr) = inline_int_null_value(targets[j].type);
+          if (targets[j].type->isFloatingPoint()) {
+            // Floating point values are stored as doubles, see below.
+            *reinterpret_cast<double*>(ptr) = inline_fp_null_value<double>();
+          } else {
+            *reinterpret_cast<int64_t*>(ptr) = inline_int_null_value(targets[j].type);
+          }
         } else {
           auto type = constant->type();
           const auto datum = constant->value();
@@ -36,6 +36,7 @@
 #include "Shared/thread_count.h"
 #include "Shared/threading.h"
 
+#include <boost/functional/hash.hpp>
 #include <llvm/ExecutionEngine/GenericValue.h>
 
 #include <algorithm>
@@ -119,6 +120,29 @@ inline int64_t get_component(const int8_t* group_by_buffer,
   return ret;
 }
 
+// Hash of the baseline group key of the entry. Used to assign entries with equal keys
+// to the same reduction worker.
+size_t get_baseline_key_hash(const QueryMemoryDescriptor& query_mem_desc,
+                             const int8_t* buff,
+                             const size_t entry_idx) {
+  const auto key_count = query_mem_desc.getGroupbyColCount();
+  size_t hash = 0;
+  if (query_mem_desc.didOutputColumnar()) {
+    const auto buff_i64 = reinterpret_cast<const int64_t*>(buff);
+    const auto entry_count = query_mem_desc.getEntryCount();
+    for (size_t i = 0; i < key_count; ++i) {
+      boost::hash_combine(hash, buff_i64[key_offset_colwise(entry_idx, i, entry_count)]);
+    }
+  } else {
+    const auto key_ptr = row_ptr_rowwise(buff, query_mem_desc, entry_idx);
+    const auto key_width = query_mem_desc.getEffectiveKeyWidth();
+    for (size_t i = 0; i < key_count; ++i) {
+      boost::hash_combine(hash, get_component(key_ptr, key_width, i));
+    }
+  }
+  return hash;
+}
+
 void run_reduction_code(const ReductionCode& reduction_code,
                         int8_t* this_buff,
                         const int8_t* that_buff,
@@ -329,6 +353,74 @@ void ResultSetReduction::reduce(const ResultSetStorage& this_,
   }
 }
 
+void ResultSetReduction::reducePartitioned(
+    const ResultSetStorage& this_,
+    const std::vector<const ResultSetStorage*>& those,
+    const ReductionCode& reduction_code,
+    const Config& config,
+    const Executor* executor) {
+  const auto& this_query_mem_desc = this_.getQueryMemDesc();
+  const auto entry_count = this_query_mem_desc.getEntryCount();
+  const auto total_entry_count = std::accumulate(
+      those.begin(), those.end(), size_t(0), [](size_t init, auto that) {
+        return init + that->getQueryMemDesc().getEntryCount();
+      });
+  const auto query_type = this_query_mem_desc.getQueryDescriptionType();
+  if (!use_multithreaded_reduction(total_entry_count) ||
+      (query_type != QueryDescriptionType::GroupByPerfectHash &&
+       query_type != QueryDescriptionType::GroupByBaselineHash)) {
+    for (auto that : those) {
+      reduce(this_, *that, {}, reduction_code, config, executor);
+    }
+    return;
+  }
+
+  if (query_type == QueryDescriptionType::GroupByBaselineHash) {
+    reduceBaselinePartitioned(this_, those, reduction_code, config, executor);
+    return;
+  }
+
+  // Perfect hash buffers share the layout, so a range of entries is the same part of
+  // the key space in all inputs.
+  auto this_buff = this_.getUnderlyingBuffer();
+  CHECK(this_buff);
+  for (auto that : those) {
+    CHECK_EQ(entry_count, that->getQueryMemDesc().getEntryCount());
+    CHECK(that->getUnderlyingBuffer());
+  }
+  if (!this_query_mem_desc.didOutputColumnar()) {
+    CHECK(reduction_code.ir_reduce_loop);
+  }
+  const std::vector<std::string> serialized_varlen_buffer;
+  threading::parallel_for(
+      threading::blocked_range<size_t>(0, entry_count), [&](auto r) {
+        for (auto that : those) {
+          auto that_buff = that->getUnderlyingBuffer();
+          if (this_query_mem_desc.didOutputColumnar()) {
+            reduceEntriesNoCollisionsColWise(this_,
+                                             *that,
+                                             this_buff,
+                                             that_buff,
+                                             r.begin(),
+                                             r.end(),
+                                             serialized_varlen_buffer,
+                                             executor);
+          } else {
+            run_reduction_code(reduction_code,
+                               this_buff,
+                               that_buff,
+                               r.begin(),
+                               r.end(),
+                               entry_count,
+                               &this_query_mem_desc,
+                               &that->getQueryMemDesc(),
+                               &serialized_varlen_buffer,
+                               executor);
+          }
+        }
+      });
+}
+
 namespace {
 
 ALWAYS_INLINE void check_watchdog() {
@@ -732,6 +824,91 @@ void ResultSetReduction::reduceOneEntryBaseline(const ResultSetStorage& this_,
       this_, that, this_entry_slots, that_buff_i64, that_entry_idx);
 }
 
+void ResultSetReduction::reduceBaselinePartitioned(
+    const ResultSetStorage& this_,
+    const std::vector<const ResultSetStorage*>& those,
+    const ReductionCode& reduction_code,
+    const Config& config,
+    const Executor* executor) {
+  const auto& this_query_mem_desc = this_.getQueryMemDesc();
+  auto this_buff = this_.getUnderlyingBuffer();
+  CHECK(this_buff);
+  // Inserts into the output hash table are lock-free, so workers can insert different
+  // keys concurrently. More partitions than threads balance skewed key distributions.
+  const size_t partition_count = cpu_threads() * 4;
+  constexpr size_t kChunkSize = 65536;
+
+  // Split non-empty entries of the inputs into partitions by key hash. Entries are
+  // scanned in chunks, each chunk stores its entries for every partition.
+  struct InputChunk {
+    const ResultSetStorage* that;
+    size_t start;
+    size_t end;
+    std::vector<std::vector<uint32_t>> partitions;
+  };
+  std::vector<InputChunk> chunks;
+  for (auto that : those) {
+    const auto that_entry_count = that->getQueryMemDesc().getEntryCount();
+    CHECK_GE(this_query_mem_desc.getEntryCount(), that_entry_count);
+    CHECK_LE(that_entry_count, size_t(std::numeric_limits<int32_t>::max()));
+    CHECK(that->getUnderlyingBuffer());
+    for (size_t start = 0; start < that_entry_count; start += kChunkSize) {
+      chunks.push_back({that, start, std::min(start + kChunkSize, that_entry_count), {}});
+    }
+  }
+  threading::parallel_for(
+      threading::blocked_range<size_t>(0, chunks.size()), [&](auto r) {
+        for (size_t chunk_idx = r.begin(); chunk_idx < r.end(); ++chunk_idx) {
+          auto& chunk = chunks[chunk_idx];
+          const auto& that_query_mem_desc = chunk.that->getQueryMemDesc();
+          auto that_buff = chunk.that->getUnderlyingBuffer();
+          chunk.partitions.resize(partition_count);
+          for (size_t entry_idx = chunk.start; entry_idx < chunk.end; ++entry_idx) {
+            if (chunk.that->isEmptyEntry(entry_idx, that_buff)) {
+              continue;
+            }
+            const auto hash =
+                get_baseline_key_hash(that_query_mem_desc, that_buff, entry_idx);
+            chunk.partitions[hash % partition_count].push_back(entry_idx);
+          }
+        }
+      });
+
+  // Each worker merges entries of its partitions from all inputs.
+  threading::parallel_for(
+      threading::blocked_range<size_t>(0, partition_count), [&](auto r) {
+        for (size_t partition_idx = r.begin(); partition_idx < r.end();
+             ++partition_idx) {
+          for (const auto& chunk : chunks) {
+            const auto& that_query_mem_desc = chunk.that->getQueryMemDesc();
+            const auto that_entry_count = that_query_mem_desc.getEntryCount();
+            auto that_buff = chunk.that->getUnderlyingBuffer();
+            for (auto entry_idx : chunk.partitions[partition_idx]) {
+              if (reduction_code.ir_reduce_loop) {
+                run_reduction_code(reduction_code,
+                                   this_buff,
+                                   that_buff,
+                                   entry_idx,
+                                   entry_idx + 1,
+                                   that_entry_count,
+                                   &this_query_mem_desc,
+                                   &that_query_mem_desc,
+                                   nullptr,
+                                   executor);
+              } else {
+                reduceOneEntryBaseline(this_,
+                                       *chunk.that,
+                                       this_buff,
+                                       that_buff,
+                                       entry_idx,
+                                       config.exec.watchdog.enable_dynamic);
+              }
+            }
+          }
+        }
+      });
+}
+
 void ResultSetReduction::reduceOneEntrySlotsBaseline(const ResultSetStorage& this_,
                                                      const ResultSetStorage& that,
                                                      int64_t* this_entry_slots,
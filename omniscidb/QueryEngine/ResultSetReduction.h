@@ -20,6 +20,16 @@ class ResultSetReduction {
                      const Config& config,
                      const Executor* executor);
 
+  // Reduces all storages from `those` into `this_` in a single parallel pass. Workers
+  // own disjoint parts of the key space: entry ranges for perfect hash layouts and
+  // hash partitions of keys for the baseline layout. Each entry of `this_` is updated
+  // by a single worker, so targets are merged without synchronization.
+  static void reducePartitioned(const ResultSetStorage& this_,
+                                const std::vector<const ResultSetStorage*>& those,
+                                const ReductionCode& reduction_code,
+                                const Config& config,
+                                const Executor* executor);
+
   // Reduces results for a single row when using interleaved bin layouts
   static bool reduceSingleRow(const int8_t* row_ptr,
                               const int8_t warp_count,
@@ -53,6 +63,11 @@ class ResultSetReduction {
                                      const int8_t* that_buff,
                                      const size_t that_entry_idx,
                                      bool enable_dynamic_watchdog);
+  static void reduceBaselinePartitioned(const ResultSetStorage& this_,
+                                        const std::vector<const ResultSetStorage*>& those,
+                                        const ReductionCode& reduction_code,
+                                        const Config& config,
+                                        const Executor* executor);
   static void reduceOneEntrySlotsBaseline(const ResultSetStorage& this_,
                                           const ResultSetStorage& that,
                                           int64_t* this_entry_slots,
@@ -127,6 +127,7 @@ bool RowFuncBuilder::codegen(llvm::Value* filter_result,
     if (executor_->isArchMaxwell(co.device_type)) {
       executor_->prependForceSync();
     }
+    auto filter_bb = executor_->cgen_state_->ir_builder_.GetInsertBlock();
     DiamondCodegen filter_cfg(filter_result,
                               executor_,
                               !is_group_by || query_mem_desc.usesGetGroupValueFast(),
@@ -134,6 +135,8 @@ bool RowFuncBuilder::codegen(llvm::Value* filter_result,
                               nullptr,
                               false);
     filter_false = filter_cfg.cond_false_;
+    executor_->cgen_state_->filter_br_ =
+        llvm::cast<llvm::BranchInst>(filter_bb->getTerminator());
 
     if (is_group_by) {
       if (query_mem_desc.getQueryDescriptionType() == QueryDescriptionType::Projection &&
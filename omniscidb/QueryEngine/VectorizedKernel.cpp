@@ -0,0 +1,939 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "QueryEngine/VectorizedKernel.h"
+
+#include "QueryEngine/DynamicWatchdog.h"
+#include "QueryEngine/Execute.h"
+#include "QueryEngine/OutputBufferInitialization.h"
+#include "QueryEngine/PlanState.h"
+#include "QueryEngine/RuntimeFunctions.h"
+#include "Shared/EmptyKeyValues.h"
+#include "Shared/InlineNullValues.h"
+#include "Shared/TargetInfo.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+
+namespace {
+
+constexpr size_t kBatchSize = 1024;
+
+using Column = VectorizedKernel::Column;
+using Predicate = VectorizedKernel::Predicate;
+using Slot = VectorizedKernel::Slot;
+using SlotKind = VectorizedKernel::SlotKind;
+
+template <typename T, typename V>
+void decode(const int8_t* data, const int64_t start, const size_t count, V* out) {
+  const T* values = reinterpret_cast<const T*>(data) + start;
+  for (size_t i = 0; i < count; ++i) {
+    out[i] = values[i];
+  }
+}
+
+template <typename V>
+V null_value(const Column& col) {
+  if constexpr (std::is_same_v<V, double>) {
+    return col.fp_null;
+  } else {
+    return col.int_null;
+  }
+}
+
+template <typename V, typename Cmp>
+void compare(const V* vals,
+             const size_t count,
+             const bool nullable,
+             const V null_val,
+             const V constant,
+             Cmp cmp,
+             uint8_t* mask) {
+  if (nullable) {
+    for (size_t i = 0; i < count; ++i) {
+      mask[i] &= (vals[i] != null_val) & cmp(vals[i], constant);
+    }
+  } else {
+    for (size_t i = 0; i < count; ++i) {
+      mask[i] &= cmp(vals[i], constant);
+    }
+  }
+}
+
+template <typename V>
+void apply_predicate(const Predicate& pred,
+                     const Column& col,
+                     const V* vals,
+                     const size_t count,
+                     uint8_t* mask) {
+  const V null_val = null_value<V>(col);
+  if (pred.op == hdk::ir::OpType::kIsNull) {
+    const uint8_t expected = !pred.negated;
+    for (size_t i = 0; i < count; ++i) {
+      mask[i] &= (col.nullable && vals[i] == null_val) == expected;
+    }
+    return;
+  }
+  V constant;
+  if constexpr (std::is_same_v<V, double>) {
+    constant = pred.fp_val;
+  } else {
+    constant = pred.int_val;
+  }
+  switch (pred.op) {
+    case hdk::ir::OpType::kEq:
+      compare(vals, count, col.nullable, null_val, constant, std::equal_to<V>(), mask);
+      break;
+    case hdk::ir::OpType::kNe:
+      compare(
+          vals, count, col.nullable, null_val, constant, std::not_equal_to<V>(), mask);
+      break;
+    case hdk::ir::OpType::kLt:
+      compare(vals, count, col.nullable, null_val, constant, std::less<V>(), mask);
+      break;
+    case hdk::ir::OpType::kGt:
+      compare(vals, count, col.nullable, null_val, constant, std::greater<V>(), mask);
+      break;
+    case hdk::ir::OpType::kLe:
+      compare(vals, count, col.nullable, null_val, constant, std::less_equal<V>(), mask);
+      break;
+    case hdk::ir::OpType::kGe:
+      compare(
+          vals, count, col.nullable, null_val, constant, std::greater_equal<V>(), mask);
+      break;
+    default:
+      CHECK(false);
+  }
+}
+
+// Decodes a batch of rows of all the used columns to 64-bit values and computes the
+// selection vector of rows passing the filter.
+class BatchReader {
+ public:
+  BatchReader(const std::vector<Column>& columns,
+              const std::vector<Predicate>& predicates,
+              const int8_t** col_buffers,
+              const uint64_t frag_row_offset)
+      : columns_(columns)
+      , predicates_(predicates)
+      , col_buffers_(col_buffers)
+      , frag_row_offset_(frag_row_offset) {
+    size_t int_count = 0;
+    size_t fp_count = 0;
+    for (const auto& col : columns_) {
+      value_idx_.push_back(col.is_fp ? fp_count++ : int_count++);
+    }
+    ints_.resize(int_count * kBatchSize);
+    fps_.resize(fp_count * kBatchSize);
+  }
+
+  // Reads rows [start, start + count) and returns the number of selected rows.
+  size_t read(const int64_t start, const size_t count) {
+    CHECK_LE(count, kBatchSize);
+    for (size_t col_idx = 0; col_idx < columns_.size(); ++col_idx) {
+      decodeColumn(col_idx, start, count);
+    }
+    std::fill(mask_, mask_ + count, 1);
+    for (const auto& pred : predicates_) {
+      const auto& col = columns_[pred.col_idx];
+      if (col.is_fp) {
+        apply_predicate(pred, col, fps(pred.col_idx), count, mask_);
+      } else {
+        apply_predicate(pred, col, ints(pred.col_idx), count, mask_);
+      }
+    }
+    size_t selected = 0;
+    for (size_t i = 0; i < count; ++i) {
+      selection_[selected] = i;
+      selected += mask_[i];
+    }
+    return selected;
+  }
+
+  const uint32_t* selection() const { return selection_; }
+
+  const int64_t* ints(const size_t col_idx) const {
+    return ints_.data() + value_idx_[col_idx] * kBatchSize;
+  }
+
+  const double* fps(const size_t col_idx) const {
+    return fps_.data() + value_idx_[col_idx] * kBatchSize;
+  }
+
+ private:
+  void decodeColumn(const size_t col_idx, const int64_t start, const size_t count) {
+    const auto& col = columns_[col_idx];
+    if (col.is_rowid) {
+      // Mirrors CodeGenerator::codegenRowId.
+      auto out = ints_.data() + value_idx_[col_idx] * kBatchSize;
+      for (size_t i = 0; i < count; ++i) {
+        out[i] = frag_row_offset_ + start + i;
+      }
+      return;
+    }
+    const auto data = col_buffers_[col.local_id];
+    if (col.is_fp) {
+      auto out = fps_.data() + value_idx_[col_idx] * kBatchSize;
+      if (col.width == 4) {
+        decode<float>(data, start, count, out);
+      } else {
+        decode<double>(data, start, count, out);
+      }
+      return;
+    }
+    auto out = ints_.data() + value_idx_[col_idx] * kBatchSize;
+    switch (col.width) {
+      case 1:
+        decode<int8_t>(data, start, count, out);
+        break;
+      case 2:
+        decode<int16_t>(data, start, count, out);
+        break;
+      case 4:
+        decode<int32_t>(data, start, count, out);
+        break;
+      case 8:
+        decode<int64_t>(data, start, count, out);
+        break;
+      default:
+        CHECK(false);
+    }
+  }
+
+  const std::vector<Column>& columns_;
+  const std::vector<Predicate>& predicates_;
+  const int8_t** col_buffers_;
+  const uint64_t frag_row_offset_;
+  std::vector<size_t> value_idx_;
+  std::vector<int64_t> ints_;
+  std::vector<double> fps_;
+  uint8_t mask_[kBatchSize];
+  uint32_t selection_[kBatchSize];
+};
+
+// Value used by the generated code to mark an empty accumulator.
+template <typename V>
+V skip_value(const Slot& slot) {
+  if constexpr (std::is_same_v<V, double>) {
+    return slot.fp_skip_val;
+  } else {
+    return slot.int_skip_val;
+  }
+}
+
+template <typename V>
+V from_bits(const int64_t bits) {
+  if constexpr (std::is_same_v<V, double>) {
+    double val;
+    memcpy(&val, &bits, sizeof(val));
+    return val;
+  } else {
+    return bits;
+  }
+}
+
+template <typename V>
+int64_t to_bits(const V val) {
+  if constexpr (std::is_same_v<V, double>) {
+    int64_t bits;
+    memcpy(&bits, &val, sizeof(bits));
+    return bits;
+  } else {
+    return val;
+  }
+}
+
+// The generated code converts nulls of the argument to nulls of the aggregate type
+// and then skips values equal to the latter, which is why sums skip both.
+template <typename V>
+bool is_skipped(const Slot& slot, const Column& col, const V val) {
+  if (!slot.skip_nulls) {
+    return false;
+  }
+  const V null_val = null_value<V>(col);
+  return val == null_val || (slot.kind == SlotKind::kSum && val == skip_value<V>(slot));
+}
+
+template <typename V>
+V combine(const SlotKind kind, const V lhs, const V rhs) {
+  switch (kind) {
+    case SlotKind::kSum:
+      return lhs + rhs;
+    case SlotKind::kMin:
+      return std::min(lhs, rhs);
+    case SlotKind::kMax:
+      return std::max(lhs, rhs);
+    default:
+      CHECK(false);
+  }
+  return lhs;
+}
+
+// Folds the selected values of a batch into the accumulator of a non-grouped
+// aggregate, following the semantics of the agg_*_skip_val runtime functions.
+template <typename V>
+void aggregate_batch(const Slot& slot,
+                     const Column& col,
+                     const V* vals,
+                     const uint32_t* sel,
+                     const size_t selected,
+                     int64_t& acc_bits) {
+  V partial = slot.kind == SlotKind::kSum   ? V(0)
+              : slot.kind == SlotKind::kMin ? std::numeric_limits<V>::max()
+                                            : std::numeric_limits<V>::lowest();
+  size_t valid = 0;
+  for (size_t i = 0; i < selected; ++i) {
+    const V val = vals[sel[i]];
+    const bool skipped = is_skipped(slot, col, val);
+    partial = skipped ? partial : combine(slot.kind, partial, val);
+    valid += !skipped;
+  }
+  if (!valid) {
+    return;
+  }
+  V acc = from_bits<V>(acc_bits);
+  if (slot.skip_nulls && acc == skip_value<V>(slot)) {
+    acc = partial;
+  } else {
+    acc = combine(slot.kind, acc, partial);
+  }
+  acc_bits = to_bits(acc);
+}
+
+template <typename V>
+size_t count_batch(const Slot& slot,
+                   const Column& col,
+                   const V* vals,
+                   const uint32_t* sel,
+                   const size_t selected) {
+  size_t valid = 0;
+  for (size_t i = 0; i < selected; ++i) {
+    valid += !is_skipped(slot, col, vals[sel[i]]);
+  }
+  return valid;
+}
+
+template <typename T>
+void store_id(int8_t* ptr, const T val, const int8_t width, const bool is_fp) {
+  if (is_fp) {
+    if (width == 4) {
+      *reinterpret_cast<float*>(ptr) = val;
+    } else {
+      *reinterpret_cast<double*>(ptr) = val;
+    }
+    return;
+  }
+  switch (width) {
+    case 1:
+      *ptr = static_cast<int8_t>(val);
+      break;
+    case 2:
+      *reinterpret_cast<int16_t*>(ptr) = static_cast<int16_t>(val);
+      break;
+    case 4:
+      *reinterpret_cast<int32_t*>(ptr) = static_cast<int32_t>(val);
+      break;
+    default:
+      *reinterpret_cast<int64_t*>(ptr) = static_cast<int64_t>(val);
+      break;
+  }
+}
+
+// Updates one slot for the selected rows of a batch, the slot of row i is at
+// base + entries[i] * stride.
+template <typename V>
+void update_slot(const Slot& slot,
+                 const Column& col,
+                 const V* vals,
+                 const uint32_t* sel,
+                 const int64_t* entries,
+                 const size_t selected,
+                 int8_t* base,
+                 const size_t stride) {
+  switch (slot.kind) {
+    case SlotKind::kId:
+      for (size_t i = 0; i < selected; ++i) {
+        store_id(base + entries[i] * stride, vals[sel[i]], slot.width, slot.is_fp);
+      }
+      return;
+    case SlotKind::kCount:
+      for (size_t i = 0; i < selected; ++i) {
+        if (is_skipped(slot, col, vals[sel[i]])) {
+          continue;
+        }
+        auto ptr = base + entries[i] * stride;
+        if (slot.width == 4) {
+          ++*reinterpret_cast<int32_t*>(ptr);
+        } else {
+          ++*reinterpret_cast<int64_t*>(ptr);
+        }
+      }
+      return;
+    default:
+      break;
+  }
+  CHECK_EQ(slot.width, 8);
+  const V skip_val = skip_value<V>(slot);
+  for (size_t i = 0; i < selected; ++i) {
+    const V val = vals[sel[i]];
+    if (is_skipped(slot, col, val)) {
+      continue;
+    }
+    auto agg = reinterpret_cast<V*>(base + entries[i] * stride);
+    if (slot.skip_nulls && *agg == skip_val) {
+      *agg = val;
+    } else {
+      *agg = combine(slot.kind, *agg, val);
+    }
+  }
+}
+
+void update_slots(const std::vector<Slot>& slots,
+                  const std::vector<Column>& columns,
+                  const BatchReader& reader,
+                  const int64_t* entries,
+                  const size_t selected,
+                  int8_t* buffer,
+                  const std::vector<size_t>& slot_offsets,
+                  const std::vector<size_t>& slot_strides) {
+  const auto sel = reader.selection();
+  for (size_t i = 0; i < slots.size(); ++i) {
+    const auto& slot = slots[i];
+    const auto stride = slot_strides[i];
+    auto base = buffer + slot_offsets[i];
+    if (!slot.col_idx) {
+      CHECK(slot.kind == SlotKind::kCount);
+      for (size_t j = 0; j < selected; ++j) {
+        auto ptr = base + entries[j] * stride;
+        if (slot.width == 4) {
+          ++*reinterpret_cast<int32_t*>(ptr);
+        } else {
+          ++*reinterpret_cast<int64_t*>(ptr);
+        }
+      }
+      continue;
+    }
+    const auto& col = columns[*slot.col_idx];
+    if (col.is_fp) {
+      update_slot(
+          slot, col, reader.fps(*slot.col_idx), sel, entries, selected, base, stride);
+    } else {
+      update_slot(
+          slot, col, reader.ints(*slot.col_idx), sel, entries, selected, base, stride);
+    }
+  }
+}
+
+bool is_supported_column(const hdk::ir::ColumnVar* col_var) {
+  if (col_var->is<hdk::ir::Var>() || col_var->rteIdx() != 0) {
+    return false;
+  }
+  auto type = col_var->type();
+  switch (type->size()) {
+    case 1:
+    case 2:
+    case 8:
+      return type->isInteger() || type->isBoolean() || type->isDecimal() ||
+             type->isFp64();
+    case 4:
+      return type->isInteger() || type->isDecimal() || type->isExtDictionary() ||
+             type->isFp32();
+    default:
+      return false;
+  }
+}
+
+hdk::ir::OpType flip_comparison(const hdk::ir::OpType op) {
+  switch (op) {
+    case hdk::ir::OpType::kLt:
+      return hdk::ir::OpType::kGt;
+    case hdk::ir::OpType::kGt:
+      return hdk::ir::OpType::kLt;
+    case hdk::ir::OpType::kLe:
+      return hdk::ir::OpType::kGe;
+    case hdk::ir::OpType::kGe:
+      return hdk::ir::OpType::kLe;
+    default:
+      return op;
+  }
+}
+
+}  // namespace
+
+std::shared_ptr<VectorizedKernel> VectorizedKernel::build(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const QueryMemoryDescriptor& query_mem_desc,
+    const ExecutionOptions& eo,
+    const bool bigint_count) {
+  if (ra_exe_unit.input_descs.size() != 1 || !ra_exe_unit.join_quals.empty() ||
+      ra_exe_unit.estimator || ra_exe_unit.union_all ||
+      query_mem_desc.hasVarlenOutput() || query_mem_desc.useStreamingTopN() ||
+      query_mem_desc.mustUseBaselineSort()) {
+    return nullptr;
+  }
+  const auto query_type = query_mem_desc.getQueryDescriptionType();
+  const bool is_group_by = query_type == QueryDescriptionType::GroupByPerfectHash;
+  const bool is_projection = query_type == QueryDescriptionType::Projection;
+  if (is_group_by) {
+    if (!query_mem_desc.isSingleColumnGroupByWithPerfectHash() ||
+        (query_mem_desc.didOutputColumnar() && query_mem_desc.hasKeylessHash())) {
+      return nullptr;
+    }
+  } else if (is_projection) {
+    if (ra_exe_unit.groupby_exprs.size() != 1 || ra_exe_unit.groupby_exprs.front()) {
+      return nullptr;
+    }
+  } else if (query_type != QueryDescriptionType::NonGroupedAggregate) {
+    return nullptr;
+  }
+
+  std::shared_ptr<VectorizedKernel> kernel(new VectorizedKernel(query_mem_desc, eo));
+
+  if (is_group_by) {
+    auto key_col = ra_exe_unit.groupby_exprs.front()->as<hdk::ir::ColumnVar>();
+    if (!key_col || !is_supported_column(key_col) ||
+        !(key_col->type()->isInteger() || key_col->type()->isExtDictionary())) {
+      return nullptr;
+    }
+    kernel->key_col_idx_ = kernel->addColumn(key_col);
+    kernel->translated_null_key_ =
+        query_mem_desc.getMaxVal() +
+        (query_mem_desc.getBucket() ? query_mem_desc.getBucket() : 1);
+  }
+
+  std::list<hdk::ir::ExprPtr> quals(ra_exe_unit.simple_quals.begin(),
+                                    ra_exe_unit.simple_quals.end());
+  quals.insert(quals.end(), ra_exe_unit.quals.begin(), ra_exe_unit.quals.end());
+  for (const auto& qual : quals) {
+    Predicate pred{0, hdk::ir::OpType::kIsNull, false, 0, 0};
+    const hdk::ir::ColumnVar* col_var{nullptr};
+    if (auto uoper = qual->as<hdk::ir::UOper>()) {
+      if (uoper->isNot()) {
+        pred.negated = true;
+        uoper = uoper->operand()->as<hdk::ir::UOper>();
+      }
+      if (!uoper || !uoper->isIsNull()) {
+        return nullptr;
+      }
+      col_var = uoper->operand()->as<hdk::ir::ColumnVar>();
+    } else if (auto bin_oper = qual->as<hdk::ir::BinOper>()) {
+      if (!hdk::ir::isComparison(bin_oper->opType()) ||
+          bin_oper->opType() == hdk::ir::OpType::kBwEq ||
+          bin_oper->qualifier() != hdk::ir::Qualifier::kOne) {
+        return nullptr;
+      }
+      pred.op = bin_oper->opType();
+      col_var = bin_oper->leftOperand()->as<hdk::ir::ColumnVar>();
+      auto constant = bin_oper->rightOperand()->as<hdk::ir::Constant>();
+      if (!col_var) {
+        col_var = bin_oper->rightOperand()->as<hdk::ir::ColumnVar>();
+        constant = bin_oper->leftOperand()->as<hdk::ir::Constant>();
+        pred.op = flip_comparison(pred.op);
+      }
+      if (!col_var || !constant || constant->isNull() ||
+          !constant->type()->withNullable(false)->equal(
+              col_var->type()->withNullable(false))) {
+        return nullptr;
+      }
+      if (constant->type()->isFloatingPoint()) {
+        pred.fp_val = constant->fpVal();
+      } else {
+        pred.int_val = constant->intVal();
+      }
+    }
+    if (!col_var || !is_supported_column(col_var)) {
+      return nullptr;
+    }
+    pred.col_idx = kernel->addColumn(col_var);
+    kernel->predicates_.push_back(pred);
+  }
+
+  size_t slot_idx = 0;
+  for (const auto target_expr : ra_exe_unit.target_exprs) {
+    if (!query_mem_desc.getPaddedSlotWidthBytes(slot_idx)) {
+      // The target is not used, and has no slot in the output.
+      ++slot_idx;
+      continue;
+    }
+    auto target_info = get_target_info(target_expr, bigint_count);
+    auto arg_expr = agg_arg(target_expr);
+    if (arg_expr) {
+      if (query_type == QueryDescriptionType::NonGroupedAggregate &&
+          target_info.is_agg && !target_info.type->isString()) {
+        target_info.skip_null_val = true;
+      } else if (constrained_not_null(arg_expr, ra_exe_unit.quals)) {
+        target_info.skip_null_val = false;
+      }
+    }
+    if (target_info.is_distinct || takes_float_argument(target_info)) {
+      return nullptr;
+    }
+
+    std::vector<SlotKind> kinds;
+    const hdk::ir::ColumnVar* col_var{nullptr};
+    if (!target_info.is_agg) {
+      if (!is_group_by && !is_projection) {
+        return nullptr;
+      }
+      kinds.push_back(SlotKind::kId);
+      col_var = target_expr->as<hdk::ir::ColumnVar>();
+      if (!col_var) {
+        return nullptr;
+      }
+    } else {
+      switch (target_info.agg_kind) {
+        case hdk::ir::AggType::kCount:
+          kinds.push_back(SlotKind::kCount);
+          break;
+        case hdk::ir::AggType::kSum:
+          kinds.push_back(SlotKind::kSum);
+          break;
+        case hdk::ir::AggType::kMin:
+          kinds.push_back(SlotKind::kMin);
+          break;
+        case hdk::ir::AggType::kMax:
+          kinds.push_back(SlotKind::kMax);
+          break;
+        case hdk::ir::AggType::kAvg:
+          kinds.push_back(SlotKind::kSum);
+          kinds.push_back(SlotKind::kCount);
+          break;
+        default:
+          return nullptr;
+      }
+      if (arg_expr) {
+        col_var = arg_expr->as<hdk::ir::ColumnVar>();
+        if (!col_var) {
+          return nullptr;
+        }
+      }
+    }
+    if (col_var && !is_supported_column(col_var)) {
+      return nullptr;
+    }
+
+    const bool is_fp_arg = col_var && col_var->type()->isFloatingPoint();
+    for (const auto kind : kinds) {
+      Slot slot{kind, std::nullopt, slot_idx, 0, false, false, 0, 0};
+      slot.width = query_mem_desc.getPaddedSlotWidthBytes(slot_idx);
+      slot.skip_nulls = target_info.skip_null_val;
+      if (!is_group_by && !is_projection && slot.width != 8) {
+        // The generated code requires padded slots here and retries without
+        // compaction, let it do so.
+        return nullptr;
+      }
+      if (col_var) {
+        slot.col_idx = kernel->addColumn(col_var);
+      }
+      if (kind == SlotKind::kCount) {
+        if (slot.width != 4 && slot.width != 8) {
+          return nullptr;
+        }
+      } else if (kind == SlotKind::kId) {
+        slot.is_fp = is_fp_arg;
+        if (is_fp_arg && slot.width != 4 && slot.width != 8) {
+          return nullptr;
+        }
+      } else {
+        // Integer arguments are aggregated with 64-bit integer arithmetic and floating
+        // point ones with double arithmetic, narrower slots are left to the JIT.
+        slot.is_fp = is_fp_arg;
+        if (slot.width != 8 || is_fp_arg != target_info.type->isFloatingPoint()) {
+          return nullptr;
+        }
+      }
+      if (col_var) {
+        auto arg_type = col_var->type();
+        if (is_fp_arg) {
+          slot.fp_skip_val = inline_fp_null_value(arg_type);
+        } else if (is_agg_domain_range_equivalent(target_info.agg_kind)) {
+          slot.int_skip_val = inline_int_null_value(arg_type);
+        } else {
+          slot.int_skip_val = inline_int_null_value(target_info.type);
+        }
+      }
+      kernel->slots_.push_back(slot);
+      ++slot_idx;
+    }
+  }
+  if (slot_idx != query_mem_desc.getSlotCount()) {
+    return nullptr;
+  }
+  return kernel;
+}
+
+size_t VectorizedKernel::addColumn(const hdk::ir::ColumnVar* col_var) {
+  for (size_t i = 0; i < col_vars_.size(); ++i) {
+    if (col_vars_[i]->tableId() == col_var->tableId() &&
+        col_vars_[i]->columnId() == col_var->columnId()) {
+      return i;
+    }
+  }
+  auto type = col_var->type();
+  Column col{-1,
+             col_var->isVirtual(),
+             static_cast<int8_t>(type->size()),
+             type->isFloatingPoint(),
+             type->nullable(),
+             0,
+             0};
+  if (col.is_fp) {
+    col.fp_null = inline_fp_null_value(type);
+  } else {
+    col.int_null = inline_int_null_value(type);
+  }
+  col_vars_.push_back(col_var);
+  columns_.push_back(col);
+  return columns_.size() - 1;
+}
+
+void VectorizedKernel::bindColumns(PlanState* plan_state) {
+  for (size_t i = 0; i < col_vars_.size(); ++i) {
+    if (!columns_[i].is_rowid) {
+      columns_[i].local_id = plan_state->getLocalColumnId(col_vars_[i], true);
+    }
+  }
+}
+
+int32_t VectorizedKernel::checkInterrupt() const {
+  // The dynamic watchdog takes precedence over the interrupt check, as in
+  // Executor::createErrorCheckControlFlow.
+  if (with_dynamic_watchdog_) {
+    return dynamic_watchdog() ? Executor::ERR_OUT_OF_TIME : 0;
+  }
+  if (allow_runtime_query_interrupt_ && check_interrupt()) {
+    return Executor::ERR_INTERRUPTED;
+  }
+  return 0;
+}
+
+void VectorizedKernel::run(const int8_t*** col_buffers,
+                           const uint64_t num_fragments,
+                           const int64_t* num_rows,
+                           const uint64_t* frag_row_offsets,
+                           const uint32_t num_tables,
+                           const int32_t max_matched,
+                           int32_t* total_matched,
+                           const std::vector<int64_t>& init_agg_vals,
+                           int64_t** out,
+                           int32_t* error_code) const {
+  auto timer = DEBUG_TIMER(__func__);
+  const auto query_type = query_mem_desc_.getQueryDescriptionType();
+  std::vector<int64_t> agg_vals;
+  for (uint64_t frag_idx = 0; frag_idx < num_fragments; ++frag_idx) {
+    const auto frag_col_buffers = col_buffers[frag_idx];
+    const auto frag_num_rows = num_rows[frag_idx * num_tables];
+    const auto frag_row_offset = frag_row_offsets[frag_idx * num_tables];
+    int32_t err{0};
+    switch (query_type) {
+      case QueryDescriptionType::NonGroupedAggregate:
+        agg_vals.resize(slots_.size());
+        err = runAggregate(frag_col_buffers,
+                           frag_num_rows,
+                           frag_row_offset,
+                           init_agg_vals,
+                           agg_vals.data());
+        for (size_t i = 0; i < slots_.size(); ++i) {
+          out[slots_[i].slot_idx][frag_idx] = agg_vals[i];
+        }
+        break;
+      case QueryDescriptionType::GroupByPerfectHash:
+        err = runGroupBy(frag_col_buffers, frag_num_rows, frag_row_offset, out[0]);
+        break;
+      case QueryDescriptionType::Projection:
+        if (*total_matched >= max_matched) {
+          return;
+        }
+        err = runProjection(frag_col_buffers,
+                            frag_num_rows,
+                            frag_row_offset,
+                            max_matched,
+                            total_matched,
+                            out[0]);
+        break;
+      default:
+        CHECK(false);
+    }
+    if (err) {
+      // Mirrors record_error_code, which keeps persistent errors.
+      if (*error_code <= 0) {
+        *error_code = err;
+      }
+      return;
+    }
+  }
+}
+
+int32_t VectorizedKernel::runAggregate(const int8_t** col_buffers,
+                                       const int64_t num_rows,
+                                       const uint64_t frag_row_offset,
+                                       const std::vector<int64_t>& init_agg_vals,
+                                       int64_t* out_slots) const {
+  for (size_t i = 0; i < slots_.size(); ++i) {
+    CHECK_LT(slots_[i].slot_idx, init_agg_vals.size());
+    out_slots[i] = init_agg_vals[slots_[i].slot_idx];
+  }
+  BatchReader reader(columns_, predicates_, col_buffers, frag_row_offset);
+  for (int64_t start = 0; start < num_rows; start += kBatchSize) {
+    if (const auto err = checkInterrupt()) {
+      return err;
+    }
+    const size_t count = std::min<int64_t>(kBatchSize, num_rows - start);
+    const size_t selected = reader.read(start, count);
+    if (!selected) {
+      continue;
+    }
+    const auto sel = reader.selection();
+    for (size_t i = 0; i < slots_.size(); ++i) {
+      const auto& slot = slots_[i];
+      if (!slot.col_idx) {
+        CHECK(slot.kind == SlotKind::kCount);
+        out_slots[i] += selected;
+        continue;
+      }
+      const auto& col = columns_[*slot.col_idx];
+      if (slot.kind == SlotKind::kCount) {
+        out_slots[i] +=
+            col.is_fp
+                ? count_batch(slot, col, reader.fps(*slot.col_idx), sel, selected)
+                : count_batch(slot, col, reader.ints(*slot.col_idx), sel, selected);
+      } else if (col.is_fp) {
+        aggregate_batch(
+            slot, col, reader.fps(*slot.col_idx), sel, selected, out_slots[i]);
+      } else {
+        aggregate_batch(
+            slot, col, reader.ints(*slot.col_idx), sel, selected, out_slots[i]);
+      }
+    }
+  }
+  return 0;
+}
+
+int32_t VectorizedKernel::runGroupBy(const int8_t** col_buffers,
+                                     const int64_t num_rows,
+                                     const uint64_t frag_row_offset,
+                                     int64_t* groups_buffer) const {
+  CHECK(key_col_idx_);
+  const auto& key_col = columns_[*key_col_idx_];
+  const bool columnar = query_mem_desc_.didOutputColumnar();
+  const bool keyless = query_mem_desc_.hasKeylessHash();
+  const bool translate_null_key = query_mem_desc_.hasNulls();
+  const int64_t min_key = query_mem_desc_.getMinVal();
+  const int64_t bucket = query_mem_desc_.getBucket();
+  const size_t row_size_quad =
+      columnar ? 0 : query_mem_desc_.getRowSize() / sizeof(int64_t);
+
+  std::vector<size_t> slot_offsets;
+  std::vector<size_t> slot_strides;
+  getSlotLayout(!keyless, slot_offsets, slot_strides);
+
+  int64_t keys[kBatchSize];
+  int64_t entries[kBatchSize];
+  BatchReader reader(columns_, predicates_, col_buffers, frag_row_offset);
+  for (int64_t start = 0; start < num_rows; start += kBatchSize) {
+    if (const auto err = checkInterrupt()) {
+      return err;
+    }
+    const size_t count = std::min<int64_t>(kBatchSize, num_rows - start);
+    const size_t selected = reader.read(start, count);
+    if (!selected) {
+      continue;
+    }
+    const auto sel = reader.selection();
+    const auto key_vals = reader.ints(*key_col_idx_);
+    for (size_t i = 0; i < selected; ++i) {
+      const int64_t key = key_vals[sel[i]];
+      keys[i] =
+          translate_null_key && key == key_col.int_null ? translated_null_key_ : key;
+    }
+    if (keyless) {
+      // Mirrors get_group_value_fast_keyless, which ignores the bucket.
+      for (size_t i = 0; i < selected; ++i) {
+        entries[i] = keys[i] - min_key;
+      }
+    } else {
+      for (size_t i = 0; i < selected; ++i) {
+        entries[i] = bucket ? (keys[i] - min_key) / bucket : keys[i] - min_key;
+      }
+      for (size_t i = 0; i < selected; ++i) {
+        auto& stored_key = groups_buffer[columnar ? entries[i]
+                                                  : entries[i] * row_size_quad];
+        if (stored_key == EMPTY_KEY_64) {
+          stored_key = keys[i];
+        }
+      }
+    }
+    update_slots(slots_,
+                 columns_,
+                 reader,
+                 entries,
+                 selected,
+                 reinterpret_cast<int8_t*>(groups_buffer),
+                 slot_offsets,
+                 slot_strides);
+  }
+  return 0;
+}
+
+int32_t VectorizedKernel::runProjection(const int8_t** col_buffers,
+                                        const int64_t num_rows,
+                                        const uint64_t frag_row_offset,
+                                        const int32_t max_matched,
+                                        int32_t* total_matched,
+                                        int64_t* output_buffer) const {
+  const bool columnar = query_mem_desc_.didOutputColumnar();
+  const size_t row_size_quad =
+      columnar ? 0 : query_mem_desc_.getRowSize() / sizeof(int64_t);
+  std::vector<size_t> slot_offsets;
+  std::vector<size_t> slot_strides;
+  getSlotLayout(/*has_key=*/true, slot_offsets, slot_strides);
+
+  int64_t entries[kBatchSize];
+  BatchReader reader(columns_, predicates_, col_buffers, frag_row_offset);
+  for (int64_t start = 0; start < num_rows && *total_matched < max_matched;
+       start += kBatchSize) {
+    if (const auto err = checkInterrupt()) {
+      return err;
+    }
+    const size_t count = std::min<int64_t>(kBatchSize, num_rows - start);
+    size_t selected = reader.read(start, count);
+    selected = std::min<size_t>(selected, max_matched - *total_matched);
+    const auto sel = reader.selection();
+    // Output entries are the row positions in the fragment, the same as written by
+    // get_scan_output_slot and get_columnar_scan_output_offset.
+    for (size_t i = 0; i < selected; ++i) {
+      entries[i] = *total_matched + i;
+      output_buffer[entries[i] * (columnar ? 1 : row_size_quad)] = start + sel[i];
+    }
+    update_slots(slots_,
+                 columns_,
+                 reader,
+                 entries,
+                 selected,
+                 reinterpret_cast<int8_t*>(output_buffer),
+                 slot_offsets,
+                 slot_strides);
+    *total_matched += selected;
+  }
+  return 0;
+}
+
+void VectorizedKernel::getSlotLayout(const bool has_key,
+                                     std::vector<size_t>& slot_offsets,
+                                     std::vector<size_t>& slot_strides) const {
+  for (const auto& slot : slots_) {
+    if (query_mem_desc_.didOutputColumnar()) {
+      slot_offsets.push_back(query_mem_desc_.getColOffInBytes(slot.slot_idx));
+      slot_strides.push_back(slot.width);
+    } else {
+      slot_offsets.push_back(query_mem_desc_.getColOnlyOffInBytes(slot.slot_idx) +
+                             (has_key ? sizeof(int64_t) : 0));
+      slot_strides.push_back(query_mem_desc_.getRowSize());
+    }
+  }
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "QueryEngine/CompilationContext.h"
+#include "QueryEngine/CompilationOptions.h"
+#include "QueryEngine/RelAlgExecutionUnit.h"
+#include "ResultSet/QueryMemoryDescriptor.h"
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+struct PlanState;
+
+/**
+ * Precompiled batch-at-a-time execution of simple single table queries, used instead
+ * of the JIT for small inputs, where compilation would take longer than the query.
+ * Supported are filters made of comparisons of fixed width columns with constants and
+ * null checks, and either a projection of such columns, an aggregation without group
+ * by, or an aggregation grouped by a single integer or dictionary key using perfect
+ * hash. Aggregates are COUNT, SUM, MIN, MAX and AVG of fixed width columns. The rowid
+ * column is computed from the fragment row offsets.
+ *
+ * Columns are decoded and filtered a batch at a time with simple loops the compiler
+ * vectorizes, and the results are written to the same output buffers and using the
+ * same layout as the generated code would, so the rest of the execution, including
+ * reduction, is shared with compiled kernels.
+ */
+class VectorizedKernel : public CompilationContext {
+ public:
+  struct Column {
+    int local_id;
+    bool is_rowid;
+    int8_t width;
+    bool is_fp;
+    bool nullable;
+    int64_t int_null;
+    double fp_null;
+  };
+
+  // Either a comparison with a constant or, for kIsNull, a null check.
+  struct Predicate {
+    size_t col_idx;
+    hdk::ir::OpType op;
+    bool negated;
+    int64_t int_val;
+    double fp_val;
+  };
+
+  enum class SlotKind { kCount, kSum, kMin, kMax, kId };
+
+  struct Slot {
+    SlotKind kind;
+    // Aggregated column, if any.
+    std::optional<size_t> col_idx;
+    size_t slot_idx;
+    int8_t width;
+    bool is_fp;
+    bool skip_nulls;
+    int64_t int_skip_val;
+    double fp_skip_val;
+  };
+
+  // Returns nullptr if the execution unit is not supported.
+  static std::shared_ptr<VectorizedKernel> build(
+      const RelAlgExecutionUnit& ra_exe_unit,
+      const QueryMemoryDescriptor& query_mem_desc,
+      const ExecutionOptions& eo,
+      const bool bigint_count);
+
+  // Maps columns to local ids. All columns are fetched, lazy fetch is not used.
+  void bindColumns(PlanState* plan_state);
+
+  // Mirrors the multifrag query function of the generated code. For queries without
+  // group by, out points to a buffer per slot with an entry per fragment, otherwise
+  // out[0] is the group by buffer. Errors are reported through error_code the same
+  // way as by the generated code, and stop the execution.
+  void run(const int8_t*** col_buffers,
+           const uint64_t num_fragments,
+           const int64_t* num_rows,
+           const uint64_t* frag_row_offsets,
+           const uint32_t num_tables,
+           const int32_t max_matched,
+           int32_t* total_matched,
+           const std::vector<int64_t>& init_agg_vals,
+           int64_t** out,
+           int32_t* error_code) const;
+
+ private:
+  VectorizedKernel(const QueryMemoryDescriptor& query_mem_desc,
+                   const ExecutionOptions& eo)
+      : query_mem_desc_(query_mem_desc)
+      , with_dynamic_watchdog_(eo.with_dynamic_watchdog)
+      , allow_runtime_query_interrupt_(eo.allow_runtime_query_interrupt) {}
+
+  size_t addColumn(const hdk::ir::ColumnVar* col_var);
+
+  // Returns the error code of a timed out or interrupted query, checked once per
+  // batch rather than every 64 rows like in the generated code.
+  int32_t checkInterrupt() const;
+
+  int32_t runAggregate(const int8_t** col_buffers,
+                       const int64_t num_rows,
+                       const uint64_t frag_row_offset,
+                       const std::vector<int64_t>& init_agg_vals,
+                       int64_t* out_slots) const;
+
+  int32_t runGroupBy(const int8_t** col_buffers,
+                     const int64_t num_rows,
+                     const uint64_t frag_row_offset,
+                     int64_t* groups_buffer) const;
+
+  int32_t runProjection(const int8_t** col_buffers,
+                        const int64_t num_rows,
+                        const uint64_t frag_row_offset,
+                        const int32_t max_matched,
+                        int32_t* total_matched,
+                        int64_t* output_buffer) const;
+
+  // Offsets of the slots from the start of the output buffer and distances between
+  // consecutive entries of the same slot.
+  void getSlotLayout(const bool has_key,
+                     std::vector<size_t>& slot_offsets,
+                     std::vector<size_t>& slot_strides) const;
+
+  const QueryMemoryDescriptor query_mem_desc_;
+  const bool with_dynamic_watchdog_;
+  const bool allow_runtime_query_interrupt_;
+  std::vector<const hdk::ir::ColumnVar*> col_vars_;
+  std::vector<Column> columns_;
+  std::vector<Predicate> predicates_;
+  std::vector<Slot> slots_;
+  // Group by key column and its null value after translation.
+  std::optional<size_t> key_col_idx_;
+  int64_t translated_null_key_{0};
+};
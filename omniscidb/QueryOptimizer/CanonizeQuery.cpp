@@ -354,7 +354,11 @@ void expandCompoundAggregates(QueryDag& dag) {
 }  // namespace
 
 void canonizeQuery(QueryDag& dag) {
+  if (dag.isCanonized()) {
+    return;
+  }
   expandCompoundAggregates(dag);
+  dag.setCanonized();
 }
 
 }  // namespace hdk::ir
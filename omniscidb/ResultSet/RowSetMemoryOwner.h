@@ -26,9 +26,11 @@
 
 #include "DataMgr/AbstractBuffer.h"
 #include "DataMgr/Allocators/ArenaAllocator.h"
+#include "DataMgr/Chunk/Chunk.h"
 #include "DataMgr/DataMgr.h"
 #include "DataProvider/DataProvider.h"
 #include "Logger/Logger.h"
+#include "Shared/QueryMemoryTracker.h"
 #include "Shared/quantile.h"
 #include "StringDictionary/StringDictionaryProxy.h"
 #include "ThirdParty/robin_hood.h"
@@ -62,8 +64,19 @@ class RowSetMemoryOwner final : public SimpleAllocator, boost::noncopyable {
     // to allocate low-level objects like strings or varlen data buffers for each
     // result set row. The code should be revised if we want to use RowSetMemoryOwner
     // for such allocations.
-    return reinterpret_cast<int8_t*>(
-        allocator_->allocate(std::max(num_bytes, (size_t)256)));
+    const size_t alloc_bytes = std::max(num_bytes, (size_t)256);
+    if (memory_tracker_) {
+      memory_tracker_->allocate(hdk::QueryMemoryCategory::kResultBuffers, alloc_bytes);
+      tracked_bytes_ += alloc_bytes;
+    }
+    return reinterpret_cast<int8_t*>(allocator_->allocate(alloc_bytes));
+  }
+
+  // Arena allocations are accounted by the tracker until the owner is destroyed.
+  void setMemoryTracker(std::shared_ptr<hdk::QueryMemoryTracker> memory_tracker) {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    CHECK(!memory_tracker_ || memory_tracker_ == memory_tracker);
+    memory_tracker_ = std::move(memory_tracker);
   }
 
   int8_t* allocateCountDistinctBuffer(const size_t num_bytes,
@@ -205,7 +218,19 @@ class RowSetMemoryOwner final : public SimpleAllocator, boost::noncopyable {
     col_buffers_.push_back(const_cast<void*>(col_buffer));
   }
 
+  // Keeps input chunks referenced by results of several kernels alive, e.g. when
+  // results of a fragment are produced by multiple sub-tasks.
+  void holdChunks(const std::list<std::shared_ptr<Chunk_NS::Chunk>>& chunks,
+                  std::shared_ptr<std::list<ChunkIter>> chunk_iters) {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    chunks_.insert(chunks_.end(), chunks.begin(), chunks.end());
+    chunk_iters_.emplace_back(std::move(chunk_iters));
+  }
+
   ~RowSetMemoryOwner() {
+    if (memory_tracker_) {
+      memory_tracker_->release(hdk::QueryMemoryCategory::kResultBuffers, tracked_bytes_);
+    }
     for (auto count_distinct_set : count_distinct_sets_) {
       delete count_distinct_set;
     }
@@ -256,10 +281,14 @@ class RowSetMemoryOwner final : public SimpleAllocator, boost::noncopyable {
   std::vector<void*> col_buffers_;
   std::vector<Data_Namespace::AbstractBuffer*> varlen_input_buffers_;
   std::vector<std::unique_ptr<quantile::TDigest>> t_digests_;
+  std::list<std::shared_ptr<Chunk_NS::Chunk>> chunks_;
+  std::vector<std::shared_ptr<std::list<ChunkIter>>> chunk_iters_;
 
   DataProvider* data_provider_;  // for metadata lookups
   size_t arena_block_size_;      // for cloning
   std::unique_ptr<Arena> allocator_;
+  std::shared_ptr<hdk::QueryMemoryTracker> memory_tracker_;
+  size_t tracked_bytes_ = 0;
 
   mutable std::mutex state_mutex_;
 
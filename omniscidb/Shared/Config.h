@@ -28,6 +28,7 @@ struct WatchdogConfig {
 struct CpuSubTasksConfig {
   bool enable = false;
   size_t sub_task_size = 500'000;
+  size_t sub_task_target_time_us = 0;
 };
 
 struct JoinConfig {
@@ -82,6 +83,16 @@ struct CodegenConfig {
   bool null_mod_by_zero = false;
   bool hoist_literals = true;
   bool enable_filter_function = true;
+  bool enable_tiered_compilation = false;
+  size_t tier_up_run_count = 3;
+  size_t tier_up_run_time_ms = 100;
+  bool enable_vectorized_interpreter = false;
+  size_t vectorized_interpreter_max_rows = 100'000;
+  size_t parallel_compilation_threads = 0;
+  bool enable_batch_codegen = false;
+  size_t batch_codegen_size = 1'024;
+  bool enable_fragment_specialization = false;
+  size_t fragment_specialization_max_variants = 4;
 };
 
 struct ExecutionConfig {
@@ -106,9 +117,20 @@ struct ExecutionConfig {
   bool cpu_only = false;
 
   bool materialize_inner_join_tables = true;
+  bool fuse_shared_projections = false;
   std::string initialize_with_gpu_vendor = "";
 
   bool enable_cost_model = false;
+
+  size_t calcite_workers = 1;
+
+  bool enable_concurrent_queries = false;
+
+  size_t parallel_steps = 0;
+
+  size_t max_threads_per_query = 0;
+
+  size_t max_query_memory = 0;
 };
 
 struct FilterPushdownConfig {
@@ -123,6 +145,7 @@ struct OptimizationsConfig {
   bool from_table_reordering = true;
   size_t constrained_by_in_threshold = 10;
   bool enable_left_join_filter_hoisting = true;
+  bool enable_metadata_aggregates = true;
 };
 
 struct ResultSetConfig {
@@ -164,6 +187,12 @@ struct CacheConfig {
   double gpu_fraction_code_cache_to_evict = 0.2;
   size_t dag_cache_size = 1'000'000'000;
   size_t code_cache_size = 1'000;
+  std::string code_cache_dir = "";
+  bool enable_plan_code_cache = true;
+  size_t dict_translation_cache_bytes = 64ULL << 20;
+  size_t dict_pattern_cache_bytes = 64ULL << 20;
+  size_t calcite_cache_size = 1'024;
+  size_t rel_alg_dag_cache_size = 128;
 };
 
 struct DebugConfig {
@@ -174,6 +203,7 @@ struct DebugConfig {
 
 struct StorageConfig {
   bool enable_lazy_dict_materialization = false;
+  bool enable_dict_compression = false;
 };
 
 struct Config {
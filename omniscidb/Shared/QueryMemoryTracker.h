@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace hdk {
+
+enum class QueryMemoryCategory {
+  // Output and intermediate result buffers allocated by RowSetMemoryOwner.
+  kResultBuffers,
+  // Table chunks fetched from the buffer pool for the query.
+  kInputChunks,
+  // Multi-fragment columns linearized by ColumnFetcher.
+  kLinearizedColumns,
+  // Join hash tables.
+  kHashTables,
+};
+
+constexpr size_t kQueryMemoryCategoryCount = 4;
+
+inline const char* toString(QueryMemoryCategory category) {
+  switch (category) {
+    case QueryMemoryCategory::kResultBuffers:
+      return "result_buffers";
+    case QueryMemoryCategory::kInputChunks:
+      return "input_chunks";
+    case QueryMemoryCategory::kLinearizedColumns:
+      return "linearized_columns";
+    case QueryMemoryCategory::kHashTables:
+      return "hash_tables";
+  }
+  return "unknown";
+}
+
+// Peak memory usage of a query. The total peak is the peak of the sum of all
+// categories, so it can be less than the sum of category peaks.
+struct QueryMemoryStats {
+  std::array<size_t, kQueryMemoryCategoryCount> peak_bytes{};
+  size_t total_peak_bytes = 0;
+
+  size_t peak(QueryMemoryCategory category) const {
+    return peak_bytes[static_cast<size_t>(category)];
+  }
+
+  std::string toString() const {
+    std::string res = "QueryMemoryStats(total_peak=" + std::to_string(total_peak_bytes);
+    for (size_t i = 0; i < kQueryMemoryCategoryCount; ++i) {
+      res += ", ";
+      res += hdk::toString(static_cast<QueryMemoryCategory>(i));
+      res += "=" + std::to_string(peak_bytes[i]);
+    }
+    return res + ")";
+  }
+};
+
+class QueryMemoryLimitExceeded : public std::runtime_error {
+ public:
+  QueryMemoryLimitExceeded(QueryMemoryCategory category, size_t bytes, size_t limit)
+      : std::runtime_error("Query memory limit of " + std::to_string(limit) +
+                           " bytes exceeded on allocation of " + std::to_string(bytes) +
+                           " bytes for " + toString(category)) {}
+};
+
+/**
+ * Memory accounting of a single query. Shared by all executors and memory owners
+ * working for the query, so it is updated concurrently.
+ *
+ * Memory is accounted when it is acquired for the query, even if it is cached and
+ * shared with other queries (e.g. buffer pool chunks and cached hash tables), and
+ * released when the query drops its reference. Objects the query can't track
+ * references to (e.g. cached hash tables) are accounted once on the first use and
+ * released when the query ends.
+ */
+class QueryMemoryTracker {
+ public:
+  // Zero limit means no limit.
+  explicit QueryMemoryTracker(size_t limit = 0) : limit_(limit) {}
+
+  // Throws QueryMemoryLimitExceeded, without accounting the memory, if the limit is
+  // exceeded.
+  void allocate(QueryMemoryCategory category, size_t bytes) {
+    auto total = total_allocated_.fetch_add(bytes) + bytes;
+    if (limit_ && total > limit_) {
+      total_allocated_ -= bytes;
+      throw QueryMemoryLimitExceeded(category, bytes, limit_);
+    }
+    auto idx = static_cast<size_t>(category);
+    updatePeak(peak_[idx], allocated_[idx].fetch_add(bytes) + bytes);
+    updatePeak(total_peak_, total);
+  }
+
+  void release(QueryMemoryCategory category, size_t bytes) {
+    allocated_[static_cast<size_t>(category)] -= bytes;
+    total_allocated_ -= bytes;
+  }
+
+  // Accounts memory of a shared object unless it is already accounted for the query.
+  void allocateShared(const void* object, QueryMemoryCategory category, size_t bytes) {
+    std::lock_guard<std::mutex> lock(shared_mutex_);
+    if (shared_.count(object)) {
+      return;
+    }
+    allocate(category, bytes);
+    shared_.emplace(object, std::make_pair(category, bytes));
+  }
+
+  // Releases memory of all shared objects. Called when the query ends.
+  void releaseShared() {
+    std::lock_guard<std::mutex> lock(shared_mutex_);
+    for (auto& entry : shared_) {
+      release(entry.second.first, entry.second.second);
+    }
+    shared_.clear();
+  }
+
+  size_t allocated() const { return total_allocated_.load(); }
+  size_t limit() const { return limit_; }
+
+  QueryMemoryStats stats() const {
+    QueryMemoryStats res;
+    for (size_t i = 0; i < kQueryMemoryCategoryCount; ++i) {
+      res.peak_bytes[i] = peak_[i].load();
+    }
+    res.total_peak_bytes = total_peak_.load();
+    return res;
+  }
+
+ private:
+  static void updatePeak(std::atomic<size_t>& peak, size_t val) {
+    auto cur = peak.load();
+    while (cur < val && !peak.compare_exchange_weak(cur, val)) {
+    }
+  }
+
+  const size_t limit_;
+  std::array<std::atomic<size_t>, kQueryMemoryCategoryCount> allocated_{};
+  std::array<std::atomic<size_t>, kQueryMemoryCategoryCount> peak_{};
+  std::atomic<size_t> total_allocated_{0};
+  std::atomic<size_t> total_peak_{0};
+  std::mutex shared_mutex_;
+  std::unordered_map<const void*, std::pair<QueryMemoryCategory, size_t>> shared_;
+};
+
+}  // namespace hdk
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <utility>
+#include <vector>
+
+/**
+ * LRU cache of ids of dictionary strings matching a pattern, bounded by the memory held
+ * by cached ids. Each entry remembers how many strings were scanned to build it, so
+ * after the dictionary grows only the new strings are checked against the pattern.
+ */
+template <typename key_t>
+class PatternMatchCache {
+ public:
+  PatternMatchCache(const size_t max_bytes) : max_bytes_(max_bytes) {}
+
+  // Returns sorted ids of strings matching the key pattern among the first num_strings
+  // strings. scan(begin, end) is called for strings not covered by the cached entry and
+  // must return sorted ids of matching strings in [begin, end).
+  template <typename ScanFunc>
+  std::vector<int32_t> get(const key_t& key, const size_t num_strings, ScanFunc&& scan) {
+    auto map_it = items_map_.find(key);
+    if (map_it == items_map_.end()) {
+      items_list_.emplace_front(key, Entry{});
+      map_it = items_map_.emplace(key, items_list_.begin()).first;
+      total_bytes_ += entryBytes(items_list_.front().second);
+    } else {
+      items_list_.splice(items_list_.begin(), items_list_, map_it->second);
+    }
+
+    auto& entry = map_it->second->second;
+    if (entry.num_strings < num_strings) {
+      const auto new_ids = scan(entry.num_strings, num_strings);
+      total_bytes_ -= entryBytes(entry);
+      entry.ids.insert(entry.ids.end(), new_ids.begin(), new_ids.end());
+      entry.num_strings = num_strings;
+      total_bytes_ += entryBytes(entry);
+    }
+    std::vector<int32_t> result(
+        entry.ids.begin(),
+        std::lower_bound(
+            entry.ids.begin(), entry.ids.end(), static_cast<int64_t>(num_strings)));
+    evict();
+    return result;
+  }
+
+  void setMaxBytes(const size_t max_bytes) {
+    max_bytes_ = max_bytes;
+    evict();
+  }
+
+  void clear() {
+    items_map_.clear();
+    items_list_.clear();
+    total_bytes_ = 0;
+  }
+
+  size_t size() const { return items_list_.size(); }
+
+  size_t bytes() const { return total_bytes_; }
+
+ private:
+  struct Entry {
+    size_t num_strings{0};
+    std::vector<int32_t> ids;
+  };
+  using cache_list_t = std::list<std::pair<key_t, Entry>>;
+
+  static size_t entryBytes(const Entry& entry) {
+    return sizeof(typename cache_list_t::value_type) +
+           entry.ids.capacity() * sizeof(int32_t);
+  }
+
+  void evict() {
+    while (total_bytes_ > max_bytes_ && !items_list_.empty()) {
+      total_bytes_ -= entryBytes(items_list_.back().second);
+      items_map_.erase(items_list_.back().first);
+      items_list_.pop_back();
+    }
+  }
+
+  size_t max_bytes_;
+  size_t total_bytes_{0};
+  cache_list_t items_list_;
+  std::map<key_t, typename cache_list_t::iterator> items_map_;
+};
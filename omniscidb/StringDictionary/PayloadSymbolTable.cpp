@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "PayloadSymbolTable.h"
+
+#include "Logger/Logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+// Each training round extends symbols by concatenating pairs of symbols found with the
+// previous round's table, so five rounds are enough to grow symbols up to 8 bytes.
+constexpr size_t kTrainingRounds = 5;
+
+}  // namespace
+
+constexpr size_t PayloadSymbolTable::kMaxSymbols;
+constexpr size_t PayloadSymbolTable::kMaxSymbolLength;
+constexpr uint8_t PayloadSymbolTable::kEscapeCode;
+
+std::unique_ptr<PayloadSymbolTable> PayloadSymbolTable::build(
+    const std::vector<std::string_view>& sample) {
+  std::unique_ptr<PayloadSymbolTable> table(new PayloadSymbolTable());
+  table->finalize();
+  for (size_t round = 0; round < kTrainingRounds; ++round) {
+    // All candidate symbols are substrings of sample strings, so we can count them
+    // using views.
+    std::unordered_map<std::string_view, size_t> counts;
+    for (const auto& str : sample) {
+      size_t prev_pos = 0;
+      size_t pos = 0;
+      while (pos < str.size()) {
+        const int code = table->findLongestSymbol(str, pos);
+        const size_t len = code >= 0 ? table->symbol_lens_[code] : 1;
+        ++counts[str.substr(pos, len)];
+        if (pos > prev_pos && pos - prev_pos < kMaxSymbolLength) {
+          ++counts[str.substr(prev_pos,
+                              std::min(pos + len - prev_pos, kMaxSymbolLength))];
+        }
+        prev_pos = pos;
+        pos += len;
+      }
+    }
+
+    std::vector<std::pair<size_t, std::string_view>> candidates;
+    candidates.reserve(counts.size());
+    for (const auto& [symbol, count] : counts) {
+      candidates.emplace_back(count * symbol.size(), symbol);
+    }
+    const size_t num_symbols = std::min(kMaxSymbols, candidates.size());
+    std::partial_sort(candidates.begin(),
+                      candidates.begin() + num_symbols,
+                      candidates.end(),
+                      [](const auto& lhs, const auto& rhs) {
+                        return lhs.first != rhs.first ? lhs.first > rhs.first
+                                                      : lhs.second < rhs.second;
+                      });
+
+    std::unique_ptr<PayloadSymbolTable> next(new PayloadSymbolTable());
+    for (size_t i = 0; i < num_symbols; ++i) {
+      next->addSymbol(candidates[i].second);
+    }
+    next->finalize();
+    table = std::move(next);
+  }
+  return table;
+}
+
+void PayloadSymbolTable::encode(std::string_view str, std::string& out) const {
+  for (size_t pos = 0; pos < str.size();) {
+    const int code = findLongestSymbol(str, pos);
+    if (code >= 0) {
+      out.push_back(static_cast<char>(code));
+      pos += symbol_lens_[code];
+    } else {
+      out.push_back(static_cast<char>(kEscapeCode));
+      out.push_back(str[pos++]);
+    }
+  }
+}
+
+void PayloadSymbolTable::decode(const char* codes, size_t size, std::string& out) const {
+  size_t decoded_size = 0;
+  for (size_t i = 0; i < size; ++i) {
+    const uint8_t code = static_cast<uint8_t>(codes[i]);
+    if (code == kEscapeCode) {
+      ++i;
+      ++decoded_size;
+    } else {
+      decoded_size += symbol_lens_[code];
+    }
+  }
+
+  const size_t out_start = out.size();
+  // Symbols are copied as whole 8-byte words, so reserve some slack at the end.
+  out.resize(out_start + decoded_size + kMaxSymbolLength);
+  char* dst = out.data() + out_start;
+  for (size_t i = 0; i < size; ++i) {
+    const uint8_t code = static_cast<uint8_t>(codes[i]);
+    if (code == kEscapeCode) {
+      *dst++ = codes[++i];
+    } else {
+      memcpy(dst, &symbol_words_[code], sizeof(uint64_t));
+      dst += symbol_lens_[code];
+    }
+  }
+  out.resize(out_start + decoded_size);
+}
+
+void PayloadSymbolTable::serialize(std::string& out) const {
+  out.push_back(static_cast<char>(symbols_.size()));
+  for (const auto& symbol : symbols_) {
+    out.push_back(static_cast<char>(symbol.size()));
+    out.append(symbol);
+  }
+}
+
+std::unique_ptr<PayloadSymbolTable> PayloadSymbolTable::deserialize(
+    std::string_view data) {
+  std::unique_ptr<PayloadSymbolTable> table(new PayloadSymbolTable());
+  size_t pos = 0;
+  if (data.empty()) {
+    throw std::runtime_error("Empty serialized symbol table.");
+  }
+  const size_t num_symbols = static_cast<uint8_t>(data[pos++]);
+  for (size_t i = 0; i < num_symbols; ++i) {
+    const size_t len = pos < data.size() ? static_cast<uint8_t>(data[pos++]) : 0;
+    if (!len || len > kMaxSymbolLength || pos + len > data.size()) {
+      throw std::runtime_error("Malformed serialized symbol table.");
+    }
+    table->addSymbol(data.substr(pos, len));
+    pos += len;
+  }
+  table->finalize();
+  return table;
+}
+
+void PayloadSymbolTable::addSymbol(std::string_view symbol) {
+  CHECK_LT(symbols_.size(), kMaxSymbols);
+  CHECK(!symbol.empty() && symbol.size() <= kMaxSymbolLength);
+  symbols_.emplace_back(symbol);
+}
+
+void PayloadSymbolTable::finalize() {
+  for (auto& codes : codes_by_first_byte_) {
+    codes.clear();
+  }
+  for (size_t code = 0; code < symbols_.size(); ++code) {
+    const auto& symbol = symbols_[code];
+    symbol_words_[code] = 0;
+    memcpy(&symbol_words_[code], symbol.data(), symbol.size());
+    symbol_lens_[code] = static_cast<uint8_t>(symbol.size());
+    codes_by_first_byte_[static_cast<uint8_t>(symbol[0])].push_back(
+        static_cast<uint8_t>(code));
+  }
+  for (auto& codes : codes_by_first_byte_) {
+    std::stable_sort(codes.begin(), codes.end(), [this](uint8_t lhs, uint8_t rhs) {
+      return symbol_lens_[lhs] > symbol_lens_[rhs];
+    });
+  }
+}
+
+int PayloadSymbolTable::findLongestSymbol(std::string_view str, size_t pos) const {
+  const size_t remaining = str.size() - pos;
+  for (const auto code : codes_by_first_byte_[static_cast<uint8_t>(str[pos])]) {
+    const size_t len = symbol_lens_[code];
+    if (len <= remaining && !memcmp(symbols_[code].data(), str.data() + pos, len)) {
+      return code;
+    }
+  }
+  return -1;
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Static symbol table used to compress string dictionary payload (FSST-style).
+ *
+ * Up to 255 symbols of 1-8 bytes are learned from a sample of strings. Each symbol is
+ * encoded with a single byte code, bytes not covered by any symbol are emitted as an
+ * escape code followed by the literal byte. Encoding is greedy (longest symbol first)
+ * and deterministic, so equal strings always have equal encodings and encoded strings
+ * can be compared byte-wise for equality.
+ */
+class PayloadSymbolTable {
+ public:
+  static constexpr size_t kMaxSymbols = 255;
+  static constexpr size_t kMaxSymbolLength = 8;
+  static constexpr uint8_t kEscapeCode = 255;
+
+  static std::unique_ptr<PayloadSymbolTable> build(
+      const std::vector<std::string_view>& sample);
+
+  // Appends encoded str to out. Encoded size never exceeds 2 * str.size().
+  void encode(std::string_view str, std::string& out) const;
+  // Appends decoded string to out.
+  void decode(const char* codes, size_t size, std::string& out) const;
+
+  size_t symbolCount() const { return symbols_.size(); }
+
+  // Serialized table is the symbol count followed by length-prefixed symbols.
+  void serialize(std::string& out) const;
+  static std::unique_ptr<PayloadSymbolTable> deserialize(std::string_view data);
+
+ private:
+  PayloadSymbolTable() = default;
+
+  void addSymbol(std::string_view symbol);
+  void finalize();
+  // Returns the code of the longest symbol matching str at pos, or -1.
+  int findLongestSymbol(std::string_view str, size_t pos) const;
+
+  std::vector<std::string> symbols_;
+  // Symbols in fixed-size slots to decode with a single unaligned copy.
+  std::array<uint64_t, kMaxSymbols> symbol_words_{};
+  std::array<uint8_t, kMaxSymbols> symbol_lens_{};
+  // Codes of symbols starting with a given byte, longest symbols first.
+  std::array<std::vector<uint8_t>, 256> codes_by_first_byte_;
+};
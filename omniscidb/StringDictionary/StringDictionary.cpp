@@ -21,8 +21,11 @@
 #include <algorithm>
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/path.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/sort/spreadsort/string_sort.hpp>
+#include <atomic>
 #include <functional>
+#include <fstream>
 #include <future>
 #include <iostream>
 #include <string_view>
@@ -41,6 +44,7 @@
 #include "OSDependent/omnisci_fs.h"
 #include "Shared/sqltypes.h"
 #include "Shared/thread_count.h"
+#include "StringDictionary/PayloadSymbolTable.h"
 #include "Utils/Regexp.h"
 #include "Utils/StringLike.h"
 
@@ -59,6 +63,35 @@ string_dict_hash_t hash_string(const std::string_view& str) {
   return str_hash;
 }
 
+std::atomic<uint64_t> g_next_dict_instance_id{0};
+
+constexpr char kSnapshotMagic[8] = {'H', 'D', 'K', 'D', 'I', 'C', 'T', '\0'};
+constexpr uint32_t kSnapshotVersion = 1;
+constexpr uint32_t kSnapshotHashesFlag = 1;
+// Fixed rather than the system page size to keep the format portable.
+constexpr uint64_t kSnapshotAlignment = 4096;
+
+struct SnapshotSection {
+  uint64_t offset;
+  uint64_t size;
+};
+
+struct SnapshotHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t flags;
+  uint64_t str_count;
+  SnapshotSection offsets;
+  SnapshotSection payload;
+  SnapshotSection hash_table;
+  SnapshotSection hash_cache;
+  SnapshotSection symbol_table;
+};
+
+uint64_t align_snapshot_offset(const uint64_t offset) {
+  return (offset + kSnapshotAlignment - 1) / kSnapshotAlignment * kSnapshotAlignment;
+}
+
 struct ThreadInfo {
   int64_t num_threads{0};
   int64_t num_elems_per_thread;
@@ -85,6 +118,7 @@ StringDictionary::StringDictionary(const DictRef& dict_ref,
                                    const bool materializeHashes,
                                    size_t initial_capacity)
     : dict_ref_(dict_ref)
+    , instance_id_(g_next_dict_instance_id++)
     , str_count_(0)
     , string_id_string_dict_hash_table_(initial_capacity, INVALID_STR_ID)
     , hash_cache_(initial_capacity)
@@ -94,7 +128,10 @@ StringDictionary::StringDictionary(const DictRef& dict_ref,
     , offset_file_size_(0)
     , payload_file_size_(0)
     , payload_file_off_(0)
-    , strings_cache_(nullptr) {
+    , like_cache_(DEFAULT_PATTERN_CACHE_BUDGET)
+    , regex_cache_(DEFAULT_PATTERN_CACHE_BUDGET)
+    , strings_cache_(nullptr)
+    , translation_cache_(DEFAULT_TRANSLATION_CACHE_BUDGET) {
   // initial capacity must be a power of two for efficient bucket computation
   CHECK_EQ(size_t(0), (initial_capacity & (initial_capacity - 1)));
 }
@@ -121,8 +158,9 @@ void StringDictionary::eachStringSerially(int64_t const generation,
   size_t const n = std::min(static_cast<size_t>(generation), str_count_);
   CHECK_LE(n, static_cast<size_t>(std::numeric_limits<int32_t>::max()) + 1);
   mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+  std::string decode_buffer;
   for (unsigned id = 0; id < n; ++id) {
-    serial_callback(getStringFromStorageFast(static_cast<int>(id)), id);
+    serial_callback(getStringFromStorageFast(static_cast<int>(id), decode_buffer), id);
   }
 }
 
@@ -176,6 +214,7 @@ int32_t StringDictionary::getOrAdd(const std::string_view& str) noexcept {
     }
     ++str_count_;
     invalidateInvertedIndex();
+    maybeCompressPayload();
   }
   return string_id_string_dict_hash_table_[bucket];
 }
@@ -405,6 +444,7 @@ void StringDictionary::getOrAddBulk(const std::vector<String>& input_strings,
   const size_t num_strings_added = str_count_ - initial_str_count;
   if (num_strings_added > 0) {
     invalidateInvertedIndex();
+    maybeCompressPayload();
   }
 }
 
@@ -482,6 +522,7 @@ void StringDictionary::getOrAddBulkParallel(const std::vector<String>& input_str
   str_count_ = shadow_str_count;
   if (num_strings_added > 0) {
     invalidateInvertedIndex();
+    maybeCompressPayload();
   }
 }
 template void StringDictionary::getOrAddBulk(const std::vector<std::string>& string_vec,
@@ -528,11 +569,12 @@ std::string StringDictionary::getStringUnlocked(int32_t string_id) const noexcep
 }
 
 std::pair<char*, size_t> StringDictionary::getStringBytes(
-    int32_t string_id) const noexcept {
+    int32_t string_id,
+    std::string& decode_buffer) const noexcept {
   mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
   CHECK_LE(0, string_id);
   CHECK_LT(string_id, static_cast<int32_t>(str_count_));
-  return getStringBytesChecked(string_id);
+  return getStringBytesChecked(string_id, decode_buffer);
 }
 
 size_t StringDictionary::storageEntryCount() const {
@@ -542,22 +584,22 @@ size_t StringDictionary::storageEntryCount() const {
 
 namespace {
 
-bool is_like(const std::string& str,
+bool is_like(const std::string_view str,
              const std::string& pattern,
              const bool icase,
              const bool is_simple,
              const char escape) {
   return icase
              ? (is_simple ? string_ilike_simple(
-                                str.c_str(), str.size(), pattern.c_str(), pattern.size())
-                          : string_ilike(str.c_str(),
+                                str.data(), str.size(), pattern.c_str(), pattern.size())
+                          : string_ilike(str.data(),
                                          str.size(),
                                          pattern.c_str(),
                                          pattern.size(),
                                          escape))
              : (is_simple ? string_like_simple(
-                                str.c_str(), str.size(), pattern.c_str(), pattern.size())
-                          : string_like(str.c_str(),
+                                str.data(), str.size(), pattern.c_str(), pattern.size())
+                          : string_like(str.data(),
                                         str.size(),
                                         pattern.c_str(),
                                         pattern.size(),
@@ -566,37 +608,27 @@ bool is_like(const std::string& str,
 
 }  // namespace
 
-std::vector<int32_t> StringDictionary::getLike(const std::string& pattern,
-                                               const bool icase,
-                                               const bool is_simple,
-                                               const char escape,
-                                               const size_t generation) const {
-  mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
-  const auto cache_key = std::make_tuple(pattern, icase, is_simple, escape);
-  const auto it = like_cache_.find(cache_key);
-  if (it != like_cache_.end()) {
-    return it->second;
-  }
+template <class Predicate>
+std::vector<int32_t> StringDictionary::getMatchingIds(const size_t begin,
+                                                      const size_t end,
+                                                      const Predicate& is_match) const {
+  // Each worker scans a contiguous range of ids, so concatenated results are sorted.
   std::vector<int32_t> result;
   std::vector<std::thread> workers;
-  int worker_count = cpu_threads();
-  CHECK_GT(worker_count, 0);
+  const size_t worker_count = std::min<size_t>(cpu_threads(), end - begin);
   std::vector<std::vector<int32_t>> worker_results(worker_count);
-  CHECK_LE(generation, str_count_);
-  for (int worker_idx = 0; worker_idx < worker_count; ++worker_idx) {
+  for (size_t worker_idx = 0; worker_idx < worker_count; ++worker_idx) {
+    const size_t worker_begin = begin + (end - begin) * worker_idx / worker_count;
+    const size_t worker_end = begin + (end - begin) * (worker_idx + 1) / worker_count;
     workers.emplace_back([&worker_results,
-                          &pattern,
-                          generation,
-                          icase,
-                          is_simple,
-                          escape,
+                          &is_match,
+                          worker_begin,
+                          worker_end,
                           worker_idx,
-                          worker_count,
                           this]() {
-      for (size_t string_id = worker_idx; string_id < generation;
-           string_id += worker_count) {
-        const auto str = getStringUnlocked(string_id);
-        if (is_like(str, pattern, icase, is_simple, escape)) {
+      std::string decode_buffer;
+      for (size_t string_id = worker_begin; string_id < worker_end; ++string_id) {
+        if (is_match(getStringFromStorageFast(string_id, decode_buffer))) {
           worker_results[worker_idx].push_back(string_id);
         }
       }
@@ -608,14 +640,24 @@ std::vector<int32_t> StringDictionary::getLike(const std::string& pattern,
   for (const auto& worker_result : worker_results) {
     result.insert(result.end(), worker_result.begin(), worker_result.end());
   }
-  // place result into cache for reuse if similar query
-  const auto it_ok = like_cache_.insert(std::make_pair(cache_key, result));
-
-  CHECK(it_ok.second);
-
   return result;
 }
 
+std::vector<int32_t> StringDictionary::getLike(const std::string& pattern,
+                                               const bool icase,
+                                               const bool is_simple,
+                                               const char escape,
+                                               const size_t generation) const {
+  mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
+  CHECK_LE(generation, str_count_);
+  const auto cache_key = std::make_tuple(pattern, icase, is_simple, escape);
+  return like_cache_.get(cache_key, generation, [&](size_t begin, size_t end) {
+    return getMatchingIds(begin, end, [&](const std::string_view str) {
+      return is_like(str, pattern, icase, is_simple, escape);
+    });
+  });
+}
+
 std::vector<int32_t> StringDictionary::getEquals(std::string pattern,
                                                  std::string comp_operator,
                                                  size_t generation) {
@@ -695,12 +737,14 @@ std::vector<int32_t> StringDictionary::getCompare(const std::string& pattern,
 
   if (!cache_index) {
     cache_index = std::make_shared<StringDictionary::compare_cache_value_t>();
+    std::string decode_buffer;
     const auto cache_itr = std::lower_bound(
         sorted_cache.begin(),
         sorted_cache.end(),
         pattern,
-        [this](decltype(sorted_cache)::value_type const& a, decltype(pattern)& b) {
-          auto a_str = this->getStringFromStorage(a);
+        [this, &decode_buffer](decltype(sorted_cache)::value_type const& a,
+                               decltype(pattern)& b) {
+          auto a_str = this->getStringFromStorage(a, decode_buffer);
           return string_lt(a_str.c_str_ptr, a_str.size, b.c_str(), b.size());
         });
 
@@ -708,7 +752,7 @@ std::vector<int32_t> StringDictionary::getCompare(const std::string& pattern,
       cache_index->index = sorted_cache.size() - 1;
       cache_index->diff = 1;
     } else {
-      const auto cache_str = getStringFromStorage(*cache_itr);
+      const auto cache_str = getStringFromStorage(*cache_itr, decode_buffer);
       if (!string_eq(
               cache_str.c_str_ptr, cache_str.size, pattern.c_str(), pattern.size())) {
         cache_index->index = cache_itr - sorted_cache.begin() - 1;
@@ -826,10 +870,10 @@ std::vector<int32_t> StringDictionary::getCompare(const std::string& pattern,
 
 namespace {
 
-bool is_regexp_like(const std::string& str,
+bool is_regexp_like(const std::string_view str,
                     const std::string& pattern,
                     const char escape) {
-  return regexp_like(str.c_str(), str.size(), pattern.c_str(), pattern.size(), escape);
+  return regexp_like(str.data(), str.size(), pattern.c_str(), pattern.size(), escape);
 }
 
 }  // namespace
@@ -838,44 +882,13 @@ std::vector<int32_t> StringDictionary::getRegexpLike(const std::string& pattern,
                                                      const char escape,
                                                      const size_t generation) const {
   mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
-  const auto cache_key = std::make_pair(pattern, escape);
-  const auto it = regex_cache_.find(cache_key);
-  if (it != regex_cache_.end()) {
-    return it->second;
-  }
-  std::vector<int32_t> result;
-  std::vector<std::thread> workers;
-  int worker_count = cpu_threads();
-  CHECK_GT(worker_count, 0);
-  std::vector<std::vector<int32_t>> worker_results(worker_count);
   CHECK_LE(generation, str_count_);
-  for (int worker_idx = 0; worker_idx < worker_count; ++worker_idx) {
-    workers.emplace_back([&worker_results,
-                          &pattern,
-                          generation,
-                          escape,
-                          worker_idx,
-                          worker_count,
-                          this]() {
-      for (size_t string_id = worker_idx; string_id < generation;
-           string_id += worker_count) {
-        const auto str = getStringUnlocked(string_id);
-        if (is_regexp_like(str, pattern, escape)) {
-          worker_results[worker_idx].push_back(string_id);
-        }
-      }
+  const auto cache_key = std::make_pair(pattern, escape);
+  return regex_cache_.get(cache_key, generation, [&](size_t begin, size_t end) {
+    return getMatchingIds(begin, end, [&](const std::string_view str) {
+      return is_regexp_like(str, pattern, escape);
     });
-  }
-  for (auto& worker : workers) {
-    worker.join();
-  }
-  for (const auto& worker_result : worker_results) {
-    result.insert(result.end(), worker_result.begin(), worker_result.end());
-  }
-  const auto it_ok = regex_cache_.insert(std::make_pair(cache_key, result));
-  CHECK(it_ok.second);
-
-  return result;
+  });
 }
 
 std::vector<std::string> StringDictionary::copyStrings() const {
@@ -986,14 +999,16 @@ void StringDictionary::increaseHashTableCapacityFromStorageAndMemory(
 }
 
 std::string StringDictionary::getStringChecked(const int string_id) const noexcept {
-  const auto str_canary = getStringFromStorage(string_id);
+  std::string decode_buffer;
+  const auto str_canary = getStringFromStorage(string_id, decode_buffer);
   CHECK(!str_canary.canary);
   return std::string(str_canary.c_str_ptr, str_canary.size);
 }
 
 std::pair<char*, size_t> StringDictionary::getStringBytesChecked(
-    const int string_id) const noexcept {
-  const auto str_canary = getStringFromStorage(string_id);
+    const int string_id,
+    std::string& decode_buffer) const noexcept {
+  const auto str_canary = getStringFromStorage(string_id, decode_buffer);
   CHECK(!str_canary.canary);
   return std::make_pair(str_canary.c_str_ptr, str_canary.size);
 }
@@ -1004,6 +1019,10 @@ uint32_t StringDictionary::computeBucket(
     const String& input_string,
     const std::vector<int32_t>& string_id_string_dict_hash_table) const noexcept {
   const size_t string_dict_hash_table_size = string_id_string_dict_hash_table.size();
+  // Encoding is deterministic, so we can compare encoded strings instead of decoding
+  // each candidate.
+  std::string encode_buffer;
+  const std::string_view lookup_string = encodePayload(input_string, encode_buffer);
   uint32_t bucket = hash & (string_dict_hash_table_size - 1);
   while (true) {
     const int32_t candidate_string_id = string_id_string_dict_hash_table[bucket];
@@ -1013,9 +1032,9 @@ uint32_t StringDictionary::computeBucket(
     }
     if ((materialize_hashes_ && hash == hash_cache_[candidate_string_id]) ||
         !materialize_hashes_) {
-      const auto candidate_string = getStringFromStorageFast(candidate_string_id);
-      if (input_string.size() == candidate_string.size() &&
-          !memcmp(input_string.data(), candidate_string.data(), input_string.size())) {
+      const auto candidate_string = getEncodedStringFromStorage(candidate_string_id);
+      if (lookup_string.size() == candidate_string.size() &&
+          !memcmp(lookup_string.data(), candidate_string.data(), lookup_string.size())) {
         // found the string
         break;
       }
@@ -1036,6 +1055,8 @@ uint32_t StringDictionary::computeBucketFromStorageAndMemory(
     const size_t storage_high_water_mark,
     const std::vector<String>& input_strings,
     const std::vector<size_t>& string_memory_ids) const noexcept {
+  std::string encode_buffer;
+  const std::string_view lookup_string = encodePayload(input_string, encode_buffer);
   uint32_t bucket = input_string_hash & (string_id_string_dict_hash_table.size() - 1);
   while (true) {
     const int32_t candidate_string_id = string_id_string_dict_hash_table[bucket];
@@ -1059,11 +1080,11 @@ uint32_t StringDictionary::computeBucketFromStorageAndMemory(
       } else {
         // The candidate string is in storage, need to fetch it for comparison
         const auto candidate_storage_string =
-            getStringFromStorageFast(candidate_string_id);
-        if (input_string.size() == candidate_storage_string.size() &&
-            !memcmp(input_string.data(),
+            getEncodedStringFromStorage(candidate_string_id);
+        if (lookup_string.size() == candidate_storage_string.size() &&
+            !memcmp(lookup_string.data(),
                     candidate_storage_string.data(),
-                    input_string.size())) {
+                    lookup_string.size())) {
           //! memcmp(input_string.data(), candidate_storage_string.c_str_ptr,
           //! input_string.size())) {
           // found the string in storage
@@ -1120,13 +1141,16 @@ void StringDictionary::checkAndConditionallyIncreaseOffsetCapacity(
 
 template <class String>
 void StringDictionary::appendToStorage(const String str) noexcept {
+  std::string encode_buffer;
+  const std::string_view payload = encodePayload(str, encode_buffer);
+
   // write the payload
-  checkAndConditionallyIncreasePayloadCapacity(str.size());
-  memcpy(payload_map_ + payload_file_off_, str.data(), str.size());
+  checkAndConditionallyIncreasePayloadCapacity(payload.size());
+  memcpy(payload_map_ + payload_file_off_, payload.data(), payload.size());
 
   // write the offset and length
-  StringIdxEntry str_meta{static_cast<uint64_t>(payload_file_off_), str.size()};
-  payload_file_off_ += str.size();  // Need to increment after we've defined str_meta
+  StringIdxEntry str_meta{static_cast<uint64_t>(payload_file_off_), payload.size()};
+  payload_file_off_ += payload.size();  // Need to increment after we've defined str_meta
 
   checkAndConditionallyIncreaseOffsetCapacity(sizeof(str_meta));
   memcpy(offset_map_ + str_count_, &str_meta, sizeof(str_meta));
@@ -1139,6 +1163,33 @@ void StringDictionary::appendToStorageBulk(
     const size_t sum_new_strings_lengths) noexcept {
   const size_t num_strings = string_memory_ids.size();
 
+  if (symbol_table_) {
+    // Encoded size is not known in advance, so encode all strings first.
+    std::string encoded_strings;
+    encoded_strings.reserve(sum_new_strings_lengths);
+    std::vector<size_t> encoded_offsets(num_strings + 1);
+    for (size_t i = 0; i < num_strings; ++i) {
+      const String& str = input_strings[string_memory_ids[i]];
+      encoded_offsets[i] = encoded_strings.size();
+      symbol_table_->encode(std::string_view(str.data(), str.size()), encoded_strings);
+    }
+    encoded_offsets[num_strings] = encoded_strings.size();
+
+    checkAndConditionallyIncreasePayloadCapacity(encoded_strings.size());
+    checkAndConditionallyIncreaseOffsetCapacity(sizeof(StringIdxEntry) * num_strings);
+    memcpy(payload_map_ + payload_file_off_,
+           encoded_strings.data(),
+           encoded_strings.size());
+    for (size_t i = 0; i < num_strings; ++i) {
+      StringIdxEntry str_meta{
+          static_cast<uint64_t>(payload_file_off_ + encoded_offsets[i]),
+          encoded_offsets[i + 1] - encoded_offsets[i]};
+      memcpy(offset_map_ + str_count_ + i, &str_meta, sizeof(str_meta));
+    }
+    payload_file_off_ += encoded_strings.size();
+    return;
+  }
+
   checkAndConditionallyIncreasePayloadCapacity(sum_new_strings_lengths);
   checkAndConditionallyIncreaseOffsetCapacity(sizeof(StringIdxEntry) * num_strings);
 
@@ -1154,22 +1205,294 @@ void StringDictionary::appendToStorageBulk(
 }
 
 std::string_view StringDictionary::getStringFromStorageFast(
-    const int string_id) const noexcept {
+    const int string_id,
+    std::string& decode_buffer) const noexcept {
   const StringIdxEntry* str_meta = offset_map_ + string_id;
+  if (symbol_table_) {
+    decode_buffer.clear();
+    symbol_table_->decode(payload_map_ + str_meta->off, str_meta->size, decode_buffer);
+    return decode_buffer;
+  }
   return {payload_map_ + str_meta->off, str_meta->size};
 }
 
 StringDictionary::PayloadString StringDictionary::getStringFromStorage(
-    const int string_id) const noexcept {
+    const int string_id,
+    std::string& decode_buffer) const noexcept {
   CHECK_GE(string_id, 0);
   const StringIdxEntry* str_meta = offset_map_ + string_id;
   if (str_meta->size == 0xffff) {
     // hit the canary
     return {nullptr, 0, true};
   }
+  if (symbol_table_) {
+    decode_buffer.clear();
+    symbol_table_->decode(payload_map_ + str_meta->off, str_meta->size, decode_buffer);
+    return {decode_buffer.data(), decode_buffer.size(), false};
+  }
   return {payload_map_ + str_meta->off, str_meta->size, false};
 }
 
+std::string_view StringDictionary::getEncodedStringFromStorage(
+    const int string_id) const noexcept {
+  const StringIdxEntry* str_meta = offset_map_ + string_id;
+  return {payload_map_ + str_meta->off, str_meta->size};
+}
+
+template <class String>
+std::string_view StringDictionary::encodePayload(
+    const String& str,
+    std::string& encode_buffer) const noexcept {
+  if (!symbol_table_) {
+    return {str.data(), str.size()};
+  }
+  encode_buffer.clear();
+  symbol_table_->encode(std::string_view(str.data(), str.size()), encode_buffer);
+  return encode_buffer;
+}
+
+void StringDictionary::enablePayloadCompression(const size_t min_training_strings) {
+  mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
+  compression_training_strings_ = std::max(min_training_strings, size_t(1));
+  maybeCompressPayload();
+}
+
+bool StringDictionary::isPayloadCompressed() const {
+  mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+  return symbol_table_ != nullptr;
+}
+
+size_t StringDictionary::payloadSize() const {
+  mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+  return payload_file_off_;
+}
+
+void StringDictionary::maybeCompressPayload() noexcept {
+  // This method is not thread-safe.
+  if (compression_training_strings_ && !symbol_table_ &&
+      str_count_ >= compression_training_strings_) {
+    compressPayload();
+  }
+}
+
+void StringDictionary::compressPayload() noexcept {
+  // This method is not thread-safe.
+  auto timer = DEBUG_TIMER(__func__);
+  CHECK(!symbol_table_);
+  CHECK_GT(str_count_, size_t(0));
+
+  // Train the symbol table on evenly spaced strings.
+  constexpr size_t max_sample_bytes = 1 << 16;
+  const size_t sample_step = std::max(size_t(1), payload_file_off_ / max_sample_bytes);
+  std::vector<std::string_view> sample;
+  sample.reserve(str_count_ / sample_step + 1);
+  for (size_t string_id = 0; string_id < str_count_; string_id += sample_step) {
+    sample.push_back(getEncodedStringFromStorage(string_id));
+  }
+  auto symbol_table = PayloadSymbolTable::build(sample);
+
+  // Re-encode the existing payload into a new buffer. String ids and sorted cache
+  // stay the same, only offsets and sizes change.
+  char* raw_payload_map = payload_map_;
+  const size_t raw_payload_size = payload_file_off_;
+  payload_map_ = nullptr;
+  payload_file_size_ = 0;
+  payload_file_off_ = 0;
+  addPayloadCapacity(raw_payload_size / 2);
+  std::string encoded;
+  for (size_t string_id = 0; string_id < str_count_; ++string_id) {
+    StringIdxEntry* str_meta = offset_map_ + string_id;
+    encoded.clear();
+    symbol_table->encode({raw_payload_map + str_meta->off, str_meta->size}, encoded);
+    checkAndConditionallyIncreasePayloadCapacity(encoded.size());
+    memcpy(payload_map_ + payload_file_off_, encoded.data(), encoded.size());
+    str_meta->off = payload_file_off_;
+    str_meta->size = encoded.size();
+    payload_file_off_ += encoded.size();
+  }
+  free(raw_payload_map);
+  symbol_table_ = std::move(symbol_table);
+  VLOG(1) << "Compressed payload of dictionary " << dict_ref_.toString() << " from "
+          << raw_payload_size << " to " << payload_file_off_ << " bytes using "
+          << symbol_table_->symbolCount() << " symbols.";
+}
+
+void StringDictionary::saveSnapshot(const std::string& path) const {
+  auto timer = DEBUG_TIMER(__func__);
+  mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+  std::string symbol_table;
+  if (symbol_table_) {
+    symbol_table_->serialize(symbol_table);
+  }
+
+  SnapshotHeader header{};
+  memcpy(header.magic, kSnapshotMagic, sizeof(header.magic));
+  header.version = kSnapshotVersion;
+  header.flags = materialize_hashes_ ? kSnapshotHashesFlag : 0;
+  header.str_count = str_count_;
+  uint64_t file_off = align_snapshot_offset(sizeof(header));
+  auto add_section = [&file_off](SnapshotSection& section, const uint64_t size) {
+    section.offset = file_off;
+    section.size = size;
+    file_off = align_snapshot_offset(file_off + size);
+  };
+  add_section(header.offsets, str_count_ * sizeof(StringIdxEntry));
+  add_section(header.payload, payload_file_off_);
+  add_section(header.hash_table,
+              string_id_string_dict_hash_table_.size() * sizeof(int32_t));
+  add_section(header.hash_cache,
+              materialize_hashes_ ? str_count_ * sizeof(string_dict_hash_t) : 0);
+  add_section(header.symbol_table, symbol_table.size());
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    throw std::runtime_error("Cannot open dictionary snapshot file " + path);
+  }
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  auto write_section = [&out](const SnapshotSection& section, const void* data) {
+    if (section.size) {
+      out.seekp(section.offset);
+      out.write(static_cast<const char*>(data), section.size);
+    }
+  };
+  write_section(header.offsets, offset_map_);
+  write_section(header.payload, payload_map_);
+  write_section(header.hash_table, string_id_string_dict_hash_table_.data());
+  write_section(header.hash_cache, hash_cache_.data());
+  write_section(header.symbol_table, symbol_table.data());
+  out.close();
+  if (!out) {
+    throw std::runtime_error("Cannot write dictionary snapshot file " + path);
+  }
+}
+
+std::shared_ptr<StringDictionary> StringDictionary::loadSnapshot(
+    const DictRef& dict_ref,
+    const std::string& path,
+    const bool materializeHashes) {
+  auto timer = DEBUG_TIMER(__func__);
+  boost::iostreams::mapped_file_source file;
+  try {
+    file.open(path);
+  } catch (const std::exception& e) {
+    throw std::runtime_error("Cannot open dictionary snapshot file " + path + ": " +
+                             e.what());
+  }
+  auto format_error = [&path](const std::string& reason) {
+    return std::runtime_error("Malformed dictionary snapshot file " + path + ": " +
+                              reason);
+  };
+
+  SnapshotHeader header;
+  if (file.size() < sizeof(header)) {
+    throw format_error("truncated header");
+  }
+  memcpy(&header, file.data(), sizeof(header));
+  if (memcmp(header.magic, kSnapshotMagic, sizeof(header.magic))) {
+    throw format_error("bad magic");
+  }
+  if (header.version != kSnapshotVersion) {
+    throw format_error("unsupported version " + std::to_string(header.version));
+  }
+  for (const auto& section : {header.offsets,
+                              header.payload,
+                              header.hash_table,
+                              header.hash_cache,
+                              header.symbol_table}) {
+    if (section.size &&
+        (section.offset > file.size() || section.size > file.size() - section.offset)) {
+      throw format_error("section is out of file bounds");
+    }
+  }
+  const uint64_t hash_table_size = header.hash_table.size / sizeof(int32_t);
+  const bool has_hashes = header.flags & kSnapshotHashesFlag;
+  if (header.str_count > MAX_STRCOUNT ||
+      header.offsets.size != header.str_count * sizeof(StringIdxEntry) ||
+      hash_table_size <= header.str_count ||
+      (hash_table_size & (hash_table_size - 1)) ||
+      header.hash_cache.size !=
+          (has_hashes ? header.str_count * sizeof(string_dict_hash_t) : 0)) {
+    throw format_error("inconsistent section sizes");
+  }
+
+  auto dict =
+      std::make_shared<StringDictionary>(dict_ref, materializeHashes, hash_table_size);
+  const char* data = file.data();
+  if (header.symbol_table.size) {
+    dict->symbol_table_ = PayloadSymbolTable::deserialize(
+        {data + header.symbol_table.offset, header.symbol_table.size});
+  }
+  if (header.str_count) {
+    dict->addOffsetCapacity(header.offsets.size);
+    memcpy(dict->offset_map_, data + header.offsets.offset, header.offsets.size);
+    dict->addPayloadCapacity(header.payload.size);
+    memcpy(dict->payload_map_, data + header.payload.offset, header.payload.size);
+    for (size_t string_id = 0; string_id < header.str_count; ++string_id) {
+      const auto& str_meta = dict->offset_map_[string_id];
+      if (str_meta.off + str_meta.size > header.payload.size) {
+        throw format_error("string is out of payload bounds");
+      }
+    }
+  }
+  dict->str_count_ = header.str_count;
+  dict->payload_file_off_ = header.payload.size;
+  memcpy(dict->string_id_string_dict_hash_table_.data(),
+         data + header.hash_table.offset,
+         header.hash_table.size);
+  // Every string must be referenced by exactly one bucket, otherwise lookups would
+  // read out of bounds or miss strings. Stored hashes also tell where probing for each
+  // string starts, and no empty bucket may break the probing sequence.
+  const auto& hash_table = dict->string_id_string_dict_hash_table_;
+  std::vector<bool> referenced(header.str_count, false);
+  for (const auto string_id : hash_table) {
+    if (string_id == INVALID_STR_ID) {
+      continue;
+    }
+    if (string_id < 0 || static_cast<uint64_t>(string_id) >= header.str_count ||
+        referenced[string_id]) {
+      throw format_error("bad string id " + std::to_string(string_id) +
+                         " in hash table");
+    }
+    referenced[string_id] = true;
+  }
+  if (std::find(referenced.begin(), referenced.end(), false) != referenced.end()) {
+    throw format_error("string is missing in hash table");
+  }
+  if (has_hashes) {
+    const auto hashes = reinterpret_cast<const string_dict_hash_t*>(
+        data + header.hash_cache.offset);
+    for (uint64_t bucket = 0; bucket < hash_table_size; ++bucket) {
+      const auto string_id = hash_table[bucket];
+      if (string_id == INVALID_STR_ID) {
+        continue;
+      }
+      for (auto probe = hashes[string_id] & (hash_table_size - 1); probe != bucket;
+           probe = (probe + 1) & (hash_table_size - 1)) {
+        if (hash_table[probe] == INVALID_STR_ID) {
+          throw format_error("hash of string " + std::to_string(string_id) +
+                             " doesn't match its bucket");
+        }
+      }
+    }
+  }
+  if (materializeHashes) {
+    if (has_hashes) {
+      memcpy(dict->hash_cache_.data(),
+             data + header.hash_cache.offset,
+             header.hash_cache.size);
+    } else {
+      std::string decode_buffer;
+      for (size_t string_id = 0; string_id < header.str_count; ++string_id) {
+        dict->hash_cache_[string_id] =
+            hash_string(dict->getStringFromStorageFast(string_id, decode_buffer));
+      }
+    }
+  }
+  VLOG(1) << "Loaded dictionary " << dict_ref.toString() << " with " << dict->str_count_
+          << " strings from snapshot " << path;
+  return dict;
+}
+
 void StringDictionary::addPayloadCapacity(const size_t min_capacity_requested) noexcept {
   payload_map_ = static_cast<char*>(
       addMemoryCapacity(payload_map_, payload_file_size_, min_capacity_requested));
@@ -1202,12 +1525,8 @@ void* StringDictionary::addMemoryCapacity(void* addr,
 }
 
 void StringDictionary::invalidateInvertedIndex() noexcept {
-  if (!like_cache_.empty()) {
-    decltype(like_cache_)().swap(like_cache_);
-  }
-  if (!regex_cache_.empty()) {
-    decltype(regex_cache_)().swap(regex_cache_);
-  }
+  // LIKE and REGEXP caches are not invalidated, their entries are extended with new
+  // strings on access.
   if (!equal_cache_.empty()) {
     decltype(equal_cache_)().swap(equal_cache_);
   }
@@ -1231,20 +1550,25 @@ void StringDictionary::sortCache(std::vector<int32_t>& cache) {
   // this boost sort is creating some problems when we use UTF-8 encoded strings.
   // TODO (vraj): investigate What is wrong with boost sort and try to mitigate it.
 
-  std::sort(cache.begin(), cache.end(), [this](int32_t a, int32_t b) {
-    auto a_str = this->getStringFromStorage(a);
-    auto b_str = this->getStringFromStorage(b);
-    return string_lt(a_str.c_str_ptr, a_str.size, b_str.c_str_ptr, b_str.size);
-  });
+  std::string a_buffer;
+  std::string b_buffer;
+  std::sort(
+      cache.begin(), cache.end(), [this, &a_buffer, &b_buffer](int32_t a, int32_t b) {
+        auto a_str = this->getStringFromStorage(a, a_buffer);
+        auto b_str = this->getStringFromStorage(b, b_buffer);
+        return string_lt(a_str.c_str_ptr, a_str.size, b_str.c_str_ptr, b_str.size);
+      });
 }
 
 void StringDictionary::mergeSortedCache(std::vector<int32_t>& temp_sorted_cache) {
   // this method is not thread safe
   std::vector<int32_t> updated_cache(temp_sorted_cache.size() + sorted_cache.size());
   size_t t_idx = 0, s_idx = 0, idx = 0;
+  std::string t_buffer;
+  std::string s_buffer;
   for (; t_idx < temp_sorted_cache.size() && s_idx < sorted_cache.size(); idx++) {
-    auto t_string = getStringFromStorage(temp_sorted_cache[t_idx]);
-    auto s_string = getStringFromStorage(sorted_cache[s_idx]);
+    auto t_string = getStringFromStorage(temp_sorted_cache[t_idx], t_buffer);
+    auto s_string = getStringFromStorage(sorted_cache[s_idx], s_buffer);
     const auto insert_from_temp_cache =
         string_lt(t_string.c_str_ptr, t_string.size, s_string.c_str_ptr, s_string.size);
     if (insert_from_temp_cache) {
@@ -1319,6 +1643,19 @@ size_t StringDictionary::buildDictionaryTranslationMap(
   CHECK_LE(num_dest_strings, static_cast<int64_t>(dest_dict->str_count_));
   const bool dest_dictionary_is_empty = (num_dest_strings == 0);
 
+  if (!dest_dictionary_is_empty) {
+    const auto num_strings_not_translated =
+        buildDictionaryTranslationMapFromCache(dest_dict,
+                                               translated_ids,
+                                               num_source_strings,
+                                               num_dest_strings,
+                                               dest_has_transients,
+                                               dest_transient_lookup_callback);
+    if (num_strings_not_translated) {
+      return *num_strings_not_translated;
+    }
+  }
+
   constexpr int64_t target_strings_per_thread{1000};
   const ThreadInfo thread_info(
       std::thread::hardware_concurrency(), num_source_strings, target_strings_per_thread);
@@ -1365,10 +1702,11 @@ size_t StringDictionary::buildDictionaryTranslationMap(
             const int32_t start_idx = r.begin();
             const int32_t end_idx = r.end();
             size_t num_strings_not_translated = 0;
+            std::string decode_buffer;
             for (int32_t source_string_id = start_idx; source_string_id != end_idx;
                  ++source_string_id) {
               const std::string_view source_str =
-                  getStringFromStorageFast(source_string_id);
+                  getStringFromStorageFast(source_string_id, decode_buffer);
               // Get the hash from this/the source dictionary's cache, as the function
               // will be the same for the dest_dict, sparing us having to recompute it
 
@@ -1408,3 +1746,126 @@ size_t StringDictionary::buildDictionaryTranslationMap(
   }
   return total_num_strings_not_translated;
 }
+
+void StringDictionary::setPatternCacheBudget(const size_t max_bytes) {
+  mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
+  like_cache_.setMaxBytes(max_bytes);
+  regex_cache_.setMaxBytes(max_bytes);
+}
+
+void StringDictionary::setTranslationCacheBudget(const size_t max_bytes) {
+  std::lock_guard<std::mutex> cache_lock(translation_cache_mutex_);
+  translation_cache_.setMaxBytes(max_bytes);
+}
+
+size_t StringDictionary::translationCacheBytes() const {
+  std::lock_guard<std::mutex> cache_lock(translation_cache_mutex_);
+  return translation_cache_.bytes();
+}
+
+std::optional<size_t> StringDictionary::buildDictionaryTranslationMapFromCache(
+    const StringDictionary* dest_dict,
+    int32_t* translated_ids,
+    const int64_t num_source_strings,
+    const int64_t num_dest_strings,
+    const bool dest_has_transients,
+    StringLookupCallback const& dest_transient_lookup_callback) const {
+  // Read locks on both dictionaries are expected to be held by the caller.
+  // Maps which don't fit into the cache budget are built without the cache.
+  std::lock_guard<std::mutex> cache_lock(translation_cache_mutex_);
+  if (!translation_cache_.fits(num_source_strings)) {
+    return std::nullopt;
+  }
+  auto& entry =
+      translation_cache_.get(dest_dict->instance_id_, dest_dict->lifetime_token_);
+  extendTranslationCacheEntry(entry, dest_dict, num_source_strings);
+
+  // Cached ids may refer to destination strings added after the requested destination
+  // generation, treat those as not translated.
+  const auto& cached_ids = entry.translated_ids;
+  std::atomic<size_t> total_num_strings_not_translated{0};
+  tbb::parallel_for(
+      tbb::blocked_range<int64_t>(0, num_source_strings),
+      [&](const tbb::blocked_range<int64_t>& r) {
+        size_t num_strings_not_translated = 0;
+        std::string decode_buffer;
+        for (int64_t source_string_id = r.begin(); source_string_id != r.end();
+             ++source_string_id) {
+          const int32_t translated_string_id = cached_ids[source_string_id];
+          if (translated_string_id != INVALID_STR_ID &&
+              translated_string_id < num_dest_strings) {
+            translated_ids[source_string_id] = translated_string_id;
+            continue;
+          }
+          translated_ids[source_string_id] = INVALID_STR_ID;
+          if (dest_has_transients) {
+            num_strings_not_translated += dest_transient_lookup_callback(
+                getStringFromStorageFast(source_string_id, decode_buffer),
+                source_string_id);
+          } else {
+            num_strings_not_translated++;
+          }
+        }
+        total_num_strings_not_translated += num_strings_not_translated;
+      });
+  translation_cache_.update();
+  return total_num_strings_not_translated.load();
+}
+
+void StringDictionary::extendTranslationCacheEntry(
+    TranslationCacheEntry& entry,
+    const StringDictionary* dest_dict,
+    const size_t num_source_strings) const {
+  const size_t num_dest_strings = dest_dict->str_count_;
+  // Strings appended to the destination dictionary can only match cached source strings
+  // which were not translated yet, look them up in this dictionary.
+  if (entry.num_dest_strings < num_dest_strings && entry.num_source_strings > 0) {
+    auto timer = DEBUG_TIMER("Extend translation map with new destination strings");
+    tbb::parallel_for(
+        tbb::blocked_range<int32_t>(entry.num_dest_strings, num_dest_strings),
+        [&](const tbb::blocked_range<int32_t>& r) {
+          std::string decode_buffer;
+          for (int32_t dest_string_id = r.begin(); dest_string_id != r.end();
+               ++dest_string_id) {
+            const std::string_view dest_str =
+                dest_dict->getStringFromStorageFast(dest_string_id, decode_buffer);
+            const string_dict_hash_t hash = dest_dict->materialize_hashes_
+                                                ? dest_dict->hash_cache_[dest_string_id]
+                                                : hash_string(dest_str);
+            const auto source_string_id = string_id_string_dict_hash_table_[computeBucket(
+                hash, dest_str, string_id_string_dict_hash_table_)];
+            if (source_string_id != INVALID_STR_ID &&
+                static_cast<size_t>(source_string_id) < entry.num_source_strings) {
+              entry.translated_ids[source_string_id] = dest_string_id;
+            }
+          }
+        });
+  }
+  entry.num_dest_strings = num_dest_strings;
+
+  // New source strings are translated against the whole destination dictionary.
+  if (entry.num_source_strings < num_source_strings) {
+    auto timer = DEBUG_TIMER("Extend translation map with new source strings");
+    // Reserve the exact size to keep the accounted memory within the budget checked
+    // by the caller.
+    entry.translated_ids.reserve(num_source_strings);
+    entry.translated_ids.resize(num_source_strings);
+    tbb::parallel_for(
+        tbb::blocked_range<int32_t>(entry.num_source_strings, num_source_strings),
+        [&](const tbb::blocked_range<int32_t>& r) {
+          std::string decode_buffer;
+          for (int32_t source_string_id = r.begin(); source_string_id != r.end();
+               ++source_string_id) {
+            const std::string_view source_str =
+                getStringFromStorageFast(source_string_id, decode_buffer);
+            const string_dict_hash_t hash = materialize_hashes_
+                                                ? hash_cache_[source_string_id]
+                                                : hash_string(source_str);
+            entry.translated_ids[source_string_id] =
+                dest_dict->string_id_string_dict_hash_table_[dest_dict->computeBucket(
+                    hash, source_str, dest_dict->string_id_string_dict_hash_table_)];
+          }
+        });
+    entry.num_source_strings = num_source_strings;
+  }
+}
@@ -20,13 +20,19 @@
 #include "../Shared/mapd_shared_mutex.h"
 #include "DictRef.h"
 #include "DictionaryCache.hpp"
+#include "PatternMatchCache.hpp"
+#include "TranslationMapCache.hpp"
 
 #include <functional>
 #include <future>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 extern bool g_enable_stringdict_parallel;
@@ -35,6 +41,8 @@ using string_dict_hash_t = uint32_t;
 
 using StringLookupCallback = std::function<bool(std::string_view, int32_t string_id)>;
 
+class PayloadSymbolTable;
+
 class StringDictionary {
  public:
   StringDictionary(const DictRef& dict_ref,
@@ -72,7 +80,10 @@ class StringDictionary {
   template <class String>
   int32_t getIdOfString(const String&) const;
   std::string getString(int32_t string_id) const;
-  std::pair<char*, size_t> getStringBytes(int32_t string_id) const noexcept;
+  // Strings of compressed payload are decoded into decode_buffer and the result points
+  // into it. Otherwise, the result points into the payload.
+  std::pair<char*, size_t> getStringBytes(int32_t string_id,
+                                          std::string& decode_buffer) const noexcept;
   size_t storageEntryCount() const;
 
   std::vector<int32_t> getLike(const std::string& pattern,
@@ -91,6 +102,24 @@ class StringDictionary {
 
   std::vector<std::string> copyStrings() const;
 
+  // Switch the dictionary to compressed payload storage. A symbol table is trained
+  // once the dictionary holds min_training_strings strings, at which point the existing
+  // payload is re-encoded. All strings added after that are stored encoded.
+  void enablePayloadCompression(
+      const size_t min_training_strings = DEFAULT_COMPRESSION_TRAINING_STRINGS);
+  bool isPayloadCompressed() const;
+  size_t payloadSize() const;
+
+  // Snapshot holds offsets, payload and hash table of the dictionary in page-aligned
+  // sections of a single file. Loading it restores the dictionary without re-hashing
+  // its strings. Both methods throw std::runtime_error on I/O or format errors, which
+  // include truncated or stale snapshots whose hash table doesn't match the strings.
+  void saveSnapshot(const std::string& path) const;
+  static std::shared_ptr<StringDictionary> loadSnapshot(
+      const DictRef& dict_ref,
+      const std::string& path,
+      const bool materializeHashes = false);
+
   std::vector<int32_t> buildDictionaryTranslationMap(
       const std::shared_ptr<StringDictionary> dest_dict,
       StringLookupCallback const& dest_transient_lookup_callback) const;
@@ -103,9 +132,23 @@ class StringDictionary {
       const bool dest_has_transients,
       StringLookupCallback const& dest_transient_lookup_callback) const;
 
+  // Translation maps to other dictionaries are cached and extended incrementally as
+  // either dictionary grows. The most recently used maps are kept within max_bytes,
+  // maps to destroyed dictionaries are dropped.
+  void setTranslationCacheBudget(const size_t max_bytes);
+  size_t translationCacheBytes() const;
+
+  // LIKE and REGEXP results are cached per pattern and extended as the dictionary
+  // grows. Each of the two caches keeps the most recently used results within
+  // max_bytes.
+  void setPatternCacheBudget(const size_t max_bytes);
+
   static constexpr int32_t INVALID_STR_ID = -1;
   static constexpr size_t MAX_STRLEN = (1 << 15) - 1;
   static constexpr size_t MAX_STRCOUNT = (1U << 31) - 1;
+  static constexpr size_t DEFAULT_COMPRESSION_TRAINING_STRINGS = 65536;
+  static constexpr size_t DEFAULT_TRANSLATION_CACHE_BUDGET = 64 << 20;
+  static constexpr size_t DEFAULT_PATTERN_CACHE_BUDGET = 64 << 20;
 
  private:
   struct StringIdxEntry {
@@ -128,6 +171,8 @@ class StringDictionary {
     bool canary;
   };
 
+  using TranslationCacheEntry = TranslationMapCache::Entry;
+
   bool fillRateIsHigh(const size_t num_strings) const noexcept;
   void increaseHashTableCapacity() noexcept;
   template <class String>
@@ -144,7 +189,9 @@ class StringDictionary {
   int32_t getUnlocked(const std::string_view sv) const noexcept;
   std::string getStringUnlocked(int32_t string_id) const noexcept;
   std::string getStringChecked(const int string_id) const noexcept;
-  std::pair<char*, size_t> getStringBytesChecked(const int string_id) const noexcept;
+  std::pair<char*, size_t> getStringBytesChecked(
+      const int string_id,
+      std::string& decode_buffer) const noexcept;
   template <class String>
   uint32_t computeBucket(
       const string_dict_hash_t hash,
@@ -170,14 +217,39 @@ class StringDictionary {
   void appendToStorageBulk(const std::vector<String>& input_strings,
                            const std::vector<size_t>& string_memory_ids,
                            const size_t sum_new_strings_lengths) noexcept;
-  PayloadString getStringFromStorage(const int string_id) const noexcept;
-  std::string_view getStringFromStorageFast(const int string_id) const noexcept;
+  // For compressed payload, strings are decoded into decode_buffer and the
+  // result points into it.
+  PayloadString getStringFromStorage(const int string_id,
+                                     std::string& decode_buffer) const noexcept;
+  std::string_view getStringFromStorageFast(const int string_id,
+                                            std::string& decode_buffer) const noexcept;
+  // Raw (possibly encoded) payload bytes of the string.
+  std::string_view getEncodedStringFromStorage(const int string_id) const noexcept;
+  template <class String>
+  std::string_view encodePayload(const String& str,
+                                 std::string& encode_buffer) const noexcept;
+  void maybeCompressPayload() noexcept;
+  void compressPayload() noexcept;
   void addPayloadCapacity(const size_t min_capacity_requested = 0) noexcept;
   void addOffsetCapacity(const size_t min_capacity_requested = 0) noexcept;
   void* addMemoryCapacity(void* addr,
                           size_t& mem_size,
                           const size_t min_capacity_requested = 0) noexcept;
   void invalidateInvertedIndex() noexcept;
+  template <class Predicate>
+  std::vector<int32_t> getMatchingIds(const size_t begin,
+                                      const size_t end,
+                                      const Predicate& is_match) const;
+  std::optional<size_t> buildDictionaryTranslationMapFromCache(
+      const StringDictionary* dest_dict,
+      int32_t* translated_ids,
+      const int64_t num_source_strings,
+      const int64_t num_dest_strings,
+      const bool dest_has_transients,
+      StringLookupCallback const& dest_transient_lookup_callback) const;
+  void extendTranslationCacheEntry(TranslationCacheEntry& entry,
+                                   const StringDictionary* dest_dict,
+                                   const size_t num_source_strings) const;
   std::vector<int32_t> getEquals(std::string pattern,
                                  std::string comp_operator,
                                  size_t generation);
@@ -186,6 +258,9 @@ class StringDictionary {
   void mergeSortedCache(std::vector<int32_t>& temp_sorted_cache);
 
   const DictRef dict_ref_;
+  // Unique across all dictionaries created in the process, used to key translation
+  // caches of other dictionaries.
+  const uint64_t instance_id_;
   size_t str_count_;
   size_t collisions_;
   std::vector<int32_t> string_id_string_dict_hash_table_;
@@ -198,13 +273,20 @@ class StringDictionary {
   size_t payload_file_size_;
   size_t payload_file_off_;
   mutable mapd_shared_mutex rw_mutex_;
-  mutable std::map<std::tuple<std::string, bool, bool, char>, std::vector<int32_t>>
-      like_cache_;
-  mutable std::map<std::pair<std::string, char>, std::vector<int32_t>> regex_cache_;
+  mutable PatternMatchCache<std::tuple<std::string, bool, bool, char>> like_cache_;
+  mutable PatternMatchCache<std::pair<std::string, char>> regex_cache_;
   mutable std::map<std::string, int32_t> equal_cache_;
   mutable DictionaryCache<std::string, compare_cache_value_t> compare_cache_;
   mutable std::shared_ptr<std::vector<std::string>> strings_cache_;
 
+  size_t compression_training_strings_{0};
+  std::unique_ptr<PayloadSymbolTable> symbol_table_;
+  mutable std::mutex translation_cache_mutex_;
+  mutable TranslationMapCache translation_cache_;
+  // Expires when the dictionary is destroyed, which lets translation caches of other
+  // dictionaries drop their maps to this one.
+  const std::shared_ptr<const char> lifetime_token_{std::make_shared<char>()};
+
   char* CANARY_BUFFER{nullptr};
   size_t canary_buffer_size = 0;
 };
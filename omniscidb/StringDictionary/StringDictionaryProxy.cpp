@@ -459,7 +459,12 @@ int32_t StringDictionaryProxy::getOrAdd(const std::string& str) noexcept {
 std::pair<const char*, size_t> StringDictionaryProxy::getStringBytes(
     int32_t string_id) const noexcept {
   if (string_id >= 0) {
-    return string_dict_.get()->getStringBytes(string_id);
+    std::string decode_buffer;
+    const auto bytes = string_dict_.get()->getStringBytes(string_id, decode_buffer);
+    if (bytes.first != decode_buffer.data()) {
+      return bytes;
+    }
+    return getDecodedStringBytes(string_id, std::move(decode_buffer));
   }
   unsigned const string_index = transientIdToIndex(string_id);
   CHECK_LT(string_index, transient_string_vec_.size());
@@ -467,6 +472,15 @@ std::pair<const char*, size_t> StringDictionaryProxy::getStringBytes(
   return {str_ptr->c_str(), str_ptr->size()};
 }
 
+std::pair<const char*, size_t> StringDictionaryProxy::getDecodedStringBytes(
+    int32_t string_id,
+    std::string&& decoded) const {
+  auto& shard = decoded_strings_[string_id % kDecodedStringsShards];
+  std::lock_guard<std::mutex> shard_lock(shard.mutex);
+  const auto& str = shard.strings.emplace(string_id, std::move(decoded)).first->second;
+  return {str.data(), str.size()};
+}
+
 size_t StringDictionaryProxy::storageEntryCount() const {
   const size_t num_storage_entries{generation_ == -1 ? string_dict_->storageEntryCount()
                                                      : generation_};
@@ -21,13 +21,16 @@
 #include "Shared/funcannotations.h"
 #include "StringDictionary.h"
 
+#include <array>
 #include <map>
+#include <mutex>
 #include <optional>
 #include <ostream>
 #include <shared_mutex>
 #include <string>
 #include <string_view>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 #ifndef STRINGDICTIONARY_EXPORT
@@ -243,6 +246,8 @@ class StringDictionaryProxy {
 
   IdMap buildIntersectionTranslationMapToOtherProxyUnlocked(
       const StringDictionaryProxy* dest_proxy) const;
+  std::pair<const char*, size_t> getDecodedStringBytes(int32_t string_id,
+                                                       std::string&& decoded) const;
   std::shared_ptr<StringDictionary> string_dict_;
   const int32_t string_dict_id_;
   TransientMap transient_str_to_int_;
@@ -251,6 +256,17 @@ class StringDictionaryProxy {
   int64_t generation_;
   mutable std::shared_mutex rw_mutex_;
 
+  // Strings of a compressed dictionary decoded by getStringBytes(). The returned
+  // pointers can end up in query results, so decoded strings live as long as the
+  // proxy, i.e. as long as the query results. Sharded by string id to reduce
+  // contention between kernel threads.
+  struct DecodedStringsShard {
+    std::mutex mutex;
+    std::unordered_map<int32_t, std::string> strings;
+  };
+  static constexpr size_t kDecodedStringsShards = 16;
+  mutable std::array<DecodedStringsShard, kDecodedStringsShards> decoded_strings_;
+
   // Return INVALID_STR_ID if not found on string_dict_. Don't lock or check transients.
   template <typename String>
   int32_t getIdOfStringFromClient(String const&) const;
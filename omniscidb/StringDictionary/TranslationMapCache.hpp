@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * LRU cache of translation maps from a dictionary to other dictionaries, bounded by the
+ * memory held by translated ids. Entries are keyed by the destination dictionary and
+ * hold a weak reference to it, entries of destroyed destinations are dropped on the
+ * next access to the cache.
+ */
+class TranslationMapCache {
+ public:
+  // Translation of the first num_source_strings ids of the source dictionary to the ids
+  // of a destination dictionary holding num_dest_strings strings. Both dictionaries are
+  // append-only, so translated ids never change and the entry only grows.
+  struct Entry {
+    size_t num_source_strings{0};
+    size_t num_dest_strings{0};
+    std::vector<int32_t> translated_ids;
+  };
+
+  TranslationMapCache(const size_t max_bytes) : max_bytes_(max_bytes) {}
+
+  // Whether an entry translating num_source_strings strings fits into the budget.
+  bool fits(const size_t num_source_strings) const {
+    return entryBytes(num_source_strings) <= max_bytes_;
+  }
+
+  // Returns the entry for the destination, an empty one is created on a miss. The entry
+  // stays valid until the next call of any other method.
+  Entry& get(const uint64_t dest_id, const std::weak_ptr<const void>& dest_alive) {
+    evictExpired();
+    auto map_it = items_map_.find(dest_id);
+    if (map_it == items_map_.end()) {
+      items_list_.push_front(Item{dest_id, dest_alive, Entry{}, entryBytes(0)});
+      map_it = items_map_.emplace(dest_id, items_list_.begin()).first;
+      total_bytes_ += items_list_.front().bytes;
+    } else {
+      items_list_.splice(items_list_.begin(), items_list_, map_it->second);
+    }
+    return map_it->second->entry;
+  }
+
+  // Accounts the memory of the most recently accessed entry after it was extended and
+  // evicts least recently used entries exceeding the budget.
+  void update() {
+    if (items_list_.empty()) {
+      return;
+    }
+    auto& front = items_list_.front();
+    total_bytes_ -= front.bytes;
+    front.bytes = entryBytes(front.entry.translated_ids.capacity());
+    total_bytes_ += front.bytes;
+    evict();
+  }
+
+  void setMaxBytes(const size_t max_bytes) {
+    max_bytes_ = max_bytes;
+    evictExpired();
+    evict();
+  }
+
+  void clear() {
+    items_map_.clear();
+    items_list_.clear();
+    total_bytes_ = 0;
+  }
+
+  size_t size() const { return items_list_.size(); }
+
+  size_t bytes() const { return total_bytes_; }
+
+ private:
+  struct Item {
+    uint64_t dest_id;
+    std::weak_ptr<const void> dest_alive;
+    Entry entry;
+    size_t bytes;
+  };
+  using cache_list_t = std::list<Item>;
+
+  static size_t entryBytes(const size_t num_ids) {
+    return sizeof(Item) + num_ids * sizeof(int32_t);
+  }
+
+  void erase(cache_list_t::iterator it) {
+    total_bytes_ -= it->bytes;
+    items_map_.erase(it->dest_id);
+    items_list_.erase(it);
+  }
+
+  void evictExpired() {
+    for (auto it = items_list_.begin(); it != items_list_.end();) {
+      auto next = std::next(it);
+      if (it->dest_alive.expired()) {
+        erase(it);
+      }
+      it = next;
+    }
+  }
+
+  void evict() {
+    while (total_bytes_ > max_bytes_ && !items_list_.empty()) {
+      erase(std::prev(items_list_.end()));
+    }
+  }
+
+  size_t max_bytes_;
+  size_t total_bytes_{0};
+  cache_list_t items_list_;
+  std::unordered_map<uint64_t, cache_list_t::iterator> items_map_;
+};
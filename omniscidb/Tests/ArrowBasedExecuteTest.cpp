@@ -7255,6 +7255,57 @@ TEST_F(Select, ReturnNullFromModByZero) {
   }
 }
 
+TEST_F(Select, BatchCodegen) {
+  const auto old_enable_batch_codegen = config().exec.codegen.enable_batch_codegen;
+  const auto old_batch_codegen_size = config().exec.codegen.batch_codegen_size;
+  ScopeGuard sg = [old_enable_batch_codegen, old_batch_codegen_size] {
+    config().exec.codegen.enable_batch_codegen = old_enable_batch_codegen;
+    config().exec.codegen.batch_codegen_size = old_batch_codegen_size;
+  };
+  const auto dt = ExecutorDeviceType::CPU;
+  // Zero disables batching. Kernels are compiled for each setting, including the
+  // same queries with and without batching.
+  for (size_t batch_size : {0, 1, 3, 1024, 0}) {
+    config().exec.codegen.enable_batch_codegen = batch_size != 0;
+    if (batch_size) {
+      config().exec.codegen.batch_codegen_size = batch_size;
+    }
+    c("SELECT COUNT(*) FROM test WHERE x > 7;", dt);
+    c("SELECT COUNT(*) FROM test WHERE x < 7;", dt);
+    c("SELECT SUM(y), MIN(t), MAX(d) FROM test WHERE x = 7 AND z < 102;", dt);
+    c("SELECT x, y, z FROM test WHERE z > 100 ORDER BY x, y, z;", dt);
+    c("SELECT z, COUNT(*) FROM test WHERE x <> 8 GROUP BY z ORDER BY z;", dt);
+    c("SELECT COUNT(*) FROM test WHERE x = 7 AND (y = 43 OR t < 1002);", dt);
+    // Nulls in filters and targets.
+    c("SELECT COUNT(*) FROM test WHERE fn IS NULL;", dt);
+    c("SELECT COUNT(*) FROM test WHERE fn < 0;", dt);
+    c("SELECT SUM(fn), COUNT(dn) FROM test WHERE y > 42;", dt);
+    c("SELECT COUNT(*) FROM test WHERE ofd > 0 OR ofq < 0;", dt);
+    c("SELECT smallint_nulls, COUNT(*) FROM test WHERE smallint_nulls IS NOT NULL GROUP "
+      "BY smallint_nulls ORDER BY smallint_nulls;",
+      dt);
+    // Errors in filters.
+    EXPECT_THROW(run_simple_agg("SELECT COUNT(*) FROM test WHERE y / (x - x) = 0;", dt),
+                 std::runtime_error);
+    ASSERT_EQ(static_cast<int64_t>(2 * g_num_rows),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM test WHERE x = x OR  y / (x - x) = y;", dt)));
+    EXPECT_THROW(
+        run_multiple_agg("SELECT COUNT(*) FROM test WHERE x + 2147483640 > 0;", dt),
+        std::runtime_error);
+    EXPECT_THROW(run_multiple_agg("SELECT COUNT(*) FROM test WHERE ofd * 2 > 0;", dt),
+                 std::runtime_error);
+    EXPECT_THROW(run_multiple_agg("SELECT COUNT(*) FROM test WHERE ofq + 1 > 0;", dt),
+                 std::runtime_error);
+    // Errors in targets of selected rows only.
+    EXPECT_THROW(run_multiple_agg("SELECT y / (x - x) FROM test WHERE x > 7;", dt),
+                 std::runtime_error);
+    EXPECT_THROW(run_multiple_agg(
+                     "SELECT CAST(x * 10000 AS SMALLINT) FROM test WHERE x > 7;", dt),
+                 std::runtime_error);
+  }
+}
+
 TEST_F(Select, ReturnInfFromDivByZero) {
   config().exec.codegen.inf_div_by_zero = true;
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
@@ -17,6 +17,8 @@
 #include "DataMgr/DataMgrBufferProvider.h"
 #include "DataMgr/DataMgrDataProvider.h"
 #include "QueryEngine/ArrowResultSet.h"
+#include "QueryEngine/RelAlgDagBuilder.h"
+#include "QueryEngine/RelAlgDagCache.h"
 #include "QueryEngine/RelAlgExecutor.h"
 
 #include "ArrowSQLRunner/ArrowSQLRunner.h"
@@ -26,6 +28,8 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+
 using namespace std::string_literals;
 using ArrowTestHelpers::compare_res_data;
 using namespace TestHelpers::ArrowSQLRunner;
@@ -257,6 +261,132 @@ TEST_F(ArrowStorageTaxiTest, TaxiQuery4) {
   }
 }
 
+class RelAlgDagCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    createTable("dag_cache_test", {{"a", ctx().int32()}, {"b", ctx().fp64()}}, {2});
+    insertCsvValues("dag_cache_test", "1,1.0\n2,3.0");
+  }
+
+  void TearDown() override { dropTable("dag_cache_test"); }
+
+  std::unique_ptr<hdk::ir::QueryDag> get(RelAlgDagCache& cache, const std::string& ra) {
+    return cache.get(ra, TEST_DB_ID, *getSchemaProvider(), configPtr());
+  }
+
+  std::unique_ptr<hdk::ir::QueryDag> build(const std::string& ra) {
+    return std::make_unique<RelAlgDagBuilder>(
+        ra, TEST_DB_ID, getSchemaProvider(), configPtr());
+  }
+
+  // Executes the DAG and returns it for the next run.
+  std::unique_ptr<hdk::ir::QueryDag> execute(std::unique_ptr<hdk::ir::QueryDag> dag,
+                                             double expected) {
+    RelAlgExecutor ra_executor(getExecutor(), getSchemaProvider(), std::move(dag));
+    auto res = ra_executor.executeRelAlgQuery(
+        CompilationOptions::defaults(ExecutorDeviceType::CPU),
+        ExecutionOptions::fromConfig(config()),
+        false);
+    compare_res_data(res, std::vector<double>({expected}));
+    return ra_executor.releaseQueryDag();
+  }
+};
+
+TEST_F(RelAlgDagCacheTest, Hit) {
+  RelAlgDagCache cache(4);
+  auto ra = getSqlQueryRelAlg("SELECT SUM(b) FROM dag_cache_test;");
+  ASSERT_FALSE(get(cache, ra));
+
+  auto dag = execute(build(ra), 4.0);
+  auto root = dag->getRootNode();
+  cache.put(ra, TEST_DB_ID, std::move(dag));
+  ASSERT_EQ(cache.size(), (size_t)1);
+
+  dag = get(cache, ra);
+  ASSERT_TRUE(dag);
+  ASSERT_EQ(dag->getRootNode(), root);
+  // The DAG is checked out until it is put back.
+  ASSERT_FALSE(get(cache, ra));
+  cache.put(ra, TEST_DB_ID, execute(std::move(dag), 4.0));
+  ASSERT_TRUE(get(cache, ra));
+}
+
+TEST_F(RelAlgDagCacheTest, RepeatedCanonization) {
+  // STDDEV_SAMP is expanded into several aggregates by canonizeQuery, which must
+  // not be repeated for a cached DAG.
+  RelAlgDagCache cache(4);
+  auto ra = getSqlQueryRelAlg("SELECT STDDEV_SAMP(b) FROM dag_cache_test;");
+  const double expected = std::sqrt(2.0);
+  auto dag = execute(build(ra), expected);
+  const size_t node_count = dag->getNodes().size();
+  ASSERT_TRUE(dag->isCanonized());
+  for (int i = 0; i < 3; ++i) {
+    cache.put(ra, TEST_DB_ID, std::move(dag));
+    dag = get(cache, ra);
+    ASSERT_TRUE(dag);
+    dag = execute(std::move(dag), expected);
+    ASSERT_EQ(dag->getNodes().size(), node_count);
+  }
+}
+
+TEST_F(RelAlgDagCacheTest, InvalidateOnAppend) {
+  RelAlgDagCache cache(4);
+  auto ra = getSqlQueryRelAlg("SELECT SUM(b) FROM dag_cache_test;");
+  cache.put(ra, TEST_DB_ID, execute(build(ra), 4.0));
+
+  auto tinfo = getStorage()->getTableInfo(TEST_DB_ID, "dag_cache_test");
+  insertCsvValues("dag_cache_test", "3,5.0\n4,7.0\n5,9.0");
+  auto new_tinfo = getStorage()->getTableInfo(TEST_DB_ID, "dag_cache_test");
+  ASSERT_NE(tinfo, new_tinfo);
+  ASSERT_EQ(tinfo->fragments, (size_t)1);
+  ASSERT_EQ(new_tinfo->fragments, (size_t)3);
+  ASSERT_EQ(new_tinfo->row_count, (size_t)5);
+
+  ASSERT_FALSE(get(cache, ra));
+  cache.put(ra, TEST_DB_ID, execute(build(ra), 25.0));
+  auto dag = get(cache, ra);
+  ASSERT_TRUE(dag);
+  execute(std::move(dag), 25.0);
+}
+
+TEST_F(RelAlgDagCacheTest, InvalidateOnDrop) {
+  RelAlgDagCache cache(4);
+  auto ra = getSqlQueryRelAlg("SELECT SUM(b) FROM dag_cache_test;");
+  cache.put(ra, TEST_DB_ID, execute(build(ra), 4.0));
+
+  dropTable("dag_cache_test");
+  ASSERT_FALSE(get(cache, ra));
+
+  // Re-create the table with the same name and schema.
+  createTable("dag_cache_test", {{"a", ctx().int32()}, {"b", ctx().fp64()}}, {2});
+  insertCsvValues("dag_cache_test", "1,10.0");
+  ASSERT_FALSE(get(cache, ra));
+  cache.put(ra, TEST_DB_ID, execute(build(ra), 10.0));
+  ASSERT_TRUE(get(cache, ra));
+}
+
+TEST_F(RelAlgDagCacheTest, Size) {
+  RelAlgDagCache cache(2);
+  std::vector<std::string> ras;
+  for (int i = 1; i <= 3; ++i) {
+    ras.push_back(getSqlQueryRelAlg("SELECT SUM(b) FROM dag_cache_test WHERE a < " +
+                                    std::to_string(i) + ";"));
+    cache.put(ras.back(), TEST_DB_ID, build(ras.back()));
+  }
+  ASSERT_EQ(cache.size(), (size_t)2);
+  // The least recently used entry is evicted.
+  ASSERT_FALSE(get(cache, ras[0]));
+  ASSERT_TRUE(get(cache, ras[2]));
+
+  cache.clear();
+  ASSERT_EQ(cache.size(), (size_t)0);
+
+  RelAlgDagCache disabled_cache(0);
+  disabled_cache.put(ras[0], TEST_DB_ID, build(ras[0]));
+  ASSERT_EQ(disabled_cache.size(), (size_t)0);
+  ASSERT_FALSE(get(disabled_cache, ras[0]));
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
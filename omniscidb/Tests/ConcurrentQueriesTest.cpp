@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ArrowSQLRunner/ArrowSQLRunner.h"
+
+#include "ArrowTestHelpers.h"
+#include "TestHelpers.h"
+
+#include "QueryEngine/RelAlgExecutor.h"
+#include "Shared/scope.h"
+
+#include <chrono>
+#include <future>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using ArrowTestHelpers::compare_res_data;
+using namespace TestHelpers::ArrowSQLRunner;
+
+namespace {
+
+constexpr size_t kFragmentSize = 5;
+constexpr int64_t kRows = 100;
+
+const char* kRTUdfIR = R"(
+define i32 @concurrent_queries_test_udf(i32 %x) {
+entry:
+  ret i32 %x
+}
+)";
+
+void checkQueryResult(RelAlgExecutor& ra_executor) {
+  auto res = ra_executor.executeRelAlgQuery(
+      CompilationOptions::defaults(ExecutorDeviceType::CPU),
+      ExecutionOptions::fromConfig(config()),
+      false);
+  compare_res_data(res,
+                   std::vector<int64_t>({kRows}),
+                   std::vector<int64_t>({10 * kRows * (kRows + 1) / 2}));
+}
+
+}  // namespace
+
+class ConcurrentQueriesTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    createTable("concurrent_test",
+                {{"a", ctx().int32()}, {"b", ctx().int64()}},
+                {kFragmentSize});
+    std::string csv;
+    for (int64_t i = 1; i <= kRows; ++i) {
+      csv += std::to_string(i) + "," + std::to_string(i * 10) + "\n";
+    }
+    insertCsvValues("concurrent_test", csv);
+  }
+
+  static void TearDownTestSuite() { dropTable("concurrent_test"); }
+
+  void SetUp() override {
+    prev_concurrent_queries_ = config().exec.enable_concurrent_queries;
+  }
+
+  void TearDown() override {
+    config().exec.enable_concurrent_queries = prev_concurrent_queries_;
+  }
+
+  bool prev_concurrent_queries_;
+};
+
+TEST_F(ConcurrentQueriesTest, SharedExecutorWithoutConcurrentQueries) {
+  config().exec.enable_concurrent_queries = false;
+  auto executor = getExecutor();
+  // Queries share the executor and don't wait for each other.
+  auto first = executor->acquireQueryExecutor();
+  auto second = executor->acquireQueryExecutor();
+  EXPECT_EQ(first.get(), executor);
+  EXPECT_EQ(second.get(), executor);
+}
+
+TEST_F(ConcurrentQueriesTest, SiblingExecutors) {
+  config().exec.enable_concurrent_queries = true;
+  auto executor = getExecutor();
+  auto first = executor->acquireQueryExecutor();
+  EXPECT_EQ(first.get(), executor);
+
+  auto second = executor->acquireQueryExecutor();
+  auto sibling = second.get();
+  EXPECT_NE(sibling, executor);
+
+  auto third = executor->acquireQueryExecutor();
+  EXPECT_NE(third.get(), executor);
+  EXPECT_NE(third.get(), sibling);
+
+  // Released executors are reused.
+  second.reset();
+  second = executor->acquireQueryExecutor();
+  EXPECT_EQ(second.get(), sibling);
+  first.reset();
+  first = executor->acquireQueryExecutor();
+  EXPECT_EQ(first.get(), executor);
+}
+
+TEST_F(ConcurrentQueriesTest, RunTimeUdfWaitsForExecutor) {
+  config().exec.enable_concurrent_queries = true;
+  auto executor = getExecutor();
+  Executor::extension_module_sources[ExtModuleKinds::rt_udf_cpu_module] = kRTUdfIR;
+  executor->update_extension_modules(/*update_runtime_modules_only=*/true);
+  ScopeGuard remove_rt_udf = [executor] {
+    Executor::extension_module_sources.erase(ExtModuleKinds::rt_udf_cpu_module);
+    executor->update_extension_modules(/*update_runtime_modules_only=*/true);
+  };
+  ASSERT_TRUE(executor->has_rt_udf_module());
+
+  // Run-time UDFs are available in the original executor only, so a query can't
+  // move to a sibling executor and waits for the running one.
+  auto first = executor->acquireQueryExecutor();
+  EXPECT_EQ(first.get(), executor);
+  auto second = std::async(std::launch::async,
+                           [executor] { return executor->acquireQueryExecutor(); });
+  EXPECT_EQ(second.wait_for(std::chrono::milliseconds(200)),
+            std::future_status::timeout);
+  first.reset();
+  EXPECT_EQ(second.get().get(), executor);
+}
+
+TEST_F(ConcurrentQueriesTest, ConcurrentQueries) {
+  config().exec.enable_concurrent_queries = true;
+  constexpr size_t kThreads = 4;
+  constexpr size_t kQueriesPerThread = 5;
+  // Calcite is used on the main thread only.
+  std::vector<std::vector<std::unique_ptr<RelAlgExecutor>>> ra_executors(kThreads);
+  for (auto& thread_executors : ra_executors) {
+    for (size_t i = 0; i < kQueriesPerThread; ++i) {
+      thread_executors.push_back(
+          makeRelAlgExecutor("SELECT COUNT(*), SUM(b) FROM concurrent_test;"));
+    }
+  }
+
+  std::vector<std::thread> threads;
+  std::vector<std::exception_ptr> errors(kThreads);
+  for (size_t thread_idx = 0; thread_idx < kThreads; ++thread_idx) {
+    threads.emplace_back([&, thread_idx] {
+      try {
+        for (auto& ra_executor : ra_executors[thread_idx]) {
+          checkQueryResult(*ra_executor);
+        }
+      } catch (...) {
+        errors[thread_idx] = std::current_exception();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  // Queries can run on the original executor after concurrent ones.
+  auto ra_executor = makeRelAlgExecutor("SELECT COUNT(*), SUM(b) FROM concurrent_test;");
+  checkQueryResult(*ra_executor);
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  init();
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+    err = EINVAL;
+  }
+
+  reset();
+  return err;
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ArrowSQLRunner/ArrowSQLRunner.h"
+
+#include "ArrowTestHelpers.h"
+#include "TestHelpers.h"
+
+#include "QueryEngine/ExecutionKernel.h"
+#include "QueryEngine/QueryProgress.h"
+#include "QueryEngine/RelAlgExecutor.h"
+
+#include <gtest/gtest.h>
+
+using ArrowTestHelpers::compareArrowTables;
+using ArrowTestHelpers::toArrow;
+using namespace TestHelpers::ArrowSQLRunner;
+
+// Compares results of queries which split fragments into CPU sub-tasks with the ones
+// of queries running a kernel per fragment.
+
+namespace {
+
+constexpr size_t kFragmentSize = 100;
+constexpr int64_t kRows = 250;
+
+ExecutionResult runSqlQuery(const std::string& sql) {
+  return TestHelpers::ArrowSQLRunner::runSqlQuery(
+      sql, ExecutorDeviceType::CPU, /*allow_loop_joins=*/false);
+}
+
+void checkQuery(const std::string& sql) {
+  SCOPED_TRACE(sql);
+  config().exec.sub_tasks.enable = false;
+  auto expected = runSqlQuery(sql);
+  config().exec.sub_tasks.enable = true;
+  auto actual = runSqlQuery(sql);
+  compareArrowTables(toArrow(expected), toArrow(actual));
+}
+
+void checkQueries() {
+  // Non-grouped aggregates produce a result per sub-task.
+  checkQuery("SELECT COUNT(*), SUM(b), MIN(a), MAX(b), AVG(a) FROM subtask_test;");
+  checkQuery("SELECT COUNT(*), SUM(a) FROM subtask_test WHERE b % 3 = 1;");
+  checkQuery("SELECT COUNT(*), MAX(a) FROM subtask_test WHERE a > 1000;");
+  // Group by queries accumulate sub-task results in thread-local contexts.
+  checkQuery(
+      "SELECT a % 7 AS k, COUNT(*), SUM(b) FROM subtask_test GROUP BY k ORDER BY k;");
+  checkQuery(
+      "SELECT a % 3 AS k, MIN(b), MAX(b) FROM subtask_test WHERE a > 42 GROUP BY k "
+      "ORDER BY k;");
+}
+
+}  // namespace
+
+class CpuSubTasksTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    createTable(
+        "subtask_test", {{"a", ctx().int32()}, {"b", ctx().int64()}}, {kFragmentSize});
+    std::string csv;
+    for (int64_t i = 1; i <= kRows; ++i) {
+      csv += std::to_string(i) + "," + std::to_string(i * 10) + "\n";
+    }
+    insertCsvValues("subtask_test", csv);
+  }
+
+  static void TearDownTestSuite() { dropTable("subtask_test"); }
+
+  void SetUp() override { prev_sub_tasks_config_ = config().exec.sub_tasks; }
+
+  void TearDown() override { config().exec.sub_tasks = prev_sub_tasks_config_; }
+
+  CpuSubTasksConfig prev_sub_tasks_config_;
+};
+
+#ifdef HAVE_TBB
+TEST_F(CpuSubTasksTest, SubtaskSize) {
+  std::vector<InputTableInfo> query_infos;
+  SharedKernelContext shared_context(query_infos);
+  // Without measurements or a target time, the default size is used.
+  EXPECT_EQ(shared_context.getSubtaskSize(5'000, 0), (size_t)5'000);
+  EXPECT_EQ(shared_context.getSubtaskSize(5'000, 100), (size_t)5'000);
+
+  // 10 rows per microsecond.
+  shared_context.addSubtaskStats(20'000, 1'000);
+  shared_context.addSubtaskStats(10'000, 2'000);
+  EXPECT_EQ(shared_context.getSubtaskSize(5'000, 0), (size_t)5'000);
+  EXPECT_EQ(shared_context.getSubtaskSize(5'000, 1'000), (size_t)10'000);
+  EXPECT_EQ(shared_context.getSubtaskSize(5'000, 300), (size_t)3'000);
+  // Too small sub-tasks are avoided.
+  EXPECT_EQ(shared_context.getSubtaskSize(5'000, 1), (size_t)1'024);
+}
+#endif  // HAVE_TBB
+
+TEST_F(CpuSubTasksTest, FixedSize) {
+  // Sizes dividing fragments evenly and not, and a size exceeding the fragment.
+  for (size_t sub_task_size : {1, 7, 50, 1'000}) {
+    SCOPED_TRACE(sub_task_size);
+    config().exec.sub_tasks.sub_task_size = sub_task_size;
+    config().exec.sub_tasks.sub_task_target_time_us = 0;
+    checkQueries();
+  }
+}
+
+TEST_F(CpuSubTasksTest, AdaptiveSize) {
+  config().exec.sub_tasks.sub_task_size = 3;
+  for (size_t target_time_us : {1, 1'000'000}) {
+    SCOPED_TRACE(target_time_us);
+    config().exec.sub_tasks.sub_task_target_time_us = target_time_us;
+    checkQueries();
+  }
+}
+
+TEST_F(CpuSubTasksTest, Progress) {
+  config().exec.sub_tasks.enable = true;
+  config().exec.sub_tasks.sub_task_size = 9;
+  for (const std::string sql :
+       {"SELECT COUNT(*), SUM(b) FROM subtask_test;",
+        "SELECT a % 5 AS k, COUNT(*) FROM subtask_test GROUP BY k ORDER BY k;"}) {
+    SCOPED_TRACE(sql);
+    auto progress = std::make_shared<hdk::QueryProgress>();
+    auto ra_executor = makeRelAlgExecutor(sql);
+    ra_executor->setQueryProgress(progress);
+    ra_executor->executeRelAlgQuery(
+        CompilationOptions::defaults(ExecutorDeviceType::CPU),
+        ExecutionOptions::fromConfig(config()),
+        false);
+    // Fragments are reported as processed once, after all their sub-tasks complete.
+    EXPECT_GE(progress->totalFragments(), (size_t)3);
+    EXPECT_EQ(progress->completedFragments(), progress->totalFragments());
+  }
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  init();
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+    err = EINVAL;
+  }
+
+  reset();
+  return err;
+}
@@ -825,6 +825,141 @@ TEST_F(ExecutionSequenceTest, JoinOfJoins) {
       res, std::vector<int32_t>({11, 22, 33}), std::vector<int64_t>({1, 2, 3}));
 }
 
+TEST_F(ExecutionSequenceTest, ParallelStepsSharedInputs) {
+  // Two independent aggregates, each consumed by two independent joins.
+  auto build_dag = [] {
+    auto dag = std::make_unique<TestRelAlgDagBuilder>(getStorage(), configPtr());
+    auto scan1 = dag->addScan(TEST_DB_ID, "test2");
+    auto agg1 = dag->addAgg(scan1, 1, {{AggType::kSum, ctx().int32(), 2}});
+    auto scan2 = dag->addScan(TEST_DB_ID, "test2");
+    auto agg2 = dag->addAgg(scan2, 1, {{AggType::kSum, ctx().int32(), 3}});
+    auto join1 = dag->addEquiJoin(agg1, agg2, JoinType::INNER, 0, 0);
+    auto proj1 = dag->addProject(join1, std::vector<int>{0, 1, 3});
+    auto join2 = dag->addEquiJoin(agg2, agg1, JoinType::INNER, 0, 0);
+    auto proj2 = dag->addProject(join2, std::vector<int>{0, 1, 3});
+    auto logical_union = std::make_shared<LogicalUnion>(NodeInputs{proj1, proj2}, true);
+    dag->addNode(logical_union);
+    dag->addSort(
+        logical_union,
+        {{0, hdk::ir::SortDirection::Ascending, hdk::ir::NullSortedPosition::Last},
+         {1, hdk::ir::SortDirection::Ascending, hdk::ir::NullSortedPosition::Last}});
+    dag->finalize();
+    return dag;
+  };
+
+  {
+    auto dag = build_dag();
+    QueryExecutionSequence seq(dag->getRootNode(), configPtr());
+    size_t independent_steps = 0;
+    for (size_t i = 0; i < seq.size(); ++i) {
+      independent_steps += seq.dependencies(i).empty() ? 1 : 0;
+    }
+    CHECK_GE(independent_steps, (size_t)2);
+  }
+
+  auto orig_parallel_steps = config().exec.parallel_steps;
+  ScopeGuard reset = [orig_parallel_steps] {
+    config().exec.parallel_steps = orig_parallel_steps;
+  };
+  // Results of finished steps are used by concurrent steps and must not be dropped
+  // by step executors, so run the query several times.
+  for (size_t parallel_steps : {0, 1, 2, 4, 4, 4}) {
+    config().exec.parallel_steps = parallel_steps;
+    auto res = runQuery(build_dag());
+    compare_res_data(res,
+                     std::vector<int32_t>({1, 1, 2, 2}),
+                     std::vector<int32_t>({65, 141, 46, 104}),
+                     std::vector<int32_t>({141, 65, 104, 46}));
+  }
+}
+
+namespace {
+
+// Builds a join of two aggregates of the same filtered table, grouped by its first
+// column, so the filter has two users.
+std::unique_ptr<TestRelAlgDagBuilder> buildSharedFilterDag(
+    const std::string& table_name,
+    const std::function<ExprPtr(const Node*)>& make_condition,
+    size_t sum_col1,
+    size_t sum_col2) {
+  auto dag = std::make_unique<TestRelAlgDagBuilder>(getStorage(), configPtr());
+  auto scan = dag->addScan(TEST_DB_ID, table_name);
+  auto filter = dag->addFilter(scan, make_condition(scan.get()));
+  auto agg1 = dag->addAgg(filter, 1, {{AggType::kSum, ctx().int32(), sum_col1}});
+  auto agg2 = dag->addAgg(filter, 1, {{AggType::kSum, ctx().int32(), sum_col2}});
+  auto join = dag->addEquiJoin(agg1, agg2, JoinType::INNER, 0, 0);
+  auto proj = dag->addProject(join, std::vector<int>{0, 1, 3});
+  dag->addSort(
+      proj, {{0, hdk::ir::SortDirection::Ascending, hdk::ir::NullSortedPosition::Last}});
+  dag->finalize();
+  return dag;
+}
+
+size_t getStepCount(const QueryDag& dag, bool fuse_shared_projections) {
+  auto orig_fuse_shared_projections = config().exec.fuse_shared_projections;
+  ScopeGuard reset = [orig_fuse_shared_projections] {
+    config().exec.fuse_shared_projections = orig_fuse_shared_projections;
+  };
+  config().exec.fuse_shared_projections = fuse_shared_projections;
+  return QueryExecutionSequence(dag.getRootNode(), configPtr()).size();
+}
+
+}  // namespace
+
+TEST_F(ExecutionSequenceTest, FuseSharedFilter) {
+  auto make_condition = [](const Node* scan) {
+    return makeExpr<BinOper>(ctx().boolean(),
+                             OpType::kGt,
+                             Qualifier::kOne,
+                             getNodeColumnRef(scan, 2),
+                             Constant::make(ctx().int32(), 11));
+  };
+  {
+    auto dag = buildSharedFilterDag("test2", make_condition, 2, 3);
+    EXPECT_LT(getStepCount(*dag, true), getStepCount(*dag, false));
+  }
+
+  auto orig_fuse_shared_projections = config().exec.fuse_shared_projections;
+  ScopeGuard reset = [orig_fuse_shared_projections] {
+    config().exec.fuse_shared_projections = orig_fuse_shared_projections;
+  };
+  for (bool fuse_shared_projections : {false, true}) {
+    config().exec.fuse_shared_projections = fuse_shared_projections;
+    auto res = runQuery(buildSharedFilterDag("test2", make_condition, 2, 3));
+    compare_res_data(res,
+                     std::vector<int32_t>({1, 2}),
+                     std::vector<int32_t>({44, 46}),
+                     std::vector<int32_t>({74, 76}));
+  }
+}
+
+TEST_F(ExecutionSequenceTest, SharedRegexpFilterNotFused) {
+  auto make_condition = [](const Node* scan) {
+    Datum pattern;
+    pattern.stringval = new std::string("str[12]");
+    return makeExpr<RegexpExpr>(getNodeColumnRef(scan, 1),
+                                makeExpr<Constant>(ctx().text(), false, pattern),
+                                nullptr);
+  };
+  auto dag = buildSharedFilterDag("test_str1", make_condition, 0, 0);
+  EXPECT_EQ(getStepCount(*dag, true), getStepCount(*dag, false));
+}
+
+TEST_F(ExecutionSequenceTest, SharedFunctionFilterNotFused) {
+  // Functions, e.g. UDFs, may be expensive or non-deterministic.
+  auto make_condition = [](const Node* scan) {
+    return makeExpr<BinOper>(
+        ctx().boolean(),
+        OpType::kGt,
+        Qualifier::kOne,
+        makeExpr<FunctionOper>(
+            ctx().int32(), "test_udf", ExprPtrVector{getNodeColumnRef(scan, 2)}),
+        Constant::make(ctx().int32(), 11));
+  };
+  auto dag = buildSharedFilterDag("test2", make_condition, 2, 3);
+  EXPECT_EQ(getStepCount(*dag, true), getStepCount(*dag, false));
+}
+
 int main(int argc, char* argv[]) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ArrowSQLRunner/ArrowSQLRunner.h"
+
+#include "ArrowTestHelpers.h"
+#include "TestHelpers.h"
+
+#include <gtest/gtest.h>
+
+using ArrowTestHelpers::compareArrowTables;
+using ArrowTestHelpers::toArrow;
+using namespace TestHelpers::ArrowSQLRunner;
+
+namespace {
+
+constexpr size_t kFragmentSize = 4;
+
+// Every 7th value of `a` and every 5th value of `b` is null, so some fragments have
+// nulls in a column and others don't.
+std::string makeRows(int64_t first, int64_t last) {
+  std::string csv;
+  for (int64_t i = first; i <= last; ++i) {
+    csv += (i % 7 ? std::to_string(i) : std::string()) + ",";
+    csv += (i % 5 ? std::to_string(i * 10) : std::string()) + "\n";
+  }
+  return csv;
+}
+
+ExecutionResult runSqlQuery(const std::string& sql) {
+  return TestHelpers::ArrowSQLRunner::runSqlQuery(
+      sql, ExecutorDeviceType::CPU, /*allow_loop_joins=*/false);
+}
+
+// Checks that kernels specialized by fragment stats produce the same result as the
+// generic kernel.
+void checkSpecialization(const std::string& sql) {
+  config().exec.codegen.enable_fragment_specialization = false;
+  auto expected = runSqlQuery(sql);
+  config().exec.codegen.enable_fragment_specialization = true;
+  auto actual = runSqlQuery(sql);
+  SCOPED_TRACE(sql);
+  compareArrowTables(toArrow(expected), toArrow(actual));
+}
+
+void checkQueries() {
+  // Fragments where the comparison holds for all rows use kernels without it.
+  checkSpecialization("SELECT COUNT(*), SUM(b) FROM spec_test WHERE a > 4;");
+  checkSpecialization("SELECT COUNT(*), SUM(b) FROM spec_test WHERE a < 13;");
+  checkSpecialization("SELECT COUNT(*), SUM(b) FROM spec_test WHERE a <> 100;");
+  checkSpecialization("SELECT COUNT(*), SUM(b) FROM spec_test WHERE a = 3;");
+  // Fragment min and max values equal to the compared constant.
+  checkSpecialization("SELECT COUNT(*), SUM(b) FROM spec_test WHERE a >= 5;");
+  checkSpecialization("SELECT COUNT(*), SUM(b) FROM spec_test WHERE a > 5;");
+  checkSpecialization("SELECT COUNT(*), SUM(b) FROM spec_test WHERE a <= 8;");
+  checkSpecialization("SELECT COUNT(*), SUM(b) FROM spec_test WHERE a < 8;");
+  checkSpecialization(
+      "SELECT COUNT(*), MIN(b), MAX(b) FROM spec_test WHERE a >= 5 AND a <= 20;");
+  // Fragments without nulls use kernels without null checks.
+  checkSpecialization("SELECT COUNT(*), SUM(a) FROM spec_test WHERE b + 1 > 50;");
+  checkSpecialization(
+      "SELECT COUNT(*), SUM(a) FROM spec_test WHERE b + 1 > 50 AND a > 2;");
+  checkSpecialization("SELECT a, b FROM spec_test WHERE b > 50 ORDER BY a, b;");
+  checkSpecialization("SELECT a, b FROM spec_test WHERE a * 2 > 10 ORDER BY a, b;");
+  checkSpecialization(
+      "SELECT a % 3 AS k, COUNT(*), SUM(b) FROM spec_test WHERE a > 4 AND b < 200 "
+      "GROUP BY k ORDER BY k;");
+}
+
+}  // namespace
+
+class FragmentSpecializationTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    prev_enable_fragment_specialization_ =
+        config().exec.codegen.enable_fragment_specialization;
+    createTable(
+        "spec_test", {{"a", ctx().int32()}, {"b", ctx().int64()}}, {kFragmentSize});
+    insertCsvValues("spec_test", makeRows(1, 24));
+  }
+
+  void TearDown() override {
+    config().exec.codegen.enable_fragment_specialization =
+        prev_enable_fragment_specialization_;
+    dropTable("spec_test");
+  }
+
+  bool prev_enable_fragment_specialization_;
+};
+
+TEST_F(FragmentSpecializationTest, SameResults) {
+  checkQueries();
+}
+
+TEST_F(FragmentSpecializationTest, AppendedData) {
+  checkQueries();
+  // New fragments with other stats, including a partially filled fragment.
+  insertCsvValues("spec_test", makeRows(25, 42));
+  checkQueries();
+  insertCsvValues("spec_test", makeRows(-10, -1));
+  checkQueries();
+}
+
+TEST_F(FragmentSpecializationTest, ReuseCompiledKernels) {
+  auto plan_code_accessor = getExecutor()->getPlanCodeAccessor();
+  ASSERT_TRUE(plan_code_accessor);
+  const std::string sql =
+      "SELECT COUNT(*), SUM(b), MAX(a) FROM spec_test WHERE a > 6 AND b < 1000;";
+  config().exec.codegen.enable_fragment_specialization = true;
+
+  auto put_count = plan_code_accessor->getPutCount();
+  auto expected = runSqlQuery(sql);
+  // The generic kernel and at least one specialization are compiled.
+  EXPECT_GT(plan_code_accessor->getPutCount(), put_count + 1);
+
+  put_count = plan_code_accessor->getPutCount();
+  auto found_count = plan_code_accessor->getFoundCount();
+  auto actual = runSqlQuery(sql);
+  EXPECT_EQ(plan_code_accessor->getPutCount(), put_count);
+  EXPECT_GT(plan_code_accessor->getFoundCount(), found_count + 1);
+  compareArrowTables(toArrow(expected), toArrow(actual));
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  init();
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+    err = EINVAL;
+  }
+
+  reset();
+  return err;
+}
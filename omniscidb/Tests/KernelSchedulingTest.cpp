@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ArrowSQLRunner/ArrowSQLRunner.h"
+
+#include "ArrowTestHelpers.h"
+#include "TestHelpers.h"
+
+#include "Shared/thread_count.h"
+
+#ifdef ENABLE_TBB
+#include <tbb/task_arena.h>
+#endif
+
+#include <gtest/gtest.h>
+
+using ArrowTestHelpers::compare_res_data;
+using namespace TestHelpers::ArrowSQLRunner;
+
+// Kernels are scheduled by Executor::launchKernels. These tests run multi-fragment
+// queries (a kernel per fragment) with a single CPU thread available to make sure
+// the launching thread runs kernels itself rather than waiting for workers. Builds
+// with DISABLE_CONCURRENCY run the same tests with the serial threading backend.
+
+namespace {
+
+constexpr size_t kFragmentSize = 2;
+constexpr int64_t kRows = 20;
+
+ExecutionResult runSqlQuery(const std::string& sql,
+                            QueryPriority priority = QueryPriority::Interactive,
+                            size_t max_threads = 0) {
+  auto eo = ExecutionOptions::fromConfig(config()).with_priority(priority);
+  eo.max_threads = max_threads;
+  return TestHelpers::ArrowSQLRunner::runSqlQuery(
+      sql, CompilationOptions::defaults(ExecutorDeviceType::CPU), eo);
+}
+
+void runQueries(QueryPriority priority, size_t max_threads) {
+  {
+    auto res = runSqlQuery("SELECT COUNT(*), SUM(b) FROM sched_test;",
+                           priority,
+                           max_threads);
+    compare_res_data(res,
+                     std::vector<int64_t>({kRows}),
+                     std::vector<int64_t>({10 * kRows * (kRows + 1) / 2}));
+  }
+  {
+    auto res = runSqlQuery(
+        "SELECT a % 2 AS k, COUNT(*) FROM sched_test GROUP BY k ORDER BY k;",
+        priority,
+        max_threads);
+    compare_res_data(res,
+                     std::vector<int32_t>({0, 1}),
+                     std::vector<int64_t>({kRows / 2, kRows / 2}));
+  }
+  {
+    auto res = runSqlQuery("SELECT a FROM sched_test WHERE a > 17 ORDER BY a;",
+                           priority,
+                           max_threads);
+    compare_res_data(res, std::vector<int32_t>({18, 19, 20}));
+  }
+}
+
+}  // namespace
+
+class KernelSchedulingTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    createTable("sched_test",
+                {{"a", ctx().int32()}, {"b", ctx().int64()}},
+                {kFragmentSize});
+    std::string csv;
+    for (int64_t i = 1; i <= kRows; ++i) {
+      csv += std::to_string(i) + "," + std::to_string(i * 10) + "\n";
+    }
+    insertCsvValues("sched_test", csv);
+  }
+
+  static void TearDownTestSuite() { dropTable("sched_test"); }
+
+  void SetUp() override {
+    prev_threads_override_ = g_cpu_threads_override;
+    g_cpu_threads_override = 1;
+  }
+
+  void TearDown() override { g_cpu_threads_override = prev_threads_override_; }
+
+  unsigned prev_threads_override_;
+};
+
+TEST_F(KernelSchedulingTest, SingleThreadInteractive) {
+  ASSERT_EQ(cpu_threads(), 1);
+  runQueries(QueryPriority::Interactive, 0);
+}
+
+TEST_F(KernelSchedulingTest, SingleThreadBatch) {
+  ASSERT_EQ(cpu_threads(), 1);
+  runQueries(QueryPriority::Batch, 0);
+}
+
+TEST_F(KernelSchedulingTest, SingleThreadMaxThreads) {
+  ASSERT_EQ(cpu_threads(), 1);
+  runQueries(QueryPriority::Interactive, 1);
+  runQueries(QueryPriority::Batch, 1);
+}
+
+TEST_F(KernelSchedulingTest, MaxThreadsBelowThreadCount) {
+  g_cpu_threads_override = 4;
+  runQueries(QueryPriority::Interactive, 1);
+  runQueries(QueryPriority::Batch, 2);
+}
+
+#ifdef ENABLE_TBB
+// Worker tasks can't get a thread in a single-threaded arena, so the query
+// completes only if the launching thread runs the kernels.
+TEST_F(KernelSchedulingTest, SingleThreadArena) {
+  tbb::task_arena arena(1);
+  arena.execute([] {
+    runQueries(QueryPriority::Interactive, 0);
+    runQueries(QueryPriority::Batch, 0);
+  });
+  g_cpu_threads_override = 4;
+  arena.execute([] { runQueries(QueryPriority::Interactive, 0); });
+}
+#endif
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  init();
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+    err = EINVAL;
+  }
+
+  reset();
+  return err;
+}
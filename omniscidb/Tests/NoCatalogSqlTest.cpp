@@ -261,6 +261,95 @@ TEST_F(NoCatalogSqlTest, MultipleCalciteMultipleThreads) {
   }
 }
 
+class ChangedSchemaProvider : public TestSchemaProvider {
+ public:
+  ChangedSchemaProvider() {
+    addColumnInfo(TEST_DB_ID, TEST1_TABLE_ID, 6, "col_new", ctx_.int32(), false);
+  }
+};
+
+TEST_F(NoCatalogSqlTest, RACacheHit) {
+  auto process = [this](const std::string& sql) {
+    return calcite_->process("test_db", sql, schema_provider_.get(), config_.get());
+  };
+  auto query_ra = process("SELECT col_bi, col_i FROM test1 WHERE col_i > 20;");
+  auto hits = calcite_->getCacheHitCount();
+  auto misses = calcite_->getCacheMissCount();
+
+  // Formatting doesn't matter.
+  EXPECT_EQ(process("SELECT col_bi,  col_i\n FROM test1 -- comment\n WHERE col_i > 20;"),
+            query_ra);
+  EXPECT_EQ(calcite_->getCacheHitCount(), hits + 1);
+  EXPECT_EQ(calcite_->getCacheMissCount(), misses);
+  compare_res_data(runRAQuery(query_ra, executor_.get()),
+                   std::vector<int64_t>({3, 4, 5}),
+                   std::vector<int32_t>({30, 40, 50}));
+
+  // Literals and options are a part of the key.
+  EXPECT_NE(process("SELECT col_bi, col_i FROM test1 WHERE col_i > 30;"), query_ra);
+  EXPECT_EQ(calcite_->getCacheMissCount(), misses + 1);
+  calcite_->process("test_db",
+                    "SELECT col_bi, col_i FROM test1 WHERE col_i > 20;",
+                    schema_provider_.get(),
+                    config_.get(),
+                    {},
+                    /*legacy_syntax=*/true);
+  EXPECT_EQ(calcite_->getCacheMissCount(), misses + 2);
+  EXPECT_EQ(calcite_->getCacheHitCount(), hits + 1);
+}
+
+TEST_F(NoCatalogSqlTest, RACacheSchemaChange) {
+  const std::string sql = "SELECT * FROM test1;";
+  auto changed_schema_provider = std::make_shared<ChangedSchemaProvider>();
+  auto query_ra =
+      calcite_->process("test_db", sql, schema_provider_.get(), config_.get());
+  auto misses = calcite_->getCacheMissCount();
+
+  // RA built for the previous schema is not used.
+  auto changed_query_ra =
+      calcite_->process("test_db", sql, changed_schema_provider.get(), config_.get());
+  EXPECT_EQ(calcite_->getCacheMissCount(), misses + 1);
+  EXPECT_EQ(query_ra.find("col_new"), std::string::npos);
+  EXPECT_NE(changed_query_ra.find("col_new"), std::string::npos);
+
+  EXPECT_EQ(calcite_->process("test_db", sql, schema_provider_.get(), config_.get()),
+            query_ra);
+  EXPECT_EQ(calcite_->getCacheMissCount(), misses + 2);
+}
+
+TEST_F(NoCatalogSqlTest, RACacheConcurrentParse) {
+  constexpr size_t kThreads = 16;
+  auto hits = calcite_->getCacheHitCount();
+  auto misses = calcite_->getCacheMissCount();
+
+  // Each thread parses a new query and then gets it from the cache.
+  std::vector<std::string> query_ras(kThreads);
+  std::vector<std::future<void>> threads;
+  for (size_t i = 0; i < kThreads; ++i) {
+    threads.push_back(std::async(std::launch::async, [this, i, &query_ras]() {
+      const std::string sql =
+          "SELECT col_bi + " + std::to_string(1000 + i) + " FROM test1;";
+      query_ras[i] =
+          calcite_->process("test_db", sql, schema_provider_.get(), config_.get());
+      auto cached_ra =
+          calcite_->process("test_db", sql, schema_provider_.get(), config_.get());
+      CHECK_EQ(cached_ra, query_ras[i]);
+    }));
+  }
+  for (auto& thread : threads) {
+    thread.get();
+  }
+  EXPECT_EQ(calcite_->getCacheHitCount(), hits + kThreads);
+  EXPECT_EQ(calcite_->getCacheMissCount(), misses + kThreads);
+
+  for (size_t i = 0; i < kThreads; i += 5) {
+    const auto i_int = static_cast<int64_t>(1000 + i);
+    compare_res_data(
+        runRAQuery(query_ras[i], executor_.get()),
+        std::vector<int64_t>({1 + i_int, 2 + i_int, 3 + i_int, 4 + i_int, 5 + i_int}));
+  }
+}
+
 TEST(CalciteReinitTest, SingleThread) {
   auto schema_provider = std::make_shared<TestSchemaProvider>();
   auto config = std::make_shared<Config>();
@@ -324,6 +413,8 @@ int main(int argc, char** argv) {
   parse_cli_args_to_globals(argc, argv);
 
   try {
+    // Parse queries on several workers and cache their RA.
+    CalciteMgr::get("", 1024, /*num_workers=*/4, /*cache_size=*/64);
     err = RUN_ALL_TESTS();
   } catch (const std::exception& e) {
     LOG(ERROR) << e.what();
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ArrowSQLRunner/ArrowSQLRunner.h"
+
+#include "ArrowTestHelpers.h"
+#include "TestHelpers.h"
+
+#include <gtest/gtest.h>
+
+using ArrowTestHelpers::compare_res_data;
+using namespace TestHelpers::ArrowSQLRunner;
+
+// Queries join two aggregates of physical tables, so the second aggregate doesn't
+// depend on other steps and is compiled by a helper executor while the first one is
+// executed. Generated code is reused through the plan code cache, so every test uses
+// its own queries.
+
+namespace {
+
+constexpr size_t kFragmentSize = 5;
+constexpr int64_t kRows = 20;
+constexpr int64_t kBigValue = 1'000'000'000'000;
+
+ExecutionResult runSqlQuery(const std::string& sql) {
+  return TestHelpers::ArrowSQLRunner::runSqlQuery(
+      sql, ExecutorDeviceType::CPU, /*allow_loop_joins=*/false);
+}
+
+std::string joinAggregates(const std::string& agg1, const std::string& agg2) {
+  return "SELECT t1.a, t1.v1, t2.v2 FROM (SELECT a, " + agg1 +
+         " AS v1 FROM par_test1 GROUP BY a) t1 JOIN (SELECT a, " + agg2 +
+         " AS v2 FROM par_test2 GROUP BY a) t2 ON t1.a = t2.a ORDER BY t1.a;";
+}
+
+}  // namespace
+
+class ParallelCompilationTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    createTable("par_test1",
+                {{"a", ctx().int32()}, {"b", ctx().int64()}, {"c", ctx().int32()}},
+                {kFragmentSize});
+    createTable(
+        "par_test2", {{"a", ctx().int32()}, {"b", ctx().int64()}}, {kFragmentSize});
+    std::string csv1;
+    std::string csv2;
+    for (int64_t i = 1; i <= kRows; ++i) {
+      csv1 += std::to_string(i % 4) + "," + std::to_string(i * 10) + "," +
+              std::to_string(i % 5) + "\n";
+      csv2 += std::to_string(i % 4) + "," + std::to_string(i % 2 ? 10 : kBigValue) +
+              "\n";
+    }
+    insertCsvValues("par_test1", csv1);
+    insertCsvValues("par_test2", csv2);
+  }
+
+  static void TearDownTestSuite() {
+    dropTable("par_test1");
+    dropTable("par_test2");
+  }
+
+  void SetUp() override {
+    prev_compilation_threads_ = config().exec.codegen.parallel_compilation_threads;
+    prev_watchdog_config_ = config().exec.watchdog;
+  }
+
+  void TearDown() override {
+    config().exec.codegen.parallel_compilation_threads = prev_compilation_threads_;
+    config().exec.watchdog = prev_watchdog_config_;
+  }
+
+  size_t prev_compilation_threads_;
+  WatchdogConfig prev_watchdog_config_;
+};
+
+TEST_F(ParallelCompilationTest, ReusePrecompiledSteps) {
+  auto plan_code_accessor = getExecutor()->getPlanCodeAccessor();
+  ASSERT_TRUE(plan_code_accessor);
+
+  // Without helpers, steps of a new query are compiled once.
+  config().exec.codegen.parallel_compilation_threads = 0;
+  auto found_count = plan_code_accessor->getFoundCount();
+  auto res = runSqlQuery(joinAggregates("COUNT(*)", "MIN(b)"));
+  compare_res_data(res,
+                   std::vector<int32_t>({0, 1, 2, 3}),
+                   std::vector<int64_t>({5, 5, 5, 5}),
+                   std::vector<int64_t>({kBigValue, 10, kBigValue, 10}));
+  EXPECT_EQ(plan_code_accessor->getFoundCount(), found_count);
+
+  // The main thread gets code compiled by a helper from the cache.
+  config().exec.codegen.parallel_compilation_threads = 2;
+  found_count = plan_code_accessor->getFoundCount();
+  res = runSqlQuery(joinAggregates("SUM(b)", "MAX(b)"));
+  compare_res_data(res,
+                   std::vector<int32_t>({0, 1, 2, 3}),
+                   std::vector<int64_t>({600, 450, 500, 550}),
+                   std::vector<int64_t>({kBigValue, 10, kBigValue, 10}));
+  EXPECT_GT(plan_code_accessor->getFoundCount(), found_count);
+}
+
+TEST_F(ParallelCompilationTest, CompilationFailure) {
+  config().exec.codegen.parallel_compilation_threads = 2;
+  // The second aggregate uses a baseline hash table, which is rejected by the
+  // watchdog both in the helper and in the main thread.
+  config().exec.watchdog.enable = true;
+  config().exec.watchdog.baseline_max_groups = 0;
+  const std::string sql =
+      "SELECT t1.a, t1.v1, t2.v2 FROM (SELECT a, AVG(b) AS v1 FROM par_test1 GROUP BY "
+      "a) t1 JOIN (SELECT a, b, COUNT(*) AS v2 FROM par_test2 GROUP BY a, b) t2 ON "
+      "t1.a = t2.a ORDER BY t1.a LIMIT 10;";
+  EXPECT_ANY_THROW(runSqlQuery(sql));
+
+  config().exec.watchdog = prev_watchdog_config_;
+  auto res = runSqlQuery(sql);
+  compare_res_data(res,
+                   std::vector<int32_t>({0, 1, 2, 3}),
+                   std::vector<double>({120, 90, 100, 110}),
+                   std::vector<int64_t>({5, 5, 5, 5}));
+}
+
+TEST_F(ParallelCompilationTest, EarlyStop) {
+  config().exec.codegen.parallel_compilation_threads = 2;
+  // The first step fails on division by zero, so helpers are stopped while the
+  // second step might still be compiled.
+  EXPECT_ANY_THROW(runSqlQuery(joinAggregates("SUM(b / c)", "MAX(b + 1)")));
+
+  auto res = runSqlQuery(joinAggregates("MAX(c)", "SUM(b) / 10"));
+  compare_res_data(res,
+                   std::vector<int32_t>({0, 1, 2, 3}),
+                   std::vector<int32_t>({4, 4, 4, 4}),
+                   std::vector<int64_t>({5 * kBigValue / 10, 5, 5 * kBigValue / 10, 5}));
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  init();
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+    err = EINVAL;
+  }
+
+  reset();
+  return err;
+}
@@ -0,0 +1,283 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ArrowSQLRunner/ArrowSQLRunner.h"
+
+#include "ArrowTestHelpers.h"
+#include "TestHelpers.h"
+
+#include "ConfigBuilder/ConfigBuilder.h"
+#include "QueryEngine/Execute.h"
+#include "QueryEngine/PersistentCodeCache.h"
+
+#include <llvm/ExecutionEngine/Orc/CompileUtils.h>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/Support/TargetSelect.h>
+
+#include <boost/filesystem.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <fstream>
+
+using ArrowTestHelpers::compare_res_data;
+using namespace TestHelpers::ArrowSQLRunner;
+
+namespace bf = boost::filesystem;
+
+namespace {
+
+constexpr size_t kFragmentSize = 5;
+constexpr int64_t kRows = 20;
+
+// Entries start with an 8-byte magic followed by the size-prefixed tag.
+constexpr size_t kTagOffset = 16;
+
+bf::path makeTempDir() {
+  auto dir = bf::temp_directory_path() / bf::unique_path("hdk_code_cache_%%%%-%%%%");
+  bf::create_directories(dir);
+  return dir;
+}
+
+std::vector<bf::path> listEntries(const bf::path& dir) {
+  std::vector<bf::path> res;
+  for (auto& entry : bf::directory_iterator(dir)) {
+    if (entry.path().extension() == ".cache") {
+      res.push_back(entry.path());
+    }
+  }
+  std::sort(res.begin(), res.end());
+  return res;
+}
+
+std::string readFile(const bf::path& path) {
+  std::ifstream in(path.string(), std::ios::binary);
+  return std::string((std::istreambuf_iterator<char>(in)),
+                     std::istreambuf_iterator<char>());
+}
+
+void writeFile(const bf::path& path, const std::string& data) {
+  std::ofstream out(path.string(), std::ios::binary | std::ios::trunc);
+  out.write(data.data(), data.size());
+}
+
+// Compiles a module with a single function returning the value into a native object.
+std::unique_ptr<llvm::MemoryBuffer> compileObject(int32_t val) {
+  llvm::LLVMContext context;
+  llvm::Module module("code_cache_test", context);
+  auto func = llvm::Function::Create(
+      llvm::FunctionType::get(llvm::Type::getInt32Ty(context), false),
+      llvm::Function::ExternalLinkage,
+      "get_value",
+      module);
+  llvm::IRBuilder<> builder(llvm::BasicBlock::Create(context, "entry", func));
+  builder.CreateRet(builder.getInt32(val));
+
+  auto target_machine_builder =
+      llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost());
+  auto target_machine = llvm::cantFail(target_machine_builder.createTargetMachine());
+  module.setDataLayout(target_machine->createDataLayout());
+  llvm::orc::SimpleCompiler compiler(*target_machine);
+  return llvm::cantFail(compiler(module));
+}
+
+ExecutionResult runSqlQuery(const std::string& sql) {
+  return TestHelpers::ArrowSQLRunner::runSqlQuery(
+      sql, ExecutorDeviceType::CPU, /*allow_loop_joins=*/false);
+}
+
+}  // namespace
+
+class PersistentCodeCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    dir_ = makeTempDir();
+    object1_ = compileObject(1);
+    object2_ = compileObject(2);
+  }
+
+  void TearDown() override { bf::remove_all(dir_); }
+
+  void checkLoad(const PersistentCodeCache& cache,
+                 const CodeCacheKey& key,
+                 const llvm::MemoryBuffer& expected) {
+    auto object = cache.load(key);
+    ASSERT_TRUE(object);
+    EXPECT_EQ(object->getBuffer(), expected.getBuffer());
+  }
+
+  bf::path dir_;
+  std::unique_ptr<llvm::MemoryBuffer> object1_;
+  std::unique_ptr<llvm::MemoryBuffer> object2_;
+};
+
+TEST_F(PersistentCodeCacheTest, RoundTrip) {
+  const CodeCacheKey key1{"func1", "opt_level=0"};
+  const CodeCacheKey key2{"func1", "opt_level=1"};
+  {
+    PersistentCodeCache cache(dir_.string());
+    EXPECT_FALSE(cache.load(key1));
+    cache.store(key1, object1_->getMemBufferRef());
+    cache.store(key2, object2_->getMemBufferRef());
+    checkLoad(cache, key1, *object1_);
+    checkLoad(cache, key2, *object2_);
+    // Entries are replaced.
+    cache.store(key1, object2_->getMemBufferRef());
+    checkLoad(cache, key1, *object2_);
+  }
+  EXPECT_EQ(listEntries(dir_).size(), (size_t)2);
+
+  // Entries survive the process restart.
+  PersistentCodeCache cache(dir_.string());
+  checkLoad(cache, key1, *object2_);
+  checkLoad(cache, key2, *object2_);
+}
+
+TEST_F(PersistentCodeCacheTest, ObjectCache) {
+  const CodeCacheKey key{"func2"};
+  PersistentCodeCache cache(dir_.string());
+  auto object_cache = cache.makeObjectCache(key);
+  object_cache->notifyObjectCompiled(nullptr, object1_->getMemBufferRef());
+  checkLoad(cache, key, *object1_);
+}
+
+TEST_F(PersistentCodeCacheTest, CorruptedEntries) {
+  const CodeCacheKey key{"func3", "opt_level=0"};
+  PersistentCodeCache cache(dir_.string());
+  cache.store(key, object1_->getMemBufferRef());
+  auto entries = listEntries(dir_);
+  ASSERT_EQ(entries.size(), (size_t)1);
+  const auto path = entries.front();
+  const auto valid_data = readFile(path);
+
+  std::vector<std::pair<std::string, std::string>> corrupted_entries = {
+      {"empty", ""},
+      {"foreign file", "not a code cache entry"},
+      {"truncated header", valid_data.substr(0, kTagOffset + 3)},
+      {"truncated object", valid_data.substr(0, valid_data.size() - 10)},
+      {"trailing data", valid_data + "garbage"}};
+  // An entry written by another build or for another CPU.
+  auto foreign_tag = valid_data;
+  foreign_tag[kTagOffset] ^= 0x1;
+  corrupted_entries.emplace_back("foreign tag", foreign_tag);
+
+  for (auto& [name, data] : corrupted_entries) {
+    SCOPED_TRACE(name);
+    writeFile(path, data);
+    EXPECT_FALSE(cache.load(key));
+    // Invalid entries are removed and can be stored again.
+    EXPECT_FALSE(bf::exists(path));
+    cache.store(key, object1_->getMemBufferRef());
+    checkLoad(cache, key, *object1_);
+  }
+
+  // An entry with a valid header holding something which is not an object file.
+  cache.store(key, llvm::MemoryBufferRef("not an object", "object"));
+  EXPECT_TRUE(bf::exists(path));
+  EXPECT_FALSE(cache.load(key));
+  EXPECT_FALSE(bf::exists(path));
+}
+
+TEST_F(PersistentCodeCacheTest, KeyMismatch) {
+  const CodeCacheKey key1{"func4", "opt_level=0"};
+  const CodeCacheKey key2{"func4", "opt_level=0", "extra"};
+  const CodeCacheKey key3{"func5", "opt_level=0"};
+  PersistentCodeCache cache(dir_.string());
+  cache.store(key1, object1_->getMemBufferRef());
+  auto entries1 = listEntries(dir_);
+  ASSERT_EQ(entries1.size(), (size_t)1);
+  EXPECT_FALSE(cache.load(key2));
+  EXPECT_FALSE(cache.load(key3));
+  checkLoad(cache, key1, *object1_);
+
+  // Simulate hash collisions by placing the entry of key1 at the paths of other keys.
+  for (auto& key : {key2, key3}) {
+    cache.store(key, object2_->getMemBufferRef());
+    auto entries = listEntries(dir_);
+    ASSERT_EQ(entries.size(), (size_t)2);
+    const auto path = entries[0] == entries1[0] ? entries[1] : entries[0];
+    writeFile(path, readFile(entries1[0]));
+    EXPECT_FALSE(cache.load(key));
+    EXPECT_FALSE(bf::exists(path));
+  }
+  checkLoad(cache, key1, *object1_);
+}
+
+class PersistentCodeCacheQueryTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    createTable(
+        "code_cache_test", {{"a", ctx().int32()}, {"b", ctx().int64()}}, {kFragmentSize});
+    std::string csv;
+    for (int64_t i = 1; i <= kRows; ++i) {
+      csv += std::to_string(i) + "," + std::to_string(i * 10) + "\n";
+    }
+    insertCsvValues("code_cache_test", csv);
+  }
+
+  static void TearDownTestSuite() { dropTable("code_cache_test"); }
+};
+
+TEST_F(PersistentCodeCacheQueryTest, ReuseAndRecover) {
+  const bf::path dir(config().cache.code_cache_dir);
+  const std::string sql = "SELECT COUNT(*), SUM(b) FROM code_cache_test WHERE a > 4;";
+  auto check_res = [&]() {
+    compare_res_data(
+        runSqlQuery(sql), std::vector<int64_t>({16}), std::vector<int64_t>({2000}));
+  };
+
+  check_res();
+  const auto entries = listEntries(dir);
+  EXPECT_FALSE(entries.empty());
+
+  // Kernels are loaded from the disk after in-memory caches are flushed.
+  Executor::resetCodeCache();
+  check_res();
+  EXPECT_EQ(listEntries(dir), entries);
+
+  // Corrupted entries are recompiled and stored again.
+  for (auto& path : entries) {
+    writeFile(path, "corrupted");
+  }
+  Executor::resetCodeCache();
+  check_res();
+  EXPECT_EQ(listEntries(dir), entries);
+  for (auto& path : entries) {
+    EXPECT_GT(bf::file_size(path), std::string("corrupted").size());
+  }
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+
+  const auto cache_dir = makeTempDir();
+  ConfigBuilder builder;
+  builder.parseCommandLineArgs(argc, argv, true);
+  auto config = builder.config();
+  // Compiled plans are reused without looking up kernels in the code caches.
+  config->cache.enable_plan_code_cache = false;
+  config->cache.code_cache_dir = cache_dir.string();
+
+  init(config);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+    err = EINVAL;
+  }
+
+  reset();
+  bf::remove_all(cache_dir);
+  return err;
+}
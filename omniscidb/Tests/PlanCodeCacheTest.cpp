@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ArrowSQLRunner/ArrowSQLRunner.h"
+
+#include "ArrowTestHelpers.h"
+#include "TestHelpers.h"
+
+#include "QueryEngine/CodeCacheAccessor.h"
+
+#include <gtest/gtest.h>
+
+using ArrowTestHelpers::compare_res_data;
+using namespace TestHelpers::ArrowSQLRunner;
+
+// Compiled plans are shared by all tests, so every test uses its own queries or tables.
+
+namespace {
+
+constexpr size_t kFragmentSize = 5;
+constexpr int64_t kRows = 20;
+
+ExecutionResult runSqlQuery(const std::string& sql) {
+  return TestHelpers::ArrowSQLRunner::runSqlQuery(
+      sql, ExecutorDeviceType::CPU, /*allow_loop_joins=*/false);
+}
+
+std::string makeCsv(int64_t first_row, int64_t last_row) {
+  std::string csv;
+  for (int64_t i = first_row; i <= last_row; ++i) {
+    csv += std::to_string(i) + "," + std::to_string(i * 10) + "," +
+           std::to_string(i % 5) + "\n";
+  }
+  return csv;
+}
+
+}  // namespace
+
+class PlanCodeCacheTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    // Tables differ from plan_cache_test only by the type or the nullability of a.
+    createTable("plan_cache_test",
+                {{"a", ctx().int32()}, {"b", ctx().int64()}, {"c", ctx().int32()}},
+                {kFragmentSize});
+    createTable("plan_cache_test_i64",
+                {{"a", ctx().int64()}, {"b", ctx().int64()}, {"c", ctx().int32()}},
+                {kFragmentSize});
+    createTable("plan_cache_test_not_null",
+                {{"a", ctx().int32(false)}, {"b", ctx().int64()}, {"c", ctx().int32()}},
+                {kFragmentSize});
+    createTable("plan_cache_test_layout",
+                {{"a", ctx().int32()}, {"b", ctx().int64()}, {"c", ctx().int32()}},
+                {kFragmentSize});
+    for (auto table : {"plan_cache_test",
+                       "plan_cache_test_i64",
+                       "plan_cache_test_not_null",
+                       "plan_cache_test_layout"}) {
+      insertCsvValues(table, makeCsv(1, kRows));
+    }
+  }
+
+  static void TearDownTestSuite() {
+    dropTable("plan_cache_test");
+    dropTable("plan_cache_test_i64");
+    dropTable("plan_cache_test_not_null");
+    dropTable("plan_cache_test_layout");
+  }
+
+  void SetUp() override {
+    plan_code_accessor_ = getExecutor()->getPlanCodeAccessor();
+    ASSERT_TRUE(plan_code_accessor_);
+    prev_codegen_config_ = config().exec.codegen;
+    config().exec.codegen.enable_fragment_specialization = false;
+  }
+
+  void TearDown() override { config().exec.codegen = prev_codegen_config_; }
+
+  // Runs the query and checks whether its plan is taken from the cache.
+  ExecutionResult runQuery(const std::string& sql, bool expect_hit) {
+    SCOPED_TRACE(sql);
+    const auto put_count = plan_code_accessor_->getPutCount();
+    const auto found_count = plan_code_accessor_->getFoundCount();
+    auto res = runSqlQuery(sql);
+    if (expect_hit) {
+      EXPECT_EQ(plan_code_accessor_->getPutCount(), put_count);
+      EXPECT_GT(plan_code_accessor_->getFoundCount(), found_count);
+    } else {
+      EXPECT_GT(plan_code_accessor_->getPutCount(), put_count);
+    }
+    return res;
+  }
+
+  CodeCacheAccessor<CompiledPlan>* plan_code_accessor_;
+  CodegenConfig prev_codegen_config_;
+};
+
+TEST_F(PlanCodeCacheTest, DifferentLiterals) {
+  auto res = runQuery(
+      "SELECT COUNT(*), SUM(b) FROM plan_cache_test WHERE a > 2 AND c < 4;", false);
+  compare_res_data(res, std::vector<int64_t>({14}), std::vector<int64_t>({1610}));
+  res = runQuery("SELECT COUNT(*), SUM(b) FROM plan_cache_test WHERE a > 5 AND c < 2;",
+                 true);
+  compare_res_data(res, std::vector<int64_t>({6}), std::vector<int64_t>({780}));
+
+  // Equal literals share a slot of the literal buffer, so plans with and without equal
+  // literals don't share the code.
+  res = runQuery("SELECT COUNT(*), SUM(b) FROM plan_cache_test WHERE a > 3 AND c < 3;",
+                 false);
+  compare_res_data(res, std::vector<int64_t>({10}), std::vector<int64_t>({1190}));
+  res = runQuery("SELECT COUNT(*), SUM(b) FROM plan_cache_test WHERE a > 6 AND c < 6;",
+                 true);
+  compare_res_data(res, std::vector<int64_t>({14}), std::vector<int64_t>({1890}));
+}
+
+TEST_F(PlanCodeCacheTest, LiteralSharedWithTarget) {
+  // The filter literal shares the slot with the one of the target, so the cached code
+  // cannot be reused with another value and is replaced.
+  const std::string sql = "SELECT COUNT(*), SUM(a + 3) FROM plan_cache_test WHERE c < ";
+  auto res = runQuery(sql + "3;", false);
+  compare_res_data(res, std::vector<int64_t>({12}), std::vector<int64_t>({158}));
+  res = runQuery(sql + "2;", false);
+  compare_res_data(res, std::vector<int64_t>({8}), std::vector<int64_t>({108}));
+  // The replacing plan has an own slot for the filter literal.
+  res = runQuery(sql + "3;", true);
+  compare_res_data(res, std::vector<int64_t>({12}), std::vector<int64_t>({158}));
+}
+
+TEST_F(PlanCodeCacheTest, DifferentTypeOrNullability) {
+  auto sql = [](const std::string& table) {
+    return "SELECT COUNT(*), SUM(b) FROM " + table + " WHERE a > 4 AND b < 160;";
+  };
+  auto res = runQuery(sql("plan_cache_test"), false);
+  compare_res_data(res, std::vector<int64_t>({11}), std::vector<int64_t>({1100}));
+  for (auto table : {"plan_cache_test_i64", "plan_cache_test_not_null"}) {
+    res = runQuery(sql(table), false);
+    compare_res_data(res, std::vector<int64_t>({11}), std::vector<int64_t>({1100}));
+  }
+}
+
+TEST_F(PlanCodeCacheTest, DifferentFragmentLayout) {
+  const std::string sql =
+      "SELECT COUNT(*), MAX(b) FROM plan_cache_test_layout WHERE c > 1;";
+  auto res = runQuery(sql, false);
+  compare_res_data(res, std::vector<int64_t>({12}), std::vector<int64_t>({190}));
+  res = runQuery(sql, true);
+  compare_res_data(res, std::vector<int64_t>({12}), std::vector<int64_t>({190}));
+
+  // New rows add a fragment and extend column ranges.
+  insertCsvValues("plan_cache_test_layout", makeCsv(kRows + 1, kRows + kFragmentSize));
+  res = runQuery(sql, false);
+  compare_res_data(res, std::vector<int64_t>({15}), std::vector<int64_t>({240}));
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  init();
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+    err = EINVAL;
+  }
+
+  reset();
+  return err;
+}
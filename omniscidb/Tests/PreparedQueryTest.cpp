@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ArrowSQLRunner/ArrowSQLRunner.h"
+
+#include "ArrowTestHelpers.h"
+#include "TestHelpers.h"
+
+#include "QueryEngine/PreparedQuery.h"
+#include "QueryEngine/RelAlgDagBuilder.h"
+#include "QueryEngine/RelAlgExecutor.h"
+
+#include <gtest/gtest.h>
+
+using ArrowTestHelpers::compare_res_data;
+using namespace TestHelpers::ArrowSQLRunner;
+using hdk::PreparedQuery;
+using hdk::QueryParameter;
+
+namespace {
+
+std::unique_ptr<hdk::ir::QueryDag> buildDag(const std::string& sql) {
+  return std::make_unique<RelAlgDagBuilder>(
+      getSqlQueryRelAlg(sql), TEST_DB_ID, getSchemaProvider(), configPtr());
+}
+
+ExecutionResult runDag(std::unique_ptr<hdk::ir::QueryDag> dag) {
+  RelAlgExecutor ra_executor(getExecutor(), getSchemaProvider(), std::move(dag));
+  return ra_executor.executeRelAlgQuery(getCompilationOptions(ExecutorDeviceType::CPU),
+                                        getExecutionOptions(/*allow_loop_joins=*/false),
+                                        /*just_explain_plan=*/false);
+}
+
+// Executes the query the same way HDK::execute does and checks whether the template
+// is used.
+ExecutionResult execute(PreparedQuery& query,
+                        const std::vector<QueryParameter>& params,
+                        bool expect_template) {
+  if (query.needsTemplate(params)) {
+    try {
+      query.addTemplate(params, getSqlQueryRelAlg(query.templateSql(params)));
+    } catch (const std::exception&) {
+      query.addUnusableTemplate(params);
+    }
+  }
+  auto dag = query.bind(params, TEST_DB_ID, getSchemaProvider(), configPtr());
+  EXPECT_EQ(!!dag, expect_template);
+  if (!dag) {
+    dag = buildDag(query.literalSql(params));
+  }
+  return runDag(std::move(dag));
+}
+
+}  // namespace
+
+class PreparedQueryTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    createTable("prep_test",
+                {{"a", ctx().int32()},
+                 {"x", ctx().fp64()},
+                 {"s", ctx().extDict(ctx().text(), 0)},
+                 {"d", ctx().date32(hdk::ir::TimeUnit::kDay)}});
+    insertCsvValues("prep_test",
+                    "1,1.1,s1,2020-01-01\n"
+                    "2,2.2,s2,2020-01-02\n"
+                    "3,3.3,s3,2020-01-03\n"
+                    "4,4.4,s4,2020-01-04\n"
+                    "5,5.5,s5,2020-01-05");
+  }
+
+  static void TearDownTestSuite() { dropTable("prep_test"); }
+};
+
+TEST_F(PreparedQueryTest, Placeholders) {
+  PreparedQuery query(
+      "SELECT a FROM prep_test WHERE s = ? OR s = '?' OR \"?\" = a -- ?\n"
+      "/* ? */ AND a > ?;");
+  EXPECT_EQ(query.parameterCount(), (size_t)2);
+  EXPECT_EQ(query.literalSql({QueryParameter::string("it's"), QueryParameter::fp(0.5)}),
+            "SELECT a FROM prep_test WHERE s = 'it''s' OR s = '?' OR \"?\" = a -- ?\n"
+            "/* ? */ AND a > 5.00000000000000000e-01;");
+  EXPECT_THROW(query.literalSql({QueryParameter::integer(1)}), std::runtime_error);
+}
+
+TEST_F(PreparedQueryTest, Markers) {
+  PreparedQuery query("SELECT COUNT(*) FROM prep_test WHERE a > ? AND x < ? AND s <> ?;");
+  const std::vector<QueryParameter> params1 = {
+      QueryParameter::integer(1), QueryParameter::fp(4.0), QueryParameter::string("s2")};
+  EXPECT_TRUE(query.needsTemplate(params1));
+  compare_res_data(execute(query, params1, true), std::vector<int64_t>({1}));
+  // Markers are replaced with values of other parameters of the same kinds.
+  EXPECT_FALSE(query.needsTemplate(params1));
+  const std::vector<QueryParameter> params2 = {
+      QueryParameter::integer(2), QueryParameter::fp(10.0), QueryParameter::string("s4")};
+  EXPECT_FALSE(query.needsTemplate(params2));
+  compare_res_data(execute(query, params2, true), std::vector<int64_t>({2}));
+  // Another kind of a parameter requires a new template.
+  const std::vector<QueryParameter> params3 = {
+      QueryParameter::fp(2.5), QueryParameter::fp(10.0), QueryParameter::string("s1")};
+  EXPECT_TRUE(query.needsTemplate(params3));
+  compare_res_data(execute(query, params3, true), std::vector<int64_t>({3}));
+}
+
+TEST_F(PreparedQueryTest, FoldedParameters) {
+  PreparedQuery query("SELECT COUNT(*) FROM prep_test WHERE a > ?;");
+  const std::vector<QueryParameter> params = {QueryParameter::integer(3)};
+  // Simulate folding of the marker with another literal by the optimizer.
+  const auto template_sql = query.templateSql(params);
+  const auto marker_pos = template_sql.find("> ") + 2;
+  const auto marker = std::stoll(template_sql.substr(marker_pos));
+  auto ra = getSqlQueryRelAlg(template_sql);
+  const auto ra_marker_pos = ra.find(std::to_string(marker));
+  ASSERT_NE(ra_marker_pos, std::string::npos);
+  ra.replace(ra_marker_pos, std::to_string(marker).size(), std::to_string(marker + 1));
+  query.addTemplate(params, ra);
+
+  EXPECT_FALSE(query.needsTemplate(params));
+  EXPECT_FALSE(query.bind(params, TEST_DB_ID, getSchemaProvider(), configPtr()));
+  compare_res_data(execute(query, params, false), std::vector<int64_t>({2}));
+}
+
+TEST_F(PreparedQueryTest, Fallback) {
+  PreparedQuery query("SELECT COUNT(*) FROM prep_test WHERE a > ?;");
+  // NULL and boolean parameters are always substituted into the SQL text.
+  EXPECT_FALSE(query.needsTemplate({QueryParameter::null()}));
+  compare_res_data(execute(query, {QueryParameter::null()}, false),
+                   std::vector<int64_t>({0}));
+  compare_res_data(execute(query, {QueryParameter::integer(4)}, true),
+                   std::vector<int64_t>({1}));
+
+  // Template SQL can fail to translate, e.g. when a string marker is compared with a
+  // date column. Such kinds of parameters are bound through the SQL text.
+  PreparedQuery date_query("SELECT COUNT(*) FROM prep_test WHERE d > ?;");
+  const std::vector<QueryParameter> params = {QueryParameter::string("2020-01-03")};
+  date_query.addUnusableTemplate(params);
+  EXPECT_FALSE(date_query.needsTemplate(params));
+  compare_res_data(execute(date_query, params, false), std::vector<int64_t>({2}));
+}
+
+TEST_F(PreparedQueryTest, ResultTypes) {
+  PreparedQuery query("SELECT a + ? AS r FROM prep_test ORDER BY a;");
+  // Template and literal SQL produce the same types.
+  for (int64_t val : {int64_t(1), int64_t(10'000'000'000)}) {
+    SCOPED_TRACE(val);
+    const std::vector<QueryParameter> params = {QueryParameter::integer(val)};
+    auto res = execute(query, params, true);
+    auto expected = runDag(buildDag(query.literalSql(params)));
+    auto type = res.getRows()->colType(0);
+    EXPECT_TRUE(type->isInteger());
+    EXPECT_EQ(type->size(), val == 1 ? 4 : 8);
+    EXPECT_TRUE(type->equal(expected.getRows()->colType(0)));
+  }
+  auto null_res = execute(query, {QueryParameter::null()}, false);
+  EXPECT_EQ(null_res.getRows()->colType(0)->size(), 4);
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  init();
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+    err = EINVAL;
+  }
+
+  reset();
+  return err;
+}
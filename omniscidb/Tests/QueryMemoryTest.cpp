@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ArrowSQLRunner/ArrowSQLRunner.h"
+
+#include "ArrowTestHelpers.h"
+#include "TestHelpers.h"
+
+#include "Shared/QueryMemoryTracker.h"
+
+#include <gtest/gtest.h>
+
+using ArrowTestHelpers::compare_res_data;
+using namespace TestHelpers::ArrowSQLRunner;
+using hdk::QueryMemoryCategory;
+
+namespace {
+
+constexpr size_t kFragmentSize = 10;
+constexpr int64_t kRows = 50;
+
+ExecutionResult runSqlQuery(const std::string& sql) {
+  return TestHelpers::ArrowSQLRunner::runSqlQuery(
+      sql, ExecutorDeviceType::CPU, /*allow_loop_joins=*/false);
+}
+
+const std::string kGroupByQuery =
+    "SELECT a % 5 AS k, COUNT(*), SUM(b) FROM mem_test1 GROUP BY k ORDER BY k;";
+const std::string kJoinQuery =
+    "SELECT COUNT(*), SUM(t1.b) FROM mem_test1 t1 JOIN mem_test2 t2 ON t1.a = t2.a;";
+
+void checkGroupByResult(const ExecutionResult& res) {
+  compare_res_data(res,
+                   std::vector<int32_t>({0, 1, 2, 3, 4}),
+                   std::vector<int64_t>({10, 10, 10, 10, 10}),
+                   std::vector<int64_t>({2750, 2350, 2450, 2550, 2650}));
+}
+
+void checkJoinResult(const ExecutionResult& res) {
+  compare_res_data(res, std::vector<int64_t>({25}), std::vector<int64_t>({6250}));
+}
+
+}  // namespace
+
+class QueryMemoryTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    createTable(
+        "mem_test1", {{"a", ctx().int32()}, {"b", ctx().int64()}}, {kFragmentSize});
+    createTable("mem_test2", {{"a", ctx().int32()}}, {kFragmentSize});
+    std::string csv1;
+    std::string csv2;
+    for (int64_t i = 1; i <= kRows; ++i) {
+      csv1 += std::to_string(i) + "," + std::to_string(i * 10) + "\n";
+      if (i % 2) {
+        csv2 += std::to_string(i) + "\n";
+      }
+    }
+    insertCsvValues("mem_test1", csv1);
+    insertCsvValues("mem_test2", csv2);
+  }
+
+  static void TearDownTestSuite() {
+    dropTable("mem_test1");
+    dropTable("mem_test2");
+  }
+
+  void SetUp() override { prev_max_query_memory_ = config().exec.max_query_memory; }
+
+  void TearDown() override { config().exec.max_query_memory = prev_max_query_memory_; }
+
+  size_t prev_max_query_memory_;
+};
+
+TEST_F(QueryMemoryTest, SharedAllocations) {
+  hdk::QueryMemoryTracker tracker(1'000);
+  int obj1;
+  int obj2;
+  int obj3;
+  tracker.allocateShared(&obj1, QueryMemoryCategory::kHashTables, 300);
+  tracker.allocateShared(&obj1, QueryMemoryCategory::kHashTables, 300);
+  tracker.allocateShared(&obj2, QueryMemoryCategory::kHashTables, 200);
+  EXPECT_EQ(tracker.allocated(), (size_t)500);
+  // Objects exceeding the limit are not accounted.
+  EXPECT_THROW(tracker.allocateShared(&obj3, QueryMemoryCategory::kHashTables, 600),
+               hdk::QueryMemoryLimitExceeded);
+  EXPECT_EQ(tracker.allocated(), (size_t)500);
+
+  tracker.releaseShared();
+  EXPECT_EQ(tracker.allocated(), (size_t)0);
+  EXPECT_EQ(tracker.stats().peak(QueryMemoryCategory::kHashTables), (size_t)500);
+  EXPECT_EQ(tracker.stats().total_peak_bytes, (size_t)500);
+}
+
+TEST_F(QueryMemoryTest, HashTablesAccountedOnce) {
+  config().exec.max_query_memory = 0;
+  auto res1 = runSqlQuery(kJoinQuery);
+  checkJoinResult(res1);
+  const auto hash_tables_peak =
+      res1.getMemoryStats().peak(QueryMemoryCategory::kHashTables);
+  EXPECT_GT(hash_tables_peak, (size_t)0);
+  // The second query reuses the cached hash table.
+  auto res2 = runSqlQuery(kJoinQuery);
+  checkJoinResult(res2);
+  EXPECT_EQ(res2.getMemoryStats().peak(QueryMemoryCategory::kHashTables),
+            hash_tables_peak);
+}
+
+TEST_F(QueryMemoryTest, LimitExceeded) {
+  for (auto& sql : {kGroupByQuery, kJoinQuery}) {
+    SCOPED_TRACE(sql);
+    config().exec.max_query_memory = 16;
+    EXPECT_THROW(runSqlQuery(sql), hdk::QueryMemoryLimitExceeded);
+  }
+
+  // Queries run after the failed ones.
+  config().exec.max_query_memory = size_t(1) << 30;
+  checkGroupByResult(runSqlQuery(kGroupByQuery));
+  checkJoinResult(runSqlQuery(kJoinQuery));
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  init();
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+    err = EINVAL;
+  }
+
+  reset();
+  return err;
+}
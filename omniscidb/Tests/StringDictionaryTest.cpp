@@ -18,13 +18,17 @@
 
 #include "StringDictionary/StringDictionaryProxy.h"
 
+#include <atomic>
 #include <cstdio>
 #include <cstdlib>
+#include <boost/filesystem.hpp>
+#include <fstream>
 #include <functional>
 #include <iostream>
 #include <limits>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <unordered_set>
 
 using namespace std::string_literals;
@@ -249,6 +253,479 @@ TEST(StringDictionary, BuildTranslationMap) {
   }
 }
 
+TEST(StringDictionary, BuildTranslationMapIncremental) {
+  const DictRef dict_ref1(-1, 1);
+  const DictRef dict_ref2(-1, 2);
+  auto source_string_dict =
+      std::make_shared<StringDictionary>(dict_ref1, g_cache_string_hash);
+  auto dest_string_dict =
+      std::make_shared<StringDictionary>(dict_ref2, g_cache_string_hash);
+
+  // Source holds even numbers and dest holds multiples of three, every batch
+  // grows both dictionaries so cached translations have to be extended both ways.
+  constexpr int batch_size = 1000;
+  constexpr int num_batches = 4;
+  auto dummy_callback = [](const std::string_view& source_string,
+                           const int32_t source_string_id) { return true; };
+  std::vector<int32_t> translated_ids;
+  for (int batch = 0; batch < num_batches; ++batch) {
+    for (int i = batch * batch_size; i < (batch + 1) * batch_size; ++i) {
+      source_string_dict->getOrAdd(std::to_string(i * 2));
+      dest_string_dict->getOrAdd(std::to_string(i * 3));
+    }
+    const size_t num_source_strings = source_string_dict->storageEntryCount();
+    const size_t num_dest_strings = dest_string_dict->storageEntryCount();
+    // Also translate to an older dest generation, translations to dest strings
+    // added after it must not be visible.
+    for (const size_t dest_generation : {num_dest_strings / 2, num_dest_strings}) {
+      translated_ids.assign(num_source_strings, 0);
+      const size_t num_not_translated =
+          source_string_dict->buildDictionaryTranslationMap(dest_string_dict.get(),
+                                                            translated_ids.data(),
+                                                            num_source_strings,
+                                                            dest_generation,
+                                                            false,
+                                                            dummy_callback);
+      size_t expected_not_translated = 0;
+      for (size_t source_id = 0; source_id < num_source_strings; ++source_id) {
+        const int64_t val = source_id * 2;
+        const int32_t expected_id = (val % 3 == 0 && size_t(val / 3) < dest_generation)
+                                        ? static_cast<int32_t>(val / 3)
+                                        : StringDictionary::INVALID_STR_ID;
+        expected_not_translated += expected_id == StringDictionary::INVALID_STR_ID;
+        ASSERT_EQ(translated_ids[source_id], expected_id);
+      }
+      ASSERT_EQ(num_not_translated, expected_not_translated);
+    }
+  }
+}
+
+TEST(StringDictionary, TranslationCacheBudget) {
+  constexpr int num_strings = 1000;
+  const DictRef dict_ref(-1, 1);
+  StringDictionary source_string_dict(dict_ref, g_cache_string_hash);
+  std::vector<std::shared_ptr<StringDictionary>> dest_string_dicts;
+  for (int i = 0; i < 3; ++i) {
+    dest_string_dicts.push_back(
+        std::make_shared<StringDictionary>(DictRef(-1, 2 + i), g_cache_string_hash));
+  }
+  for (int i = 0; i < num_strings; ++i) {
+    source_string_dict.getOrAdd(std::to_string(i));
+    for (auto& dest_string_dict : dest_string_dicts) {
+      dest_string_dict->getOrAdd(std::to_string(num_strings - 1 - i));
+    }
+  }
+
+  auto dummy_callback = [](const std::string_view& source_string,
+                           const int32_t source_string_id) { return true; };
+  auto check_translation = [&](const StringDictionary* dest_string_dict) {
+    std::vector<int32_t> translated_ids(num_strings, 0);
+    ASSERT_EQ(source_string_dict.buildDictionaryTranslationMap(dest_string_dict,
+                                                               translated_ids.data(),
+                                                               num_strings,
+                                                               num_strings,
+                                                               false,
+                                                               dummy_callback),
+              0UL);
+    for (int i = 0; i < num_strings; ++i) {
+      ASSERT_EQ(translated_ids[i], num_strings - 1 - i);
+    }
+  };
+
+  // Maps to destroyed dictionaries are dropped.
+  check_translation(dest_string_dicts[0].get());
+  const size_t entry_bytes = source_string_dict.translationCacheBytes();
+  ASSERT_GE(entry_bytes, num_strings * sizeof(int32_t));
+  check_translation(dest_string_dicts[1].get());
+  ASSERT_EQ(source_string_dict.translationCacheBytes(), 2 * entry_bytes);
+  dest_string_dicts[1].reset();
+  check_translation(dest_string_dicts[0].get());
+  ASSERT_EQ(source_string_dict.translationCacheBytes(), entry_bytes);
+
+  // Least recently used maps are evicted to fit the budget.
+  source_string_dict.setTranslationCacheBudget(entry_bytes);
+  check_translation(dest_string_dicts[2].get());
+  ASSERT_EQ(source_string_dict.translationCacheBytes(), entry_bytes);
+
+  // Maps which don't fit are built without the cache.
+  for (const size_t budget : {entry_bytes - 1, 0UL}) {
+    source_string_dict.setTranslationCacheBudget(budget);
+    ASSERT_EQ(source_string_dict.translationCacheBytes(), 0UL);
+    check_translation(dest_string_dicts[0].get());
+    ASSERT_EQ(source_string_dict.translationCacheBytes(), 0UL);
+  }
+}
+
+namespace {
+
+std::string make_url(int i) {
+  return "https://www.example.com/products/category_" + std::to_string(i % 17) +
+         "/item.html?id=" + std::to_string(i);
+}
+
+}  // namespace
+
+TEST(StringDictionary, CompressedPayload) {
+  const DictRef dict_ref(-1, 1);
+  StringDictionary string_dict(dict_ref, g_cache_string_hash);
+  constexpr int num_strings{g_op_count / 10};
+  string_dict.enablePayloadCompression(num_strings / 2);
+
+  std::vector<std::string> strings;
+  strings.reserve(num_strings);
+  size_t raw_payload_size = 0;
+  for (int i = 0; i < num_strings; ++i) {
+    strings.emplace_back(make_url(i));
+    raw_payload_size += strings.back().size();
+  }
+  std::vector<int32_t> string_ids(num_strings);
+  string_dict.getOrAddBulk(strings, string_ids.data());
+  ASSERT_TRUE(string_dict.isPayloadCompressed());
+  ASSERT_LT(string_dict.payloadSize() * 2, raw_payload_size);
+
+  for (int i = 0; i < num_strings; ++i) {
+    ASSERT_EQ(i, string_ids[i]);
+    ASSERT_EQ(strings[i], string_dict.getString(i));
+    ASSERT_EQ(i, string_dict.getIdOfString(strings[i]));
+  }
+
+  // Strings added after compression are encoded with the same symbol table.
+  ASSERT_EQ(num_strings, string_dict.getOrAdd(make_url(num_strings)));
+  ASSERT_EQ(num_strings, string_dict.getOrAdd(make_url(num_strings)));
+  ASSERT_EQ(num_strings + 1, string_dict.getOrAdd("bytes not seen in training: ~`{|}"));
+  ASSERT_EQ("bytes not seen in training: ~`{|}", string_dict.getString(num_strings + 1));
+
+  std::string decode_buffer;
+  const auto bytes = string_dict.getStringBytes(5, decode_buffer);
+  ASSERT_EQ(strings[5], std::string(bytes.first, bytes.second));
+
+  const auto like_ids = string_dict.getLike("category_3/", false, true, '\\', 100);
+  for (const auto id : like_ids) {
+    ASSERT_EQ(id % 17, 3);
+  }
+  ASSERT_EQ(like_ids.size(), size_t(6));
+
+  const auto copied_strings = string_dict.copyStrings();
+  ASSERT_EQ(copied_strings.size(), size_t(num_strings + 2));
+  for (int i = 0; i < num_strings; ++i) {
+    ASSERT_EQ(strings[i], copied_strings[i]);
+  }
+}
+
+TEST(StringDictionary, CompressedPayloadStringBytes) {
+  const DictRef dict_ref(-1, 1);
+  auto string_dict = std::make_shared<StringDictionary>(dict_ref, g_cache_string_hash);
+  constexpr int num_strings{1000};
+  string_dict->enablePayloadCompression(num_strings / 2);
+  std::vector<std::string> strings;
+  for (int i = 0; i < num_strings; ++i) {
+    strings.emplace_back(make_url(i));
+  }
+  std::vector<int32_t> string_ids(num_strings);
+  string_dict->getOrAddBulk(strings, string_ids.data());
+  ASSERT_TRUE(string_dict->isPayloadCompressed());
+
+  // The dictionary doesn't keep decoded strings, they are decoded into the caller's
+  // buffer.
+  std::string decode_buffer;
+  for (int i = 0; i < num_strings; ++i) {
+    const auto bytes = string_dict->getStringBytes(i, decode_buffer);
+    ASSERT_EQ(bytes.first, decode_buffer.data());
+    ASSERT_EQ(strings[i], std::string(bytes.first, bytes.second));
+  }
+
+  // Proxy pointers stay valid for the proxy lifetime.
+  StringDictionaryProxy string_dict_proxy(
+      string_dict, 1 /* string_dict_id */, string_dict->storageEntryCount());
+  std::vector<std::pair<const char*, size_t>> proxy_bytes(num_strings);
+  for (int i = 0; i < num_strings; ++i) {
+    proxy_bytes[i] = string_dict_proxy.getStringBytes(i);
+  }
+  for (int i = 0; i < num_strings; ++i) {
+    ASSERT_EQ(proxy_bytes[i], string_dict_proxy.getStringBytes(i));
+    ASSERT_EQ(strings[i], std::string(proxy_bytes[i].first, proxy_bytes[i].second));
+  }
+
+  // Concurrent decoding through the dictionary and the proxy.
+  constexpr int num_threads{8};
+  std::vector<std::thread> threads;
+  std::atomic<int> mismatches{0};
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t] {
+      std::string thread_buffer;
+      for (int i = 0; i < num_strings; ++i) {
+        const int id = (i * (t + 1) + t) % num_strings;
+        const auto dict_bytes = string_dict->getStringBytes(id, thread_buffer);
+        const auto bytes = string_dict_proxy.getStringBytes(id);
+        if (strings[id] != std::string(dict_bytes.first, dict_bytes.second) ||
+            bytes != proxy_bytes[id]) {
+          ++mismatches;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(mismatches.load(), 0);
+
+  // Uncompressed payload is returned without decoding.
+  StringDictionary raw_dict(dict_ref, g_cache_string_hash);
+  raw_dict.getOrAddBulk(strings, string_ids.data());
+  ASSERT_FALSE(raw_dict.isPayloadCompressed());
+  const auto raw_bytes = raw_dict.getStringBytes(7, decode_buffer);
+  ASSERT_NE(raw_bytes.first, decode_buffer.data());
+  ASSERT_EQ(strings[7], std::string(raw_bytes.first, raw_bytes.second));
+}
+
+TEST(StringDictionary, CompressedPayloadTranslationMap) {
+  const DictRef dict_ref1(-1, 1);
+  const DictRef dict_ref2(-1, 2);
+  auto source_string_dict =
+      std::make_shared<StringDictionary>(dict_ref1, g_cache_string_hash);
+  auto dest_string_dict =
+      std::make_shared<StringDictionary>(dict_ref2, g_cache_string_hash);
+  source_string_dict->enablePayloadCompression(1000);
+
+  constexpr int num_strings{10000};
+  std::vector<std::string> strings;
+  for (int i = 0; i < num_strings; ++i) {
+    strings.emplace_back(make_url(i));
+  }
+  std::vector<int32_t> string_ids(num_strings);
+  source_string_dict->getOrAddBulk(strings, string_ids.data());
+  ASSERT_TRUE(source_string_dict->isPayloadCompressed());
+
+  // Destination holds every other string in reversed order.
+  std::vector<std::string> dest_strings;
+  for (int i = num_strings - 1; i >= 0; i -= 2) {
+    dest_strings.emplace_back(strings[i]);
+  }
+  std::vector<int32_t> dest_string_ids(dest_strings.size());
+  dest_string_dict->getOrAddBulk(dest_strings, dest_string_ids.data());
+
+  auto dummy_callback = [](const std::string_view& source_string,
+                           const int32_t source_string_id) { return false; };
+  const auto translated_ids =
+      source_string_dict->buildDictionaryTranslationMap(dest_string_dict, dummy_callback);
+  ASSERT_EQ(translated_ids.size(), static_cast<size_t>(num_strings));
+  for (int i = 0; i < num_strings; ++i) {
+    if (i % 2) {
+      ASSERT_EQ(translated_ids[i], (num_strings - 1 - i) / 2);
+    } else {
+      ASSERT_EQ(translated_ids[i], StringDictionary::INVALID_STR_ID);
+    }
+  }
+
+  // Compress the destination too and translate back.
+  dest_string_dict->enablePayloadCompression(1);
+  ASSERT_TRUE(dest_string_dict->isPayloadCompressed());
+  const auto reverse_translated_ids =
+      dest_string_dict->buildDictionaryTranslationMap(source_string_dict, dummy_callback);
+  for (size_t i = 0; i < dest_strings.size(); ++i) {
+    ASSERT_EQ(reverse_translated_ids[i], num_strings - 1 - 2 * static_cast<int>(i));
+  }
+}
+
+TEST(StringDictionary, PatternCacheGrowth) {
+  const DictRef dict_ref(-1, 1);
+  StringDictionary string_dict(dict_ref, g_cache_string_hash);
+  auto expected_ids = [](size_t generation, int mod) {
+    std::vector<int32_t> ids;
+    for (size_t i = 0; i < generation; ++i) {
+      if (i % 17 == size_t(mod)) {
+        ids.push_back(i);
+      }
+    }
+    return ids;
+  };
+  auto sorted = [](std::vector<int32_t> ids) {
+    std::sort(ids.begin(), ids.end());
+    return ids;
+  };
+
+  // Results must match the requested generation while cached entries are extended
+  // with new strings, including when the cache is too small to hold anything.
+  for (const size_t budget : {StringDictionary::DEFAULT_PATTERN_CACHE_BUDGET, 0UL}) {
+    string_dict.setPatternCacheBudget(budget);
+    for (int batch = 0; batch < 3; ++batch) {
+      const int first = string_dict.storageEntryCount();
+      for (int i = first; i < first + 1000; ++i) {
+        string_dict.getOrAdd(make_url(i));
+      }
+      const size_t generation = string_dict.storageEntryCount();
+      for (const size_t gen : {generation, generation / 2}) {
+        ASSERT_EQ(sorted(string_dict.getLike("category_3/", false, true, '\\', gen)),
+                  expected_ids(gen, 3));
+        ASSERT_EQ(sorted(string_dict.getRegexpLike(".*category_5/.*", '\\', gen)),
+                  expected_ids(gen, 5));
+      }
+    }
+  }
+}
+
+TEST(StringDictionary, Snapshot) {
+  const auto snapshot_path =
+      (boost::filesystem::temp_directory_path() /
+       boost::filesystem::unique_path("dict_snapshot_%%%%-%%%%-%%%%.bin"))
+          .string();
+  const DictRef dict_ref(-1, 1);
+  for (const bool compress : {false, true}) {
+    StringDictionary string_dict(dict_ref, g_cache_string_hash);
+    if (compress) {
+      string_dict.enablePayloadCompression(1000);
+    }
+    constexpr int num_strings = 5000;
+    std::vector<std::string> strings;
+    for (int i = 0; i < num_strings; ++i) {
+      strings.push_back(make_url(i));
+    }
+    std::vector<int32_t> string_ids(num_strings);
+    string_dict.getOrAddBulk(strings, string_ids.data());
+    ASSERT_EQ(string_dict.isPayloadCompressed(), compress);
+    string_dict.saveSnapshot(snapshot_path);
+
+    // Load with and without hash materialization to cover both stored and
+    // recomputed hashes.
+    for (const bool materialize_hashes : {false, true}) {
+      auto loaded_dict =
+          StringDictionary::loadSnapshot(dict_ref, snapshot_path, materialize_hashes);
+      ASSERT_EQ(loaded_dict->storageEntryCount(), static_cast<size_t>(num_strings));
+      ASSERT_EQ(loaded_dict->isPayloadCompressed(), compress);
+      for (int i = 0; i < num_strings; ++i) {
+        ASSERT_EQ(loaded_dict->getString(string_ids[i]), strings[i]);
+        ASSERT_EQ(loaded_dict->getIdOfString(strings[i]), string_ids[i]);
+      }
+      // Loaded dictionary keeps growing from where the snapshot stopped.
+      ASSERT_EQ(loaded_dict->getOrAdd(make_url(0)), string_ids[0]);
+      ASSERT_EQ(loaded_dict->getOrAdd("new string"), num_strings);
+      for (int i = num_strings; i < 2 * num_strings; ++i) {
+        ASSERT_EQ(loaded_dict->getOrAdd(make_url(i)), i + 1);
+      }
+      ASSERT_EQ(loaded_dict->getIdOfString(make_url(num_strings / 2)),
+                string_ids[num_strings / 2]);
+      ASSERT_EQ(loaded_dict->getString(num_strings), "new string");
+    }
+  }
+
+  {
+    std::ofstream out(snapshot_path, std::ios::binary | std::ios::trunc);
+    out << "not a dictionary snapshot";
+  }
+  EXPECT_THROW(StringDictionary::loadSnapshot(dict_ref, snapshot_path),
+               std::runtime_error);
+  boost::filesystem::remove(snapshot_path);
+  EXPECT_THROW(StringDictionary::loadSnapshot(dict_ref, snapshot_path),
+               std::runtime_error);
+}
+
+TEST(StringDictionary, CorruptedSnapshot) {
+  const auto snapshot_path =
+      (boost::filesystem::temp_directory_path() /
+       boost::filesystem::unique_path("dict_snapshot_%%%%-%%%%-%%%%.bin"))
+          .string();
+  const DictRef dict_ref(-1, 1);
+  constexpr int num_strings = 50;
+  {
+    // Stored hashes allow to check positions of strings in the hash table.
+    StringDictionary string_dict(dict_ref, /*materializeHashes=*/true);
+    for (int i = 0; i < num_strings; ++i) {
+      string_dict.getOrAdd(make_url(i));
+    }
+    string_dict.saveSnapshot(snapshot_path);
+  }
+  std::string valid_data;
+  {
+    std::ifstream in(snapshot_path, std::ios::binary);
+    valid_data.assign(std::istreambuf_iterator<char>(in),
+                      std::istreambuf_iterator<char>());
+  }
+
+  // Offsets of header fields.
+  constexpr size_t kStrCountOff = 16;
+  constexpr size_t kOffsetsSizeOff = 32;
+  constexpr size_t kHashTableOff = 56;
+  constexpr size_t kHashTableSizeOff = 64;
+  constexpr size_t kHashCacheSizeOff = 80;
+  auto read_u64 = [](const std::string& data, size_t off) {
+    uint64_t val;
+    memcpy(&val, data.data() + off, sizeof(val));
+    return val;
+  };
+  auto write_u64 = [](std::string& data, size_t off, uint64_t val) {
+    memcpy(data.data() + off, &val, sizeof(val));
+  };
+  const auto hash_table_off = read_u64(valid_data, kHashTableOff);
+  const auto hash_table_size = read_u64(valid_data, kHashTableSizeOff) / sizeof(int32_t);
+  ASSERT_EQ(read_u64(valid_data, kStrCountOff), static_cast<uint64_t>(num_strings));
+  auto bucket_ptr = [hash_table_off](std::string& data, size_t bucket) {
+    return reinterpret_cast<int32_t*>(data.data() + hash_table_off) + bucket;
+  };
+  std::vector<size_t> used_buckets;
+  for (size_t bucket = 0; bucket < hash_table_size; ++bucket) {
+    if (*bucket_ptr(valid_data, bucket) != StringDictionary::INVALID_STR_ID) {
+      used_buckets.push_back(bucket);
+    }
+  }
+  ASSERT_EQ(used_buckets.size(), static_cast<size_t>(num_strings));
+
+  std::vector<std::pair<std::string, std::string>> corrupted_snapshots;
+  corrupted_snapshots.emplace_back("truncated", valid_data.substr(0, hash_table_off));
+  {
+    // The snapshot of an older state with strings which are still in the hash table.
+    auto data = valid_data;
+    write_u64(data, kStrCountOff, num_strings - 1);
+    write_u64(data, kOffsetsSizeOff, (num_strings - 1) * sizeof(uint64_t));
+    write_u64(data, kHashCacheSizeOff, (num_strings - 1) * sizeof(uint32_t));
+    corrupted_snapshots.emplace_back("stale string count", data);
+  }
+  {
+    auto data = valid_data;
+    *bucket_ptr(data, used_buckets[0]) = num_strings;
+    corrupted_snapshots.emplace_back("unknown string id", data);
+  }
+  {
+    auto data = valid_data;
+    *bucket_ptr(data, used_buckets[0]) = *bucket_ptr(data, used_buckets[1]);
+    corrupted_snapshots.emplace_back("duplicate string id", data);
+  }
+  {
+    auto data = valid_data;
+    *bucket_ptr(data, used_buckets[0]) = StringDictionary::INVALID_STR_ID;
+    corrupted_snapshots.emplace_back("missing string", data);
+  }
+  {
+    // Move a string to an empty bucket following another empty one, which is never
+    // reached by probing.
+    auto data = valid_data;
+    const auto string_id = *bucket_ptr(data, used_buckets[0]);
+    *bucket_ptr(data, used_buckets[0]) = StringDictionary::INVALID_STR_ID;
+    for (size_t bucket = 1; bucket < hash_table_size; ++bucket) {
+      if (*bucket_ptr(data, bucket) == StringDictionary::INVALID_STR_ID &&
+          *bucket_ptr(data, bucket - 1) == StringDictionary::INVALID_STR_ID &&
+          bucket != used_buckets[0] && bucket - 1 != used_buckets[0]) {
+        *bucket_ptr(data, bucket) = string_id;
+        break;
+      }
+    }
+    corrupted_snapshots.emplace_back("misplaced string", data);
+  }
+
+  for (const auto& [name, data] : corrupted_snapshots) {
+    SCOPED_TRACE(name);
+    {
+      std::ofstream out(snapshot_path, std::ios::binary | std::ios::trunc);
+      out.write(data.data(), data.size());
+    }
+    for (const bool materialize_hashes : {false, true}) {
+      EXPECT_THROW(
+          StringDictionary::loadSnapshot(dict_ref, snapshot_path, materialize_hashes),
+          std::runtime_error);
+    }
+  }
+  boost::filesystem::remove(snapshot_path);
+}
+
 TEST(StringDictionaryProxy, GetOrAddTransient) {
   const DictRef dict_ref(-1, 1);
   std::shared_ptr<StringDictionary> string_dict =
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ArrowSQLRunner/ArrowSQLRunner.h"
+
+#include "ArrowTestHelpers.h"
+#include "TestHelpers.h"
+
+#include "QueryEngine/CompilationContext.h"
+#include "QueryEngine/Compiler/Backend.h"
+
+#include <gtest/gtest.h>
+
+using ArrowTestHelpers::compare_res_data;
+using namespace TestHelpers::ArrowSQLRunner;
+
+// Queries run a kernel per fragment. Tier-up thresholds are captured when the code
+// is compiled, and compiled code is reused through the code caches, so every test uses
+// its own queries.
+
+namespace {
+
+constexpr size_t kFragmentSize = 2;
+constexpr int64_t kRows = 20;
+
+ExecutionResult runSqlQuery(const std::string& sql) {
+  return TestHelpers::ArrowSQLRunner::runSqlQuery(
+      sql, ExecutorDeviceType::CPU, /*allow_loop_joins=*/false);
+}
+
+}  // namespace
+
+class TieredCompilationTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    createTable(
+        "tier_test", {{"a", ctx().int32()}, {"b", ctx().int64()}}, {kFragmentSize});
+    std::string csv;
+    for (int64_t i = 1; i <= kRows; ++i) {
+      csv += std::to_string(i) + "," + std::to_string(i * 10) + "\n";
+    }
+    insertCsvValues("tier_test", csv);
+  }
+
+  static void TearDownTestSuite() { dropTable("tier_test"); }
+
+  void SetUp() override {
+    prev_codegen_config_ = config().exec.codegen;
+    config().exec.codegen.enable_tiered_compilation = true;
+  }
+
+  void TearDown() override { config().exec.codegen = prev_codegen_config_; }
+
+  CodegenConfig prev_codegen_config_;
+};
+
+TEST_F(TieredCompilationTest, RunCountPerQuery) {
+  config().exec.codegen.tier_up_run_count = 3;
+  config().exec.codegen.tier_up_run_time_ms = 1'000'000;
+  const std::string sql = "SELECT COUNT(*), SUM(b) FROM tier_test WHERE a > 4;";
+  const auto tier_up_count = CpuCompilationContext::getTierUpCount();
+  for (size_t run = 1; run <= 5; ++run) {
+    SCOPED_TRACE(run);
+    auto res = runSqlQuery(sql);
+    compare_res_data(res, std::vector<int64_t>({16}), std::vector<int64_t>({2000}));
+    // Kernels of all fragments share the code, but the query counts as a single run.
+    EXPECT_EQ(CpuCompilationContext::getTierUpCount(), tier_up_count + (run >= 3));
+  }
+}
+
+TEST_F(TieredCompilationTest, RunTime) {
+  config().exec.codegen.tier_up_run_count = 1'000;
+  config().exec.codegen.tier_up_run_time_ms = 0;
+  const std::string sql = "SELECT MIN(a), MAX(b) FROM tier_test WHERE b < 150;";
+  const auto tier_up_count = CpuCompilationContext::getTierUpCount();
+  for (size_t run = 1; run <= 3; ++run) {
+    SCOPED_TRACE(run);
+    auto res = runSqlQuery(sql);
+    compare_res_data(res, std::vector<int32_t>({1}), std::vector<int64_t>({140}));
+    // The first run is long enough, and the code is recompiled once.
+    EXPECT_EQ(CpuCompilationContext::getTierUpCount(), tier_up_count + 1);
+  }
+}
+
+TEST_F(TieredCompilationTest, Disabled) {
+  config().exec.codegen.enable_tiered_compilation = false;
+  config().exec.codegen.tier_up_run_count = 1;
+  config().exec.codegen.tier_up_run_time_ms = 0;
+  const auto tier_up_count = CpuCompilationContext::getTierUpCount();
+  auto res = runSqlQuery("SELECT COUNT(*) FROM tier_test WHERE b >= 100;");
+  compare_res_data(res, std::vector<int64_t>({11}));
+  EXPECT_EQ(CpuCompilationContext::getTierUpCount(), tier_up_count);
+}
+
+TEST_F(TieredCompilationTest, StopAndRestart) {
+  config().exec.codegen.tier_up_run_count = 1;
+  config().exec.codegen.tier_up_run_time_ms = 0;
+  const auto tier_up_count = CpuCompilationContext::getTierUpCount();
+  auto res = runSqlQuery("SELECT COUNT(*), MAX(a) FROM tier_test WHERE b > 30;");
+  compare_res_data(res, std::vector<int64_t>({17}), std::vector<int32_t>({20}));
+  EXPECT_EQ(CpuCompilationContext::getTierUpCount(), tier_up_count + 1);
+
+  // Stopping waits for the recompilation in progress and drops queued ones, the code
+  // stays usable either way.
+  compiler::stopTierUp();
+  res = runSqlQuery("SELECT COUNT(*), MAX(a) FROM tier_test WHERE b > 30;");
+  compare_res_data(res, std::vector<int64_t>({17}), std::vector<int32_t>({20}));
+
+  // New recompilations restart the worker.
+  res = runSqlQuery("SELECT COUNT(*), MIN(a) FROM tier_test WHERE b > 60;");
+  compare_res_data(res, std::vector<int64_t>({14}), std::vector<int32_t>({7}));
+  EXPECT_EQ(CpuCompilationContext::getTierUpCount(), tier_up_count + 2);
+  compiler::stopTierUp();
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  init();
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+    err = EINVAL;
+  }
+
+  reset();
+  return err;
+}
@@ -18,6 +18,7 @@
 #include "TestHelpers.h"
 #include "Utils/Regexp.h"
 #include "Utils/StringLike.h"
+#include "Utils/StringSearch.h"
 
 #include <gtest/gtest.h>
 
@@ -25,6 +26,7 @@
 #include <array>
 #include <atomic>
 #include <future>
+#include <random>
 
 // for (auto const interval : makeIntervals(0, M, n_workers)) {...}
 // iterates over interval={begin,end} pairs which satisfy:
@@ -159,6 +161,76 @@ TEST(Utils, StringLike) {
   ASSERT_TRUE(string_like("hello [", 7, "%\\[%", 4, '\\'));
 }
 
+TEST(Utils, StringLikeBrackets) {
+  // Character classes in patterns of fast path shapes must not be matched literally.
+  ASSERT_TRUE(string_like("xby", 3, "%[b]%", 5, '\\'));
+  ASSERT_FALSE(string_like("x[q]y", 5, "%[b]%", 5, '\\'));
+  ASSERT_TRUE(string_like("x[b]y", 5, "%[b]%", 5, '\\'));
+  ASSERT_TRUE(string_like("bcd", 3, "[ab]%", 5, '\\'));
+  ASSERT_FALSE(string_like("[ab]cd", 6, "[ab]%", 5, '\\'));
+  ASSERT_TRUE(string_like("xxa", 3, "%[ab]", 5, '\\'));
+  ASSERT_FALSE(string_like("xx[ab]", 6, "%[ab]", 5, '\\'));
+  ASSERT_TRUE(string_like("xyza", 4, "%y[xz]%", 7, '\\'));
+  ASSERT_FALSE(string_like("xya", 3, "%y[xz]%", 7, '\\'));
+  // ILIKE patterns are lowercased by the caller.
+  ASSERT_TRUE(string_ilike("XBY", 3, "%[b]%", 5, '\\'));
+  ASSERT_FALSE(string_ilike("X[Q]Y", 5, "%[b]%", 5, '\\'));
+  ASSERT_TRUE(string_ilike("Bcd", 3, "[ab]%", 5, '\\'));
+  ASSERT_TRUE(string_ilike("xxA", 3, "%[ab]", 5, '\\'));
+  ASSERT_FALSE(string_ilike("XX[AB]", 6, "%[ab]", 5, '\\'));
+}
+
+TEST(Utils, StringSearch) {
+  // Compare vectorized kernels with std::string search on strings long enough to
+  // cover both vector blocks and scalar tails, with matches at every position.
+  std::mt19937 rng(42);
+  auto lower = [](std::string str) {
+    std::transform(str.begin(), str.end(), str.begin(), ::tolower);
+    return str;
+  };
+  for (int iter = 0; iter < 2000; ++iter) {
+    std::string str(rng() % 100, ' ');
+    for (auto& c : str) {
+      c = "abAB%_"[rng() % 6];
+    }
+    const size_t pat_len = rng() % 6;
+    const size_t pat_pos = str.empty() ? 0 : rng() % str.size();
+    std::string pattern = lower(str.substr(pat_pos, pat_len));
+    if (rng() % 4 == 0) {
+      pattern += 'c';
+    }
+    for (const bool icase : {false, true}) {
+      const std::string haystack = icase ? lower(str) : str;
+      const bool contains = haystack.find(pattern) != std::string::npos;
+      const bool has_prefix = haystack.rfind(pattern, 0) == 0;
+      const bool has_suffix =
+          haystack.size() >= pattern.size() &&
+          haystack.compare(haystack.size() - pattern.size(), pattern.size(), pattern) ==
+              0;
+      ASSERT_EQ(string_contains(
+                    str.data(), str.size(), pattern.data(), pattern.size(), icase),
+                contains);
+      ASSERT_EQ(string_has_prefix(
+                    str.data(), str.size(), pattern.data(), pattern.size(), icase),
+                has_prefix);
+      ASSERT_EQ(string_has_suffix(
+                    str.data(), str.size(), pattern.data(), pattern.size(), icase),
+                has_suffix);
+    }
+  }
+
+  const std::string str = std::string(40, 'x') + "Needle" + std::string(40, 'y');
+  ASSERT_TRUE(string_like(str.data(), str.size(), "%Needle%", 8, '\\'));
+  ASSERT_FALSE(string_like(str.data(), str.size(), "%needle%", 8, '\\'));
+  ASSERT_TRUE(string_ilike(str.data(), str.size(), "%needle%", 8, '\\'));
+  ASSERT_TRUE(string_like(str.data(), str.size(), "xxx%", 4, '\\'));
+  ASSERT_FALSE(string_like(str.data(), str.size(), "yyy%", 4, '\\'));
+  ASSERT_TRUE(string_ilike(str.data(), str.size(), "%yyy", 4, '\\'));
+  ASSERT_FALSE(string_like(str.data(), str.size(), "%y\\%", 4, '\\'));
+  ASSERT_TRUE(string_like_simple(str.data(), str.size(), "Needle", 6));
+  ASSERT_TRUE(string_ilike_simple(str.data(), str.size(), "needle", 6));
+}
+
 TEST(Utils, Regexp) {
   ASSERT_TRUE(regexp_like("abc", 3, "abc", 3, '\\'));
   ASSERT_FALSE(regexp_like("abc", 3, "ABC", 3, '\\'));
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ArrowSQLRunner/ArrowSQLRunner.h"
+
+#include "ArrowTestHelpers.h"
+#include "TestHelpers.h"
+
+#include "ConfigBuilder/ConfigBuilder.h"
+#include "QueryEngine/RuntimeFunctions.h"
+#include "Shared/scope.h"
+
+#include <gtest/gtest.h>
+
+using ArrowTestHelpers::compareArrowTables;
+using ArrowTestHelpers::toArrow;
+using namespace TestHelpers::ArrowSQLRunner;
+
+// Compares results of the vectorized kernel with the ones of the generated code. The
+// plan code cache is disabled, so that each run compiles or interprets its own kernel.
+
+namespace {
+
+constexpr size_t kFragmentSize = 4;
+
+// Every 7th value of `a`, every 5th value of `b` and every 6th value of `c` is null.
+std::string makeRows(int64_t first, int64_t last) {
+  std::string csv;
+  for (int64_t i = first; i <= last; ++i) {
+    csv += (i % 7 ? std::to_string(i) : std::string()) + ",";
+    csv += (i % 5 ? std::to_string(i * 10) : std::string()) + ",";
+    csv += (i % 6 ? std::to_string(i * 0.5) : std::string()) + ",";
+    csv += std::to_string(i % 4) + "\n";
+  }
+  return csv;
+}
+
+ExecutionResult runSqlQuery(const std::string& sql, const bool vectorized) {
+  config().exec.codegen.enable_vectorized_interpreter = vectorized;
+  return TestHelpers::ArrowSQLRunner::runSqlQuery(
+      sql, ExecutorDeviceType::CPU, /*allow_loop_joins=*/false);
+}
+
+void checkQuery(const std::string& sql) {
+  SCOPED_TRACE(sql);
+  auto expected = runSqlQuery(sql, /*vectorized=*/false);
+  auto actual = runSqlQuery(sql, /*vectorized=*/true);
+  compareArrowTables(toArrow(expected), toArrow(actual));
+}
+
+void checkQueries() {
+  // Aggregates without group by.
+  checkQuery("SELECT COUNT(*), SUM(b), MIN(a), MAX(c), AVG(b) FROM vec_test;");
+  checkQuery("SELECT COUNT(a), COUNT(c), SUM(c) FROM vec_test WHERE b > 50;");
+  checkQuery("SELECT COUNT(*) FROM vec_test WHERE a IS NULL;");
+  checkQuery("SELECT COUNT(*), SUM(a) FROM vec_test WHERE c IS NOT NULL AND d = 1;");
+  checkQuery("SELECT COUNT(*), MIN(b) FROM vec_test WHERE a > 1000;");
+  // Group by.
+  checkQuery("SELECT d, COUNT(*), SUM(b), MAX(a) FROM vec_test GROUP BY d ORDER BY d;");
+  checkQuery(
+      "SELECT a, COUNT(*), AVG(c) FROM vec_test WHERE b < 200 GROUP BY a ORDER BY a;");
+  // Projections across fragments.
+  checkQuery("SELECT a, b, c, d FROM vec_test ORDER BY b, a;");
+  checkQuery("SELECT a, c FROM vec_test WHERE d <> 2 AND a < 20 ORDER BY a, c;");
+  checkQuery("SELECT b FROM vec_test WHERE a IS NULL ORDER BY b;");
+  // The rowid is computed from the fragment row offsets.
+  checkQuery("SELECT rowid, a FROM vec_test ORDER BY rowid;");
+  checkQuery("SELECT rowid, b FROM vec_test WHERE rowid >= 5 AND d = 0 ORDER BY rowid;");
+  checkQuery("SELECT MIN(rowid), MAX(rowid), SUM(rowid) FROM vec_test WHERE b > 40;");
+  checkQuery(
+      "SELECT d, MIN(rowid), MAX(rowid) FROM vec_test WHERE a > 2 GROUP BY d "
+      "ORDER BY d;");
+}
+
+}  // namespace
+
+class VectorizedKernelTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    prev_enable_vectorized_interpreter_ =
+        config().exec.codegen.enable_vectorized_interpreter;
+    createTable("vec_test",
+                {{"a", ctx().int32()},
+                 {"b", ctx().int64()},
+                 {"c", ctx().fp64()},
+                 {"d", ctx().int16()}},
+                {kFragmentSize});
+    insertCsvValues("vec_test", makeRows(1, 30));
+  }
+
+  void TearDown() override {
+    config().exec.codegen.enable_vectorized_interpreter =
+        prev_enable_vectorized_interpreter_;
+    dropTable("vec_test");
+  }
+
+  bool prev_enable_vectorized_interpreter_;
+};
+
+TEST_F(VectorizedKernelTest, SameResults) {
+  checkQueries();
+}
+
+TEST_F(VectorizedKernelTest, AppendedData) {
+  // A partially filled fragment followed by new ones.
+  insertCsvValues("vec_test", makeRows(31, 45));
+  checkQueries();
+}
+
+TEST_F(VectorizedKernelTest, Interrupt) {
+  auto co = CompilationOptions::defaults(ExecutorDeviceType::CPU);
+  auto eo = ExecutionOptions::fromConfig(config());
+  eo.allow_runtime_query_interrupt = true;
+  const std::string sql = "SELECT COUNT(*), SUM(b) FROM vec_test WHERE a > 3;";
+  for (bool vectorized : {false, true}) {
+    SCOPED_TRACE(vectorized);
+    config().exec.codegen.enable_vectorized_interpreter = vectorized;
+    {
+      check_interrupt_init(static_cast<unsigned>(INT_ABORT));
+      ScopeGuard reset_interrupt = [] {
+        check_interrupt_init(static_cast<unsigned>(INT_RESET));
+      };
+      EXPECT_ANY_THROW(TestHelpers::ArrowSQLRunner::runSqlQuery(sql, co, eo));
+    }
+    auto res = TestHelpers::ArrowSQLRunner::runSqlQuery(sql, co, eo);
+    ArrowTestHelpers::compare_res_data(
+        res, std::vector<int64_t>({23}), std::vector<int64_t>({2840}));
+  }
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  ConfigBuilder builder;
+  builder.parseCommandLineArgs(argc, argv, true);
+  auto config = builder.config();
+  config->cache.enable_plan_code_cache = false;
+
+  init(config);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+    err = EINVAL;
+  }
+
+  reset();
+  return err;
+}
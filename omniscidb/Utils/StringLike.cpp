@@ -24,6 +24,12 @@
  **/
 
 #include "StringLike.h"
+#include "StringSearch.h"
+
+// Vectorized search kernels are only available on the host.
+#if !defined(__CUDACC__)
+#define HAVE_STRING_SEARCH_KERNELS
+#endif
 
 enum LikeStatus {
   kLIKE_TRUE,
@@ -44,6 +50,9 @@ extern "C" RUNTIME_EXPORT DEVICE bool string_like_simple(const char* str,
                                                          const int32_t str_len,
                                                          const char* pattern,
                                                          const int32_t pat_len) {
+#ifdef HAVE_STRING_SEARCH_KERNELS
+  return string_contains(str, str_len, pattern, pat_len, false);
+#else
   int i, j;
   int search_len = str_len - pat_len + 1;
   for (i = 0; i < search_len; ++i) {
@@ -54,12 +63,16 @@ extern "C" RUNTIME_EXPORT DEVICE bool string_like_simple(const char* str,
     }
   }
   return false;
+#endif
 }
 
 extern "C" RUNTIME_EXPORT DEVICE bool string_ilike_simple(const char* str,
                                                           const int32_t str_len,
                                                           const char* pattern,
                                                           const int32_t pat_len) {
+#ifdef HAVE_STRING_SEARCH_KERNELS
+  return string_contains(str, str_len, pattern, pat_len, true);
+#else
   int i, j;
   int search_len = str_len - pat_len + 1;
   for (i = 0; i < search_len; ++i) {
@@ -70,6 +83,7 @@ extern "C" RUNTIME_EXPORT DEVICE bool string_ilike_simple(const char* str,
     }
   }
   return false;
+#endif
 }
 
 #define STR_LIKE_SIMPLE_NULLABLE(base_func)                                              \
@@ -231,6 +245,44 @@ DEVICE static LikeStatus string_like_match(const char* str,
   return kLIKE_ABORT;
 }
 
+#ifdef HAVE_STRING_SEARCH_KERNELS
+
+// Matches patterns of 'foo%', '%foo' and '%foo%' shapes with search kernels. Returns
+// false if the pattern has some other shape, or a wildcard, escape or character class
+// ('[...]') in its body, and has to go through string_like_match.
+static bool string_like_fast_path(const char* str,
+                                  const int32_t str_len,
+                                  const char* pattern,
+                                  const int32_t pat_len,
+                                  const char escape_char,
+                                  const bool is_ilike,
+                                  bool& result) {
+  const bool leading_wildcard = pat_len > 0 && pattern[0] == '%';
+  const bool trailing_wildcard =
+      pat_len > (leading_wildcard ? 1 : 0) && pattern[pat_len - 1] == '%';
+  if ((!leading_wildcard && !trailing_wildcard) || escape_char == '%') {
+    return false;
+  }
+  const char* body = pattern + (leading_wildcard ? 1 : 0);
+  const int32_t body_len =
+      pat_len - (leading_wildcard ? 1 : 0) - (trailing_wildcard ? 1 : 0);
+  for (int32_t i = 0; i < body_len; ++i) {
+    if (body[i] == '%' || body[i] == '_' || body[i] == '[' || body[i] == escape_char) {
+      return false;
+    }
+  }
+  if (leading_wildcard && trailing_wildcard) {
+    result = string_contains(str, str_len, body, body_len, is_ilike);
+  } else if (leading_wildcard) {
+    result = string_has_suffix(str, str_len, body, body_len, is_ilike);
+  } else {
+    result = string_has_prefix(str, str_len, body, body_len, is_ilike);
+  }
+  return true;
+}
+
+#endif  // HAVE_STRING_SEARCH_KERNELS
+
 /*
  * @brief string_like performs the SQL LIKE and ILIKE operation
  * @param str string argument to be matched against pattern.  single-byte
@@ -248,6 +300,12 @@ extern "C" RUNTIME_EXPORT DEVICE bool string_like(const char* str,
                                                   const char* pattern,
                                                   const int32_t pat_len,
                                                   const char escape_char) {
+#ifdef HAVE_STRING_SEARCH_KERNELS
+  bool result;
+  if (string_like_fast_path(str, str_len, pattern, pat_len, escape_char, false, result)) {
+    return result;
+  }
+#endif
   // @TODO(wei/alex) add runtime error handling
   LikeStatus status =
       string_like_match(str, str_len, pattern, pat_len, escape_char, false);
@@ -259,6 +317,12 @@ extern "C" RUNTIME_EXPORT DEVICE bool string_ilike(const char* str,
                                                    const char* pattern,
                                                    const int32_t pat_len,
                                                    const char escape_char) {
+#ifdef HAVE_STRING_SEARCH_KERNELS
+  bool result;
+  if (string_like_fast_path(str, str_len, pattern, pat_len, escape_char, true, result)) {
+    return result;
+  }
+#endif
   // @TODO(wei/alex) add runtime error handling
   LikeStatus status =
       string_like_match(str, str_len, pattern, pat_len, escape_char, true);
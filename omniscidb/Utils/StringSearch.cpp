@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "StringSearch.h"
+
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define STRING_SEARCH_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using ContainsKernel = bool (*)(const char*, int32_t, const char*, int32_t, bool);
+using EqualsKernel = bool (*)(const char*, const char*, int32_t, bool);
+
+inline char lowercase(const char c) {
+  return ('A' <= c && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+bool equals_scalar(const char* str,
+                   const char* pattern,
+                   const int32_t len,
+                   const bool icase) {
+  if (!icase) {
+    return !memcmp(str, pattern, len);
+  }
+  for (int32_t i = 0; i < len; ++i) {
+    if (lowercase(str[i]) != pattern[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool contains_scalar(const char* str,
+                     const int32_t str_len,
+                     const char* pattern,
+                     const int32_t pat_len,
+                     const bool icase) {
+  for (int32_t i = 0; i + pat_len <= str_len; ++i) {
+    if (equals_scalar(str + i, pattern, pat_len, icase)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+#ifdef STRING_SEARCH_X86_SIMD
+
+// Both vector kernels use the approach described by Wojciech Mula in "SIMD-friendly
+// algorithms for substring searching": compare blocks of the string starting at
+// candidate positions with the first and the last pattern characters, then verify
+// the remaining candidates.
+
+__attribute__((target("avx2"))) inline __m256i lowercase_avx2(const __m256i v) {
+  const __m256i is_upper =
+      _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('A' - 1)),
+                       _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), v));
+  return _mm256_or_si256(v, _mm256_and_si256(is_upper, _mm256_set1_epi8(0x20)));
+}
+
+__attribute__((target("avx2"))) bool contains_avx2(const char* str,
+                                                   const int32_t str_len,
+                                                   const char* pattern,
+                                                   const int32_t pat_len,
+                                                   const bool icase) {
+  if (pat_len == 0 || pat_len > str_len) {
+    return pat_len == 0;
+  }
+  const __m256i first = _mm256_set1_epi8(pattern[0]);
+  const __m256i last = _mm256_set1_epi8(pattern[pat_len - 1]);
+  const int32_t num_positions = str_len - pat_len + 1;
+  int32_t i = 0;
+  for (; i + 32 <= num_positions; i += 32) {
+    __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str + i));
+    __m256i block_last =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str + i + pat_len - 1));
+    if (icase) {
+      block_first = lowercase_avx2(block_first);
+      block_last = lowercase_avx2(block_last);
+    }
+    uint32_t mask = _mm256_movemask_epi8(_mm256_and_si256(
+        _mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last)));
+    while (mask) {
+      if (equals_scalar(str + i + __builtin_ctz(mask), pattern, pat_len, icase)) {
+        return true;
+      }
+      mask &= mask - 1;
+    }
+  }
+  return contains_scalar(str + i, str_len - i, pattern, pat_len, icase);
+}
+
+__attribute__((target("avx2"))) bool equals_avx2(const char* str,
+                                                 const char* pattern,
+                                                 const int32_t len,
+                                                 const bool icase) {
+  if (!icase) {
+    return !memcmp(str, pattern, len);
+  }
+  int32_t i = 0;
+  for (; i + 32 <= len; i += 32) {
+    const __m256i block = lowercase_avx2(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str + i)));
+    const __m256i pattern_block =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pattern + i));
+    if (static_cast<uint32_t>(_mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(block, pattern_block))) != 0xffffffffU) {
+      return false;
+    }
+  }
+  return equals_scalar(str + i, pattern + i, len - i, icase);
+}
+
+__attribute__((target("sse4.2"))) inline __m128i lowercase_sse42(const __m128i v) {
+  const __m128i is_upper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+                                         _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+  return _mm_or_si128(v, _mm_and_si128(is_upper, _mm_set1_epi8(0x20)));
+}
+
+__attribute__((target("sse4.2"))) bool contains_sse42(const char* str,
+                                                      const int32_t str_len,
+                                                      const char* pattern,
+                                                      const int32_t pat_len,
+                                                      const bool icase) {
+  if (pat_len == 0 || pat_len > str_len) {
+    return pat_len == 0;
+  }
+  const __m128i first = _mm_set1_epi8(pattern[0]);
+  const __m128i last = _mm_set1_epi8(pattern[pat_len - 1]);
+  const int32_t num_positions = str_len - pat_len + 1;
+  int32_t i = 0;
+  for (; i + 16 <= num_positions; i += 16) {
+    __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+    __m128i block_last =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i + pat_len - 1));
+    if (icase) {
+      block_first = lowercase_sse42(block_first);
+      block_last = lowercase_sse42(block_last);
+    }
+    uint32_t mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first),
+                                                    _mm_cmpeq_epi8(last, block_last)));
+    while (mask) {
+      if (equals_scalar(str + i + __builtin_ctz(mask), pattern, pat_len, icase)) {
+        return true;
+      }
+      mask &= mask - 1;
+    }
+  }
+  return contains_scalar(str + i, str_len - i, pattern, pat_len, icase);
+}
+
+__attribute__((target("sse4.2"))) bool equals_sse42(const char* str,
+                                                   const char* pattern,
+                                                   const int32_t len,
+                                                   const bool icase) {
+  if (!icase) {
+    return !memcmp(str, pattern, len);
+  }
+  int32_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    const __m128i block =
+        lowercase_sse42(_mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i)));
+    const __m128i pattern_block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern + i));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(block, pattern_block)) != 0xffff) {
+      return false;
+    }
+  }
+  return equals_scalar(str + i, pattern + i, len - i, icase);
+}
+
+#endif  // STRING_SEARCH_X86_SIMD
+
+struct SearchKernels {
+  ContainsKernel contains;
+  EqualsKernel equals;
+};
+
+SearchKernels select_kernels() {
+#ifdef STRING_SEARCH_X86_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return {contains_avx2, equals_avx2};
+  }
+  if (__builtin_cpu_supports("sse4.2")) {
+    return {contains_sse42, equals_sse42};
+  }
+#endif
+  return {contains_scalar, equals_scalar};
+}
+
+const SearchKernels& get_kernels() {
+  static const SearchKernels kernels = select_kernels();
+  return kernels;
+}
+
+}  // namespace
+
+extern "C" RUNTIME_EXPORT bool string_contains(const char* str,
+                                               const int32_t str_len,
+                                               const char* pattern,
+                                               const int32_t pat_len,
+                                               const bool icase) {
+  return get_kernels().contains(str, str_len, pattern, pat_len, icase);
+}
+
+extern "C" RUNTIME_EXPORT bool string_has_prefix(const char* str,
+                                                 const int32_t str_len,
+                                                 const char* pattern,
+                                                 const int32_t pat_len,
+                                                 const bool icase) {
+  return pat_len <= str_len && get_kernels().equals(str, pattern, pat_len, icase);
+}
+
+extern "C" RUNTIME_EXPORT bool string_has_suffix(const char* str,
+                                                 const int32_t str_len,
+                                                 const char* pattern,
+                                                 const int32_t pat_len,
+                                                 const bool icase) {
+  return pat_len <= str_len &&
+         get_kernels().equals(str + str_len - pat_len, pattern, pat_len, icase);
+}
@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Substring, prefix and suffix search kernels used for the common LIKE shapes
+ * ('%foo%', 'foo%' and '%foo'). Kernels are vectorized with AVX2 or SSE4.2 depending
+ * on what the host CPU supports, the choice is made once at runtime. With icase set,
+ * str is lowercased (ASCII only) before the comparison and pattern is expected to be
+ * lowercase already, which matches ILIKE semantics.
+ *
+ * Kernels are host-only. They are exported to be callable from generated code.
+ */
+
+#pragma once
+
+#include "../Shared/funcannotations.h"
+
+#include <cstdint>
+
+extern "C" RUNTIME_EXPORT bool string_contains(const char* str,
+                                               const int32_t str_len,
+                                               const char* pattern,
+                                               const int32_t pat_len,
+                                               const bool icase);
+
+extern "C" RUNTIME_EXPORT bool string_has_prefix(const char* str,
+                                                 const int32_t str_len,
+                                                 const char* pattern,
+                                                 const int32_t pat_len,
+                                                 const bool icase);
+
+extern "C" RUNTIME_EXPORT bool string_has_suffix(const char* str,
+                                                 const int32_t str_len,
+                                                 const char* pattern,
+                                                 const int32_t pat_len,
+                                                 const bool icase);
@@ -627,6 +627,16 @@ cdef class QueryNode:
     res.scan = self._hdk.scan(res.table_name)
     return res
 
+  def run_async(self, **kwargs):
+    assert self._hdk is not None
+    cdef CQueryDag* c_dag = self.c_node.finalize().release()
+    dag = QueryDag()
+    dag.c_dag.reset(c_dag)
+    rel_alg_executor = RelAlgExecutor(self._hdk._executor, self._hdk._storage, self._hdk._data_mgr, dag=dag)
+    handle = rel_alg_executor.execute_async(**kwargs)
+    handle.hdk = self._hdk
+    return handle
+
   def finalize(self):
     cdef CQueryDag* c_dag = self.c_node.finalize().release()
     dag = QueryDag()
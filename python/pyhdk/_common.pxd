@@ -128,6 +128,7 @@ cdef extern from "omniscidb/Shared/Config.h":
   cdef cppclass CCpuSubTasksConfig "CpuSubTasksConfig":
     bool enable
     size_t sub_task_size
+    size_t sub_task_target_time_us
 
   cdef cppclass CJoinConfig "JoinConfig":
     bool allow_loop_joins
@@ -173,6 +174,16 @@ cdef extern from "omniscidb/Shared/Config.h":
     bool null_div_by_zero
     bool hoist_literals
     bool enable_filter_function
+    bool enable_tiered_compilation
+    size_t tier_up_run_count
+    size_t tier_up_run_time_ms
+    bool enable_vectorized_interpreter
+    size_t vectorized_interpreter_max_rows
+    size_t parallel_compilation_threads
+    bool enable_batch_codegen
+    size_t batch_codegen_size
+    bool enable_fragment_specialization
+    size_t fragment_specialization_max_variants
 
   cdef cppclass CExecutionConfig "ExecutionConfig":
     CWatchdogConfig watchdog
@@ -193,6 +204,12 @@ cdef extern from "omniscidb/Shared/Config.h":
     size_t override_gpu_grid_size
     bool cpu_only
     string initialize_with_gpu_vendor;
+    size_t calcite_workers
+    bool enable_concurrent_queries
+    bool fuse_shared_projections
+    size_t parallel_steps
+    size_t max_threads_per_query
+    size_t max_query_memory
 
   cdef cppclass CFilterPushdownConfig "FilterPushdownConfig":
     bool enable
@@ -205,6 +222,7 @@ cdef extern from "omniscidb/Shared/Config.h":
     bool from_table_reordering
     size_t constrained_by_in_threshold
     bool enable_left_join_filter_hoisting
+    bool enable_metadata_aggregates
 
   cdef cppclass CResultSetConfig "ResultSetConfig":
     bool enable_columnar_output
@@ -235,6 +253,12 @@ cdef extern from "omniscidb/Shared/Config.h":
     double gpu_fraction_code_cache_to_evict
     size_t dag_cache_size
     size_t code_cache_size
+    string code_cache_dir
+    bool enable_plan_code_cache
+    size_t dict_translation_cache_bytes
+    size_t dict_pattern_cache_bytes
+    size_t calcite_cache_size
+    size_t rel_alg_dag_cache_size
 
   cdef cppclass CDebugConfig "DebugConfig":
     string build_ra_cache
@@ -243,6 +267,7 @@ cdef extern from "omniscidb/Shared/Config.h":
 
   cdef cppclass CStorageConfig "StorageConfig":
     bool enable_lazy_dict_materialization
+    bool enable_dict_compression
 
   cdef cppclass CConfig "Config":
     CExecutionConfig exec
@@ -34,6 +34,7 @@ cdef extern from "omniscidb/QueryEngine/CompilationOptions.h":
   enum CExecutorOptLevel "ExecutorOptLevel":
     OptLevel_Default "ExecutorOptLevel::Default",
     ReductionJIT "ExecutorOptLevel::ReductionJIT",
+    FastJIT "ExecutorOptLevel::FastJIT",
 
   enum CExecutorExplainType "ExecutorExplainType":
     ExplainType_Default "ExecutorExplainType::Default",
@@ -68,6 +69,10 @@ cdef extern from "omniscidb/QueryEngine/CompilationOptions.h":
     Native "ExecutorType::Native",
     Extern "ExecutorType::Extern",
 
+  enum CQueryPriority "QueryPriority":
+    Interactive "QueryPriority::Interactive",
+    Batch "QueryPriority::Batch",
+
   cdef cppclass CExecutionOptions "ExecutionOptions":
     bool output_columnar_hint
     bool allow_multifrag
@@ -88,6 +93,8 @@ cdef extern from "omniscidb/QueryEngine/CompilationOptions.h":
     vector[size_t] outer_fragment_indices
     bool multifrag_result
     bool preserve_order
+    CQueryPriority priority
+    size_t max_threads
 
     @staticmethod
     CExecutionOptions fromConfig(const CConfig)
@@ -151,5 +158,8 @@ cdef extern from "omniscidb/QueryEngine/Execute.h":
     const CConfig &getConfig()
     shared_ptr[CConfig] getConfigPtr()
 
+cdef extern from "omniscidb/QueryEngine/Compiler/Backend.h" namespace "compiler":
+  void stopTierUp()
+
 cdef class Executor:
   cdef shared_ptr[CExecutor] c_executor
@@ -8,6 +8,14 @@ from libcpp.memory cimport shared_ptr, make_shared, static_pointer_cast
 from pyhdk._common cimport Config
 from pyhdk._storage cimport DataMgr, Storage, CAbstractBufferMgr, CSchemaProvider
 
+import atexit
+
+# Background recompilations have to be finished before LLVM is torn down at exit.
+def _stop_tier_up():
+  stopTierUp()
+
+atexit.register(_stop_tier_up)
+
 cdef class Executor:
   def __cinit__(self, DataMgr data_mgr, Config config):
     cdef string debug_dir = "".encode('UTF-8')
@@ -3,6 +3,7 @@
 #
 # SPDX-License-Identifier: Apache-2.0
 
+from libc.stdint cimport int64_t
 from libcpp cimport bool
 from libcpp.memory cimport shared_ptr, unique_ptr
 from libcpp.string cimport string
@@ -31,7 +32,7 @@ cdef extern from "omniscidb/Calcite/CalciteJNI.h":
 
   cdef cppclass CalciteMgr:    
     @staticmethod
-    CalciteMgr* get(const string&, size_t);
+    CalciteMgr* get(const string&, size_t, size_t, size_t);
     
     string process(const string&, const string&, CSchemaProvider*, CConfig*, const vector[FilterPushDownInfo]&, bool, bool, bool) except +
 
@@ -46,10 +47,52 @@ cdef extern from "omniscidb/IR/Node.h":
 cdef class QueryDag:
   cdef unique_ptr[CQueryDag] c_dag
 
+cdef extern from "omniscidb/QueryEngine/PreparedQuery.h":
+  cdef cppclass CQueryParameter "hdk::QueryParameter":
+    CQueryParameter()
+
+    @staticmethod
+    CQueryParameter null()
+    @staticmethod
+    CQueryParameter boolean(bool)
+    @staticmethod
+    CQueryParameter integer(int64_t)
+    @staticmethod
+    CQueryParameter fp(double)
+    @staticmethod
+    CQueryParameter string(string)
+
+  cdef cppclass CPreparedQuery "hdk::PreparedQuery":
+    CPreparedQuery(string)
+
+    const string& sql()
+    size_t parameterCount()
+    bool needsTemplate(const vector[CQueryParameter]&) except +
+    string templateSql(const vector[CQueryParameter]&) except +
+    void addTemplate(const vector[CQueryParameter]&, const string&) except +
+    void addUnusableTemplate(const vector[CQueryParameter]&) except +
+    unique_ptr[CQueryDag] bind(const vector[CQueryParameter]&, int, CSchemaProviderPtr, shared_ptr[CConfig]) except +
+    string literalSql(const vector[CQueryParameter]&) except +
+
+cdef class PreparedQuery:
+  cdef shared_ptr[CPreparedQuery] c_query
+
 cdef extern from "omniscidb/QueryEngine/RelAlgDagBuilder.h":
   cdef cppclass CRelAlgDagBuilder "RelAlgDagBuilder"(CQueryDag):
     CRelAlgDagBuilder(const string&, int, CSchemaProviderPtr, shared_ptr[CConfig]) except +
 
+cdef extern from "omniscidb/Shared/QueryMemoryTracker.h":
+  enum CQueryMemoryCategory "hdk::QueryMemoryCategory":
+    ResultBuffers "hdk::QueryMemoryCategory::kResultBuffers",
+    InputChunks "hdk::QueryMemoryCategory::kInputChunks",
+    LinearizedColumns "hdk::QueryMemoryCategory::kLinearizedColumns",
+    HashTables "hdk::QueryMemoryCategory::kHashTables",
+
+  cdef cppclass CQueryMemoryStats "hdk::QueryMemoryStats":
+    size_t total_peak_bytes
+
+    size_t peak(CQueryMemoryCategory)
+
 cdef extern from "omniscidb/QueryEngine/Descriptors/RelAlgExecutionDescriptor.h":
   cdef cppclass CExecutionResult "ExecutionResult":
     CExecutionResult()
@@ -60,6 +103,7 @@ cdef extern from "omniscidb/QueryEngine/Descriptors/RelAlgExecutionDescriptor.h"
     const vector[CTargetMetaInfo]& getTargetsMeta()
     string getExplanation()
     const string& tableName()
+    const CQueryMemoryStats& getMemoryStats()
 
     CExecutionResult head(size_t) except +
     CExecutionResult tail(size_t) except +
@@ -80,10 +124,34 @@ cdef extern from "omniscidb/QueryEngine/RelAlgExecutor.h":
   cdef cppclass CRelAlgExecutor "RelAlgExecutor":
     CRelAlgExecutor(CExecutor*, CSchemaProviderPtr, unique_ptr[CQueryDag])
 
-    CExecutionResult executeRelAlgQuery(const CCompilationOptions&, const CExecutionOptions&, const bool) except +
+    CExecutionResult executeRelAlgQuery(const CCompilationOptions&, const CExecutionOptions&, const bool) nogil except +
     CExecutor *getExecutor()
 
 cdef class RelAlgExecutor:
   cdef shared_ptr[CRelAlgExecutor] c_rel_alg_executor
   # DataMgr is used only to pass it to each produced ExecutionResult
   cdef shared_ptr[CDataMgr] c_data_mgr
+
+  cdef CCompilationOptions _compilation_options(self, kwargs) except *
+  cdef shared_ptr[CExecutionOptions] _execution_options(self, kwargs) except *
+
+cdef extern from "omniscidb/QueryEngine/QueryHandle.h":
+  cdef cppclass CQueryHandle "hdk::QueryHandle":
+    @staticmethod
+    shared_ptr[CQueryHandle] start(shared_ptr[CRelAlgExecutor], const CCompilationOptions&, const CExecutionOptions&) except +
+
+    bool poll()
+    bool waitFor(size_t) nogil
+    const CExecutionResult& wait() nogil except +
+    void cancel()
+    bool isCancelled()
+    size_t totalFragments()
+    size_t completedFragments()
+    size_t skippedFragments()
+
+cdef class QueryHandle:
+  cdef shared_ptr[CQueryHandle] c_handle
+  # DataMgr is used only to pass it to the produced ExecutionResult
+  cdef shared_ptr[CDataMgr] c_data_mgr
+  # HDK object is used to provide a scan for the produced ExecutionResult
+  cdef object _hdk
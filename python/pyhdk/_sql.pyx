@@ -13,7 +13,7 @@ from pyarrow.lib cimport CTable as CArrowTable
 
 from pyhdk._common cimport CConfig, Config, boost_get, CType, CArrayBaseType
 from pyhdk._storage cimport SchemaProvider, CDataMgr, DataMgr
-from pyhdk._execute cimport Executor, CExecutorDeviceType, CArrowResultSetConverter, CResultSet
+from pyhdk._execute cimport Executor, CExecutorDeviceType, CArrowResultSetConverter, CResultSet, CQueryPriority
 from pyhdk._execute cimport CNullableString, CScalarTargetValue, CArrayTargetValue, CTargetValue, isNull
 from pyhdk._execute cimport isNull, isInt, getInt, isFloat, getFloat, isDouble, getDouble, isString, getString
 
@@ -26,7 +26,9 @@ cdef class Calcite:
     cdef string udf_filename = kwargs.get("udf_filename", "")
     cdef size_t calcite_max_mem_mb = kwargs.get("calcite_max_mem_mb", 1024)
 
-    self.calcite = CalciteMgr.get(udf_filename, calcite_max_mem_mb)
+    cdef const CConfig *c_config = config.c_config.get()
+
+    self.calcite = CalciteMgr.get(udf_filename, calcite_max_mem_mb, c_config.exec.calcite_workers, c_config.cache.calcite_cache_size)
     self.schema_provider = schema_provider.c_schema_provider
     self.config = config.c_config
 
@@ -105,6 +107,17 @@ cdef class ExecutionResult:
   def table_name(self):
     return self.c_result.tableName()
 
+  @property
+  def memory_stats(self):
+    cdef CQueryMemoryStats stats = self.c_result.getMemoryStats()
+    return {
+      "result_buffers": stats.peak(ResultBuffers),
+      "input_chunks": stats.peak(InputChunks),
+      "linearized_columns": stats.peak(LinearizedColumns),
+      "hash_tables": stats.peak(HashTables),
+      "total": stats.total_peak_bytes,
+    }
+
   @property
   def scan(self):
     return self._scan
@@ -172,20 +185,78 @@ cdef class ExecutionResult:
   def __getitem__(self, col):
     return self._scan.__getitem__(col)
 
+def default_db_id(SchemaProvider schema_provider):
+  # Choose the default database ID. Ignore ResultSetRegistry.
+  db_ids = schema_provider.listDatabases()
+  assert len(db_ids) <= 2
+  if len(db_ids) == 1:
+    return db_ids[0]
+  elif len(db_ids) == 2:
+    return db_ids[1] if db_ids[0] == ((100 << 24) + 1) else db_ids[0]
+  return 0
+
+cdef vector[CQueryParameter] to_query_parameters(params) except *:
+  cdef vector[CQueryParameter] res
+  for param in params:
+    if param is None:
+      res.push_back(CQueryParameter.null())
+    elif isinstance(param, bool):
+      res.push_back(CQueryParameter.boolean(param))
+    elif isinstance(param, int):
+      res.push_back(CQueryParameter.integer(param))
+    elif isinstance(param, float):
+      res.push_back(CQueryParameter.fp(param))
+    elif isinstance(param, str):
+      res.push_back(CQueryParameter.string(param))
+    else:
+      raise TypeError(f"Unsupported query parameter type: {type(param)}.")
+  return res
+
+cdef class PreparedQuery:
+  def __cinit__(self, string sql):
+    self.c_query = make_shared[CPreparedQuery](sql)
+
+  @property
+  def sql(self):
+    return self.c_query.get().sql()
+
+  @property
+  def parameter_count(self):
+    return self.c_query.get().parameterCount()
+
+  def bind(self, params, Calcite calcite, SchemaProvider schema_provider):
+    """
+    Build a query DAG with the specified parameter values. SQL is translated
+    by Calcite only on the first use of a combination of parameter types.
+    """
+    cdef vector[CQueryParameter] c_params = to_query_parameters(params)
+    cdef int db_id = default_db_id(schema_provider)
+    if self.c_query.get().needsTemplate(c_params):
+      # Markers might make the SQL invalid, in this case SQL with parameter values
+      # is translated for these parameter types.
+      try:
+        ra = calcite.process(self.c_query.get().templateSql(c_params))
+        self.c_query.get().addTemplate(c_params, ra)
+      except Exception:
+        self.c_query.get().addUnusableTemplate(c_params)
+
+    # Cannot assign unique_ptr here because Cython uses additional
+    # intermediate variable and copy assignment for that. Use
+    # release + reset instead.
+    cdef CQueryDag* c_dag = self.c_query.get().bind(c_params, db_id, schema_provider.c_schema_provider, calcite.config).release()
+    if c_dag == NULL:
+      ra = calcite.process(self.c_query.get().literalSql(c_params))
+      c_dag = new CRelAlgDagBuilder(ra, db_id, schema_provider.c_schema_provider, calcite.config)
+    dag = QueryDag()
+    dag.c_dag.reset(c_dag)
+    return dag
+
 cdef class RelAlgExecutor:
   def __cinit__(self, Executor executor, SchemaProvider schema_provider, DataMgr data_mgr, ra_json=None, QueryDag dag=None):
     cdef CExecutor* c_executor = executor.c_executor.get()
     cdef CSchemaProviderPtr c_schema_provider = schema_provider.c_schema_provider
     cdef unique_ptr[CQueryDag] c_dag
-    cdef int db_id = 0
-
-    # Choose the default database ID. Ignore ResultSetRegistry.
-    db_ids = schema_provider.listDatabases()
-    assert len(db_ids) <= 2
-    if len(db_ids) == 1:
-      db_id = db_ids[0]
-    elif len(db_ids) == 2:
-      db_id = db_ids[1] if db_ids[0] == ((100 << 24) + 1) else db_ids[0]
+    cdef int db_id = default_db_id(schema_provider)
 
     if ra_json is not None:
       c_dag.reset(new CRelAlgDagBuilder(ra_json, db_id, c_schema_provider, c_executor.getConfigPtr()))
@@ -196,7 +267,7 @@ cdef class RelAlgExecutor:
     self.c_rel_alg_executor = make_shared[CRelAlgExecutor](c_executor, c_schema_provider, move(c_dag))
     self.c_data_mgr = data_mgr.c_data_mgr
 
-  def execute(self, **kwargs):
+  cdef CCompilationOptions _compilation_options(self, kwargs) except *:
     cdef const CConfig *config = self.c_rel_alg_executor.get().getExecutor().getConfigPtr().get()
     cdef CCompilationOptions c_co
     if kwargs.get("device_type", "auto") == "GPU" and not config.exec.cpu_only:
@@ -205,13 +276,117 @@ cdef class RelAlgExecutor:
       c_co = CCompilationOptions.defaults(CExecutorDeviceType.CPU, False)
     c_co.allow_lazy_fetch = kwargs.get("enable_lazy_fetch", config.rs.enable_lazy_fetch)
     c_co.with_dynamic_watchdog = kwargs.get("enable_dynamic_watchdog", config.exec.watchdog.enable_dynamic)
-    cdef unique_ptr[CExecutionOptions] c_eo = make_unique[CExecutionOptions](CExecutionOptions.fromConfig(dereference(config)))
+    return c_co
+
+  cdef shared_ptr[CExecutionOptions] _execution_options(self, kwargs) except *:
+    cdef const CConfig *config = self.c_rel_alg_executor.get().getExecutor().getConfigPtr().get()
+    cdef shared_ptr[CExecutionOptions] c_eo = make_shared[CExecutionOptions](CExecutionOptions.fromConfig(dereference(config)))
     c_eo.get().output_columnar_hint = kwargs.get("enable_columnar_output", config.rs.enable_columnar_output)
     c_eo.get().with_watchdog = kwargs.get("enable_watchdog", config.exec.watchdog.enable)
     c_eo.get().with_dynamic_watchdog = kwargs.get("enable_dynamic_watchdog", config.exec.watchdog.enable_dynamic)
     c_eo.get().just_explain = kwargs.get("just_explain", False)
-    cdef CExecutionResult c_res = self.c_rel_alg_executor.get().executeRelAlgQuery(c_co, dereference(c_eo.get()), False)
+    if kwargs.get("priority", "interactive").lower() == "batch":
+      c_eo.get().priority = CQueryPriority.Batch
+    c_eo.get().max_threads = kwargs.get("max_threads", config.exec.max_threads_per_query)
+    return c_eo
+
+  def execute(self, **kwargs):
+    cdef CCompilationOptions c_co = self._compilation_options(kwargs)
+    cdef shared_ptr[CExecutionOptions] c_eo = self._execution_options(kwargs)
+    cdef CRelAlgExecutor *c_rel_alg_executor = self.c_rel_alg_executor.get()
+    cdef CExecutionResult c_res
+    # Release GIL to allow other Python threads to run while the query is executed.
+    with nogil:
+      c_res = c_rel_alg_executor.executeRelAlgQuery(c_co, dereference(c_eo.get()), False)
     cdef ExecutionResult res = ExecutionResult()
     res.c_result = move(c_res)
     res.c_data_mgr = self.c_data_mgr
     return res
+
+  def execute_async(self, **kwargs):
+    """
+    Start the query execution in a separate thread. Return QueryHandle to wait
+    for the result, track progress and cancel the query.
+    """
+    cdef CCompilationOptions c_co = self._compilation_options(kwargs)
+    cdef shared_ptr[CExecutionOptions] c_eo = self._execution_options(kwargs)
+    cdef QueryHandle handle = QueryHandle()
+    handle.c_handle = CQueryHandle.start(self.c_rel_alg_executor, c_co, dereference(c_eo.get()))
+    handle.c_data_mgr = self.c_data_mgr
+    return handle
+
+cdef class QueryHandle:
+  def poll(self):
+    """
+    Return True if the query is finished.
+    """
+    return self.c_handle.get().poll()
+
+  def wait(self, timeout=None):
+    """
+    Wait for the query completion and return its result. Raise TimeoutError if
+    the query is not finished in `timeout` seconds.
+    """
+    cdef CQueryHandle *c_handle = self.c_handle.get()
+    cdef size_t timeout_ms
+    cdef bool finished
+    if timeout is not None:
+      timeout_ms = int(timeout * 1000)
+      with nogil:
+        finished = c_handle.waitFor(timeout_ms)
+      if not finished:
+        raise TimeoutError("Query is not finished in {} seconds.".format(timeout))
+    cdef CExecutionResult c_res
+    with nogil:
+      c_res = c_handle.wait()
+    cdef ExecutionResult res = ExecutionResult()
+    res.c_result = move(c_res)
+    res.c_data_mgr = self.c_data_mgr
+    if self._hdk is not None:
+      res.scan = self._hdk.scan(res.table_name)
+    return res
+
+  def cancel(self):
+    """
+    Request the query cancellation. The cancelled query fails with the
+    interruption error unless it finishes before the request is noticed.
+    """
+    self.c_handle.get().cancel()
+
+  @property
+  def hdk(self):
+    return self._hdk
+
+  @hdk.setter
+  def hdk(self, val):
+    self._hdk = val
+
+  @property
+  def cancelled(self):
+    return self.c_handle.get().isCancelled()
+
+  @property
+  def total_fragments(self):
+    return self.c_handle.get().totalFragments()
+
+  @property
+  def completed_fragments(self):
+    return self.c_handle.get().completedFragments()
+
+  @property
+  def skipped_fragments(self):
+    """
+    Fragments not processed because a projection with LIMIT had already
+    collected enough rows. Fragments are skipped by whole execution kernels,
+    and skipped fragments are included into completed ones.
+    """
+    return self.c_handle.get().skippedFragments()
+
+  @property
+  def progress(self):
+    """
+    Fraction of fragments processed by the query. Fragments of a query step
+    are counted when the step starts.
+    """
+    total = self.total_fragments
+    return self.completed_fragments / total if total else 0.0
@@ -12,6 +12,7 @@ from pyhdk._storage import (
     SchemaMgr,
 )
 from pyhdk._sql import Calcite, RelAlgExecutor, ExecutionResult
+from pyhdk._sql import PreparedQuery as _PreparedQuery
 from pyhdk._execute import Executor, ResultSetRegistry
 from pyhdk._builder import QueryBuilder, QueryExpr, QueryNode
 
@@ -1555,6 +1556,29 @@ class QueryNodeAPI:
         """
         pass
 
+    def run_async(self):
+        """
+        Start query execution with the current node as a query root node in
+        a separate thread.
+
+        Returns
+        -------
+        QueryHandle
+            The handle to wait for the query result, check its progress and
+            cancel the query. Destroying the handle of a running query cancels
+            it.
+
+        Examples
+        --------
+        >>> hdk = pyhdk.init()
+        >>> ht = hdk.import_pydict({"a": [1, 2, 3], "b": [3, 2, 1]})
+        >>> handle = ht.proj(sum=ht["a"] + ht["b"]).run_async()
+        >>> handle.progress
+        0.0
+        >>> res = handle.wait()
+        """
+        pass
+
 
 class QueryOptions:
     def __init__(self, config):
@@ -1651,6 +1675,73 @@ class QueryOptions:
             )
         self._opts["device_type"] = value
 
+    @property
+    def priority(self):
+        return self._opts.get("priority", "interactive")
+
+    @priority.setter
+    def priority(self, value):
+        if value.lower() not in ("interactive", "batch"):
+            raise ValueError(
+                f"Expected 'interactive' or 'batch' query priority. Got: {value}."
+            )
+        self._opts["priority"] = value
+
+    @property
+    def max_threads(self):
+        return self._opts.get("max_threads", self._config.exec.max_threads_per_query)
+
+    @max_threads.setter
+    def max_threads(self, value):
+        if type(value) != type(1) or value < 0:
+            raise ValueError(
+                f"Expected non-negative int value for 'max_threads' option. Got: {value}."
+            )
+        self._opts["max_threads"] = value
+
+
+class PreparedQuery:
+    """
+    SQL query prepared for repeated execution with different parameter values.
+    Created by `HDK.prepare` method.
+    """
+
+    def __init__(self, hdk, sql_query):
+        self._hdk = hdk
+        self._query = _PreparedQuery(sql_query)
+
+    @property
+    def sql(self):
+        return self._query.sql
+
+    @property
+    def parameter_count(self):
+        return self._query.parameter_count
+
+    def execute(self, *params, query_opts=None):
+        """
+        Execute the query with specified parameter values.
+
+        Parameters
+        ----------
+        *params : list
+            Parameter values in the order of placeholders. Supported are None,
+            bool, int, float and str values.
+        query_opts : QueryOptions or dict, default: None
+            Query execution options.
+
+        Returns
+        -------
+        ExecutionResult
+            The result of query execution.
+        """
+        hdk = self._hdk
+        dag = self._query.bind(params, hdk._calcite, hdk._schema_mgr)
+        ra_executor = RelAlgExecutor(
+            hdk._executor, hdk._schema_mgr, hdk._data_mgr, dag=dag
+        )
+        return hdk._execute(ra_executor, query_opts)
+
 
 class HDK:
     def __init__(self, **kwargs):
@@ -2014,6 +2105,12 @@ class HDK:
         ExecutionResult
             The result of query execution.
 
+        Raises
+        ------
+        RuntimeError
+            If the query fails, e.g. when it exceeds the `max_query_memory` limit
+            passed to `pyhdk.init`.
+
         Examples
         --------
         >>> hdk = pyhdk.init()
@@ -2024,17 +2121,87 @@ class HDK:
         >>> test = hdk.import_csv("test.csv")
         >>> res = hdk.sql("SELCT type, count(*) FROM test GROUP BY type;", test=test)
         """
-        if query_opts is None:
-            query_opts = {}
-        elif isinstance(query_opts, QueryOptions):
-            query_opts = query_opts._opts
-        elif not isinstance(query_opts, dict):
-            raise TypeError(
-                f"Expected dict or QueryOptions for 'query_opts' arg. Got: {type(query_opts)}."
-            )
+        sql_query = self._add_table_aliases(sql_query, kwargs)
+        ra = self._calcite.process(sql_query)
+        ra_executor = RelAlgExecutor(
+            self._executor, self._schema_mgr, self._data_mgr, ra
+        )
+        return self._execute(ra_executor, query_opts)
 
+    def sql_async(self, sql_query, query_opts=None, **kwargs):
+        """
+        Start SQL query execution in a separate thread. GIL is released while
+        the query is running, so other Python threads are not blocked.
+
+        Parameters
+        ----------
+        sql_query : str
+            SQL query to execute.
+        query_opts : QueryOptions or dict, default: None
+            Query execution options.
+        **kwargs : dict
+            Table aliases for the query. Same as for `sql` method.
+
+        Returns
+        -------
+        QueryHandle
+            The handle to wait for the query result, check its progress and
+            cancel the query. Destroying the handle of a running query cancels
+            it.
+
+        Examples
+        --------
+        >>> hdk = pyhdk.init()
+        >>>
+        >>> hdk.import_csv("test.csv", "test")
+        >>> handle = hdk.sql_async("SELECT type, count(*) FROM test GROUP BY type;")
+        >>> while not handle.poll():
+        ...     print(f"{handle.progress:.0%}")
+        ...     time.sleep(1)
+        >>> res = handle.wait()
+        """
+        sql_query = self._add_table_aliases(sql_query, kwargs)
+        ra = self._calcite.process(sql_query)
+        ra_executor = RelAlgExecutor(
+            self._executor, self._schema_mgr, self._data_mgr, ra
+        )
+        handle = ra_executor.execute_async(**self._query_opts_dict(query_opts))
+        handle.hdk = self
+        return handle
+
+    def prepare(self, sql_query, **kwargs):
+        """
+        Prepare SQL query with '?' parameter placeholders for repeated execution.
+
+        The query is translated once for each combination of parameter types and
+        then executed with new parameter values without parsing and optimizing
+        SQL. Generated code is also reused between executions.
+
+        Parameters
+        ----------
+        sql_query : str
+            SQL query with parameter placeholders.
+        **kwargs : dict
+            Table aliases for the query. Same as for `sql` method.
+
+        Returns
+        -------
+        PreparedQuery
+
+        Examples
+        --------
+        >>> hdk = pyhdk.init()
+        >>>
+        >>> hdk.import_csv("test.csv", "test")
+        >>> query = hdk.prepare("SELECT count(*) FROM test WHERE id > ?;")
+        >>> res1 = query.execute(10)
+        >>> res2 = query.execute(20)
+        """
+        return PreparedQuery(self, self._add_table_aliases(sql_query, kwargs))
+
+    def _add_table_aliases(self, sql_query, aliases):
         parts = []
-        for name, orig_table in kwargs.items():
+        for name, orig_table in aliases.items():
             if (
                 isinstance(orig_table, (QueryNode, ExecutionResult))
                 and orig_table.is_scan
@@ -2051,12 +2218,21 @@ class HDK:
                 parts.append(", ")
             parts.append(f"{name} AS (SELECT * FROM {orig_table})\n")
 
-        sql_query = "".join(parts) + sql_query
-        ra = self._calcite.process(sql_query)
-        ra_executor = RelAlgExecutor(
-            self._executor, self._schema_mgr, self._data_mgr, ra
-        )
-        res = ra_executor.execute(**query_opts)
+        return "".join(parts) + sql_query
+
+    def _query_opts_dict(self, query_opts):
+        if query_opts is None:
+            return {}
+        elif isinstance(query_opts, QueryOptions):
+            return query_opts._opts
+        elif not isinstance(query_opts, dict):
+            raise TypeError(
+                f"Expected dict or QueryOptions for 'query_opts' arg. Got: {type(query_opts)}."
+            )
+        return query_opts
+
+    def _execute(self, ra_executor, query_opts):
+        res = ra_executor.execute(**self._query_opts_dict(query_opts))
         res.scan = self.scan(res.table_name)
         return res
 
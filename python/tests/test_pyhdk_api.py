@@ -1011,6 +1011,169 @@ class TestSql(BaseTest):
         res3 = hdk.sql(f"SELECT b - 1 as b, a + 1 as a FROM {res1.table_name};")
         check_res(res3, {"b": [4, 3, 2, 1, 0], "a": [2, 3, 4, 5, 6]})
 
+    def test_prepared(self):
+        hdk = pyhdk.init()
+        ht = hdk.import_pydict(
+            {
+                "a": [1, 2, 3, 4, 5],
+                "x": [1.1, 2.2, 3.3, 4.4, 5.5],
+                "s": ["s1", "s2", "s3", "s'4", "s5"],
+            }
+        )
+
+        query = hdk.prepare(
+            "SELECT a FROM t1 WHERE a > ? AND x < ? ORDER BY a;", t1=ht
+        )
+        assert query.parameter_count == 2
+        check_res(query.execute(1, 4.0), {"a": [2, 3]})
+        check_res(query.execute(2, 10.0), {"a": [3, 4, 5]})
+        check_res(query.execute(2, 10), {"a": [3, 4, 5]})
+        check_res(query.execute(None, 10.0), {"a": []})
+
+        query = hdk.prepare("SELECT a FROM t1 WHERE s = ? OR s = '?';", t1=ht)
+        assert query.parameter_count == 1
+        check_res(query.execute("s2"), {"a": [2]})
+        check_res(query.execute("s'4"), {"a": [4]})
+
+        with pytest.raises(RuntimeError):
+            query.execute()
+
+    def test_async(self):
+        hdk = pyhdk.init()
+        ht = hdk.import_pydict(
+            {"a": [1, 2, 3, 4, 5], "b": [5, 4, 3, 2, 1]}, fragment_size=2
+        )
+
+        handle = hdk.sql_async("SELECT a, b FROM t1 WHERE a > 1;", t1=ht)
+        res = handle.wait()
+        check_res(res, {"a": [2, 3, 4, 5], "b": [4, 3, 2, 1]})
+        assert handle.poll()
+        # Filtered projections might run an additional count query.
+        assert handle.total_fragments >= 3
+        assert handle.completed_fragments == handle.total_fragments
+        assert handle.progress == 1.0
+        # Cancellation of a finished query doesn't affect its result.
+        handle.cancel()
+        assert handle.cancelled
+        check_res(handle.wait(timeout=1), {"a": [2, 3, 4, 5], "b": [4, 3, 2, 1]})
+
+        res = ht.proj("b", "a").run_async().wait()
+        check_res(res, {"b": [5, 4, 3, 2, 1], "a": [1, 2, 3, 4, 5]})
+        check_res(res.proj("a").run(), {"a": [1, 2, 3, 4, 5]})
+
+    def test_limit_early_termination(self):
+        hdk = pyhdk.init()
+        ht = hdk.import_pydict({"a": list(range(1, 11))}, fragment_size=1)
+
+        # With a single thread, kernels run one by one, so fragments following the
+        # ones holding the first three matching rows are never started.
+        opts = hdk.query_opts()
+        opts.max_threads = 1
+        handle = hdk.sql_async("SELECT a FROM t1 WHERE a > 2 LIMIT 3;", opts, t1=ht)
+        check_res(handle.wait(), {"a": [3, 4, 5]})
+        assert handle.skipped_fragments > 0
+        assert handle.skipped_fragments <= handle.total_fragments - 3
+        # Skipped fragments are reported as processed.
+        assert handle.completed_fragments == handle.total_fragments
+
+        check_res(
+            hdk.sql("SELECT a FROM t1 LIMIT 2 OFFSET 7;", t1=ht), {"a": [8, 9]}
+        )
+
+    def test_metadata_aggregates(self):
+        hdk = pyhdk.init()
+        ht = hdk.import_pydict(
+            {"a": [1, 2, 3, 4, 5, 6], "b": [1.5, None, 3.5, 4.5, 5.5, 6.5]},
+            fragment_size=2,
+        )
+
+        check_res(
+            hdk.sql(
+                "SELECT COUNT(*) AS c, COUNT(b) AS cb, MIN(a) AS mn, MAX(b) AS mx FROM t1;",
+                t1=ht,
+            ),
+            {"c": [6], "cb": [5], "mn": [1], "mx": [6.5]},
+        )
+        # The first fragment is partially covered by the filter and has to be scanned.
+        check_res(
+            hdk.sql(
+                "SELECT COUNT(*) AS c, MIN(b) AS mn, MAX(a) AS mx FROM t1 WHERE a >= 2;",
+                t1=ht,
+            ),
+            {"c": [5], "mn": [3.5], "mx": [6]},
+        )
+        check_res(
+            hdk.sql(
+                "SELECT COUNT(*) AS c, MIN(a) AS mn FROM t1 WHERE a > 2 AND a < 5;",
+                t1=ht,
+            ),
+            {"c": [2], "mn": [3]},
+        )
+
+    def test_priority(self):
+        hdk = pyhdk.init()
+        ht = hdk.import_pydict(
+            {"a": [1, 2, 3, 4, 5], "b": [5, 4, 3, 2, 1]}, fragment_size=1
+        )
+
+        opts = hdk.query_opts()
+        opts.priority = "batch"
+        opts.max_threads = 1
+        batch = hdk.sql_async("SELECT a, b FROM t1 WHERE a > 1;", opts, t1=ht)
+        res = hdk.sql(
+            "SELECT SUM(a) AS s FROM t1;", {"priority": "interactive"}, t1=ht
+        )
+        check_res(res, {"s": [15]})
+        check_res(batch.wait(), {"a": [2, 3, 4, 5], "b": [4, 3, 2, 1]})
+
+        with pytest.raises(ValueError):
+            opts.priority = "urgent"
+        with pytest.raises(ValueError):
+            opts.max_threads = -1
+
+    def test_memory_stats(self):
+        hdk = pyhdk.init()
+        ht = hdk.import_pydict(
+            {"a": [1, 2, 3, 1, 2], "b": [10, 20, 30, 40, 50]}, fragment_size=2
+        )
+
+        res = hdk.sql("SELECT a, SUM(b) AS s FROM t1 GROUP BY a ORDER BY a;", t1=ht)
+        check_res(res, {"a": [1, 2, 3], "s": [50, 70, 30]})
+        stats = res.memory_stats
+        assert stats["result_buffers"] > 0
+        assert stats["input_chunks"] > 0
+        assert stats["total"] >= max(stats["result_buffers"], stats["input_chunks"])
+        assert stats["total"] <= sum(v for k, v in stats.items() if k != "total")
+
+    def test_partitioned_reduction(self):
+        hdk = pyhdk.init()
+        n = 150000
+        ht = hdk.import_pydict(
+            {
+                "a": list(range(n)) * 2,
+                "b": [i % 7 for i in range(2 * n)],
+                "c": [(i % n) * 100000 for i in range(2 * n)],
+            },
+            fragment_size=n // 2,
+        )
+
+        # Perfect hash group-by with a count distinct target.
+        res = hdk.sql(
+            "SELECT a, COUNT(*) AS cnt, COUNT(DISTINCT b) AS d FROM t1 GROUP BY a;",
+            t1=ht,
+        )
+        df = res.to_arrow().to_pandas()
+        assert len(df) == n
+        assert (df["cnt"] == 2).all()
+        assert (df["d"] == 2).all()
+
+        # Baseline hash group-by.
+        res = hdk.sql("SELECT a, c, SUM(b) AS s FROM t1 GROUP BY a, c;", t1=ht)
+        df = res.to_arrow().to_pandas()
+        assert len(df) == n
+        assert (df["c"] == df["a"] * 100000).all()
+        assert df["s"].sum() == sum(i % 7 for i in range(2 * n))
+
 
 class BaseTaxiTest:
     @staticmethod
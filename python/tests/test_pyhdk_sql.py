@@ -81,3 +81,14 @@ class TestSql:
 
         with pytest.raises(RuntimeError):
             self.get_storage().importArrowTable(at, "test", opt)
+
+    def test_query_memory_limit(self):
+        config = pyhdk.buildConfig(max_query_memory=16)
+        executor = pyhdk.Executor(self.data_mgr, config)
+        ra = self.calcite.process("SELECT a, SUM(b) FROM test GROUP BY a;")
+        rel_alg_executor = pyhdk.sql.RelAlgExecutor(
+            executor, self.storage, self.data_mgr, ra
+        )
+        with pytest.raises(RuntimeError) as e:
+            rel_alg_executor.execute()
+        assert "Query memory limit of 16 bytes exceeded" in str(e.value)
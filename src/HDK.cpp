@@ -13,6 +13,7 @@
 #include "DataMgr/DataMgr.h"
 #include "Logger/Logger.h"
 #include "QueryEngine/Execute.h"
+#include "QueryEngine/RelAlgDagCache.h"
 #include "QueryEngine/RelAlgExecutor.h"
 #include "Shared/Config.h"
 
@@ -27,6 +28,7 @@ struct Internal {
   std::shared_ptr<Data_Namespace::DataMgr> data_mgr;
   CalciteMgr* calcite;
   std::shared_ptr<Executor> executor;
+  std::unique_ptr<RelAlgDagCache> dag_cache;
 };
 
 void HDK::read(std::shared_ptr<arrow::Table>& table, const std::string& table_name) {
@@ -36,28 +38,81 @@ void HDK::read(std::shared_ptr<arrow::Table>& table, const std::string& table_na
 }
 
 ExecutionResult HDK::query(const std::string& sql, const bool is_explain) {
+  auto ra = translate(sql);
+  return execute(buildDag(ra), ra);
+}
+
+std::shared_ptr<hdk::QueryHandle> HDK::queryAsync(const std::string& sql) {
+  return std::make_shared<hdk::QueryHandle>(
+      [this, sql](std::shared_ptr<hdk::QueryProgress> progress) {
+        auto ra = translate(sql);
+        return execute(buildDag(ra), ra, progress);
+      });
+}
+
+std::shared_ptr<hdk::PreparedQuery> HDK::prepare(const std::string& sql) {
+  return std::make_shared<hdk::PreparedQuery>(sql);
+}
+
+ExecutionResult HDK::execute(hdk::PreparedQuery& query,
+                             const std::vector<hdk::QueryParameter>& params) {
+  CHECK(internal_);
+  if (query.needsTemplate(params)) {
+    try {
+      query.addTemplate(params, translate(query.templateSql(params)));
+    } catch (const std::exception& e) {
+      LOG(INFO) << "Failed to translate the prepared query template: " << e.what();
+      query.addUnusableTemplate(params);
+    }
+  }
+  auto dag = query.bind(params, internal_->db_id, internal_->storage, internal_->config);
+  if (dag) {
+    return execute(std::move(dag));
+  }
+  auto ra = translate(query.literalSql(params));
+  return execute(buildDag(ra), ra);
+}
+
+std::string HDK::translate(const std::string& sql) {
   CHECK(internal_);
   CHECK(internal_->calcite);
-  auto ra = internal_->calcite->process(internal_->db_name,
-                                        sql,
-                                        internal_->storage.get(),
-                                        internal_->config.get(),
-                                        {},
-                                        /*legacy_syntax=*/true);
+  return internal_->calcite->process(internal_->db_name,
+                                     sql,
+                                     internal_->storage.get(),
+                                     internal_->config.get(),
+                                     {},
+                                     /*legacy_syntax=*/true);
+}
 
+std::unique_ptr<hdk::ir::QueryDag> HDK::buildDag(const std::string& ra) {
   CHECK(internal_->storage);
   CHECK(internal_->config);
-  auto dag = std::make_unique<RelAlgDagBuilder>(
-      ra, internal_->db_id, internal_->storage, internal_->config);
+  CHECK(internal_->dag_cache);
+  auto dag = internal_->dag_cache->get(
+      ra, internal_->db_id, *internal_->storage, internal_->config);
+  if (!dag) {
+    dag = std::make_unique<RelAlgDagBuilder>(
+        ra, internal_->db_id, internal_->storage, internal_->config);
+  }
+  return dag;
+}
 
+ExecutionResult HDK::execute(std::unique_ptr<hdk::ir::QueryDag> dag,
+                             const std::string& ra,
+                             std::shared_ptr<hdk::QueryProgress> progress) {
   CHECK(internal_->executor);
   CHECK(internal_->data_mgr);
   RelAlgExecutor ra_executor(
       internal_->executor.get(), internal_->storage, std::move(dag));
+  ra_executor.setQueryProgress(progress);
 
   auto co = CompilationOptions::defaults(ExecutorDeviceType::CPU);
   auto eo = ExecutionOptions::fromConfig(*internal_->config.get());
-  return ra_executor.executeRelAlgQuery(co, eo, /*just_explain_plan=*/false);
+  auto res = ra_executor.executeRelAlgQuery(co, eo, /*just_explain_plan=*/false);
+  if (!ra.empty()) {
+    internal_->dag_cache->put(ra, internal_->db_id, ra_executor.releaseQueryDag());
+  }
+  return res;
 }
 
 namespace {
@@ -91,12 +146,17 @@ HDK::HDK() : internal_(std::make_unique<Internal>()) {
 
   // Calcite
   internal_->calcite = CalciteMgr::get(/*udf_filename=*/"",
-                                       /*calcite_max_mem_mb=*/1024);
+                                       /*calcite_max_mem_mb=*/1024,
+                                       internal_->config->exec.calcite_workers,
+                                       internal_->config->cache.calcite_cache_size);
 
   // Executor
   internal_->executor =
       Executor::getExecutor(internal_->data_mgr.get(), internal_->config, "", "");
   internal_->executor->setSchemaProvider(internal_->storage);
+
+  internal_->dag_cache =
+      std::make_unique<RelAlgDagCache>(internal_->config->cache.rel_alg_dag_cache_size);
 }
 
 HDK::~HDK() {}
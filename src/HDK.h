@@ -5,6 +5,8 @@
  */
 
 #include "QueryEngine/Descriptors/RelAlgExecutionDescriptor.h"  // ExecutionResult
+#include "QueryEngine/PreparedQuery.h"
+#include "QueryEngine/QueryHandle.h"
 
 #include <arrow/api.h>
 
@@ -20,8 +22,25 @@ class HDK {
 
   ExecutionResult query(const std::string& sql, const bool is_explain = false);
 
+  // Starts the query execution in background and returns its handle.
+  std::shared_ptr<hdk::QueryHandle> queryAsync(const std::string& sql);
+
+  // Prepares SQL query with '?' parameter placeholders for repeated execution.
+  std::shared_ptr<hdk::PreparedQuery> prepare(const std::string& sql);
+
+  ExecutionResult execute(hdk::PreparedQuery& query,
+                          const std::vector<hdk::QueryParameter>& params);
+
   static HDK init();
 
  private:
+  std::string translate(const std::string& sql);
+  // Takes a cached DAG for the RA or builds a new one.
+  std::unique_ptr<hdk::ir::QueryDag> buildDag(const std::string& ra);
+  // The DAG is put into the cache after execution if the RA it's built from is given.
+  ExecutionResult execute(std::unique_ptr<hdk::ir::QueryDag> dag,
+                          const std::string& ra = "",
+                          std::shared_ptr<hdk::QueryProgress> progress = nullptr);
+
   std::unique_ptr<Internal> internal_;
 };